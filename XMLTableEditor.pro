@@ -5,16 +5,21 @@ CONFIG += c++17
 TARGET = XMLTableEditor
 TEMPLATE = app
 
+# XML engine (no widget dependencies)
+include(xmlcore.pri)
+
 # Source files
 SOURCES += \
     main.cpp \
     mainwindow.cpp \
-    xmlworker.cpp
+    xmlloader.cpp \
+    xmlsaver.cpp
 
 # Header files
 HEADERS += \
     mainwindow.h \
-    xmlworker.h
+    xmlloader.h \
+    xmlsaver.h
 
 
 
@@ -0,0 +1,236 @@
+#include "benchmarkdata.h"
+#include <QFile>
+#include <QDebug>
+
+const int BenchmarkData::SIDE_TABLE_ROW_COUNT = 100;         // Rows in each side table
+const int BenchmarkData::TYPED_COLUMN_COUNT = 5;             // id, first_name, department, salary, hire_date
+
+/**
+ * @brief Write a synthetic database file
+ */
+bool BenchmarkData::GenerateDatabase(const QString &filePath, int rowCount, int columnCount, int sideTableCount)
+{
+    QFile _file(filePath);  // Output file
+    if (!_file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot create benchmark file" << filePath;
+        return false;
+    }
+
+    const QStringList _columnHeaders = GetColumnHeaders(columnCount);  // Column names shared by all tables
+
+    QXmlStreamWriter _writer(&_file);  // Writer producing the same layout as the editor
+    _writer.setAutoFormatting(true);
+    _writer.setAutoFormattingIndent(4);
+    _writer.writeStartDocument();
+    _writer.writeStartElement("database");
+
+    for (int _table = 0; _table <= sideTableCount; ++_table) {  // Table index (0 is the main table)
+        _writer.writeComment(QString(" Table %1 ").arg(_table));
+        WriteTable(_writer, _table == 0 ? GetMainTableName() : QString("side_%1").arg(_table),
+                   _table == 0 ? rowCount : SIDE_TABLE_ROW_COUNT, _columnHeaders, 0);
+    }
+
+    _writer.writeEndElement();
+    _writer.writeEndDocument();
+
+    return !_writer.hasError();
+}
+
+/**
+ * @brief Write a database shaped like sample.xml with tables of equal size
+ */
+bool BenchmarkData::GenerateSampleDatabase(const QString &filePath, int tableCount, int rowCount, int columnCount, int cellSize)
+{
+    QFile _file(filePath);  // Output file
+    if (!_file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot create stress file" << filePath;
+        return false;
+    }
+
+    const QStringList _columnHeaders = GetColumnHeaders(columnCount);  // Column names shared by all tables
+
+    QXmlStreamWriter _writer(&_file);  // Writer producing the same layout as the editor
+    _writer.setAutoFormatting(true);
+    _writer.setAutoFormattingIndent(4);
+    _writer.writeStartDocument();
+    _writer.writeStartElement("database");
+
+    for (int _table = 0; _table < tableCount; ++_table) {  // Table index (0-based)
+        _writer.writeComment(QString(" Table %1 of %2 ").arg(_table + 1).arg(tableCount));
+        WriteTable(_writer, GetSampleTableName(_table), rowCount, _columnHeaders, cellSize);
+    }
+
+    _writer.writeEndElement();
+    _writer.writeEndDocument();
+
+    return !_writer.hasError();
+}
+
+/**
+ * @brief Get name of a table written by GenerateSampleDatabase
+ */
+QString BenchmarkData::GetSampleTableName(int table)
+{
+    return QString("table_%1").arg(table + 1);
+}
+
+/**
+ * @brief Get name of the main table written by GenerateDatabase
+ */
+QString BenchmarkData::GetMainTableName()
+{
+    return "bench";
+}
+
+/**
+ * @brief Get generated column names for a column count
+ */
+QStringList BenchmarkData::GetColumnHeaders(int columnCount)
+{
+    static const QStringList _baseNames = {"id", "first_name", "department", "salary", "hire_date"};  // Typed leading columns
+
+    QStringList _headers;  // Generated column names
+    for (int _col = 0; _col < columnCount; ++_col) {  // Current column index (0-based)
+        _headers.append(_col < _baseNames.size() ? _baseNames.at(_col) : QString("field_%1").arg(_col));
+    }
+    return _headers;
+}
+
+/**
+ * @brief Get deterministic value of a generated cell
+ */
+QString BenchmarkData::GetCellValue(int row, int column)
+{
+    static const QStringList _firstNames = {"John", "Lisa", "Michael", "Sarah", "David", "Emma", "James", "Olivia"};  // Low-cardinality names
+    static const QStringList _departments = {"Engineering", "Marketing", "Sales", "Finance", "Support"};           // Very low-cardinality values
+
+    switch (column) {
+    case 0:
+        return QString::number(100000 + row);
+    case 1:
+        return _firstNames.at(row % _firstNames.size());
+    case 2:
+        return _departments.at((row / 3) % _departments.size());
+    case 3:
+        return QString::number(40000 + (row * 37) % 60000);
+    case 4:
+        return QString("20%1-%2-%3").arg(10 + row % 15).arg(1 + row % 12, 2, 10, QChar('0')).arg(1 + row % 28, 2, 10, QChar('0'));
+    default:
+        return QString("value %1 of row %2").arg(column).arg(row);
+    }
+}
+
+/**
+ * @brief Get deterministic value of a generated cell, padded to a minimum size
+ */
+QString BenchmarkData::GetCellValue(int row, int column, int cellSize)
+{
+    static const QString _filler = " lorem & ipsum <dolor> sit amet";  // Padding, with characters that need escaping
+
+    QString _value = GetCellValue(row, column);  // Unpadded cell text
+    if (column < TYPED_COLUMN_COUNT) {
+        return _value;
+    }
+
+    while (_value.size() < cellSize) {
+        _value += _filler.left(cellSize - _value.size());
+    }
+    return _value;
+}
+
+/**
+ * @brief Reset the peak resident set size counter of the process (Linux only)
+ */
+void BenchmarkData::ResetPeakResidentSize()
+{
+#ifdef Q_OS_LINUX
+    // Writing 5 resets VmHWM to the current RSS (Linux 4.0 and later)
+    QFile _clearRefs("/proc/self/clear_refs");  // Kernel interface for page reference statistics
+    if (_clearRefs.open(QIODevice::WriteOnly)) {
+        _clearRefs.write("5");
+    }
+#endif
+}
+
+/**
+ * @brief Get peak resident set size of the process since start or the last reset
+ */
+qint64 BenchmarkData::GetPeakResidentSize()
+{
+    return ReadStatusValue("VmHWM:");
+}
+
+/**
+ * @brief Get current resident set size of the process
+ */
+qint64 BenchmarkData::GetResidentSize()
+{
+    return ReadStatusValue("VmRSS:");
+}
+
+/**
+ * @brief Print throughput and peak memory of a measured operation
+ */
+void BenchmarkData::ReportThroughput(const QString &operation, qint64 bytes, qint64 rows, qint64 nanoseconds)
+{
+    const double _seconds = nanoseconds > 0 ? nanoseconds / 1e9 : 0.0;  // Duration of one run in seconds
+    QString _line = QString("%1: %2 ms").arg(operation).arg(nanoseconds / 1e6, 0, 'f', 3);  // Report line
+
+    if (_seconds > 0.0 && bytes > 0) {
+        _line += QString(", %1 MB/s").arg(bytes / _seconds / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+    if (_seconds > 0.0 && rows > 0) {
+        _line += QString(", %1 rows/s").arg(rows / _seconds, 0, 'f', 0);
+    }
+
+    const qint64 _peakResident = GetPeakResidentSize();  // Peak RSS in KiB (-1 if unknown)
+    _line += _peakResident >= 0 ? QString(", peak RSS %1 MiB").arg(_peakResident / 1024.0, 0, 'f', 1) : QString(", peak RSS n/a");
+
+    qInfo().noquote() << _line;
+}
+
+/**
+ * @brief Write one table element with generated rows
+ */
+void BenchmarkData::WriteTable(QXmlStreamWriter &writer, const QString &tableName, int rowCount, const QStringList &columnHeaders, int cellSize)
+{
+    writer.writeStartElement("table");
+    writer.writeAttribute("name", tableName);
+
+    for (int _row = 0; _row < rowCount; ++_row) {  // Current row index (0-based)
+        writer.writeStartElement("row");
+        for (int _col = 0; _col < columnHeaders.size(); ++_col) {  // Current column index (0-based)
+            writer.writeStartElement("cell");
+            writer.writeAttribute("name", columnHeaders.at(_col));
+            writer.writeCharacters(GetCellValue(_row, _col, cellSize));
+            writer.writeEndElement();
+        }
+        writer.writeEndElement();
+    }
+
+    writer.writeEndElement();
+}
+
+/**
+ * @brief Read a memory counter of the process status (Linux only)
+ */
+qint64 BenchmarkData::ReadStatusValue(const QByteArray &key)
+{
+#ifdef Q_OS_LINUX
+    QFile _status("/proc/self/status");  // Process status with memory counters
+    if (!_status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+
+    // Line format: "VmHWM:     123456 kB"
+    while (!_status.atEnd()) {
+        const QByteArray _line = _status.readLine();  // Current status line
+        if (_line.startsWith(key)) {
+            return _line.mid(key.size()).trimmed().split(' ').value(0).toLongLong();
+        }
+    }
+#else
+    Q_UNUSED(key);
+#endif
+    return -1;
+}
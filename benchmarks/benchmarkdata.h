@@ -0,0 +1,121 @@
+#ifndef BENCHMARKDATA_H
+#define BENCHMARKDATA_H
+
+#include <QString>
+#include <QStringList>
+#include <QXmlStreamWriter>
+
+/**
+ * @brief Helpers shared by the benchmark targets
+ * Generates deterministic synthetic databases in the editor's XML format and
+ * reads process memory statistics
+ */
+class BenchmarkData
+{
+public:
+    /**
+     * @brief Write a synthetic database file
+     * The main table mixes low-cardinality columns (names, departments) with
+     * unique ones (ids, free text); small side tables make lazy loading visible
+     * @param filePath Path of the file to create (overwritten if it exists)
+     * @param rowCount Number of rows in the main table
+     * @param columnCount Number of columns in every table
+     * @param sideTableCount Number of additional small tables written after the main table
+     * @return true if the file was written successfully, false otherwise
+     */
+    static bool GenerateDatabase(const QString &filePath, int rowCount, int columnCount, int sideTableCount = 2);
+
+    /**
+     * @brief Write a database shaped like sample.xml with tables of equal size
+     * Tables are named table_1, table_2, ... and preceded by a comment, like the
+     * tables of sample.xml. Free text cells (columns past the typed leading ones)
+     * are padded to the cell size with filler text that includes '&', '<' and '>'
+     * @param filePath Path of the file to create (overwritten if it exists)
+     * @param tableCount Number of tables
+     * @param rowCount Number of rows in every table
+     * @param columnCount Number of columns in every table
+     * @param cellSize Minimum number of characters of every free text cell
+     * @return true if the file was written successfully, false otherwise
+     */
+    static bool GenerateSampleDatabase(const QString &filePath, int tableCount, int rowCount, int columnCount, int cellSize);
+
+    /**
+     * @brief Get name of a table written by GenerateSampleDatabase
+     * @param table Table index (0-based)
+     * @return QString containing the table name
+     */
+    static QString GetSampleTableName(int table);
+
+    /**
+     * @brief Get name of the main table written by GenerateDatabase
+     * @return QString containing the table name
+     */
+    static QString GetMainTableName();
+
+    /**
+     * @brief Get generated column names for a column count
+     * @param columnCount Number of columns
+     * @return QStringList containing column names
+     */
+    static QStringList GetColumnHeaders(int columnCount);
+
+    /**
+     * @brief Get deterministic value of a generated cell
+     * @param row Row index (0-based)
+     * @param column Column index (0-based)
+     * @return QString containing the cell text
+     */
+    static QString GetCellValue(int row, int column);
+
+    /**
+     * @brief Get deterministic value of a generated cell, padded to a minimum size
+     * @param row Row index (0-based)
+     * @param column Column index (0-based)
+     * @param cellSize Minimum number of characters of free text cells (typed leading columns are not padded)
+     * @return QString containing the cell text
+     */
+    static QString GetCellValue(int row, int column, int cellSize);
+
+    /**
+     * @brief Reset the peak resident set size counter of the process (Linux only)
+     */
+    static void ResetPeakResidentSize();
+
+    /**
+     * @brief Get peak resident set size of the process since start or the last reset
+     * @return Peak RSS in KiB, -1 if not available on this platform
+     */
+    static qint64 GetPeakResidentSize();
+
+    /**
+     * @brief Get current resident set size of the process
+     * @return RSS in KiB, -1 if not available on this platform
+     */
+    static qint64 GetResidentSize();
+
+    /**
+     * @brief Print throughput and peak memory of a measured operation
+     * @param operation Name of the measured operation
+     * @param bytes Number of bytes processed by one run (0 to omit)
+     * @param rows Number of rows processed by one run (0 to omit)
+     * @param nanoseconds Average duration of one run
+     */
+    static void ReportThroughput(const QString &operation, qint64 bytes, qint64 rows, qint64 nanoseconds);
+
+private:
+    /**
+     * @brief Write one table element with generated rows
+     */
+    static void WriteTable(QXmlStreamWriter &writer, const QString &tableName, int rowCount, const QStringList &columnHeaders, int cellSize);
+
+    /**
+     * @brief Read a memory counter of the process status (Linux only)
+     * @return Value in KiB, -1 if not available
+     */
+    static qint64 ReadStatusValue(const QByteArray &key);
+
+    static const int SIDE_TABLE_ROW_COUNT;       // Rows in each side table
+    static const int TYPED_COLUMN_COUNT;         // Leading columns holding numbers, names and dates
+};
+
+#endif // BENCHMARKDATA_H
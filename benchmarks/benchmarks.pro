@@ -0,0 +1,9 @@
+# Benchmark and stress targets, both run by "make check"
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    xmlworkerbenchmark \
+    xmlworkerstress
+
+xmlworkerbenchmark.file = xmlworkerbenchmark.pro
+xmlworkerstress.file = xmlworkerstress.pro
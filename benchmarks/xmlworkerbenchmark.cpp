@@ -0,0 +1,1012 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include "benchmarkdata.h"
+#include "xmlworker.h"
+#include "xmlscanner.h"
+#include "xmltablemodel.h"
+#include "changejournal.h"
+#include "tablediff.h"
+#include "xmlworkspace.h"
+#include "delimitedfile.h"
+#include "tablecodec.h"
+#include "tablepager.h"
+
+/**
+ * @brief QTest benchmarks for the XMLWorker hot paths
+ * Every function runs for each load mode over generated databases of several
+ * sizes. Besides the QBENCHMARK timing, throughput and peak RSS are printed.
+ * Set XMLBENCH_MAX_ROWS to include larger databases (default 100000, up to 10000000)
+ */
+class XMLWorkerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Prepare the temporary directory and the row counts to run
+     */
+    void initTestCase();
+
+    /**
+     * @brief Reset the peak RSS counter so each data row reports its own peak
+     */
+    void init();
+
+    void BenchLoadXMLFile_data();
+    void BenchLoadXMLFile();
+
+    void BenchLoadTableData_data();
+    void BenchLoadTableData();
+
+    void BenchScanTableRanges_data();
+    void BenchScanTableRanges();
+
+    void BenchLoadFromSidecar_data();
+    void BenchLoadFromSidecar();
+
+    void BenchUpdateCompleteTable_data();
+    void BenchUpdateCompleteTable();
+
+    void BenchDeleteRowFromTable_data();
+    void BenchDeleteRowFromTable();
+
+    void BenchDeleteRowsFromTable_data();
+    void BenchDeleteRowsFromTable();
+
+    void BenchSaveXMLFile_data();
+    void BenchSaveXMLFile();
+
+    void BenchSortColumn_data();
+    void BenchSortColumn();
+
+    void BenchInferColumnTypes_data();
+    void BenchInferColumnTypes();
+
+    void BenchDiscardChanges_data();
+    void BenchDiscardChanges();
+
+    void BenchTableDiff_data();
+    void BenchTableDiff();
+
+    void BenchImportDelimited_data();
+    void BenchImportDelimited();
+
+    void BenchExportDelimited_data();
+    void BenchExportDelimited();
+
+    void BenchParseTableCodec_data();
+    void BenchParseTableCodec();
+
+    void BenchWriteTableCodec_data();
+    void BenchWriteTableCodec();
+
+private:
+    /**
+     * @brief Add one data row per load mode, row count and column count
+     */
+    void AddBenchmarkRows();
+
+    /**
+     * @brief Add one data row per row count, column count and codec ("fixed" or "generic")
+     */
+    void AddCodecRows();
+
+    /**
+     * @brief Serialize a table with QXmlStreamWriter the way the general save path does
+     */
+    static QByteArray WriteTableGeneric(const TableData &table);
+
+    /**
+     * @brief Get path of a generated database, generating it on first use
+     * @param rowCount Number of rows in the main table
+     * @param columnCount Number of columns
+     * @return Absolute path of the read-only database file
+     */
+    QString GetDatabaseFile(int rowCount, int columnCount);
+
+    QTemporaryDir TempDir;                   // Directory holding generated databases (removed on exit)
+    QHash<QString, QString> DatabaseFiles;   // Size key ("rows x columns") to generated file path
+    QList<int> RowCounts;                    // Main table sizes to benchmark
+
+    static const int DELETE_BATCH_SIZE;      // Rows deleted in one DeleteRowFromTable or DeleteRowsFromTable measurement
+};
+
+const int XMLWorkerBenchmark::DELETE_BATCH_SIZE = 1000;  // Rows deleted per measurement
+
+/**
+ * @brief Prepare the temporary directory and the row counts to run
+ */
+void XMLWorkerBenchmark::initTestCase()
+{
+    QVERIFY(TempDir.isValid());
+
+    bool _ok = false;  // Flag indicating the environment variable holds a number
+    int _maxRows = qEnvironmentVariableIntValue("XMLBENCH_MAX_ROWS", &_ok);  // Largest main table to generate
+    if (!_ok) {
+        _maxRows = 100000;
+    }
+
+    for (int _rows : {1000, 10000, 100000, 1000000, 10000000}) {
+        if (_rows <= _maxRows) {
+            RowCounts.append(_rows);
+        }
+    }
+}
+
+/**
+ * @brief Reset the peak RSS counter so each data row reports its own peak
+ */
+void XMLWorkerBenchmark::init()
+{
+    BenchmarkData::ResetPeakResidentSize();
+}
+
+void XMLWorkerBenchmark::BenchLoadXMLFile_data()
+{
+    AddBenchmarkRows();
+}
+
+/**
+ * @brief Time a complete LoadXMLFile call
+ */
+void XMLWorkerBenchmark::BenchLoadXMLFile()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    const QString _filePath = GetDatabaseFile(rows, columns);  // Database to load
+    XMLWorker _worker;  // Worker under test
+    _worker.SetLoadMode(XMLWorker::LoadMode(mode));
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_worker.LoadXMLFile(_filePath));
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    BenchmarkData::ReportThroughput("LoadXMLFile", QFileInfo(_filePath).size(), rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchScanTableRanges_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("columns");
+
+    for (int _rows : RowCounts) {
+        for (int _columns : {4, 16}) {
+            QTest::addRow("%dx%d", _rows, _columns) << _rows << _columns;
+        }
+    }
+}
+
+/**
+ * @brief Time the structural pre-scan that locates the tables of a mapped file
+ */
+void XMLWorkerBenchmark::BenchScanTableRanges()
+{
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    QFile _file(GetDatabaseFile(rows, columns));  // Database to scan
+    QVERIFY(_file.open(QIODevice::ReadOnly));
+    const uchar *_data = _file.map(0, _file.size());  // Mapped file content
+    QVERIFY(_data);
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        XMLScanner _scanner(reinterpret_cast<const char *>(_data), _file.size());  // Scanner under test
+        _timer.start();
+        QVERIFY(_scanner.Scan("table"));
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    BenchmarkData::ReportThroughput(QString("XMLScanner (%1)").arg(XMLStructuralIndex::GetImplementationName()),
+                                    _file.size(), rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchLoadFromSidecar_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("columns");
+
+    for (int _rows : RowCounts) {
+        for (int _columns : {4, 16}) {
+            QTest::addRow("%dx%d", _rows, _columns) << _rows << _columns;
+        }
+    }
+}
+
+/**
+ * @brief Time reopening an unchanged file from its binary sidecar instead of parsing it
+ */
+void XMLWorkerBenchmark::BenchLoadFromSidecar()
+{
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    const QString _filePath = GetDatabaseFile(rows, columns);  // Database to load
+    XMLWorker _worker;  // Worker under test
+    _worker.SetLoadMode(XMLWorker::StreamingLoadMode);
+    _worker.SetSidecarCacheEnabled(true);
+
+    // The first load parses the file and writes the sidecar
+    QVERIFY(_worker.LoadXMLFile(_filePath));
+    QVERIFY(QFileInfo::exists(SidecarCache::GetSidecarPath(_filePath)));
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_worker.LoadXMLFile(_filePath));
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    TableData _table;  // Main table as read from the sidecar
+    QVERIFY(_worker.GetTable(BenchmarkData::GetMainTableName(), &_table));
+    QCOMPARE(_table.GetRowCount(), rows);
+    BenchmarkData::ReportThroughput("LoadXMLFile (sidecar)", QFileInfo(SidecarCache::GetSidecarPath(_filePath)).size(), rows, _elapsed / _runs);
+
+    // Leave the directory as generated
+    QFile::remove(SidecarCache::GetSidecarPath(_filePath));
+}
+
+void XMLWorkerBenchmark::BenchLoadTableData_data()
+{
+    AddBenchmarkRows();
+}
+
+/**
+ * @brief Time serving the main table to a model, first call and repeated calls
+ */
+void XMLWorkerBenchmark::BenchLoadTableData()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    XMLWorker _worker;         // Worker under test
+    XMLTableModel _model;      // Model receiving the table
+    _worker.SetLoadMode(XMLWorker::LoadMode(mode));
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, columns)));
+
+    // DomLoadMode and LazyLoadMode only read the first page of rows, so neither call should grow with the table
+    QElapsedTimer _timer;   // Timer of a single run
+    _timer.start();
+    QVERIFY(_worker.LoadTableData(BenchmarkData::GetMainTableName(), &_model));
+    BenchmarkData::ReportThroughput("LoadTableData (first)", 0, rows, _timer.nsecsElapsed());
+
+    qint64 _elapsed = 0;    // Total time of all repeated runs in nanoseconds
+    int _runs = 0;          // Number of repeated runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_worker.LoadTableData(BenchmarkData::GetMainTableName(), &_model));
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    // The remaining pages must complete the table exactly as counted up front
+    QCOMPARE(_model.GetTotalRowCount(), rows);
+    _model.FetchAll();
+    QCOMPARE(_model.rowCount(), rows);
+    QCOMPARE(_model.data(_model.index(rows - 1, 0)).toString(), BenchmarkData::GetCellValue(rows - 1, 0));
+    BenchmarkData::ReportThroughput("LoadTableData", 0, rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchUpdateCompleteTable_data()
+{
+    AddBenchmarkRows();
+}
+
+/**
+ * @brief Time replacing the main table with the model content
+ */
+void XMLWorkerBenchmark::BenchUpdateCompleteTable()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    XMLWorker _worker;         // Worker under test
+    XMLTableModel _model;      // Model providing the new content
+    _worker.SetLoadMode(XMLWorker::LoadMode(mode));
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, columns)));
+    QVERIFY(_worker.LoadTableData(BenchmarkData::GetMainTableName(), &_model));
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_worker.UpdateCompleteTable(BenchmarkData::GetMainTableName(), &_model));
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    BenchmarkData::ReportThroughput("UpdateCompleteTable", 0, rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchDeleteRowFromTable_data()
+{
+    AddBenchmarkRows();
+}
+
+/**
+ * @brief Time deleting a batch of rows from the middle of the main table
+ */
+void XMLWorkerBenchmark::BenchDeleteRowFromTable()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    XMLWorker _worker;  // Worker under test
+    _worker.SetLoadMode(XMLWorker::LoadMode(mode));
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, columns)));
+
+    // Deleting consumes the table, so the batch is measured exactly once
+    const int _batchSize = qMin(DELETE_BATCH_SIZE, rows / 2);  // Rows deleted in the measurement
+    QElapsedTimer _timer;   // Timer of the batch
+    qint64 _elapsed = 0;    // Time of the batch in nanoseconds
+
+    QBENCHMARK_ONCE {
+        _timer.start();
+        for (int _i = 0; _i < _batchSize; ++_i) {  // Rows deleted so far
+            QVERIFY(_worker.DeleteRowFromTable(BenchmarkData::GetMainTableName(), (rows - _i) / 2));
+        }
+        _elapsed = _timer.nsecsElapsed();
+    }
+
+    BenchmarkData::ReportThroughput(QString("DeleteRowFromTable x%1").arg(_batchSize), 0, _batchSize, _elapsed);
+}
+
+void XMLWorkerBenchmark::BenchDeleteRowsFromTable_data()
+{
+    AddBenchmarkRows();
+}
+
+/**
+ * @brief Time deleting the same rows as BenchDeleteRowFromTable with one batch call
+ */
+void XMLWorkerBenchmark::BenchDeleteRowsFromTable()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    XMLWorker _worker;  // Worker under test
+    _worker.SetLoadMode(XMLWorker::LoadMode(mode));
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, columns)));
+
+    // Same rows as the single row deletions: the middle block of the table
+    const int _batchSize = qMin(DELETE_BATCH_SIZE, rows / 2);  // Rows deleted in the measurement
+    QList<int> _rowIndices;  // Rows to delete
+    for (int _i = 0; _i < _batchSize; ++_i) {  // Rows collected so far
+        _rowIndices.append((rows - _batchSize) / 2 + _i);
+    }
+
+    QElapsedTimer _timer;   // Timer of the batch
+    qint64 _elapsed = 0;    // Time of the batch in nanoseconds
+
+    QBENCHMARK_ONCE {
+        _timer.start();
+        QVERIFY(_worker.DeleteRowsFromTable(BenchmarkData::GetMainTableName(), _rowIndices));
+        _elapsed = _timer.nsecsElapsed();
+    }
+
+    BenchmarkData::ReportThroughput(QString("DeleteRowsFromTable x%1").arg(_batchSize), 0, _batchSize, _elapsed);
+}
+
+void XMLWorkerBenchmark::BenchSaveXMLFile_data()
+{
+    AddBenchmarkRows();
+}
+
+/**
+ * @brief Time saving the file after a single cell edit of the main table
+ */
+void XMLWorkerBenchmark::BenchSaveXMLFile()
+{
+    QFETCH(int, mode);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    // Saving overwrites the file, so work on a private copy of the generated database
+    const QString _filePath = TempDir.filePath(QString("save_%1.xml").arg(QTest::currentDataTag()).replace('/', '_'));  // File rewritten by the benchmark
+    QFile::remove(_filePath);
+    QVERIFY(QFile::copy(GetDatabaseFile(rows, columns), _filePath));
+
+    XMLWorker _worker;  // Worker under test
+    _worker.SetLoadMode(XMLWorker::LoadMode(mode));
+    QVERIFY(_worker.LoadXMLFile(_filePath));
+
+    ChangeJournal _journal;  // Single edit, so patch saves only rewrite the main table
+    _journal.RecordCellEdit(rows / 2, 1, "edited");
+    QVERIFY(_worker.ApplyTableChanges(BenchmarkData::GetMainTableName(), _journal));
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_worker.SaveXMLFile());
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    BenchmarkData::ReportThroughput("SaveXMLFile", QFileInfo(_filePath).size(), rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchSortColumn_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("column");
+
+    for (int _rows : RowCounts) {
+        QTest::addRow("%d/numeric", _rows) << _rows << 0;
+        QTest::addRow("%d/text", _rows) << _rows << 1;
+    }
+}
+
+/**
+ * @brief Time sorting the main table by a numeric and by a text column
+ */
+void XMLWorkerBenchmark::BenchSortColumn()
+{
+    QFETCH(int, rows);
+    QFETCH(int, column);
+
+    XMLWorker _worker;         // Worker providing the table
+    XMLTableModel _model;      // Model being sorted
+    _worker.SetLoadMode(XMLWorker::StreamingLoadMode);
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, 4)));
+    QVERIFY(_worker.LoadTableData(BenchmarkData::GetMainTableName(), &_model));
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+    QVector<int> _order;    // Sorted view rows of the last run
+
+    // Descending, so the already ascending id column is really reordered
+    QBENCHMARK {
+        ColumnSorter _sorter = _model.CreateSorter(column);  // Sort job for the displayed rows
+        _timer.start();
+        _order = _sorter.Sort(Qt::DescendingOrder);
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    QCOMPARE(_order.size(), rows);
+    QVERIFY(_model.ApplyRowOrder(_order, _model.GetRevision()));
+    for (int _row = 1; _row < qMin(rows, 1000); ++_row) {  // Current view row (0-based)
+        const QString _previous = _model.data(_model.index(_row - 1, column)).toString();  // Value of the row above
+        const QString _current = _model.data(_model.index(_row, column)).toString();  // Value of the row
+        QVERIFY(column == 0 ? _previous.toInt() >= _current.toInt() : _previous.compare(_current, Qt::CaseInsensitive) >= 0);
+    }
+
+    BenchmarkData::ReportThroughput(QString("SortColumn (column %1)").arg(column), 0, rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchInferColumnTypes_data()
+{
+    QTest::addColumn<int>("rows");
+
+    for (int _rows : RowCounts) {
+        QTest::addRow("%d", _rows) << _rows;
+    }
+}
+
+/**
+ * @brief Time converting the numeric and date columns of the main table to native values
+ */
+void XMLWorkerBenchmark::BenchInferColumnTypes()
+{
+    QFETCH(int, rows);
+
+    const int _columns = 6;  // Id, name, department, salary, date and one free text column
+    TableData _table(BenchmarkData::GetMainTableName());  // Table as it is right after parsing
+    _table.SetColumnHeaders(BenchmarkData::GetColumnHeaders(_columns));
+    for (int _row = 0; _row < rows; ++_row) {  // Current row index (0-based)
+        QStringList _rowData;  // Generated cells of the row
+        for (int _col = 0; _col < _columns; ++_col) {  // Current column index (0-based)
+            _rowData.append(BenchmarkData::GetCellValue(_row, _col));
+        }
+        _table.AppendRow(_rowData);
+    }
+
+    // Inference converts the table in place, so it is measured exactly once
+    QElapsedTimer _timer;   // Timer of the conversion
+    qint64 _elapsed = 0;    // Time of the conversion in nanoseconds
+
+    QBENCHMARK_ONCE {
+        _timer.start();
+        _table.InferColumnTypes();
+        _elapsed = _timer.nsecsElapsed();
+    }
+
+    QVERIFY(_table.GetColumnType(0) == TableData::IntegerColumn);
+    QVERIFY(_table.GetColumnType(1) == TableData::TextColumn);
+    QVERIFY(_table.GetColumnType(3) == TableData::IntegerColumn);
+    QVERIFY(_table.GetColumnType(4) == TableData::DateColumn);
+    QVERIFY(_table.GetColumnType(5) == TableData::TextColumn);
+
+    // Native values must format back to exactly the parsed text
+    for (int _row = 0; _row < rows; _row += qMax(1, rows / 1000)) {  // Sampled row index (0-based)
+        for (int _col = 0; _col < _columns; ++_col) {  // Current column index (0-based)
+            QCOMPARE(_table.GetCell(_row, _col), BenchmarkData::GetCellValue(_row, _col));
+        }
+    }
+
+    BenchmarkData::ReportThroughput("InferColumnTypes", 0, rows, _elapsed);
+}
+
+void XMLWorkerBenchmark::BenchDiscardChanges_data()
+{
+    QTest::addColumn<int>("rows");
+
+    for (int _rows : RowCounts) {
+        QTest::addRow("%d", _rows) << _rows;
+    }
+}
+
+/**
+ * @brief Time undoing a mix of cell edits, inserted rows and deleted rows without reloading the table
+ */
+void XMLWorkerBenchmark::BenchDiscardChanges()
+{
+    QFETCH(int, rows);
+
+    XMLWorker _worker;         // Worker providing the table
+    XMLTableModel _model;      // Model being edited
+    _worker.SetLoadMode(XMLWorker::StreamingLoadMode);
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, 4)));
+    QVERIFY(_worker.LoadTableData(BenchmarkData::GetMainTableName(), &_model));
+
+    const int _edits = qMin(rows, 10000);  // Number of edited cells, also the number of deleted rows
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        for (int _i = 0; _i < _edits; ++_i) {  // Number of edits made so far
+            _model.setData(_model.index(_i, 1), QString("edited %1").arg(_i));
+        }
+        _model.insertRows(_model.rowCount(), 100);
+        QList<int> _deletedRows;  // Every other edited row
+        for (int _row = 0; _row < _edits; _row += 2) {  // Current view row (0-based)
+            _deletedRows.append(_row);
+        }
+        QVERIFY(_model.RemoveRowSet(_deletedRows));
+
+        _timer.start();
+        _model.DiscardChanges();
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    QVERIFY(!_model.HasPendingChanges());
+    QVERIFY(_model.CanRedo());
+    QCOMPARE(_model.rowCount(), rows);
+    for (int _row = 0; _row < _edits; _row += qMax(1, _edits / 1000)) {  // Sampled view row (0-based)
+        QCOMPARE(_model.data(_model.index(_row, 1)).toString(), BenchmarkData::GetCellValue(_row, 1));
+    }
+
+    BenchmarkData::ReportThroughput("DiscardChanges", 0, _edits, _elapsed / _runs);
+}
+
+/**
+ * @brief Add one data row per row count, matching rows by key column and by whole rows
+ */
+void XMLWorkerBenchmark::BenchTableDiff_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<bool>("keyed");
+
+    for (int _rows : RowCounts) {
+        QTest::addRow("%d/key", _rows) << _rows << true;
+        QTest::addRow("%d/rows", _rows) << _rows << false;
+    }
+}
+
+/**
+ * @brief Time comparing the main table of two files opened into one workspace, after editing one side
+ */
+void XMLWorkerBenchmark::BenchTableDiff()
+{
+    QFETCH(int, rows);
+    QFETCH(bool, keyed);
+
+    // Two files with the same content intern nothing new for the second one
+    const QString _filePath = GetDatabaseFile(rows, 4);  // Older version of the database
+    const QString _copyPath = TempDir.filePath(QString("database_%1x4_copy.xml").arg(rows));  // Newer version, edited in memory below
+    QVERIFY(QFile::exists(_copyPath) || QFile::copy(_filePath, _copyPath));
+
+    XMLWorkspace _singleWorkspace;  // Workspace holding only the older version
+    QVERIFY(_singleWorkspace.OpenFiles({_filePath}));
+    XMLWorkspace _workspace;  // Workspace holding both versions
+    QVERIFY(_workspace.OpenFiles({_filePath, _copyPath}));
+    QCOMPARE(_workspace.GetFileCount(), 2);
+    QCOMPARE(_workspace.GetStringPool()->GetSize(), _singleWorkspace.GetStringPool()->GetSize());
+
+    TableData _leftTable;   // Main table of the older version
+    TableData _rightTable;  // Main table of the newer version
+    QVERIFY(_workspace.GetWorker(0)->GetTable(BenchmarkData::GetMainTableName(), &_leftTable));
+    QVERIFY(_workspace.GetWorker(1)->GetTable(BenchmarkData::GetMainTableName(), &_rightTable));
+
+    // Edit every 100th row, delete the rows halfway between them and append a few new ones
+    int _editedRows = 0;   // Rows whose name was changed
+    QList<int> _deletedRows;  // Rows removed from the newer version, ascending
+    for (int _row = 0; _row < rows; _row += 100) {  // Edited row index (0-based)
+        _rightTable.SetCell(_row, 1, "Changed");
+        _editedRows++;
+        if (_row + 50 < rows) {
+            _deletedRows.append(_row + 50);
+        }
+    }
+    const int _deletedCount = int(_deletedRows.size());  // Rows only the older version has
+    QCOMPARE(_rightTable.RemoveRows(_deletedRows), _deletedCount);
+    const int _addedRows = 10;  // Rows only the newer version has
+    for (int _i = 0; _i < _addedRows; ++_i) {  // Number of rows appended so far
+        QStringList _rowData;  // Cells of the new row, with an id no other row has
+        _rowData << QString::number(100000 + rows + _i) << "New" << "Engineering" << BenchmarkData::GetCellValue(_i, 3);
+        _rightTable.AppendRow(_rowData);
+    }
+
+    const QString _keyColumnName = keyed ? BenchmarkData::GetColumnHeaders(4).at(0) : QString();  // Id column, or whole rows
+    TableDiff _diff(_leftTable, _rightTable, _keyColumnName);  // Comparison being measured
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_diff.Compare());
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    // Without a key an edited row is one removed and one added row
+    QCOMPARE(_diff.GetChangeCount(TableDiff::ChangedRow), keyed ? _editedRows : 0);
+    QCOMPARE(_diff.GetChangeCount(TableDiff::RemovedRow), _deletedCount + (keyed ? 0 : _editedRows));
+    QCOMPARE(_diff.GetChangeCount(TableDiff::AddedRow), _addedRows + (keyed ? 0 : _editedRows));
+    QCOMPARE(_diff.GetUnchangedRowCount(), rows - _deletedCount - _editedRows);
+
+    const TableData _result = _diff.CreateResultTable();  // Differences as displayed
+    QCOMPARE(_result.GetRowCount(), int(_diff.GetChanges().size()));
+    if (keyed) {
+        const int _changedRow = _diff.GetChangeCount(TableDiff::RemovedRow);  // First changed row, after the removed rows
+        QCOMPARE(_result.GetCell(_changedRow, 0), QString("changed"));
+        QCOMPARE(_result.GetCell(_changedRow, 2), BenchmarkData::GetCellValue(0, 1) + " -> Changed");
+    }
+
+    BenchmarkData::ReportThroughput("TableDiff", 0, qint64(rows) * 2, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchImportDelimited_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<bool>("tsv");
+    QTest::addColumn<bool>("replace");
+
+    for (int _rows : RowCounts) {
+        QTest::addRow("%d/csv/append", _rows) << _rows << false << false;
+        QTest::addRow("%d/tsv/replace", _rows) << _rows << true << true;
+    }
+}
+
+/**
+ * @brief Time importing the main table from a delimited file into a streaming worker
+ */
+void XMLWorkerBenchmark::BenchImportDelimited()
+{
+    QFETCH(int, rows);
+    QFETCH(bool, tsv);
+    QFETCH(bool, replace);
+
+    XMLWorker _worker;  // Worker receiving the rows
+    _worker.SetLoadMode(XMLWorker::StreamingLoadMode);
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, 16)));
+
+    // The imported file holds the main table itself, written once by the exporter
+    const QString _importPath = TempDir.filePath(QString("import_%1x16.%2").arg(rows).arg(tsv ? "tsv" : "csv"));  // Delimited file to import
+    DelimitedFile _file(DelimitedFile::GetDefaultDelimiter(_importPath));  // Importer under test
+    if (!QFile::exists(_importPath)) {
+        TableData _table;  // Main table, released before the import so appending does not copy it
+        QVERIFY(_worker.GetTable(BenchmarkData::GetMainTableName(), &_table));
+        QVERIFY(_file.WriteFile(_table, _importPath));
+    }
+
+    const DelimitedFile::ImportMode _mode = replace ? DelimitedFile::ReplaceRows : DelimitedFile::AppendRows;  // Import mode of the data row
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_file.ImportTable(&_worker, BenchmarkData::GetMainTableName(), _importPath, _mode));
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    // Every append adds the whole file once more, a replace leaves the file content
+    QCOMPARE(_file.GetRecordCount(), qint64(rows));
+    TableData _result;  // Main table after the imports
+    QVERIFY(_worker.GetTable(BenchmarkData::GetMainTableName(), &_result));
+    QCOMPARE(_result.GetRowCount(), replace ? rows : rows * (1 + _runs));
+    QCOMPARE(_result.GetCell(_result.GetRowCount() - 1, 3), BenchmarkData::GetCellValue(rows - 1, 3));
+
+    BenchmarkData::ReportThroughput("ImportDelimited", QFileInfo(_importPath).size(), rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchExportDelimited_data()
+{
+    QTest::addColumn<int>("rows");
+
+    for (int _rows : RowCounts) {
+        QTest::addRow("%d", _rows) << _rows;
+    }
+}
+
+/**
+ * @brief Time writing the main table as a CSV file
+ */
+void XMLWorkerBenchmark::BenchExportDelimited()
+{
+    QFETCH(int, rows);
+
+    XMLWorker _worker;  // Worker holding the table
+    _worker.SetLoadMode(XMLWorker::StreamingLoadMode);
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, 16)));
+    TableData _table;  // Table being written
+    QVERIFY(_worker.GetTable(BenchmarkData::GetMainTableName(), &_table));
+
+    const QString _exportPath = TempDir.filePath(QString("export_%1x16.csv").arg(rows));  // File rewritten by every run
+    DelimitedFile _file;  // Exporter under test
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        QVERIFY(_file.WriteFile(_table, _exportPath));
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    QCOMPARE(_file.GetRecordCount(), qint64(rows));
+    BenchmarkData::ReportThroughput("ExportDelimited", QFileInfo(_exportPath).size(), rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchParseTableCodec_data()
+{
+    AddCodecRows();
+}
+
+/**
+ * @brief Time parsing the main table range with the fixed layout parser and with the stream reader
+ */
+void XMLWorkerBenchmark::BenchParseTableCodec()
+{
+    QFETCH(bool, fixed);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    QFile _file(GetDatabaseFile(rows, columns));  // Database holding the table
+    QVERIFY(_file.open(QIODevice::ReadOnly));
+    const char *_data = reinterpret_cast<const char *>(_file.map(0, _file.size()));  // Mapped file content
+    QVERIFY(_data);
+
+    XMLScanner _scanner(_data, _file.size());  // Locates the main table
+    QVERIFY(_scanner.Scan("table"));
+    XMLScanner::ElementRange _range = {};  // Bytes of the main table
+    for (const XMLScanner::ElementRange &_candidate : _scanner.GetTableRanges()) {  // Table found by the scan
+        if (_candidate.Name == BenchmarkData::GetMainTableName()) {
+            _range = _candidate;
+        }
+    }
+    QVERIFY(_range.End > _range.Start);
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+    int _parsedRows = 0;    // Rows of the table parsed by the last run
+
+    QBENCHMARK {
+        _timer.start();
+        QSharedPointer<TableData> _table;  // Parsed table
+        if (fixed) {
+            QCOMPARE(int(TableCodec::ParseTable(_data + _range.Start, _range.End - _range.Start, QSharedPointer<StringPool>(), nullptr, &_table)),
+                     int(TableCodec::Parsed));
+        } else {
+            // Same steps as XMLWorker::ParseTableStream
+            QXmlStreamReader _reader(QByteArray::fromRawData(_data + _range.Start, int(_range.End - _range.Start)));  // Reader over the range
+            _reader.setNamespaceProcessing(false);
+            QVERIFY(_reader.readNextStartElement());
+            _table.reset(new TableData(_reader.attributes().value("name").toString()));
+            while (_reader.readNextStartElement()) {
+                QStringList _rowData;    // Cell values of the current row
+                QStringList _cellNames;  // Cell names (first row only)
+                TablePager::ReadStreamRow(_reader, "cell", &_rowData, _table->GetRowCount() == 0 ? &_cellNames : nullptr);
+                if (_table->GetRowCount() == 0) {
+                    _table->SetColumnHeaders(_cellNames);
+                }
+                _table->AppendRow(_rowData);
+            }
+            QVERIFY(!_reader.hasError());
+            _table->InferColumnTypes();
+        }
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+        _parsedRows = _table->GetRowCount();
+    }
+
+    QCOMPARE(_parsedRows, rows);
+    BenchmarkData::ReportThroughput(fixed ? "ParseTable (fixed layout)" : "ParseTable (stream reader)",
+                                    _range.End - _range.Start, rows, _elapsed / _runs);
+}
+
+void XMLWorkerBenchmark::BenchWriteTableCodec_data()
+{
+    AddCodecRows();
+}
+
+/**
+ * @brief Time serializing the main table with byte templates and with QXmlStreamWriter
+ */
+void XMLWorkerBenchmark::BenchWriteTableCodec()
+{
+    QFETCH(bool, fixed);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    XMLWorker _worker;  // Worker holding the table
+    _worker.SetLoadMode(XMLWorker::StreamingLoadMode);
+    QVERIFY(_worker.LoadXMLFile(GetDatabaseFile(rows, columns)));
+    TableData _table;  // Table being written
+    QVERIFY(_worker.GetTable(BenchmarkData::GetMainTableName(), &_table));
+
+    // Both serializations must agree byte for byte before their speed is compared
+    const QByteArray _expected = WriteTableGeneric(_table);  // Output of the general writer
+    QBuffer _check;  // Output of the fixed layout writer
+    QVERIFY(_check.open(QIODevice::WriteOnly));
+    QVERIFY(TableCodec::WriteTable(&_check, _table, 1));
+    QVERIFY(_check.data() == _expected);
+
+    QElapsedTimer _timer;   // Timer of a single run
+    qint64 _elapsed = 0;    // Total time of all runs in nanoseconds
+    int _runs = 0;          // Number of runs
+
+    QBENCHMARK {
+        _timer.start();
+        if (fixed) {
+            QBuffer _buffer;  // Serialized table
+            QVERIFY(_buffer.open(QIODevice::WriteOnly));
+            QVERIFY(TableCodec::WriteTable(&_buffer, _table, 1));
+        } else {
+            QVERIFY(!WriteTableGeneric(_table).isEmpty());
+        }
+        _elapsed += _timer.nsecsElapsed();
+        _runs++;
+    }
+
+    BenchmarkData::ReportThroughput(fixed ? "WriteTable (fixed layout)" : "WriteTable (stream writer)",
+                                    _expected.size(), rows, _elapsed / _runs);
+}
+
+/**
+ * @brief Add one data row per load mode, row count and column count
+ */
+void XMLWorkerBenchmark::AddBenchmarkRows()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("columns");
+
+    const QList<QPair<int, const char *>> _modes = {
+        {XMLWorker::DomLoadMode, "dom"},
+        {XMLWorker::StreamingLoadMode, "streaming"},
+        {XMLWorker::LazyLoadMode, "lazy"},
+        {XMLWorker::ParallelLoadMode, "parallel"}
+    };  // Load modes with their data tag prefix
+
+    for (const auto &_mode : _modes) {
+        for (int _rows : RowCounts) {
+            for (int _columns : {4, 16}) {
+                QTest::addRow("%s/%dx%d", _mode.second, _rows, _columns) << _mode.first << _rows << _columns;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Add one data row per row count, column count and codec ("fixed" or "generic")
+ */
+void XMLWorkerBenchmark::AddCodecRows()
+{
+    QTest::addColumn<bool>("fixed");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("columns");
+
+    for (bool _fixed : {true, false}) {
+        for (int _rows : RowCounts) {
+            for (int _columns : {4, 16}) {
+                QTest::addRow("%s/%dx%d", _fixed ? "fixed" : "generic", _rows, _columns) << _fixed << _rows << _columns;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Serialize a table with QXmlStreamWriter the way the general save path does
+ */
+QByteArray XMLWorkerBenchmark::WriteTableGeneric(const TableData &table)
+{
+    QBuffer _buffer;  // Serialized table
+    _buffer.open(QIODevice::WriteOnly);
+
+    // Depth 1 below a root element, same as in a saved document
+    QXmlStreamWriter _writer(&_buffer);  // General writer
+    _writer.setAutoFormatting(true);
+    _writer.setAutoFormattingIndent(4);
+    _writer.writeStartElement("database");
+
+    const QStringList _columnHeaders = table.GetColumnHeaders();  // Column names written as cell attributes
+    _writer.writeStartElement("table");
+    _writer.writeAttribute("name", table.GetName());
+    for (int _row = 0; _row < table.GetRowCount(); ++_row) {  // Current row index (0-based)
+        _writer.writeStartElement("row");
+        for (int _col = 0; _col < _columnHeaders.size(); ++_col) {  // Current column index (0-based)
+            _writer.writeStartElement("cell");
+            _writer.writeAttribute("name", _columnHeaders.at(_col));
+            _writer.writeCharacters(table.GetCell(_row, _col));
+            _writer.writeEndElement();
+        }
+        _writer.writeEndElement();
+    }
+    _writer.writeEndElement();
+
+    // The table starts with the line break before its start tag, the root end tag is never written
+    const int _tableStart = _buffer.data().lastIndexOf('\n', _buffer.data().indexOf("<table"));  // Offset of the table output
+    return _buffer.data().mid(_tableStart);
+}
+
+/**
+ * @brief Get path of a generated database, generating it on first use
+ */
+QString XMLWorkerBenchmark::GetDatabaseFile(int rowCount, int columnCount)
+{
+    const QString _key = QString("%1x%2").arg(rowCount).arg(columnCount);  // Size key of the database
+    auto _iterator = DatabaseFiles.constFind(_key);  // Previously generated file (end if not generated yet)
+    if (_iterator != DatabaseFiles.constEnd()) {
+        return _iterator.value();
+    }
+
+    const QString _filePath = TempDir.filePath(QString("database_%1.xml").arg(_key));  // New database file
+    if (!BenchmarkData::GenerateDatabase(_filePath, rowCount, columnCount)) {
+        return QString();
+    }
+
+    DatabaseFiles.insert(_key, _filePath);
+    return _filePath;
+}
+
+QTEST_GUILESS_MAIN(XMLWorkerBenchmark)
+#include "xmlworkerbenchmark.moc"
@@ -0,0 +1,27 @@
+QT += core xml testlib
+QT -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = xmlworkerbenchmark
+TEMPLATE = app
+
+# Both targets build in this directory, keep their intermediate files apart
+OBJECTS_DIR = .obj/$$TARGET
+MOC_DIR = .moc/$$TARGET
+
+# XML engine under test
+include(../xmlcore.pri)
+
+# Source files
+SOURCES += \
+    benchmarkdata.cpp \
+    xmlworkerbenchmark.cpp
+
+# Header files
+HEADERS += \
+    benchmarkdata.h
+
+# Compiler flags for professional development
+QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
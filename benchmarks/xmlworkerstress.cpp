@@ -0,0 +1,675 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include "benchmarkdata.h"
+#include "delimitedfile.h"
+#include "xmlworker.h"
+#include "xmltablemodel.h"
+
+/**
+ * @brief Wall time and peak memory allowed for one operation of the edit cycle
+ * Both ceilings grow linearly with the size of the file the operation works on,
+ * so an operation turning quadratic in the row count exceeds them on the larger
+ * shapes while linear ones stay well below
+ */
+struct OperationCeiling {
+    const char *Name;                    // Operation name in reports and failure messages
+    double NanosecondsPerByte;           // Wall time allowed per byte of the file
+    double ResidentBytesPerByte;         // Peak RSS growth allowed per byte of the file
+};
+
+/**
+ * @brief Ceilings of the operations in cycle order, for the compact load modes
+ * DOM mode gets DOM_TIME_FACTOR and DOM_MEMORY_FACTOR on top of these
+ */
+static const OperationCeiling OPERATION_CEILINGS[] = {
+    {"Load", 300.0, 4.0},                // LoadXMLFile
+    {"Edit", 300.0, 6.0},                // LoadTableData, cell edits, row insert and delete, UpdateCompleteTable
+    {"Save", 200.0, 3.0},                // SaveXMLFile
+    {"Reload", 300.0, 4.0}               // LoadXMLFile of the saved file in a second worker
+};
+
+/**
+ * @brief QTest stress suite driving load, edit, save and reload cycles over large generated databases
+ * Every operation is checked against a wall time and a peak RSS ceiling (see
+ * OPERATION_CEILINGS), and the reloaded table must equal the edited one cell by
+ * cell. A second test runs the cycle on 4 times the rows and fails if any
+ * operation grows by more than SCALING_RATIO_LIMIT, which catches quadratic
+ * algorithms independently of the speed of the machine.
+ * Regression functions replay fixed bugs on small generated files.
+ * Set XMLSTRESS_SCALE to multiply all row counts (default 1), and
+ * XMLSTRESS_CEILING_FACTOR to relax all ceilings on slow or instrumented builds (default 1.0)
+ */
+class XMLWorkerStress : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Prepare the temporary directory and read the scale settings
+     */
+    void initTestCase();
+
+    void StressEditCycle_data();
+    void StressEditCycle();
+
+    void StressScaling_data();
+    void StressScaling();
+
+    /**
+     * @brief Append a row to a table of which only the first page is fetched
+     */
+    void RegressionAppendRowWhilePaging();
+
+    /**
+     * @brief Sort a table of which only the first page is fetched
+     */
+    void RegressionSortWhilePaging();
+
+    /**
+     * @brief Filter a sorted table that has no pending changes
+     */
+    void RegressionFilterSortedTable();
+
+    /**
+     * @brief Load a file in lazy and streaming mode after a parallel load failed on the same worker
+     */
+    void RegressionLoadAfterFailedParallelLoad();
+
+    /**
+     * @brief Export a one-column table with empty cells and read it back
+     */
+    void RegressionDelimitedEmptyCells();
+
+    /**
+     * @brief Import a multi-column file with a blank line between its records
+     */
+    void RegressionDelimitedBlankLine();
+
+private:
+    /**
+     * @brief Operations of one cycle, indexing OPERATION_CEILINGS
+     */
+    enum Operation {
+        LoadOperation,
+        EditOperation,
+        SaveOperation,
+        ReloadOperation,
+        OPERATION_COUNT
+    };
+
+    /**
+     * @brief Measured cost of one operation
+     */
+    struct OperationCost {
+        qint64 Nanoseconds;              // Wall time
+        qint64 PeakResidentKiB;          // Peak RSS growth over the RSS before the operation (-1 if unknown)
+    };
+
+    /**
+     * @brief Run one load, edit, save and reload cycle on a file, checking every ceiling
+     * Failures are reported through QTest; check QTest::currentTestFailed afterwards
+     * @param mode Load mode of both workers
+     * @param filePath File loaded and overwritten by the save
+     * @param tableCount Number of tables the file must have after reloading
+     * @param cycle Cycle number, part of the edited values
+     * @param costs Receives the cost of every operation
+     */
+    void RunCycle(int mode, const QString &filePath, int tableCount, int cycle, QVector<OperationCost> *costs);
+
+    /**
+     * @brief Reset the peak RSS counter and start timing an operation
+     */
+    void StartOperation();
+
+    /**
+     * @brief Stop timing an operation, report it and check its ceilings
+     * @return Measured cost of the operation
+     */
+    OperationCost FinishOperation(Operation operation, int mode, qint64 fileBytes, int rows);
+
+    /**
+     * @brief Get path of a generated database, generating it on first use
+     * @return Absolute path of the read-only database file
+     */
+    QString GetDatabaseFile(int tableCount, int rowCount, int columnCount, int cellSize);
+
+    /**
+     * @brief Copy a generated database to a file the cycle may overwrite
+     * @return Path of the copy, named after the current data tag
+     */
+    QString CreateWorkingCopy(const QString &filePath, const QString &suffix);
+
+    QTemporaryDir TempDir;                   // Directory holding generated databases (removed on exit)
+    QHash<QString, QString> DatabaseFiles;   // Shape key to generated file path
+    int Scale;                               // Multiplier of all row counts
+    double CeilingFactor;                    // Multiplier of all ceilings
+    QElapsedTimer OperationTimer;            // Timer of the running operation
+    qint64 OperationBaseKiB;                 // RSS when the running operation started (-1 if unknown)
+
+    static const int CYCLE_COUNT;            // Cycles run on each file; later cycles load what the previous one saved
+    static const int EDIT_COUNT;             // Cells edited per cycle
+    static const qint64 BASE_NANOSECONDS;    // Wall time allowed per operation on top of the per-byte ceiling
+    static const qint64 BASE_RESIDENT_KIB;   // RSS growth allowed per operation on top of the per-byte ceiling
+    static const double DOM_TIME_FACTOR;     // Ceiling multiplier of wall time in DOM mode
+    static const double DOM_MEMORY_FACTOR;   // Ceiling multiplier of RSS growth in DOM mode
+    static const int SCALING_ROW_COUNT;      // Rows of the smaller file of the scaling test
+    static const double SCALING_RATIO_LIMIT; // Largest growth of an operation for 4 times the rows
+    static const qint64 SCALING_MIN_NANOSECONDS;  // Floor of the smaller time, so timer noise cannot fail the ratio
+};
+
+const int XMLWorkerStress::CYCLE_COUNT = 2;                          // Second cycle reads the output of the first
+const int XMLWorkerStress::EDIT_COUNT = 100;                         // Edits spread over the whole table
+const qint64 XMLWorkerStress::BASE_NANOSECONDS = 250000000;          // 250 ms for setup and small files
+const qint64 XMLWorkerStress::BASE_RESIDENT_KIB = 64 * 1024;         // 64 MiB for allocator slack and thread stacks
+const double XMLWorkerStress::DOM_TIME_FACTOR = 3.0;                 // DOM nodes are built one by one
+const double XMLWorkerStress::DOM_MEMORY_FACTOR = 6.0;               // A DOM node costs far more than its bytes
+const int XMLWorkerStress::SCALING_ROW_COUNT = 25000;                // Large enough to rise above fixed costs
+const double XMLWorkerStress::SCALING_RATIO_LIMIT = 10.0;            // Linear is 4, n log n about 4.5, quadratic 16
+const qint64 XMLWorkerStress::SCALING_MIN_NANOSECONDS = 20000000;    // 20 ms
+
+/**
+ * @brief Prepare the temporary directory and read the scale settings
+ */
+void XMLWorkerStress::initTestCase()
+{
+    QVERIFY(TempDir.isValid());
+
+    bool _ok = false;  // Flag indicating the environment variable holds a number
+    Scale = qEnvironmentVariableIntValue("XMLSTRESS_SCALE", &_ok);
+    if (!_ok || Scale < 1) {
+        Scale = 1;
+    }
+
+    CeilingFactor = qEnvironmentVariable("XMLSTRESS_CEILING_FACTOR").toDouble(&_ok);
+    if (!_ok || CeilingFactor <= 0.0) {
+        CeilingFactor = 1.0;
+    }
+
+    OperationBaseKiB = -1;
+    qInfo().noquote() << QString("Stress scale %1, ceiling factor %2").arg(Scale).arg(CeilingFactor);
+}
+
+void XMLWorkerStress::StressEditCycle_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("tables");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("cellSize");
+
+    const QList<QPair<int, const char *>> _modes = {
+        {XMLWorker::DomLoadMode, "dom"},
+        {XMLWorker::StreamingLoadMode, "streaming"},
+        {XMLWorker::LazyLoadMode, "lazy"},
+        {XMLWorker::ParallelLoadMode, "parallel"}
+    };  // Load modes with their data tag prefix
+
+    // Many tables, many rows and large cells; all around 20 to 30 MB at scale 1
+    const QList<QVector<int>> _shapes = {
+        {32, 2500, 6, 32},
+        {1, 100000, 6, 32},
+        {1, 10000, 8, 1024}
+    };  // Table count, row count, column count and cell size
+
+    for (const auto &_mode : _modes) {
+        for (const QVector<int> &_shape : _shapes) {
+            const int _rows = _shape.at(1) * Scale;  // Rows of every table
+            QTest::addRow("%s/%dx%dx%dx%d", _mode.second, _shape.at(0), _rows, _shape.at(2), _shape.at(3))
+                << _mode.first << _shape.at(0) << _rows << _shape.at(2) << _shape.at(3);
+        }
+    }
+}
+
+/**
+ * @brief Run the edit cycles on one database shape and load mode
+ */
+void XMLWorkerStress::StressEditCycle()
+{
+    QFETCH(int, mode);
+    QFETCH(int, tables);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+    QFETCH(int, cellSize);
+
+    const QString _sourcePath = GetDatabaseFile(tables, rows, columns, cellSize);  // Generated database
+    QVERIFY(!_sourcePath.isEmpty());
+    const QString _filePath = CreateWorkingCopy(_sourcePath, QString());  // File edited by the cycles
+    QVERIFY(!_filePath.isEmpty());
+
+    for (int _cycle = 1; _cycle <= CYCLE_COUNT; ++_cycle) {  // Current cycle (1-based)
+        QVector<OperationCost> _costs;  // Costs of the cycle, checked on the way
+        RunCycle(mode, _filePath, tables, _cycle, &_costs);
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+    }
+
+    QFile::remove(_filePath);
+}
+
+void XMLWorkerStress::StressScaling_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::addRow("dom") << int(XMLWorker::DomLoadMode);
+    QTest::addRow("streaming") << int(XMLWorker::StreamingLoadMode);
+    QTest::addRow("lazy") << int(XMLWorker::LazyLoadMode);
+    QTest::addRow("parallel") << int(XMLWorker::ParallelLoadMode);
+}
+
+/**
+ * @brief Compare every operation on a file and on one with 4 times the rows
+ */
+void XMLWorkerStress::StressScaling()
+{
+    QFETCH(int, mode);
+
+    const int _smallRows = SCALING_ROW_COUNT * Scale;  // Rows of the smaller file
+    QVector<OperationCost> _smallCosts;  // Operation costs on the smaller file
+    QVector<OperationCost> _largeCosts;  // Operation costs on the larger file
+
+    const QString _smallPath = CreateWorkingCopy(GetDatabaseFile(1, _smallRows, 6, 32), "small");  // Smaller file
+    QVERIFY(!_smallPath.isEmpty());
+    RunCycle(mode, _smallPath, 1, 1, &_smallCosts);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    const QString _largePath = CreateWorkingCopy(GetDatabaseFile(1, 4 * _smallRows, 6, 32), "large");  // Larger file
+    QVERIFY(!_largePath.isEmpty());
+    RunCycle(mode, _largePath, 1, 1, &_largeCosts);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    for (int _operation = 0; _operation < OPERATION_COUNT; ++_operation) {  // Compared operation
+        const double _ratio = double(_largeCosts.at(_operation).Nanoseconds)
+                              / qMax(_smallCosts.at(_operation).Nanoseconds, SCALING_MIN_NANOSECONDS);  // Growth for 4 times the rows
+        qInfo().noquote() << QString("%1: %2x for 4x rows").arg(OPERATION_CEILINGS[_operation].Name).arg(_ratio, 0, 'f', 2);
+        QVERIFY2(_ratio <= SCALING_RATIO_LIMIT * CeilingFactor,
+                 qPrintable(QString("%1 grew %2x for 4x rows (limit %3x)")
+                                .arg(OPERATION_CEILINGS[_operation].Name).arg(_ratio, 0, 'f', 2).arg(SCALING_RATIO_LIMIT * CeilingFactor)));
+    }
+
+    QFile::remove(_smallPath);
+    QFile::remove(_largePath);
+}
+
+/**
+ * @brief Append a row to a table of which only the first page is fetched
+ */
+void XMLWorkerStress::RegressionAppendRowWhilePaging()
+{
+    const int _rows = 5000;  // Many pages of rows
+    const QString _filePath = GetDatabaseFile(1, _rows, 4, 0);  // Small database
+    QVERIFY(!_filePath.isEmpty());
+
+    // Unopened lazy tables are served page by page
+    XMLWorker _worker;  // Worker paging the table
+    _worker.SetLoadMode(XMLWorker::LazyLoadMode);
+    _worker.SetSidecarCacheEnabled(false);
+    QVERIFY(_worker.LoadXMLFile(_filePath));
+
+    XMLTableModel _model;  // Model reading the table page by page
+    QVERIFY(_worker.LoadTableData(BenchmarkData::GetSampleTableName(0), &_model));
+    QVERIFY(_model.rowCount() < _rows);
+    QCOMPARE(_model.GetTotalRowCount(), _rows);
+
+    // Appending and editing read no further page, rows fetched later are shown above the new row
+    int _fetchedRows = _model.rowCount();  // Rows of the first page
+    QCOMPARE(_model.AppendRow(), _fetchedRows);
+    QVERIFY(_model.setData(_model.index(0, 0), "edited"));
+    QCOMPARE(_model.rowCount(), _fetchedRows + 1);
+    QCOMPARE(_model.GetTotalRowCount(), _rows + 1);
+
+    _model.FetchAll();
+    QCOMPARE(_model.rowCount(), _rows + 1);
+    QCOMPARE(_model.data(_model.index(0, 0)).toString(), QString("edited"));
+    QCOMPARE(_model.data(_model.index(_rows - 1, 0)).toString(), BenchmarkData::GetCellValue(_rows - 1, 0));
+    QVERIFY(_model.data(_model.index(_rows, 0)).toString().isEmpty());
+
+    // Inserting after the last fetched row of a fresh pager also lands at the end
+    XMLWorker _pagingWorker;  // Worker whose table is still unopened
+    _pagingWorker.SetLoadMode(XMLWorker::LazyLoadMode);
+    _pagingWorker.SetSidecarCacheEnabled(false);
+    QVERIFY(_pagingWorker.LoadXMLFile(_filePath));
+    QVERIFY(_pagingWorker.LoadTableData(BenchmarkData::GetSampleTableName(0), &_model));
+    _fetchedRows = _model.rowCount();
+    QVERIFY(_fetchedRows < _rows);
+    QVERIFY(_model.insertRows(_fetchedRows, 1));
+    QCOMPARE(_model.rowCount(), _fetchedRows + 1);
+
+    _model.FetchAll();
+    QCOMPARE(_model.rowCount(), _rows + 1);
+    QCOMPARE(_model.data(_model.index(_fetchedRows, 0)).toString(), BenchmarkData::GetCellValue(_fetchedRows, 0));
+    QVERIFY(_model.data(_model.index(_rows, 0)).toString().isEmpty());
+}
+
+/**
+ * @brief Sort a table of which only the first page is fetched
+ */
+void XMLWorkerStress::RegressionSortWhilePaging()
+{
+    const int _rows = 5000;  // Many pages of rows
+    const QString _filePath = GetDatabaseFile(1, _rows, 4, 0);  // Small database
+    QVERIFY(!_filePath.isEmpty());
+
+    XMLWorker _worker;  // Worker paging the table
+    _worker.SetLoadMode(XMLWorker::LazyLoadMode);
+    _worker.SetSidecarCacheEnabled(false);
+    QVERIFY(_worker.LoadXMLFile(_filePath));
+
+    XMLTableModel _model;  // Model reading the table page by page
+    QVERIFY(_worker.LoadTableData(BenchmarkData::GetSampleTableName(0), &_model));
+    QVERIFY(_model.rowCount() < _rows);
+
+    // Same order of calls as the window: the revision is read once the sorter has fetched every row
+    ColumnSorter _sorter = _model.CreateSorter(0);  // Sort job for the whole table
+    const quint64 _revision = _model.GetRevision();  // Revision the sorted rows belong to
+    QVERIFY(_model.ApplyRowOrder(_sorter.Sort(Qt::DescendingOrder), _revision));
+    QCOMPARE(_model.rowCount(), _rows);
+    QCOMPARE(_model.data(_model.index(0, 0)).toString(), BenchmarkData::GetCellValue(_rows - 1, 0));
+    QCOMPARE(_model.data(_model.index(_rows - 1, 0)).toString(), BenchmarkData::GetCellValue(0, 0));
+}
+
+/**
+ * @brief Filter a sorted table that has no pending changes
+ */
+void XMLWorkerStress::RegressionFilterSortedTable()
+{
+    const int _rows = 1000;  // Rows of the table
+    TableData _table("sorted");  // Table sorted in reverse by its first column
+    _table.SetColumnHeaders(QStringList() << "id" << "name");
+    for (int _row = 0; _row < _rows; ++_row) {  // Current row index (0-based)
+        _table.AppendRow(QStringList() << BenchmarkData::GetCellValue(_row, 0) << BenchmarkData::GetCellValue(_row, 1));
+    }
+
+    XMLTableModel _model;  // Model showing the sorted rows
+    _model.SetTableData(_table);
+    ColumnSorter _sorter = _model.CreateSorter(0);  // Sort job for the whole table
+    const quint64 _revision = _model.GetRevision();  // Revision the sorted rows belong to
+    QVERIFY(_model.ApplyRowOrder(_sorter.Sort(Qt::DescendingOrder), _revision));
+    QVERIFY(!_model.HasPendingChanges());
+
+    const int _matchRow = 10;  // Committed row searched for
+    const QVector<int> _matches = _model.FindRows(0, ColumnIndex::EqualQuery, BenchmarkData::GetCellValue(_matchRow, 0));  // Matching view rows
+    QCOMPARE(int(_matches.size()), 1);
+    QCOMPARE(_matches.first(), _rows - 1 - _matchRow);
+    QCOMPARE(_model.data(_model.index(_matches.first(), 0)).toString(), BenchmarkData::GetCellValue(_matchRow, 0));
+}
+
+/**
+ * @brief Load a file in lazy and streaming mode after a parallel load failed on the same worker
+ */
+void XMLWorkerStress::RegressionLoadAfterFailedParallelLoad()
+{
+    // The undeclared entity only fails the table parse, the pre-scan accepts the file
+    const QString _brokenPath = TempDir.filePath("broken_entity.xml");  // File failing in the parallel parse
+    QFile _brokenFile(_brokenPath);  // Writer of the broken file
+    QVERIFY(_brokenFile.open(QIODevice::WriteOnly));
+    _brokenFile.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<database>\n"
+                      "    <table name=\"good\">\n        <row>\n            <cell name=\"a\">1</cell>\n        </row>\n    </table>\n"
+                      "    <table name=\"bad\">\n        <row>\n            <cell name=\"a\">&undeclared;</cell>\n        </row>\n    </table>\n"
+                      "</database>\n");
+    _brokenFile.close();
+
+    const int _rows = 5000;  // More rows than one cancel poll interval
+    const QString _filePath = GetDatabaseFile(1, _rows, 4, 0);  // Valid database
+    QVERIFY(!_filePath.isEmpty());
+
+    XMLWorker _worker;  // Worker reused across the loads
+    _worker.SetSidecarCacheEnabled(false);
+
+    for (XMLWorker::LoadMode _mode : {XMLWorker::LazyLoadMode, XMLWorker::StreamingLoadMode}) {  // Mode of the load after the failure
+        _worker.SetLoadMode(XMLWorker::ParallelLoadMode);
+        QVERIFY(!_worker.LoadXMLFile(_brokenPath));
+
+        _worker.SetLoadMode(_mode);
+        QVERIFY(_worker.LoadXMLFile(_filePath));
+        TableData _table;  // Table parsed after the failed load
+        QVERIFY(_worker.GetTable(BenchmarkData::GetSampleTableName(0), &_table));
+        QCOMPARE(_table.GetRowCount(), _rows);
+    }
+}
+
+/**
+ * @brief Export a one-column table with empty cells and read it back
+ */
+void XMLWorkerStress::RegressionDelimitedEmptyCells()
+{
+    TableData _table("single");  // One column with empty cells inside and at the end
+    _table.SetColumnHeaders(QStringList() << "value");
+    const QStringList _cells = QStringList() << "a" << "" << "" << "b" << "";  // Cells in row order
+    for (const QString &_cell : _cells) {
+        _table.AppendRow(QStringList() << _cell);
+    }
+
+    const QString _filePath = TempDir.filePath("single_column.csv");  // Exported table
+    DelimitedFile _file;  // Writer and reader of the table
+    QVERIFY(_file.WriteFile(_table, _filePath));
+
+    QList<QStringList> _records;  // Records read back, header first
+    QVERIFY(_file.ReadRecords(_filePath, [&_records](const QList<QStringList> &records) {
+        _records.append(records);
+        return true;
+    }));
+    QCOMPARE(int(_records.size()), int(_cells.size()) + 1);
+    QCOMPARE(_records.first(), QStringList() << "value");
+    for (int _row = 0; _row < _cells.size(); ++_row) {  // Current row index (0-based)
+        QCOMPARE(_records.at(_row + 1), QStringList() << _cells.at(_row));
+    }
+}
+
+/**
+ * @brief Import a multi-column file with a blank line between its records
+ */
+void XMLWorkerStress::RegressionDelimitedBlankLine()
+{
+    const QString _xmlPath = TempDir.filePath("blank_line.xml");  // Database with one two-column table
+    QFile _xmlFile(_xmlPath);  // Writer of the database
+    QVERIFY(_xmlFile.open(QIODevice::WriteOnly));
+    _xmlFile.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<database>\n"
+                   "    <table name=\"pairs\">\n        <row>\n            <cell name=\"a\">0</cell>\n"
+                   "            <cell name=\"b\">0</cell>\n        </row>\n    </table>\n</database>\n");
+    _xmlFile.close();
+
+    const QString _csvPath = TempDir.filePath("blank_line.csv");  // Rows separated by a blank line
+    QFile _csvFile(_csvPath);  // Writer of the rows
+    QVERIFY(_csvFile.open(QIODevice::WriteOnly));
+    _csvFile.write("a,b\n1,2\n\n3,4\n\n");
+    _csvFile.close();
+
+    XMLWorker _worker;  // Worker holding the table
+    _worker.SetLoadMode(XMLWorker::StreamingLoadMode);
+    _worker.SetSidecarCacheEnabled(false);
+    QVERIFY(_worker.LoadXMLFile(_xmlPath));
+
+    DelimitedFile _file;  // Importer of the rows
+    QVERIFY(_file.ImportTable(&_worker, "pairs", _csvPath, DelimitedFile::AppendRows));
+    QCOMPARE(int(_file.GetRecordCount()), 2);
+
+    TableData _table;  // Table after the import
+    QVERIFY(_worker.GetTable("pairs", &_table));
+    QCOMPARE(_table.GetRowCount(), 3);
+    QCOMPARE(_table.GetRow(1), QStringList() << "1" << "2");
+    QCOMPARE(_table.GetRow(2), QStringList() << "3" << "4");
+}
+
+/**
+ * @brief Run one load, edit, save and reload cycle on a file, checking every ceiling
+ */
+void XMLWorkerStress::RunCycle(int mode, const QString &filePath, int tableCount, int cycle, QVector<OperationCost> *costs)
+{
+    const QString _tableName = BenchmarkData::GetSampleTableName(0);  // Table edited by the cycle
+    const qint64 _fileBytes = QFileInfo(filePath).size();  // Size of the file the cycle starts from
+    costs->clear();
+
+    // Sidecars would let the reload skip the XML
+    XMLWorker _worker;  // Worker loading, editing and saving the file
+    _worker.SetLoadMode(XMLWorker::LoadMode(mode));
+    _worker.SetSidecarCacheEnabled(false);
+
+    StartOperation();
+    QVERIFY(_worker.LoadXMLFile(filePath));
+    costs->append(FinishOperation(LoadOperation, mode, _fileBytes, 0));
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // Scattered cell edits, one appended row and one removed row, committed through the complete table path
+    XMLTableModel _model;  // Model holding the edits
+    StartOperation();
+    QVERIFY(_worker.LoadTableData(_tableName, &_model));
+    _model.FetchAll();
+    const int _rows = _model.rowCount();  // Rows of the edited table
+    QVERIFY(_rows > 2);
+
+    const int _editInterval = qMax(2, _rows / EDIT_COUNT);  // Rows between two edited rows
+    for (int _row = 0; _row < _rows; _row += _editInterval) {  // Edited row
+        QVERIFY(_model.setData(_model.index(_row, 1), QString("edited %1 in cycle %2").arg(_row).arg(cycle)));
+    }
+    QVERIFY(_model.insertRows(_rows, 1));
+    QVERIFY(_model.setData(_model.index(_rows, 0), QString("inserted in cycle %1").arg(cycle)));
+    QVERIFY(_model.removeRows(1, 1));
+    QVERIFY(_worker.UpdateCompleteTable(_tableName, &_model));
+    costs->append(FinishOperation(EditOperation, mode, _fileBytes, _rows));
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    TableData _expected;  // Edited table as held by the worker
+    QVERIFY(_worker.GetTable(_tableName, &_expected));
+    QCOMPARE(_expected.GetRowCount(), _rows);
+    QCOMPARE(_expected.GetCell(_rows - 1, 0), QString("inserted in cycle %1").arg(cycle));
+
+    StartOperation();
+    QVERIFY(_worker.SaveXMLFile());
+    costs->append(FinishOperation(SaveOperation, mode, _fileBytes, _rows));
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    const qint64 _savedBytes = QFileInfo(filePath).size();  // Size of the saved file
+    XMLWorker _reloaded;  // Worker reading the saved file
+    _reloaded.SetLoadMode(XMLWorker::LoadMode(mode));
+    _reloaded.SetSidecarCacheEnabled(false);
+
+    StartOperation();
+    QVERIFY(_reloaded.LoadXMLFile(filePath));
+    costs->append(FinishOperation(ReloadOperation, mode, _savedBytes, _rows));
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // The saved file must hold exactly the edited table, and every other table unchanged in size
+    QCOMPARE(_reloaded.GetTableNames().size(), tableCount);
+    TableData _actual;  // Edited table as read back
+    QVERIFY(_reloaded.GetTable(_tableName, &_actual));
+    QCOMPARE(_actual.GetColumnHeaders(), _expected.GetColumnHeaders());
+    QCOMPARE(_actual.GetRowCount(), _expected.GetRowCount());
+    for (int _row = 0; _row < _expected.GetRowCount(); ++_row) {  // Compared row
+        for (int _col = 0; _col < _expected.GetColumnCount(); ++_col) {  // Compared column
+            if (_actual.GetCell(_row, _col) != _expected.GetCell(_row, _col)) {
+                QFAIL(qPrintable(QString("Cell %1,%2 reads \"%3\", expected \"%4\"")
+                                     .arg(_row).arg(_col).arg(_actual.GetCell(_row, _col), _expected.GetCell(_row, _col))));
+            }
+        }
+    }
+
+    if (tableCount > 1) {
+        TableData _untouched;  // Last table, never edited
+        QVERIFY(_reloaded.GetTable(BenchmarkData::GetSampleTableName(tableCount - 1), &_untouched));
+        QCOMPARE(_untouched.GetRowCount(), _rows);
+    }
+}
+
+/**
+ * @brief Reset the peak RSS counter and start timing an operation
+ */
+void XMLWorkerStress::StartOperation()
+{
+    BenchmarkData::ResetPeakResidentSize();
+    OperationBaseKiB = BenchmarkData::GetResidentSize();
+    OperationTimer.start();
+}
+
+/**
+ * @brief Stop timing an operation, report it and check its ceilings
+ */
+XMLWorkerStress::OperationCost XMLWorkerStress::FinishOperation(Operation operation, int mode, qint64 fileBytes, int rows)
+{
+    OperationCost _cost = OperationCost();  // Measured cost
+    _cost.Nanoseconds = OperationTimer.nsecsElapsed();
+
+    const qint64 _peakKiB = BenchmarkData::GetPeakResidentSize();  // Peak RSS since StartOperation (-1 if unknown)
+    _cost.PeakResidentKiB = _peakKiB >= 0 && OperationBaseKiB >= 0 ? qMax(qint64(0), _peakKiB - OperationBaseKiB) : -1;
+
+    const OperationCeiling &_ceiling = OPERATION_CEILINGS[operation];  // Ceilings of the operation
+    const bool _dom = mode == XMLWorker::DomLoadMode;  // Flag indicating DOM mode allowances apply
+    const qint64 _maxNanoseconds = qint64((BASE_NANOSECONDS + _ceiling.NanosecondsPerByte * fileBytes * (_dom ? DOM_TIME_FACTOR : 1.0))
+                                          * CeilingFactor);  // Wall time ceiling
+    const qint64 _maxResidentKiB = qint64((BASE_RESIDENT_KIB + _ceiling.ResidentBytesPerByte * fileBytes / 1024.0 * (_dom ? DOM_MEMORY_FACTOR : 1.0))
+                                          * CeilingFactor);  // Peak RSS growth ceiling
+
+    BenchmarkData::ReportThroughput(QString("%1 (RSS +%2 MiB, ceilings %3 ms, %4 MiB)")
+                                        .arg(_ceiling.Name)
+                                        .arg(_cost.PeakResidentKiB / 1024.0, 0, 'f', 1)
+                                        .arg(_maxNanoseconds / 1e6, 0, 'f', 0)
+                                        .arg(_maxResidentKiB / 1024.0, 0, 'f', 0),
+                                    fileBytes, rows, _cost.Nanoseconds);
+
+    // QVERIFY2 cannot return a value, so the failure is recorded and the caller checks currentTestFailed
+    if (_cost.Nanoseconds > _maxNanoseconds) {
+        QTest::qFail(qPrintable(QString("%1 took %2 ms, ceiling %3 ms").arg(_ceiling.Name)
+                                    .arg(_cost.Nanoseconds / 1e6, 0, 'f', 1).arg(_maxNanoseconds / 1e6, 0, 'f', 1)),
+                     __FILE__, __LINE__);
+    } else if (_cost.PeakResidentKiB > _maxResidentKiB) {
+        QTest::qFail(qPrintable(QString("%1 grew RSS by %2 MiB, ceiling %3 MiB").arg(_ceiling.Name)
+                                    .arg(_cost.PeakResidentKiB / 1024.0, 0, 'f', 1).arg(_maxResidentKiB / 1024.0, 0, 'f', 1)),
+                     __FILE__, __LINE__);
+    }
+
+    return _cost;
+}
+
+/**
+ * @brief Get path of a generated database, generating it on first use
+ */
+QString XMLWorkerStress::GetDatabaseFile(int tableCount, int rowCount, int columnCount, int cellSize)
+{
+    const QString _key = QString("%1x%2x%3x%4").arg(tableCount).arg(rowCount).arg(columnCount).arg(cellSize);  // Shape key
+    auto _iterator = DatabaseFiles.constFind(_key);  // Previously generated file (end if not generated yet)
+    if (_iterator != DatabaseFiles.constEnd()) {
+        return _iterator.value();
+    }
+
+    const QString _filePath = TempDir.filePath(QString("stress_%1.xml").arg(_key));  // New database file
+    if (!BenchmarkData::GenerateSampleDatabase(_filePath, tableCount, rowCount, columnCount, cellSize)) {
+        return QString();
+    }
+
+    DatabaseFiles.insert(_key, _filePath);
+    return _filePath;
+}
+
+/**
+ * @brief Copy a generated database to a file the cycle may overwrite
+ */
+QString XMLWorkerStress::CreateWorkingCopy(const QString &filePath, const QString &suffix)
+{
+    const QString _copyPath = TempDir.filePath(QString("work_%1%2.xml").arg(QString::fromLatin1(QTest::currentDataTag()), suffix).replace('/', '_'));  // Working copy
+    QFile::remove(_copyPath);
+    if (filePath.isEmpty() || !QFile::copy(filePath, _copyPath)) {
+        return QString();
+    }
+
+    // Copies keep the read-only permissions some platforms give to the source
+    QFile::setPermissions(_copyPath, QFile::permissions(_copyPath) | QFileDevice::WriteOwner);
+    return _copyPath;
+}
+
+QTEST_GUILESS_MAIN(XMLWorkerStress)
+#include "xmlworkerstress.moc"
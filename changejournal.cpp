@@ -0,0 +1,215 @@
+#include "changejournal.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor initializes an empty journal
+ */
+ChangeJournal::ChangeJournal()
+    : CellEdits()                      // Pending committed cell values
+    , InsertedRows()                   // Pending appended rows
+    , DeletedRows()                    // Pending deleted rows
+    , NextInsertId(0)                  // Insertion counter
+{
+}
+
+/**
+ * @brief Discard all recorded changes
+ */
+void ChangeJournal::Clear()
+{
+    CellEdits.clear();
+    InsertedRows.clear();
+    DeletedRows.clear();
+    NextInsertId = 0;
+}
+
+/**
+ * @brief Check if any change was recorded
+ */
+bool ChangeJournal::IsEmpty() const
+{
+    return CellEdits.isEmpty() && InsertedRows.isEmpty() && DeletedRows.isEmpty();
+}
+
+/**
+ * @brief Check if any committed cell was edited
+ */
+bool ChangeJournal::HasCellEdits() const
+{
+    return !CellEdits.isEmpty();
+}
+
+/**
+ * @brief Record new text for a cell
+ */
+void ChangeJournal::RecordCellEdit(int rowReference, int column, const QString &value)
+{
+    if (column < 0) {
+        return;
+    }
+
+    if (IsInsertedRow(rowReference)) {
+        // Inserted rows hold their values directly
+        auto _iterator = InsertedRows.find(-rowReference - 1);  // Entry of the inserted row
+        if (_iterator != InsertedRows.end() && column < _iterator->size()) {
+            (*_iterator)[column] = value;
+        }
+        return;
+    }
+
+    CellEdits.insert(CellKey(rowReference, column), value);
+}
+
+/**
+ * @brief Look up the pending text of a cell
+ */
+bool ChangeJournal::FindCellValue(int rowReference, int column, QString *value) const
+{
+    if (IsInsertedRow(rowReference)) {
+        auto _iterator = InsertedRows.constFind(-rowReference - 1);  // Entry of the inserted row
+        if (_iterator == InsertedRows.constEnd()) {
+            return false;
+        }
+        *value = column >= 0 && column < _iterator->size() ? _iterator->at(column) : QString();
+        return true;
+    }
+
+    auto _iterator = CellEdits.constFind(CellKey(rowReference, column));  // Entry of the edited cell
+    if (_iterator == CellEdits.constEnd()) {
+        return false;
+    }
+
+    *value = _iterator.value();
+    return true;
+}
+
+/**
+ * @brief Forget the pending text of a committed cell
+ */
+void ChangeJournal::DiscardCellEdit(int rowReference, int column)
+{
+    if (!IsInsertedRow(rowReference)) {
+        CellEdits.remove(CellKey(rowReference, column));
+    }
+}
+
+/**
+ * @brief Record a new empty row appended to the table
+ */
+int ChangeJournal::RecordRowInsert(int columnCount)
+{
+    QStringList _rowData;  // Empty cell values of the new row
+    for (int _col = 0; _col < columnCount; ++_col) {  // Current column index (0-based)
+        _rowData.append(QString());
+    }
+
+    const int _insertId = NextInsertId++;  // Insertion order of the new row
+    InsertedRows.insert(_insertId, _rowData);
+    return -_insertId - 1;
+}
+
+/**
+ * @brief Record deletion of a row
+ */
+void ChangeJournal::RecordRowDelete(int rowReference)
+{
+    if (IsInsertedRow(rowReference)) {
+        // Inserted rows never reached the document, simply forget them
+        InsertedRows.remove(-rowReference - 1);
+        return;
+    }
+
+    DeletedRows.insert(rowReference);
+}
+
+/**
+ * @brief Look up the cell values of an inserted row
+ */
+bool ChangeJournal::FindRowData(int rowReference, QStringList *rowData) const
+{
+    if (!IsInsertedRow(rowReference)) {
+        return false;
+    }
+
+    auto _iterator = InsertedRows.constFind(-rowReference - 1);  // Entry of the inserted row
+    if (_iterator == InsertedRows.constEnd()) {
+        return false;
+    }
+
+    *rowData = _iterator.value();
+    return true;
+}
+
+/**
+ * @brief Bring back a row that RecordRowInsert or RecordRowDelete took out
+ */
+void ChangeJournal::RestoreRow(int rowReference, const QStringList &rowData)
+{
+    if (!IsInsertedRow(rowReference)) {
+        DeletedRows.remove(rowReference);
+        return;
+    }
+
+    // The insert id keeps its place in insertion order, so the row is saved where it was before
+    const int _insertId = -rowReference - 1;  // Insertion order of the row
+    InsertedRows.insert(_insertId, rowData);
+    NextInsertId = qMax(NextInsertId, _insertId + 1);
+}
+
+/**
+ * @brief Get edits of committed rows that are not deleted, ordered by row
+ */
+QList<ChangeJournal::CellEdit> ChangeJournal::GetCellEdits() const
+{
+    QList<CellEdit> _edits;  // Collected edits of surviving rows
+    _edits.reserve(CellEdits.size());
+
+    for (auto _iterator = CellEdits.constBegin(); _iterator != CellEdits.constEnd(); ++_iterator) {
+        const int _row = int(_iterator.key() >> 32);  // Committed row index of the edit
+        const int _column = int(_iterator.key() & 0xffffffffu);  // Column index of the edit
+        if (!DeletedRows.contains(_row)) {
+            _edits.append(CellEdit{_row, _column, _iterator.value()});
+        }
+    }
+
+    std::sort(_edits.begin(), _edits.end(), [](const CellEdit &left, const CellEdit &right) {
+        return left.Row != right.Row ? left.Row < right.Row : left.Column < right.Column;
+    });
+
+    return _edits;
+}
+
+/**
+ * @brief Get deleted committed rows in ascending order
+ */
+QList<int> ChangeJournal::GetDeletedRows() const
+{
+    QList<int> _rows(DeletedRows.begin(), DeletedRows.end());  // Deleted row indices
+    std::sort(_rows.begin(), _rows.end());
+    return _rows;
+}
+
+/**
+ * @brief Get cell values of inserted rows in insertion order
+ */
+QList<QStringList> ChangeJournal::GetInsertedRows() const
+{
+    return InsertedRows.values();
+}
+
+/**
+ * @brief Check if a row reference addresses an inserted row
+ */
+bool ChangeJournal::IsInsertedRow(int rowReference)
+{
+    return rowReference < 0;
+}
+
+/**
+ * @brief Build hash key for a committed cell
+ */
+quint64 ChangeJournal::CellKey(int row, int column)
+{
+    return (quint64(quint32(row)) << 32) | quint32(column);
+}
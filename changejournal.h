@@ -0,0 +1,141 @@
+#ifndef CHANGEJOURNAL_H
+#define CHANGEJOURNAL_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+/**
+ * @brief Sparse record of pending edits made to one table
+ * Rows are addressed by reference: a committed row index (>= 0) or an inserted
+ * row reference (< 0) returned by RecordRowInsert. Only touched cells are stored,
+ * so the cost of keeping and applying the journal is proportional to the edits
+ */
+class ChangeJournal
+{
+public:
+    /**
+     * @brief Single edited cell of a committed row
+     */
+    struct CellEdit {
+        int Row;                         // Committed row index (0-based)
+        int Column;                      // Column index (0-based)
+        QString Value;                   // New cell text
+    };
+
+    /**
+     * @brief Constructor for ChangeJournal
+     */
+    ChangeJournal();
+
+    /**
+     * @brief Discard all recorded changes
+     */
+    void Clear();
+
+    /**
+     * @brief Check if any change was recorded
+     * @return true if journal holds no changes, false otherwise
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Check if any committed cell was edited
+     * @return true if at least one cell edit is recorded, false otherwise
+     */
+    bool HasCellEdits() const;
+
+    /**
+     * @brief Record new text for a cell
+     * @param rowReference Committed row index or inserted row reference
+     * @param column Column index (0-based)
+     * @param value New cell text
+     */
+    void RecordCellEdit(int rowReference, int column, const QString &value);
+
+    /**
+     * @brief Look up the pending text of a cell
+     * @param rowReference Committed row index or inserted row reference
+     * @param column Column index (0-based)
+     * @param value Receives the pending text if one is recorded
+     * @return true if the cell has pending text, false if the committed value applies
+     */
+    bool FindCellValue(int rowReference, int column, QString *value) const;
+
+    /**
+     * @brief Forget the pending text of a committed cell, so its committed value applies again
+     * @param rowReference Committed row index (inserted rows are ignored, their cells are always pending)
+     * @param column Column index (0-based)
+     */
+    void DiscardCellEdit(int rowReference, int column);
+
+    /**
+     * @brief Record a new empty row appended to the table
+     * @param columnCount Number of cells of the new row
+     * @return Inserted row reference (< 0) used to address the row afterwards
+     */
+    int RecordRowInsert(int columnCount);
+
+    /**
+     * @brief Record deletion of a row
+     * @param rowReference Committed row index or inserted row reference
+     */
+    void RecordRowDelete(int rowReference);
+
+    /**
+     * @brief Look up the cell values of an inserted row
+     * @param rowReference Inserted row reference
+     * @param rowData Receives the cell values if the row exists
+     * @return true if the row is an inserted row that is not deleted, false otherwise
+     */
+    bool FindRowData(int rowReference, QStringList *rowData) const;
+
+    /**
+     * @brief Bring back a row that RecordRowInsert or RecordRowDelete took out, as undo and redo do
+     * A committed row is no longer deleted, an inserted row is inserted again under its old reference
+     * @param rowReference Committed row index or inserted row reference
+     * @param rowData Cell values of an inserted row, ignored for committed rows
+     */
+    void RestoreRow(int rowReference, const QStringList &rowData);
+
+    /**
+     * @brief Get edits of committed rows that are not deleted, ordered by row
+     * @return QList of cell edits
+     */
+    QList<CellEdit> GetCellEdits() const;
+
+    /**
+     * @brief Get deleted committed rows in ascending order
+     * @return QList of row indices
+     */
+    QList<int> GetDeletedRows() const;
+
+    /**
+     * @brief Get cell values of inserted rows in insertion order
+     * @return QList of row data
+     */
+    QList<QStringList> GetInsertedRows() const;
+
+    /**
+     * @brief Check if a row reference addresses an inserted row
+     * @param rowReference Row reference to check
+     * @return true for inserted rows, false for committed rows
+     */
+    static bool IsInsertedRow(int rowReference);
+
+private:
+    /**
+     * @brief Build hash key for a committed cell
+     */
+    static quint64 CellKey(int row, int column);
+
+    QHash<quint64, QString> CellEdits;   // Pending text of committed cells keyed by row and column (empty if none)
+    QMap<int, QStringList> InsertedRows; // Inserted rows keyed by insertion order (empty if none)
+    QSet<int> DeletedRows;               // Deleted committed row indices (empty if none)
+    int NextInsertId;                    // Insertion order assigned to the next inserted row
+};
+
+#endif // CHANGEJOURNAL_H
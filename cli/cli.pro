@@ -0,0 +1,23 @@
+QT += core xml
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = xmltabletool
+TEMPLATE = app
+
+# XML engine (no widget dependencies)
+include(../xmlcore.pri)
+
+# Source files
+SOURCES += \
+    main.cpp \
+    tablecommands.cpp
+
+# Header files
+HEADERS += \
+    tablecommands.h
+
+# Compiler flags for professional development
+QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
@@ -0,0 +1,151 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QHash>
+#include "tablecommands.h"
+#include "xmlworker.h"
+#include "xmlworkspace.h"
+
+static bool VerboseOutput = false;  // Flag indicating debug messages are printed (true) or dropped (false)
+
+/**
+ * @brief Drop worker debug output unless verbose output was requested
+ */
+static void FilterMessages(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    Q_UNUSED(context);
+    if (type == QtDebugMsg && !VerboseOutput) {
+        return;
+    }
+    QTextStream(stderr) << message << '\n';
+}
+
+/**
+ * @brief Command line entry point for headless bulk table operations
+ * @param argc Number of command line arguments
+ * @param argv Array of command line arguments
+ * @return 0 on success, 1 on usage errors, 2 if the command failed
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication _app(argc, argv);  // Application object without GUI
+    _app.setApplicationName("xmltabletool");
+    _app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser _parser;  // Parser for commands and options
+    _parser.setApplicationDescription(
+        "Bulk operations on XML Table Editor files.\n\n"
+        "Commands:\n"
+        "  list <file>                        Print all table names\n"
+        "  export <file> <table>              Write a table as CSV (TSV for .tsv outputs)\n"
+        "  import <file> <table> <rows.csv>   Append rows of a CSV or TSV file with a header line and save\n"
+        "  apply <file> <table> <edits.csv>   Apply row,column,value cell edits and save\n"
+        "  merge <file> <target> <source>     Append source rows to target by column name and save\n"
+        "  diff <file> <table> <other>        Write the rows of a table that differ in another file as CSV");
+    _parser.addHelpOption();
+    _parser.addVersionOption();
+    _parser.addPositionalArgument("command", "list, export, import, apply, merge or diff");
+    _parser.addPositionalArgument("file", "XML file to work on");
+
+    QCommandLineOption _outputOption({"o", "output"}, "Write the result to <path> instead of standard output (export, diff) or the input file (import, apply, merge).", "path");
+    QCommandLineOption _modeOption("mode", "Load strategy: lazy (default), parallel, streaming or dom.", "mode", "lazy");
+    QCommandLineOption _verboseOption({"v", "verbose"}, "Print worker diagnostics.");
+    QCommandLineOption _traceOption("trace", "Record stage timings and write them to <path> as Chrome trace JSON.", "path");
+    QCommandLineOption _noCacheOption("no-cache", "Neither read nor write the binary sidecar (<file>.xtcache) of the streaming and parallel modes.");
+    QCommandLineOption _keyOption("key", "Match rows of both files by <column> (diff only, default: match whole rows).", "column");
+    QCommandLineOption _replaceOption("replace", "Replace all rows of the table instead of appending (import only).");
+    QCommandLineOption _delimiterOption("delimiter", "Field separator of CSV/TSV files: comma, tab, semicolon or a single character (default: tab for .tsv and .tab files, comma otherwise).", "separator");
+    _parser.addOption(_outputOption);
+    _parser.addOption(_modeOption);
+    _parser.addOption(_verboseOption);
+    _parser.addOption(_traceOption);
+    _parser.addOption(_noCacheOption);
+    _parser.addOption(_keyOption);
+    _parser.addOption(_replaceOption);
+    _parser.addOption(_delimiterOption);
+    _parser.process(_app);
+
+    VerboseOutput = _parser.isSet(_verboseOption);
+    qInstallMessageHandler(FilterMessages);
+
+    const QStringList _arguments = _parser.positionalArguments();  // Command, file and command arguments
+    const QString _command = _arguments.value(0);                   // Requested command
+    const QHash<QString, int> _argumentCounts = {{"list", 2}, {"export", 3}, {"import", 4}, {"apply", 4}, {"merge", 4}, {"diff", 4}};  // Positional arguments per command
+
+    if (!_argumentCounts.contains(_command) || _arguments.size() != _argumentCounts.value(_command)) {
+        QTextStream(stderr) << _parser.helpText();
+        return 1;
+    }
+
+    const QString _delimiterName = _parser.value(_delimiterOption);  // Requested field separator (empty to choose by file extension)
+    const QHash<QString, QChar> _delimiterNames = {{"comma", ','}, {"tab", '\t'}, {"semicolon", ';'}};  // Separators given by name
+    QChar _delimiter;  // Field separator of delimited files (null to choose by file extension)
+    if (_delimiterNames.contains(_delimiterName)) {
+        _delimiter = _delimiterNames.value(_delimiterName);
+    } else if (_delimiterName.size() == 1 && _delimiterName != "\"" && _delimiterName != "\n") {
+        _delimiter = _delimiterName.at(0);
+    } else if (!_delimiterName.isEmpty()) {
+        QTextStream(stderr) << "Unknown delimiter: " << _delimiterName << '\n';
+        return 1;
+    }
+
+    const QString _tracePath = _parser.value(_traceOption);  // Trace file (empty if timings are not recorded)
+    XMLProfiler::SetEnabled(!_tracePath.isEmpty());
+
+    const QString _mode = _parser.value(_modeOption);  // Requested load strategy
+    XMLWorkspace _workspace;  // Files of the command, the first one is worked on
+    if (_mode == "dom") {
+        _workspace.SetLoadMode(XMLWorker::DomLoadMode);
+    } else if (_mode == "streaming") {
+        _workspace.SetLoadMode(XMLWorker::StreamingLoadMode);
+    } else if (_mode == "lazy") {
+        _workspace.SetLoadMode(XMLWorker::LazyLoadMode);
+    } else if (_mode == "parallel") {
+        _workspace.SetLoadMode(XMLWorker::ParallelLoadMode);
+    } else {
+        QTextStream(stderr) << "Unknown load mode: " << _mode << '\n';
+        return 1;
+    }
+    _workspace.SetSidecarCacheEnabled(!_parser.isSet(_noCacheOption));
+
+    // Both files of a diff are loaded concurrently and share one string pool
+    const QStringList _filePaths = _command == "diff" ? QStringList({_arguments.at(1), _arguments.at(3)}) : QStringList(_arguments.at(1));  // Files to load
+    _workspace.OpenFiles(_filePaths);
+    for (const QString &_filePath : _filePaths) {  // File the command needs
+        if (_workspace.FindFile(_filePath) < 0) {
+            QTextStream(stderr) << "Failed to load " << _filePath << '\n';
+            return 2;
+        }
+    }
+
+    TableCommands _commands(_workspace.GetWorker(_workspace.FindFile(_filePaths.first())));  // Command implementations
+    _commands.SetDelimiter(_delimiter);
+    const QString _outputPath = _parser.value(_outputOption);  // Output path (empty for default target)
+    bool _success = false;  // Result of the command
+
+    if (_command == "list") {
+        _success = _commands.ListTables();
+    } else if (_command == "export") {
+        _success = _commands.ExportTable(_arguments.at(2), _outputPath);
+    } else if (_command == "import") {
+        _success = _commands.ImportRows(_arguments.at(2), _arguments.at(3), _parser.isSet(_replaceOption), _outputPath);
+    } else if (_command == "apply") {
+        _success = _commands.ApplyEdits(_arguments.at(2), _arguments.at(3), _outputPath);
+    } else if (_command == "merge") {
+        _success = _commands.MergeTables(_arguments.at(2), _arguments.at(3), _outputPath);
+    } else {
+        _success = _commands.DiffTables(_arguments.at(2), _workspace.GetWorker(_workspace.FindFile(_filePaths.last())), _parser.value(_keyOption), _outputPath);
+    }
+
+    if (!_tracePath.isEmpty()) {
+        QTextStream(stderr) << XMLProfiler::GetReport() << '\n';
+        XMLProfiler::ExportChromeTrace(_tracePath);
+    }
+
+    if (!_success) {
+        QTextStream(stderr) << _commands.GetErrorString() << '\n';
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include "tablecommands.h"
+#include <QFile>
+#include <QTextStream>
+
+/**
+ * @brief Constructor stores the worker used by all commands
+ */
+TableCommands::TableCommands(XMLWorker *worker)
+    : Worker(worker)                   // Worker with loaded document
+    , Delimiter()                      // Chosen by file extension
+    , ErrorString()                    // Last error
+{
+}
+
+/**
+ * @brief Set the field separator of all delimited files read or written
+ */
+void TableCommands::SetDelimiter(QChar delimiter)
+{
+    Delimiter = delimiter;
+}
+
+/**
+ * @brief Print the names of all tables, one per line
+ */
+bool TableCommands::ListTables()
+{
+    QTextStream _output(stdout);  // Standard output stream
+    for (const QString &_tableName : Worker->GetTableNames()) {
+        _output << _tableName << '\n';
+    }
+    return true;
+}
+
+/**
+ * @brief Write a table as CSV or TSV with a header line of column names
+ */
+bool TableCommands::ExportTable(const QString &tableName, const QString &outputPath)
+{
+    ErrorString.clear();
+
+    TableData _table;  // Table being exported
+    if (!Worker->GetTable(tableName, &_table)) {
+        ErrorString = QString("Table '%1' not found").arg(tableName);
+        return false;
+    }
+
+    return WriteDelimited(_table, outputPath);
+}
+
+/**
+ * @brief Apply cell edits read from a CSV file and save the document
+ */
+bool TableCommands::ApplyEdits(const QString &tableName, const QString &editsPath, const QString &outputPath)
+{
+    ErrorString.clear();
+
+    TableData _table;  // Table being edited, used to validate positions
+    if (!Worker->GetTable(tableName, &_table)) {
+        ErrorString = QString("Table '%1' not found").arg(tableName);
+        return false;
+    }
+
+    const QStringList _columnHeaders = _table.GetColumnHeaders();  // Column names for name lookup
+    ChangeJournal _journal;  // Edits collected before they are applied at once
+    int _recordNumber = 0;   // Number of the current edit record (1-based)
+
+    DelimitedFile _editsFile(GetDelimiter(editsPath));  // Reader of the edit records
+    const bool _read = _editsFile.ReadRecords(editsPath, [&](const QList<QStringList> &records) {  // Flag indicating all edits were read
+        for (const QStringList &_record : records) {  // Current edit record
+            ++_recordNumber;
+
+            bool _rowValid = false;  // Flag indicating the row field is a number
+            const int _row = _record.value(0).trimmed().toInt(&_rowValid);  // Row index of the edit
+            if (!_rowValid && _recordNumber == 1) {
+                continue;  // Header line
+            }
+
+            if (!_rowValid || _record.size() < 3 || _row < 0 || _row >= _table.GetRowCount()) {
+                ErrorString = QString("Invalid row in edit record %1").arg(_recordNumber);
+                return false;
+            }
+
+            const QString _columnField = _record.at(1).trimmed();  // Column name or index
+            int _column = _columnHeaders.indexOf(_columnField);    // Column index of the edit (-1 if unknown)
+            if (_column < 0) {
+                bool _columnValid = false;  // Flag indicating the column field is a number
+                _column = _columnField.toInt(&_columnValid);
+                if (!_columnValid || _column < 0 || _column >= _table.GetColumnCount()) {
+                    ErrorString = QString("Unknown column '%1' in edit record %2").arg(_columnField).arg(_recordNumber);
+                    return false;
+                }
+            }
+
+            _journal.RecordCellEdit(_row, _column, _record.at(2));
+        }
+        return true;
+    });
+
+    if (!_read) {
+        if (ErrorString.isEmpty()) {
+            ErrorString = _editsFile.GetErrorString();
+        }
+        return false;
+    }
+
+    if (!Worker->ApplyTableChanges(tableName, _journal)) {
+        ErrorString = QString("Failed to apply edits to table '%1'").arg(tableName);
+        return false;
+    }
+
+    return Save(outputPath);
+}
+
+/**
+ * @brief Read rows from a CSV or TSV file into a table and save the document
+ */
+bool TableCommands::ImportRows(const QString &tableName, const QString &inputPath, bool replaceRows, const QString &outputPath)
+{
+    ErrorString.clear();
+
+    DelimitedFile _inputFile(GetDelimiter(inputPath));  // Reader of the imported rows
+    if (!_inputFile.ImportTable(Worker, tableName, inputPath, replaceRows ? DelimitedFile::ReplaceRows : DelimitedFile::AppendRows)) {
+        ErrorString = _inputFile.GetErrorString();
+        return false;
+    }
+
+    QTextStream(stderr) << _inputFile.GetRecordCount() << " rows imported\n";
+    return Save(outputPath);
+}
+
+/**
+ * @brief Append all rows of one table to another and save the document
+ */
+bool TableCommands::MergeTables(const QString &targetTableName, const QString &sourceTableName, const QString &outputPath)
+{
+    ErrorString.clear();
+
+    TableData _targetTable;  // Table receiving the rows
+    TableData _sourceTable;  // Table providing the rows
+    if (!Worker->GetTable(targetTableName, &_targetTable) || !Worker->GetTable(sourceTableName, &_sourceTable)) {
+        ErrorString = QString("Tables '%1' and '%2' must both exist").arg(targetTableName, sourceTableName);
+        return false;
+    }
+
+    const QStringList _targetHeaders = _targetTable.GetColumnHeaders();  // Column layout of the merged rows
+    const QStringList _sourceHeaders = _sourceTable.GetColumnHeaders();  // Column layout of the source rows
+    if (_targetHeaders.isEmpty()) {
+        ErrorString = QString("Table '%1' has no columns").arg(targetTableName);
+        return false;
+    }
+
+    // Source column of every target column (-1 if the source does not have it)
+    QList<int> _sourceColumns;  // Source column index per target column
+    for (const QString &_header : _targetHeaders) {
+        _sourceColumns.append(_sourceHeaders.indexOf(_header));
+    }
+
+    // Appended rows go through the journal, so only the new rows are written to the document
+    ChangeJournal _journal;  // Rows to append
+    for (int _row = 0; _row < _sourceTable.GetRowCount(); ++_row) {  // Current source row index (0-based)
+        const int _rowReference = _journal.RecordRowInsert(_targetHeaders.size());  // Journal reference of the new row
+        for (int _col = 0; _col < _sourceColumns.size(); ++_col) {  // Current target column index (0-based)
+            if (_sourceColumns.at(_col) >= 0) {
+                _journal.RecordCellEdit(_rowReference, _col, _sourceTable.GetCell(_row, _sourceColumns.at(_col)));
+            }
+        }
+    }
+
+    if (!Worker->ApplyTableChanges(targetTableName, _journal)) {
+        ErrorString = QString("Failed to append rows to table '%1'").arg(targetTableName);
+        return false;
+    }
+
+    return Save(outputPath);
+}
+
+/**
+ * @brief Write the differences between a table and the table of the same name in another file as CSV or TSV
+ */
+bool TableCommands::DiffTables(const QString &tableName, XMLWorker *otherWorker, const QString &keyColumnName, const QString &outputPath)
+{
+    ErrorString.clear();
+
+    TableData _leftTable;   // Table of the loaded file
+    TableData _rightTable;  // Table of the other file
+    if (!Worker->GetTable(tableName, &_leftTable)) {
+        ErrorString = QString("Table '%1' not found in '%2'").arg(tableName, Worker->GetCurrentFilePath());
+        return false;
+    }
+    if (!otherWorker->GetTable(tableName, &_rightTable)) {
+        ErrorString = QString("Table '%1' not found in '%2'").arg(tableName, otherWorker->GetCurrentFilePath());
+        return false;
+    }
+
+    TableDiff _diff(_leftTable, _rightTable, keyColumnName);  // Comparison of both versions
+    if (!_diff.Compare()) {
+        ErrorString = QString("Key column '%1' not found in both tables").arg(keyColumnName);
+        return false;
+    }
+
+    QTextStream(stderr) << _diff.GetChangeCount(TableDiff::RemovedRow) << " removed, " << _diff.GetChangeCount(TableDiff::ChangedRow)
+                        << " changed, " << _diff.GetChangeCount(TableDiff::AddedRow) << " added, " << _diff.GetUnchangedRowCount()
+                        << " unchanged rows\n";
+    return WriteDelimited(_diff.CreateResultTable(), outputPath);
+}
+
+/**
+ * @brief Get description of the last error
+ */
+QString TableCommands::GetErrorString() const
+{
+    return ErrorString;
+}
+
+/**
+ * @brief Get the field separator of a delimited file
+ */
+QChar TableCommands::GetDelimiter(const QString &filePath) const
+{
+    return Delimiter.isNull() ? DelimitedFile::GetDefaultDelimiter(filePath) : Delimiter;
+}
+
+/**
+ * @brief Write a table with a header line of column names and record an error on failure
+ */
+bool TableCommands::WriteDelimited(const TableData &table, const QString &outputPath)
+{
+    DelimitedFile _outputFile(GetDelimiter(outputPath));  // Writer of the output
+
+    bool _written = false;  // Result of writing the table
+    if (outputPath.isEmpty()) {
+        QFile _stdout;  // Standard output
+        if (!_stdout.open(stdout, QIODevice::WriteOnly)) {
+            ErrorString = "Cannot write to standard output";
+            return false;
+        }
+        _written = _outputFile.WriteTable(table, &_stdout);
+    } else {
+        _written = _outputFile.WriteFile(table, outputPath);
+    }
+
+    if (!_written) {
+        ErrorString = _outputFile.GetErrorString();
+    }
+    return _written;
+}
+
+/**
+ * @brief Save the document and record an error on failure
+ */
+bool TableCommands::Save(const QString &outputPath)
+{
+    if (!Worker->SaveXMLFile(outputPath)) {
+        ErrorString = QString("Failed to save '%1'").arg(outputPath.isEmpty() ? Worker->GetCurrentFilePath() : outputPath);
+        return false;
+    }
+    return true;
+}
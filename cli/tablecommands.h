@@ -0,0 +1,119 @@
+#ifndef TABLECOMMANDS_H
+#define TABLECOMMANDS_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include "xmlworker.h"
+#include "tablediff.h"
+#include "delimitedfile.h"
+
+/**
+ * @brief Bulk table operations of the command line tool
+ * Each command works on the file loaded by the worker; commands that modify
+ * tables save the result, either in place or to a separate output file.
+ * Delimited files are read and written by DelimitedFile, as CSV or TSV
+ * depending on the file extension unless a delimiter is set
+ */
+class TableCommands
+{
+public:
+    /**
+     * @brief Constructor for TableCommands
+     * @param worker Worker with the file already loaded (not owned)
+     */
+    explicit TableCommands(XMLWorker *worker);
+
+    /**
+     * @brief Set the field separator of all delimited files read or written
+     * @param delimiter Field separator, or a null QChar to choose it by file extension (default)
+     */
+    void SetDelimiter(QChar delimiter);
+
+    /**
+     * @brief Print the names of all tables, one per line
+     * @return true on success, false otherwise
+     */
+    bool ListTables();
+
+    /**
+     * @brief Write a table as CSV or TSV with a header line of column names
+     * @param tableName Name of the table to export
+     * @param outputPath Delimited file to write (empty for CSV on standard output)
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool ExportTable(const QString &tableName, const QString &outputPath);
+
+    /**
+     * @brief Apply cell edits read from a CSV file and save the document
+     * Every record holds "row,column,value": a 0-based row index, a column name
+     * or 0-based column index, and the new cell text. A first record whose row
+     * field is not a number is treated as a header line and skipped
+     * @param tableName Name of the table to edit
+     * @param editsPath CSV file with the edits
+     * @param outputPath XML file to write (empty to overwrite the loaded file)
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool ApplyEdits(const QString &tableName, const QString &editsPath, const QString &outputPath);
+
+    /**
+     * @brief Read rows from a CSV or TSV file into a table and save the document
+     * The first line names the columns, which are matched to the table columns by
+     * name (see DelimitedFile::ImportTable)
+     * @param tableName Name of the table receiving the rows
+     * @param inputPath Delimited file with a header line
+     * @param replaceRows true to replace all rows of the table, false to append the rows
+     * @param outputPath XML file to write (empty to overwrite the loaded file)
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool ImportRows(const QString &tableName, const QString &inputPath, bool replaceRows, const QString &outputPath);
+
+    /**
+     * @brief Append all rows of one table to another and save the document
+     * Cells are matched by column name; source columns missing in the target are dropped
+     * @param targetTableName Table receiving the rows
+     * @param sourceTableName Table providing the rows (left unchanged)
+     * @param outputPath XML file to write (empty to overwrite the loaded file)
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool MergeTables(const QString &targetTableName, const QString &sourceTableName, const QString &outputPath);
+
+    /**
+     * @brief Write the differences between a table and the table of the same name in another file as CSV or TSV
+     * The first column names the change ("removed", "changed" or "added"), see TableDiff
+     * @param tableName Name of the table in both files
+     * @param otherWorker Worker holding the newer file (not owned)
+     * @param keyColumnName Column identifying rows in both files (empty to match whole rows)
+     * @param outputPath Delimited file to write (empty for CSV on standard output)
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool DiffTables(const QString &tableName, XMLWorker *otherWorker, const QString &keyColumnName, const QString &outputPath);
+
+    /**
+     * @brief Get description of the last error
+     * @return QString containing the error, empty if the last command succeeded
+     */
+    QString GetErrorString() const;
+
+private:
+    /**
+     * @brief Get the field separator of a delimited file
+     */
+    QChar GetDelimiter(const QString &filePath) const;
+
+    /**
+     * @brief Write a table with a header line of column names and record an error on failure
+     */
+    bool WriteDelimited(const TableData &table, const QString &outputPath);
+
+    /**
+     * @brief Save the document and record an error on failure
+     */
+    bool Save(const QString &outputPath);
+
+    XMLWorker *Worker;                   // Worker holding the loaded document (not owned)
+    QChar Delimiter;                     // Field separator of delimited files (null to choose by file extension)
+    QString ErrorString;                 // Description of the last error (empty if successful)
+};
+
+#endif // TABLECOMMANDS_H
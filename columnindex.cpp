@@ -0,0 +1,341 @@
+#include "columnindex.h"
+#include "xmlprofiler.h"
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Constructor prepares an index with nothing built yet
+ */
+ColumnIndex::ColumnIndex(int column)
+    : Column(column)                   // Indexed column
+    , EqualityIndexBuilt(false)        // Hash index not built
+    , ValueGroups()                    // Distinct values
+    , GroupStarts()                    // Group offsets
+    , GroupedRows()                    // Rows by group
+    , SortedIndexBuilt(false)          // Sorted index not built
+    , SortedRows()                     // Rows by text
+    , TypedTexts()                     // Text of typed cells
+    , NumericIndexBuilt(false)         // Numeric index not built
+    , NumericValues()                  // Sorted numbers
+    , NumericRows()                    // Rows by number
+{
+}
+
+/**
+ * @brief Run a query against the column
+ */
+QVector<int> ColumnIndex::Find(const TableData &table, QueryType type, const QString &value, const QString &upperValue)
+{
+    if (Column < 0 || Column >= table.GetColumnCount()) {
+        return QVector<int>();
+    }
+
+    switch (type) {
+    case EqualQuery:
+        return FindEqual(table, value);
+    case PrefixQuery:
+        return FindPrefix(table, value);
+    case RangeQuery:
+        break;
+    }
+
+    double _lower = 0.0;  // Parsed lower bound (unused)
+    double _upper = 0.0;  // Parsed upper bound (unused)
+    if (value.isEmpty() && upperValue.isEmpty()) {
+        QVector<int> _allRows(table.GetRowCount());  // Every row matches an unbounded range
+        std::iota(_allRows.begin(), _allRows.end(), 0);
+        return _allRows;
+    }
+    if (ParseNumericBound(value, &_lower) && ParseNumericBound(upperValue, &_upper)) {
+        return FindNumericRange(table, value, upperValue);
+    }
+    return FindTextRange(table, value, upperValue);
+}
+
+/**
+ * @brief Check a single value against a query, as Find would
+ */
+bool ColumnIndex::Matches(QueryType type, QStringView cellText, const QString &value, const QString &upperValue)
+{
+    switch (type) {
+    case EqualQuery:
+        return cellText == value;
+    case PrefixQuery:
+        return cellText.startsWith(value);
+    case RangeQuery:
+        break;
+    }
+
+    double _lower = 0.0;  // Parsed lower bound
+    double _upper = 0.0;  // Parsed upper bound
+    if (value.isEmpty() && upperValue.isEmpty()) {
+        return true;
+    }
+    if (ParseNumericBound(value, &_lower) && ParseNumericBound(upperValue, &_upper)) {
+        bool _isNumber = false;  // Flag indicating the cell holds a number (true) or text (false)
+        const double _cellValue = cellText.trimmed().toDouble(&_isNumber);  // Numeric value of the cell
+        return _isNumber && (value.isEmpty() || _cellValue >= _lower) && (upperValue.isEmpty() || _cellValue <= _upper);
+    }
+
+    return (value.isEmpty() || cellText.compare(value) >= 0) && (upperValue.isEmpty() || cellText.compare(upperValue) <= 0);
+}
+
+/**
+ * @brief Get rows whose cell text equals a value
+ */
+QVector<int> ColumnIndex::FindEqual(const TableData &table, const QString &value)
+{
+    if (table.GetColumnType(Column) != TableData::TextColumn) {
+        return FindTypedEqual(table, value);
+    }
+
+    BuildEqualityIndex(table);
+
+    auto _iterator = ValueGroups.constFind(QStringView(value));  // Group of the value (end if no row holds it)
+    if (_iterator == ValueGroups.constEnd()) {
+        return QVector<int>();
+    }
+
+    const int _group = _iterator.value();  // Group holding the matching rows
+    return GroupedRows.mid(GroupStarts.at(_group), GroupStarts.at(_group + 1) - GroupStarts.at(_group));
+}
+
+/**
+ * @brief Get rows of a typed column whose cell text equals a value, by native value
+ */
+QVector<int> ColumnIndex::FindTypedEqual(const TableData &table, const QString &value)
+{
+    // Native values only have their canonical text, any other text can only equal an empty or outlier cell
+    qint64 _target = 0;  // Native value of the query
+    const bool _targetTyped = table.ParseTypedValue(Column, value, &_target);  // Flag indicating the query is a native value (true) or text (false)
+
+    QVector<int> _rows;  // Matching rows
+    for (int _row = 0; _row < table.GetRowCount(); ++_row) {  // Current row index (0-based)
+        qint64 _cellValue = 0;  // Native value of the cell
+        const bool _cellTyped = table.GetTypedValue(_row, Column, &_cellValue);  // Flag indicating the cell holds a native value (true) or text (false)
+        if (_targetTyped ? _cellTyped && _cellValue == _target : !_cellTyped && table.GetCellView(_row, Column) == value) {
+            _rows.append(_row);
+        }
+    }
+    return _rows;
+}
+
+/**
+ * @brief Get rows whose cell text starts with a prefix
+ */
+QVector<int> ColumnIndex::FindPrefix(const TableData &table, const QString &prefix)
+{
+    BuildSortedIndex(table);
+
+    // Every value starting with the prefix sorts at or after the prefix itself
+    auto _first = std::lower_bound(SortedRows.cbegin(), SortedRows.cend(), prefix, [&table, this](int row, const QString &bound) {
+        return GetSortText(table, row).compare(bound) < 0;
+    });  // First row not sorting before the prefix
+
+    QVector<int> _rows;  // Matching rows
+    for (auto _iterator = _first; _iterator != SortedRows.cend(); ++_iterator) {  // Candidate row in text order
+        if (!GetSortText(table, *_iterator).startsWith(prefix)) {
+            break;
+        }
+        _rows.append(*_iterator);
+    }
+
+    std::sort(_rows.begin(), _rows.end());
+    return _rows;
+}
+
+/**
+ * @brief Get rows whose cell text lies between two bounds in lexicographic order
+ */
+QVector<int> ColumnIndex::FindTextRange(const TableData &table, const QString &lowerValue, const QString &upperValue)
+{
+    BuildSortedIndex(table);
+
+    auto _first = SortedRows.cbegin();  // First row not below the lower bound
+    if (!lowerValue.isEmpty()) {
+        _first = std::lower_bound(SortedRows.cbegin(), SortedRows.cend(), lowerValue, [&table, this](int row, const QString &bound) {
+            return GetSortText(table, row).compare(bound) < 0;
+        });
+    }
+
+    auto _last = SortedRows.cend();  // First row above the upper bound
+    if (!upperValue.isEmpty()) {
+        _last = std::upper_bound(_first, SortedRows.cend(), upperValue, [&table, this](const QString &bound, int row) {
+            return GetSortText(table, row).compare(bound) > 0;
+        });
+    }
+
+    QVector<int> _rows(_first, _last);  // Matching rows
+    std::sort(_rows.begin(), _rows.end());
+    return _rows;
+}
+
+/**
+ * @brief Get rows whose numeric cell value lies between two bounds
+ */
+QVector<int> ColumnIndex::FindNumericRange(const TableData &table, const QString &lowerValue, const QString &upperValue)
+{
+    BuildNumericIndex(table);
+
+    double _lower = 0.0;  // Parsed lower bound
+    double _upper = 0.0;  // Parsed upper bound
+    ParseNumericBound(lowerValue, &_lower);
+    ParseNumericBound(upperValue, &_upper);
+
+    const int _first = lowerValue.isEmpty() ? 0
+        : int(std::lower_bound(NumericValues.cbegin(), NumericValues.cend(), _lower) - NumericValues.cbegin());  // First entry not below the lower bound
+    const int _last = upperValue.isEmpty() ? NumericValues.size()
+        : int(std::upper_bound(NumericValues.cbegin(), NumericValues.cend(), _upper) - NumericValues.cbegin());  // First entry above the upper bound
+
+    if (_first >= _last) {
+        return QVector<int>();
+    }
+
+    QVector<int> _rows = NumericRows.mid(_first, _last - _first);  // Matching rows
+    std::sort(_rows.begin(), _rows.end());
+    return _rows;
+}
+
+/**
+ * @brief Build the hash from cell value to its rows
+ */
+void ColumnIndex::BuildEqualityIndex(const TableData &table)
+{
+    if (EqualityIndexBuilt) {
+        return;
+    }
+
+    XML_PROFILE_SCOPE("Build index");
+
+    const int _rowCount = table.GetRowCount();  // Number of rows to index
+    QVector<int> _rowGroups(_rowCount);  // Group of each row
+    QVector<int> _groupSizes;            // Number of rows in each group
+
+    // Group rows by value first, then lay the groups out in one array instead of one list per value
+    for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+        const QStringView _value = table.GetCellView(_row, Column);  // Cell text, stays valid while the table is unchanged
+        auto _iterator = ValueGroups.constFind(_value);  // Existing group of the value (end if new)
+        if (_iterator == ValueGroups.constEnd()) {
+            _iterator = ValueGroups.insert(_value, _groupSizes.size());
+            _groupSizes.append(0);
+        }
+        _rowGroups[_row] = _iterator.value();
+        _groupSizes[_iterator.value()]++;
+    }
+
+    GroupStarts.resize(_groupSizes.size() + 1);
+    GroupStarts[0] = 0;
+    for (int _group = 0; _group < _groupSizes.size(); ++_group) {  // Current group
+        GroupStarts[_group + 1] = GroupStarts.at(_group) + _groupSizes.at(_group);
+    }
+
+    // Rows are placed in ascending order, so each group is already sorted
+    QVector<int> _nextSlot(GroupStarts.cbegin(), GroupStarts.cend() - 1);  // Next free position of each group
+    GroupedRows.resize(_rowCount);
+    for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+        GroupedRows[_nextSlot[_rowGroups.at(_row)]++] = _row;
+    }
+
+    EqualityIndexBuilt = true;
+}
+
+/**
+ * @brief Build the rows sorted by cell text
+ */
+void ColumnIndex::BuildSortedIndex(const TableData &table)
+{
+    if (SortedIndexBuilt) {
+        return;
+    }
+
+    XML_PROFILE_SCOPE("Build index");
+
+    const int _rowCount = table.GetRowCount();  // Number of rows to index
+    if (table.GetColumnType(Column) != TableData::TextColumn) {
+        // Native values have no stored text, text order needs them formatted once
+        TypedTexts.resize(_rowCount);
+        for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+            TypedTexts[_row] = table.GetCell(_row, Column);
+        }
+    }
+
+    QVector<QStringView> _values(_rowCount);  // Cell text of every row, fetched once for the sort
+    for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+        _values[_row] = GetSortText(table, _row);
+    }
+
+    SortedRows.resize(_rowCount);
+    std::iota(SortedRows.begin(), SortedRows.end(), 0);
+    std::sort(SortedRows.begin(), SortedRows.end(), [&_values](int left, int right) {
+        return _values.at(left).compare(_values.at(right)) < 0;
+    });
+
+    SortedIndexBuilt = true;
+}
+
+/**
+ * @brief Build the rows with a numeric cell sorted by value
+ */
+void ColumnIndex::BuildNumericIndex(const TableData &table)
+{
+    if (NumericIndexBuilt) {
+        return;
+    }
+
+    XML_PROFILE_SCOPE("Build index");
+
+    const int _rowCount = table.GetRowCount();  // Number of rows to index
+    QVector<double> _values;  // Numeric value of each numeric row, in row order
+    QVector<int> _order;      // Position in _values, sorted by value
+
+    for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+        // Native integers and decimals are used as they are, text cells (outliers included) are parsed
+        double _value = 0.0;  // Numeric cell value
+        bool _isNumber = table.GetNumericValue(_row, Column, &_value);  // Flag indicating the cell holds a number (true) or text (false)
+        qint64 _typedValue = 0;  // Native date or bool value (unused)
+        if (!_isNumber && !table.GetTypedValue(_row, Column, &_typedValue)) {
+            _value = table.GetCellView(_row, Column).trimmed().toDouble(&_isNumber);
+        }
+        if (_isNumber) {
+            NumericRows.append(_row);
+            _values.append(_value);
+        }
+    }
+
+    _order.resize(_values.size());
+    std::iota(_order.begin(), _order.end(), 0);
+    std::sort(_order.begin(), _order.end(), [&_values](int left, int right) {
+        return _values.at(left) < _values.at(right);
+    });
+
+    const QVector<int> _rowsInRowOrder = NumericRows;  // Numeric rows before sorting
+    NumericValues.resize(_order.size());
+    for (int _i = 0; _i < _order.size(); ++_i) {  // Position in value order
+        NumericValues[_i] = _values.at(_order.at(_i));
+        NumericRows[_i] = _rowsInRowOrder.at(_order.at(_i));
+    }
+
+    NumericIndexBuilt = true;
+}
+
+/**
+ * @brief Get the text of a row as the sorted index compares it
+ */
+QStringView ColumnIndex::GetSortText(const TableData &table, int row) const
+{
+    return TypedTexts.isEmpty() ? table.GetCellView(row, Column) : QStringView(TypedTexts.at(row));
+}
+
+/**
+ * @brief Parse a range bound as a number
+ */
+bool ColumnIndex::ParseNumericBound(const QString &bound, double *number)
+{
+    if (bound.isEmpty()) {
+        return true;
+    }
+
+    bool _isNumber = false;  // Flag indicating the bound is a number (true) or text (false)
+    *number = QStringView(bound).trimmed().toDouble(&_isNumber);
+    return _isNumber;
+}
@@ -0,0 +1,123 @@
+#ifndef COLUMNINDEX_H
+#define COLUMNINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include "tablestore.h"
+
+/**
+ * @brief Lazily built search indexes over one column of a TableData
+ * Equality queries use a hash from cell value to its rows, prefix and text
+ * range queries use the rows sorted by value, and range queries whose bounds
+ * are numbers use the rows sorted by numeric value. Each index is only built
+ * by the first query that needs it. Keys are views into the table storage,
+ * so an index is only valid for the unmodified table it was built on. Equality
+ * and numeric queries on typed columns compare the native values directly; text
+ * order on a typed column needs the formatted text, which the index then keeps
+ */
+class ColumnIndex
+{
+public:
+    /**
+     * @brief Kind of query run against a column
+     */
+    enum QueryType {
+        EqualQuery,                      // Cell text equals the value
+        PrefixQuery,                     // Cell text starts with the value
+        RangeQuery                       // Cell value lies between two inclusive bounds (an empty bound is open)
+    };
+
+    /**
+     * @brief Constructor for ColumnIndex
+     * @param column Column index (0-based) the indexes are built for
+     */
+    explicit ColumnIndex(int column);
+
+    /**
+     * @brief Run a query against the column
+     * @param table Table the index belongs to (must be the same unmodified table on every call)
+     * @param type Kind of query
+     * @param value Value to compare with, lower bound for range queries
+     * @param upperValue Upper bound for range queries, ignored otherwise
+     * @return Matching row indices in ascending order
+     */
+    QVector<int> Find(const TableData &table, QueryType type, const QString &value, const QString &upperValue = QString());
+
+    /**
+     * @brief Check a single value against a query, as Find would
+     * @param type Kind of query
+     * @param cellText Text of the cell to check
+     * @param value Value to compare with, lower bound for range queries
+     * @param upperValue Upper bound for range queries, ignored otherwise
+     * @return true if the cell matches, false otherwise
+     */
+    static bool Matches(QueryType type, QStringView cellText, const QString &value, const QString &upperValue = QString());
+
+private:
+    /**
+     * @brief Get rows whose cell text equals a value
+     */
+    QVector<int> FindEqual(const TableData &table, const QString &value);
+
+    /**
+     * @brief Get rows of a typed column whose cell text equals a value, by native value
+     */
+    QVector<int> FindTypedEqual(const TableData &table, const QString &value);
+
+    /**
+     * @brief Get rows whose cell text starts with a prefix
+     */
+    QVector<int> FindPrefix(const TableData &table, const QString &prefix);
+
+    /**
+     * @brief Get rows whose cell text lies between two bounds in lexicographic order
+     */
+    QVector<int> FindTextRange(const TableData &table, const QString &lowerValue, const QString &upperValue);
+
+    /**
+     * @brief Get rows whose numeric cell value lies between two bounds
+     */
+    QVector<int> FindNumericRange(const TableData &table, const QString &lowerValue, const QString &upperValue);
+
+    /**
+     * @brief Build the hash from cell value to its rows
+     */
+    void BuildEqualityIndex(const TableData &table);
+
+    /**
+     * @brief Build the rows sorted by cell text
+     */
+    void BuildSortedIndex(const TableData &table);
+
+    /**
+     * @brief Build the rows with a numeric cell sorted by value
+     */
+    void BuildNumericIndex(const TableData &table);
+
+    /**
+     * @brief Get the text of a row as the sorted index compares it
+     */
+    QStringView GetSortText(const TableData &table, int row) const;
+
+    /**
+     * @brief Parse a range bound as a number
+     * @return true if the bound is empty (open) or a number, false otherwise
+     */
+    static bool ParseNumericBound(const QString &bound, double *number);
+
+    int Column;                          // Indexed column (0-based)
+    bool EqualityIndexBuilt;             // Flag indicating ValueGroups is filled (true) or not built yet (false)
+    QHash<QStringView, int> ValueGroups; // Distinct cell value to its group in GroupStarts
+    QVector<int> GroupStarts;            // Offset of each group in GroupedRows, plus a final end offset
+    QVector<int> GroupedRows;            // Rows ordered by group, ascending within a group
+    bool SortedIndexBuilt;               // Flag indicating SortedRows is filled (true) or not built yet (false)
+    QVector<int> SortedRows;             // Rows ordered by cell text
+    QVector<QString> TypedTexts;         // Formatted text of every row of a typed column (empty for text columns)
+    bool NumericIndexBuilt;              // Flag indicating the numeric index is filled (true) or not built yet (false)
+    QVector<double> NumericValues;       // Numeric cell values in ascending order
+    QVector<int> NumericRows;            // Row of each entry in NumericValues
+};
+
+#endif // COLUMNINDEX_H
@@ -0,0 +1,215 @@
+#include "columnsorter.h"
+#include <QAtomicInt>
+#include <QDate>
+#include <QThreadPool>
+#include <QtNumeric>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "xmlprofiler.h"
+
+const int ColumnSorter::MIN_CHUNK_ROWS = 16384;  // Smaller chunks cost more in scheduling than they gain
+
+/**
+ * @brief Row range handled by one pool task
+ */
+struct SortChunk {
+    int Begin;                           // First row of the chunk
+    int Middle;                          // First row of the second half to merge (unused while sorting chunks)
+    int End;                             // Row past the chunk
+};
+
+/**
+ * @brief Constructor captures the column to sort
+ */
+ColumnSorter::ColumnSorter(const TableData &table, int column, const QVector<int> &rowReferences, const QHash<int, QString> &pendingValues)
+    : Table(table)                     // Shared committed table
+    , Column(column)                   // Sorted column
+    , RowReferences(rowReferences)     // View row references
+    , PendingValues(pendingValues)     // Pending displayed values
+    , UsedKeyType(TextKey)             // Nothing sorted yet
+{
+}
+
+/**
+ * @brief Compute the sorted order of the view rows, blocking until done
+ */
+QVector<int> ColumnSorter::Sort(Qt::SortOrder order)
+{
+    XML_PROFILE_SCOPE("Sort column");
+
+    const int _rowCount = RowReferences.size();  // Number of view rows
+    const TableData::ColumnType _columnType = Table.GetColumnType(Column);  // Storage type of the sorted column
+    QVector<QStringView> _values(_rowCount);  // Displayed text of every view row, valid while the sorter lives
+    QVector<qint64> _nativeValues;  // Native value of every view row of a typed column
+    QVector<bool> _isNative;        // Flag per view row indicating _nativeValues applies (true) or _values does (false)
+    if (_columnType != TableData::TextColumn) {
+        _nativeValues.resize(_rowCount);
+        _isNative.fill(false, _rowCount);
+    }
+    for (int _row = 0; _row < _rowCount; ++_row) {  // Current view row (0-based)
+        const int _rowReference = RowReferences.at(_row);  // Committed row index or pending row reference
+        auto _pending = PendingValues.constFind(_rowReference);  // Pending text of the row (end if unchanged)
+        if (_pending != PendingValues.constEnd()) {
+            _values[_row] = _pending.value();
+        } else if (_columnType == TableData::TextColumn || !Table.GetTypedValue(_rowReference, Column, &_nativeValues[_row])) {
+            _values[_row] = Table.GetCellView(_rowReference, Column);
+        } else {
+            _isNative[_row] = true;
+        }
+    }
+
+    QVector<int> _rows(_rowCount);  // View rows, sorted in place
+    std::iota(_rows.begin(), _rows.end(), 0);
+    const bool _descending = order == Qt::DescendingOrder;  // Flag indicating largest values come first (true) or last (false)
+    const double _decimalFactor = std::pow(10.0, Table.GetDecimalScale(Column));  // Divisor of native decimals (1 otherwise)
+
+    // Typed keys are tried first, native values of the matching column type are used as they are;
+    // empty cells take the smallest key so they never decide the type
+    QVector<double> _numbers;  // Parsed number of every view row
+    QVector<qint64> _days;     // Parsed day of every view row
+    if (ExtractKeys(_rowCount, [&](int row, double *key) {
+            if (!_isNative.isEmpty() && _isNative.at(row)) {
+                *key = double(_nativeValues.at(row)) / _decimalFactor;
+                return _columnType == TableData::IntegerColumn || _columnType == TableData::DecimalColumn;
+            }
+            const QStringView _text = _values.at(row).trimmed();  // Candidate number text
+            if (_text.isEmpty()) {
+                *key = -std::numeric_limits<double>::infinity();
+                return true;
+            }
+            bool _isNumber = false;  // Flag indicating the text is a number (true) or not (false)
+            *key = _text.toDouble(&_isNumber);
+            return _isNumber && !qIsNaN(*key);  // NaN would break the ordering
+        }, &_numbers)) {
+        UsedKeyType = NumericKey;
+        ParallelStableSort(_rows, [&_numbers, _descending](int left, int right) {
+            return _descending ? _numbers.at(right) < _numbers.at(left) : _numbers.at(left) < _numbers.at(right);
+        });
+    } else if (ExtractKeys(_rowCount, [&](int row, qint64 *key) {
+                   if (!_isNative.isEmpty() && _isNative.at(row)) {
+                       *key = _nativeValues.at(row);  // Julian day for date columns
+                       return _columnType == TableData::DateColumn;
+                   }
+                   const QStringView _text = _values.at(row).trimmed();  // Candidate date text
+                   if (_text.isEmpty()) {
+                       *key = std::numeric_limits<qint64>::min();
+                       return true;
+                   }
+                   if (_text.size() != 10 || _text.at(4) != QLatin1Char('-') || _text.at(7) != QLatin1Char('-')) {
+                       return false;
+                   }
+                   const QDate _date = QDate::fromString(_text.toString(), Qt::ISODate);  // Parsed date (invalid if not a date)
+                   *key = _date.toJulianDay();
+                   return _date.isValid();
+               }, &_days)) {
+        UsedKeyType = DateKey;
+        ParallelStableSort(_rows, [&_days, _descending](int left, int right) {
+            return _descending ? _days.at(right) < _days.at(left) : _days.at(left) < _days.at(right);
+        });
+    } else {
+        // Comparing as text needs the text of native values, formatted once per row
+        QVector<QString> _formattedValues(_isNative.isEmpty() ? 0 : _rowCount);  // Text of native values (empty for other rows)
+        for (int _row = 0; _row < _formattedValues.size(); ++_row) {  // Current view row (0-based)
+            if (_isNative.at(_row)) {
+                _formattedValues[_row] = Table.GetCell(RowReferences.at(_row), Column);
+                _values[_row] = _formattedValues.at(_row);
+            }
+        }
+
+        UsedKeyType = TextKey;
+        ParallelStableSort(_rows, [&_values, _descending](int left, int right) {
+            return _descending ? _values.at(right).compare(_values.at(left), Qt::CaseInsensitive) < 0
+                               : _values.at(left).compare(_values.at(right), Qt::CaseInsensitive) < 0;
+        });
+    }
+
+    XML_PROFILE_COUNT("Rows sorted", _rowCount);
+    return _rows;
+}
+
+/**
+ * @brief Get how the values were compared by the last Sort call
+ */
+ColumnSorter::KeyType ColumnSorter::GetKeyType() const
+{
+    return UsedKeyType;
+}
+
+/**
+ * @brief Compute the key of every view row on the thread pool
+ */
+template <typename Key, typename Parse>
+bool ColumnSorter::ExtractKeys(int rowCount, Parse parse, QVector<Key> *keys)
+{
+    keys->resize(rowCount);
+    const QVector<int> _bounds = GetChunkBounds(rowCount);  // Chunk boundaries
+    QVector<SortChunk> _chunks;  // Row ranges parsed by one task each
+    for (int _i = 0; _i + 1 < _bounds.size(); ++_i) {  // Position of the chunk
+        _chunks.append({_bounds.at(_i), _bounds.at(_i), _bounds.at(_i + 1)});
+    }
+
+    QAtomicInt _failed(0);  // Set by the first task meeting a value that has no key
+    Key *_keys = keys->data();  // Detached once here, tasks write disjoint ranges
+    QtConcurrent::blockingMap(_chunks, [&parse, &_failed, _keys](SortChunk &chunk) {
+        for (int _row = chunk.Begin; _row < chunk.End && !_failed.loadRelaxed(); ++_row) {  // Current view row (0-based)
+            if (!parse(_row, &_keys[_row])) {
+                _failed.storeRelaxed(1);
+            }
+        }
+    });
+
+    return !_failed.loadRelaxed();
+}
+
+/**
+ * @brief Sort view rows with a strict weak ordering, in parallel chunks merged pairwise
+ */
+template <typename LessThan>
+void ColumnSorter::ParallelStableSort(QVector<int> &rows, LessThan lessThan)
+{
+    QVector<int> _bounds = GetChunkBounds(rows.size());  // Boundaries of the sorted runs
+    int *_rows = rows.data();  // Detached once here, tasks work on disjoint ranges
+
+    QVector<SortChunk> _chunks;  // Runs sorted or merged by one task each
+    for (int _i = 0; _i + 1 < _bounds.size(); ++_i) {  // Position of the run
+        _chunks.append({_bounds.at(_i), _bounds.at(_i), _bounds.at(_i + 1)});
+    }
+    QtConcurrent::blockingMap(_chunks, [_rows, &lessThan](SortChunk &chunk) {
+        std::stable_sort(_rows + chunk.Begin, _rows + chunk.End, lessThan);
+    });
+
+    // Merge neighbouring runs until one is left; inplace_merge keeps equal rows in order like stable_sort
+    while (_bounds.size() > 2) {
+        QVector<int> _mergedBounds;  // Boundaries after this round
+        _chunks.clear();
+        for (int _i = 0; _i + 1 < _bounds.size(); _i += 2) {  // First run of the pair
+            _mergedBounds.append(_bounds.at(_i));
+            if (_i + 2 < _bounds.size()) {
+                _chunks.append({_bounds.at(_i), _bounds.at(_i + 1), _bounds.at(_i + 2)});
+            }
+        }
+        _mergedBounds.append(_bounds.last());
+
+        QtConcurrent::blockingMap(_chunks, [_rows, &lessThan](SortChunk &chunk) {
+            std::inplace_merge(_rows + chunk.Begin, _rows + chunk.Middle, _rows + chunk.End, lessThan);
+        });
+        _bounds = _mergedBounds;
+    }
+}
+
+/**
+ * @brief Split a number of rows into chunks, one per pool thread at most
+ */
+QVector<int> ColumnSorter::GetChunkBounds(int rowCount)
+{
+    const int _maxChunks = qMax(1, QThreadPool::globalInstance()->maxThreadCount());  // One chunk per pool thread
+    const int _chunkCount = qBound(1, rowCount / MIN_CHUNK_ROWS, _maxChunks);  // Chunks actually used
+    QVector<int> _bounds;  // Chunk boundaries
+    for (int _i = 0; _i <= _chunkCount; ++_i) {  // Position of the boundary
+        _bounds.append(int(qint64(rowCount) * _i / _chunkCount));
+    }
+    return _bounds;
+}
@@ -0,0 +1,87 @@
+#ifndef COLUMNSORTER_H
+#define COLUMNSORTER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include "tablestore.h"
+
+/**
+ * @brief Sorts the rows of a table view by one column on the global thread pool
+ * The sorter holds an implicitly shared copy of the committed table plus the
+ * pending values of the sorted column, so it can run on another thread while
+ * the model keeps being edited. Keys are extracted once per row: a column whose
+ * non-empty values are all numbers is compared numerically, one whose values are
+ * all ISO dates (yyyy-MM-dd) is compared by day, and any other column by text.
+ * Cells of typed columns give their native value without being formatted.
+ * Chunks are sorted in parallel and then merged pairwise in parallel rounds
+ */
+class ColumnSorter
+{
+public:
+    /**
+     * @brief How the values of the sorted column are compared
+     */
+    enum KeyType {
+        TextKey,                         // Case-insensitive text comparison
+        NumericKey,                      // Comparison of the parsed numbers
+        DateKey                          // Comparison of the parsed ISO dates
+    };
+
+    /**
+     * @brief Constructor for ColumnSorter
+     * @param table Committed table the row references point into
+     * @param column Column index (0-based) to sort by
+     * @param rowReferences Row reference of every view row: committed row index, or a key of pendingValues
+     * @param pendingValues Displayed text of rows whose value differs from the committed table, by row reference
+     */
+    ColumnSorter(const TableData &table, int column, const QVector<int> &rowReferences, const QHash<int, QString> &pendingValues);
+
+    /**
+     * @brief Compute the sorted order of the view rows, blocking until done
+     * Equal values keep their current relative order, empty values sort first in ascending order
+     * @param order Qt::AscendingOrder or Qt::DescendingOrder
+     * @return View rows in their sorted order
+     */
+    QVector<int> Sort(Qt::SortOrder order);
+
+    /**
+     * @brief Get how the values were compared by the last Sort call
+     * @return NumericKey, DateKey or TextKey
+     */
+    KeyType GetKeyType() const;
+
+private:
+    /**
+     * @brief Compute the key of every view row on the thread pool
+     * @param rowCount Number of view rows
+     * @param parse Called as parse(row, &key), returns false if the row has no key of this kind
+     * @param keys Receives the key of every view row
+     * @return true if every row has a key, false otherwise
+     */
+    template <typename Key, typename Parse>
+    static bool ExtractKeys(int rowCount, Parse parse, QVector<Key> *keys);
+
+    /**
+     * @brief Sort view rows with a strict weak ordering, in parallel chunks merged pairwise
+     */
+    template <typename LessThan>
+    static void ParallelStableSort(QVector<int> &rows, LessThan lessThan);
+
+    /**
+     * @brief Split a number of rows into chunks, one per pool thread at most
+     * @return Chunk boundaries, starting with 0 and ending with rowCount
+     */
+    static QVector<int> GetChunkBounds(int rowCount);
+
+    TableData Table;                     // Committed table (implicitly shared with the model)
+    int Column;                          // Sorted column (0-based)
+    QVector<int> RowReferences;          // Row reference of every view row
+    QHash<int, QString> PendingValues;   // Displayed text of edited and inserted rows by row reference
+    KeyType UsedKeyType;                 // Comparison chosen by the last Sort call (TextKey before)
+
+    static const int MIN_CHUNK_ROWS;     // Rows below which a chunk is not split further
+};
+
+#endif // COLUMNSORTER_H
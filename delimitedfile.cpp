@@ -0,0 +1,474 @@
+#include "delimitedfile.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <cstring>
+#include "xmlprofiler.h"
+
+const qint64 DelimitedFile::CHUNK_BYTES = 256 * 1024;       // Large enough to amortize task scheduling
+const qint64 DelimitedFile::BLOCK_BYTES = 8 * 1024 * 1024;  // Parsed rows of one block stay well below 100 MB
+const int DelimitedFile::CHUNK_ROWS = 16384;                // Same granularity as the other row-parallel algorithms
+
+/**
+ * @brief Byte range decoded and split into records by one pool task
+ */
+struct TextChunk {
+    qint64 Begin;                        // First byte of the chunk (start of a record)
+    qint64 End;                          // Byte past the chunk (start of a record or end of file)
+    QList<QStringList> Records;          // Records parsed from the chunk
+};
+
+/**
+ * @brief Row range formatted by one pool task
+ */
+struct RowChunk {
+    int Begin;                           // First row of the chunk
+    int End;                             // Row past the chunk
+    QByteArray Text;                     // UTF-8 lines of the rows
+};
+
+/**
+ * @brief Constructor stores the field separator used for reading and writing
+ */
+DelimitedFile::DelimitedFile(QChar delimiter)
+    : Delimiter(delimiter)             // Field separator
+    , RecordCount(0)                   // Nothing handled yet
+    , ErrorString()                    // Last error
+{
+}
+
+/**
+ * @brief Get the field separator a file name suggests
+ */
+QChar DelimitedFile::GetDefaultDelimiter(const QString &filePath)
+{
+    const QString _suffix = QFileInfo(filePath).suffix().toLower();  // File extension without dot
+    return _suffix == "tsv" || _suffix == "tab" ? QChar('\t') : QChar(',');
+}
+
+/**
+ * @brief Parse a delimited file and pass its records on in blocks, blocking until done
+ */
+bool DelimitedFile::ReadRecords(const QString &filePath, const std::function<bool(const QList<QStringList> &records)> &handleBlock)
+{
+    XML_PROFILE_SCOPE("Read delimited file");
+    ErrorString.clear();
+    RecordCount = 0;
+
+    QFile _file(filePath);  // Delimited input file
+    if (!_file.open(QIODevice::ReadOnly)) {
+        ErrorString = QString("Cannot read '%1'").arg(filePath);
+        return false;
+    }
+
+    // Pages are mapped on demand, only files that cannot be mapped are read into memory
+    const qint64 _size = _file.size();  // File size in bytes
+    QByteArray _contents;  // File contents (only used if mapping fails)
+    const char *_data = _size > 0 ? reinterpret_cast<const char *>(_file.map(0, _size)) : nullptr;  // Start of the file bytes
+    qint64 _end = _size;  // Byte past the file content
+    if (!_data) {
+        _contents = _file.readAll();
+        _data = _contents.constData();
+        _end = _contents.size();
+    }
+
+    qint64 _begin = 0;  // First byte of the first record
+    if (_end >= 3 && std::memcmp(_data, "\xEF\xBB\xBF", 3) == 0) {
+        _begin = 3;  // UTF-8 byte order mark
+    }
+
+    QVector<qint64> _chunkStarts;  // Chunk boundaries, ending with the file end
+    if (!FindChunkStarts(_data, _begin, _end, &_chunkStarts)) {
+        ErrorString = QString("Unterminated quoted field in '%1'").arg(filePath);
+        return false;
+    }
+
+    const int _chunksPerBlock = int(BLOCK_BYTES / CHUNK_BYTES);  // Chunks parsed before their records are passed on
+    const QChar _delimiter = Delimiter;  // Field separator used by the tasks
+    for (int _first = 0; _first + 1 < _chunkStarts.size(); _first += _chunksPerBlock) {  // First chunk of the block
+        QVector<TextChunk> _chunks;  // Chunks of the block
+        for (int _i = _first; _i < qMin(_first + _chunksPerBlock, int(_chunkStarts.size()) - 1); ++_i) {  // Position of the chunk
+            _chunks.append({_chunkStarts.at(_i), _chunkStarts.at(_i + 1), QList<QStringList>()});
+        }
+
+        QtConcurrent::blockingMap(_chunks, [_data, _delimiter](TextChunk &chunk) {
+            // Chunks start after line breaks, so no UTF-8 sequence is split
+            const QString _text = QString::fromUtf8(_data + chunk.Begin, int(chunk.End - chunk.Begin));  // Decoded chunk
+            ParseChunk(_text, _delimiter, &chunk.Records);
+        });
+
+        QList<QStringList> _records = _chunks.first().Records;  // Records of the block in file order
+        for (int _i = 1; _i < _chunks.size(); ++_i) {  // Position of the chunk
+            _records.append(_chunks.at(_i).Records);
+        }
+        _chunks.clear();
+
+        RecordCount += _records.size();
+        if (!handleBlock(_records)) {
+            return false;
+        }
+    }
+
+    XML_PROFILE_COUNT("Delimited records read", RecordCount);
+    return true;
+}
+
+/**
+ * @brief Read rows from a delimited file into a table of the worker
+ */
+bool DelimitedFile::ImportTable(XMLWorker *worker, const QString &tableName, const QString &filePath, ImportMode mode)
+{
+    XML_PROFILE_SCOPE("Import delimited file");
+    ErrorString.clear();
+    RecordCount = 0;
+
+    QStringList _tableHeaders;  // Column layout of the imported rows
+    int _tableRowCount = 0;     // Rows of the table before the import
+    if (!worker || !worker->GetTableMetadata(tableName, &_tableHeaders, &_tableRowCount)) {
+        ErrorString = QString("Table '%1' not found").arg(tableName);
+        return false;
+    }
+    if (_tableHeaders.isEmpty() && mode == AppendRows) {
+        ErrorString = QString("Table '%1' has no columns").arg(tableName);
+        return false;
+    }
+
+    bool _headerRead = false;       // Flag indicating the header line was matched (true) or not yet (false)
+    bool _sameLayout = false;       // Flag indicating the file columns are the table columns in table order
+    QVector<int> _fileColumns;      // File column of every table column (-1 if the file does not have it)
+    qint64 _importedRows = 0;       // Rows handed to the table so far
+    TableData _replacement(tableName);  // Rows replacing the table (ReplaceRows only)
+
+    const bool _read = ReadRecords(filePath, [&](const QList<QStringList> &records) {
+        QList<QStringList> _rows;  // Records of the block in table column order
+        _rows.reserve(records.size());
+
+        for (const QStringList &_record : records) {  // Current record
+            if (!_headerRead) {
+                _headerRead = true;
+                if (_tableHeaders.isEmpty()) {
+                    _tableHeaders = _record;
+                }
+
+                int _matchedColumns = 0;  // Table columns found in the file
+                for (const QString &_header : _tableHeaders) {
+                    _fileColumns.append(_record.indexOf(_header));
+                    _matchedColumns += _fileColumns.last() >= 0 ? 1 : 0;
+                }
+                if (_matchedColumns == 0) {
+                    ErrorString = QString("No column of '%1' matches a column of table '%2'").arg(filePath, tableName);
+                    return false;
+                }
+                if (_matchedColumns < _tableHeaders.size() || _record.size() > _matchedColumns) {
+                    qDebug() << "Importing" << _matchedColumns << "of" << _record.size() << "file columns into" << _tableHeaders.size() << "table columns";
+                }
+
+                _sameLayout = _record == _tableHeaders;
+                _replacement.SetColumnHeaders(_tableHeaders);
+                continue;
+            }
+
+            if (_sameLayout && _record.size() == _tableHeaders.size()) {
+                _rows.append(_record);
+                continue;
+            }
+
+            QStringList _row;  // Record in table column order
+            _row.reserve(_fileColumns.size());
+            for (int _fileColumn : _fileColumns) {  // File column of the current table column
+                _row.append(_fileColumn >= 0 ? _record.value(_fileColumn) : QString());
+            }
+            _rows.append(_row);
+        }
+
+        _importedRows += _rows.size();
+        if (mode == ReplaceRows) {
+            for (const QStringList &_row : _rows) {
+                _replacement.AppendRow(_row);
+            }
+            return true;
+        }
+
+        // Appended block by block, so only one block of parsed rows is held at a time. Quoting errors are
+        // found before the first block and the header in it, and the table lookup fails on the first
+        // append if at all, so no later block can fail after earlier ones were added
+        if (!_rows.isEmpty() && !worker->AddRowsToTable(tableName, _rows)) {
+            ErrorString = QString("Failed to append rows to table '%1'").arg(tableName);
+            return false;
+        }
+        return true;
+    });
+
+    if (!_read) {
+        return false;
+    }
+    if (!_headerRead) {
+        ErrorString = QString("'%1' has no header line").arg(filePath);
+        return false;
+    }
+    if (mode == ReplaceRows && !worker->ReplaceTable(tableName, _replacement)) {
+        ErrorString = QString("Failed to replace rows of table '%1'").arg(tableName);
+        return false;
+    }
+
+    RecordCount = _importedRows;
+    qDebug() << "Imported" << _importedRows << "rows from" << filePath << "into table" << tableName << "now holding"
+             << (mode == AppendRows ? _tableRowCount : 0) + _importedRows << "rows";
+    return true;
+}
+
+/**
+ * @brief Write a table with a header line of column names
+ */
+bool DelimitedFile::WriteTable(const TableData &table, QIODevice *device)
+{
+    XML_PROFILE_SCOPE("Write delimited file");
+    ErrorString.clear();
+    RecordCount = 0;
+
+    QStringList _fields;  // Escaped column names
+    for (const QString &_header : table.GetColumnHeaders()) {
+        _fields.append(EscapeField(_header, Delimiter, table.GetColumnCount() == 1));
+    }
+    const QByteArray _headerLine = (_fields.join(Delimiter) + '\n').toUtf8();  // First line of the output
+    if (device->write(_headerLine) != _headerLine.size()) {
+        ErrorString = "Failed to write delimited output";
+        return false;
+    }
+
+    // One block of formatted rows at a time, each chunk formatted by one pool task
+    const int _rowCount = table.GetRowCount();  // Rows to write
+    const int _blockRows = CHUNK_ROWS * qMax(1, QThreadPool::globalInstance()->maxThreadCount());  // Rows formatted before they are written
+    const QChar _delimiter = Delimiter;  // Field separator used by the tasks
+    for (int _blockBegin = 0; _blockBegin < _rowCount; _blockBegin += _blockRows) {  // First row of the block
+        const int _blockEnd = int(qMin<qint64>(_rowCount, qint64(_blockBegin) + _blockRows));  // Row past the block
+        QVector<RowChunk> _chunks;  // Chunks of the block
+        for (int _begin = _blockBegin; _begin < _blockEnd; _begin += CHUNK_ROWS) {  // First row of the chunk
+            _chunks.append({_begin, qMin(_blockEnd, _begin + CHUNK_ROWS), QByteArray()});
+        }
+
+        QtConcurrent::blockingMap(_chunks, [&table, _delimiter](RowChunk &chunk) {
+            FormatRows(table, chunk.Begin, chunk.End, _delimiter, &chunk.Text);
+        });
+
+        for (const RowChunk &_chunk : _chunks) {  // Formatted chunk, in row order
+            if (device->write(_chunk.Text) != _chunk.Text.size()) {
+                ErrorString = "Failed to write delimited output";
+                return false;
+            }
+        }
+        RecordCount = _blockEnd;
+    }
+
+    XML_PROFILE_COUNT("Delimited records written", RecordCount);
+    return true;
+}
+
+/**
+ * @brief Write a table with a header line of column names to a file, replacing it only once complete
+ */
+bool DelimitedFile::WriteFile(const TableData &table, const QString &filePath)
+{
+    QSaveFile _file(filePath);  // Output written next to the target and renamed on commit
+    if (!_file.open(QIODevice::WriteOnly)) {
+        ErrorString = QString("Cannot write '%1'").arg(filePath);
+        return false;
+    }
+
+    if (!WriteTable(table, &_file)) {
+        _file.cancelWriting();
+        return false;
+    }
+
+    if (!_file.commit()) {
+        ErrorString = QString("Failed to write '%1'").arg(filePath);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Get number of rows handled by the last call
+ */
+qint64 DelimitedFile::GetRecordCount() const
+{
+    return RecordCount;
+}
+
+/**
+ * @brief Get description of the last error
+ */
+QString DelimitedFile::GetErrorString() const
+{
+    return ErrorString;
+}
+
+/**
+ * @brief Find the chunk boundaries of a byte range, each at the start of a record
+ */
+bool DelimitedFile::FindChunkStarts(const char *data, qint64 begin, qint64 end, QVector<qint64> *chunkStarts)
+{
+    chunkStarts->append(begin);
+
+    bool _quoted = false;                      // Flag indicating the scan is inside a quoted field
+    qint64 _position = begin;                  // Current byte
+    qint64 _splitAt = begin + CHUNK_BYTES;     // Byte after which the next record end closes the chunk
+
+    while (_position < end) {
+        if (_quoted) {
+            // Only the closing quote matters inside a quoted field; a doubled quote reopens right after
+            const char *_quote = static_cast<const char *>(std::memchr(data + _position, '"', size_t(end - _position)));  // Closing quote
+            if (!_quote) {
+                return false;
+            }
+            _quoted = false;
+            _position = _quote - data + 1;
+            continue;
+        }
+
+        if (_position < _splitAt) {
+            // Before the split point only quotes change the state, line breaks do not matter yet
+            const qint64 _limit = qMin(_splitAt, end);  // End of the quote search
+            const char *_quote = static_cast<const char *>(std::memchr(data + _position, '"', size_t(_limit - _position)));  // Opening quote
+            if (_quote) {
+                _quoted = true;
+                _position = _quote - data + 1;
+            } else {
+                _position = _limit;
+            }
+            continue;
+        }
+
+        // Past the split point the next line break outside quotes ends the chunk
+        const char _c = data[_position];  // Current byte
+        ++_position;
+        if (_c == '"') {
+            _quoted = true;
+        } else if (_c == '\n' || _c == '\r') {
+            if (_c == '\r' && _position < end && data[_position] == '\n') {
+                ++_position;
+            }
+            if (_position < end) {
+                chunkStarts->append(_position);
+            }
+            _splitAt = _position + CHUNK_BYTES;
+        }
+    }
+
+    if (end > begin) {
+        chunkStarts->append(end);
+    }
+    return true;
+}
+
+/**
+ * @brief Split decoded text that starts and ends at record boundaries into records of fields
+ */
+void DelimitedFile::ParseChunk(QStringView text, QChar delimiter, QList<QStringList> *records)
+{
+    const qsizetype _size = text.size();  // Characters of the chunk
+    qsizetype _position = 0;              // Current character index
+    QStringList _record;                  // Fields of the current record
+
+    while (_position < _size) {
+        if (_record.isEmpty() && (text.at(_position) == '\n' || text.at(_position) == '\r')) {
+            ++_position;  // Empty line
+            continue;
+        }
+
+        QString _field;  // Text of the current field
+        if (text.at(_position) == '"') {
+            // Quoted field: copy the runs between quotes, a doubled quote stands for one quote
+            ++_position;
+            while (_position < _size) {
+                qsizetype _quote = text.indexOf(QChar('"'), _position);  // Next quote (closing or doubled)
+                if (_quote < 0) {
+                    _quote = _size;
+                }
+                _field.append(text.mid(_position, _quote - _position));
+                _position = _quote + 1;
+                if (_position < _size && text.at(_position) == '"') {
+                    _field.append('"');
+                    ++_position;
+                    continue;
+                }
+                break;
+            }
+
+            // Text between the closing quote and the next separator is kept
+            while (_position < _size && text.at(_position) != delimiter && text.at(_position) != '\n' && text.at(_position) != '\r') {
+                _field.append(text.at(_position));
+                ++_position;
+            }
+        } else {
+            const qsizetype _start = _position;  // First character of the field
+            while (_position < _size && text.at(_position) != delimiter && text.at(_position) != '\n' && text.at(_position) != '\r') {
+                ++_position;
+            }
+            _field = text.mid(_start, _position - _start).toString();
+        }
+        _record.append(_field);
+
+        if (_position >= _size) {
+            break;
+        }
+
+        const QChar _separator = text.at(_position);  // Delimiter or line break after the field
+        ++_position;
+        if (_separator == delimiter) {
+            if (_position >= _size) {
+                _record.append(QString());  // Empty last field at the end of the text
+            }
+            continue;
+        }
+
+        if (_separator == '\r' && _position < _size && text.at(_position) == '\n') {
+            ++_position;
+        }
+        records->append(_record);
+        _record.clear();
+    }
+
+    if (!_record.isEmpty()) {
+        records->append(_record);
+    }
+}
+
+/**
+ * @brief Append the delimited lines of a row range to a UTF-8 buffer
+ */
+void DelimitedFile::FormatRows(const TableData &table, int begin, int end, QChar delimiter, QByteArray *buffer)
+{
+    const int _columnCount = table.GetColumnCount();  // Fields per line
+    QString _text;  // Lines of the range, encoded once at the end
+    for (int _row = begin; _row < end; ++_row) {  // Current row index (0-based)
+        for (int _col = 0; _col < _columnCount; ++_col) {  // Current column index (0-based)
+            if (_col > 0) {
+                _text.append(delimiter);
+            }
+            _text.append(EscapeField(table.GetCell(_row, _col), delimiter, _columnCount == 1));
+        }
+        _text.append('\n');
+    }
+    buffer->append(_text.toUtf8());
+}
+
+/**
+ * @brief Quote a field if it contains the delimiter, quotes or line breaks, or is empty and alone on its line
+ */
+QString DelimitedFile::EscapeField(const QString &field, QChar delimiter, bool onlyField)
+{
+    if (onlyField && field.isEmpty()) {
+        return "\"\"";  // A bare empty line would be read as a blank line
+    }
+    if (!field.contains(delimiter) && !field.contains('"') && !field.contains('\n') && !field.contains('\r')) {
+        return field;
+    }
+
+    QString _escaped = field;  // Field with doubled quotes
+    _escaped.replace('"', "\"\"");
+    return '"' + _escaped + '"';
+}
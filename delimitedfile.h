@@ -0,0 +1,134 @@
+#ifndef DELIMITEDFILE_H
+#define DELIMITEDFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QList>
+#include <QVector>
+#include <QIODevice>
+#include <functional>
+#include "tablestore.h"
+#include "xmlworker.h"
+
+/**
+ * @brief Streams tables between delimited text files (CSV, TSV) and a worker
+ * Files are memory-mapped and split into chunks of about CHUNK_BYTES at record
+ * ends by one sequential pass that only looks at quotes and line breaks, so
+ * malformed quoting is reported before any row is handed on. Chunks are then
+ * decoded and split into fields on the global thread pool, a block of chunks at
+ * a time, and every block is passed on in file order before the next one is
+ * parsed, which bounds the memory of parsed rows by BLOCK_BYTES of input.
+ * Writing formats row ranges in parallel the same way and writes them in order.
+ * Quoting follows RFC 4180: fields holding the delimiter, quotes or line breaks
+ * are enclosed in quotes with inner quotes doubled; empty lines are skipped, so
+ * an empty field alone on its line is written as ""
+ */
+class DelimitedFile
+{
+public:
+    /**
+     * @brief How imported rows are combined with the rows already in the table
+     */
+    enum ImportMode {
+        AppendRows,                      // Imported rows are added after the existing rows
+        ReplaceRows                      // Imported rows replace all existing rows
+    };
+
+    /**
+     * @brief Constructor for DelimitedFile
+     * @param delimiter Field separator, usually ',' or '\t' (see GetDefaultDelimiter)
+     */
+    explicit DelimitedFile(QChar delimiter = QChar(','));
+
+    /**
+     * @brief Get the field separator a file name suggests
+     * @param filePath Path of the delimited file
+     * @return '\t' for .tsv and .tab files, ',' otherwise
+     */
+    static QChar GetDefaultDelimiter(const QString &filePath);
+
+    /**
+     * @brief Parse a delimited file and pass its records on in blocks, blocking until done
+     * @param filePath File to read (a leading UTF-8 byte order mark is skipped)
+     * @param handleBlock Called with the records of each block in file order; returning false stops reading
+     * @return true if the whole file was read, false on errors or if handleBlock stopped (see GetErrorString)
+     */
+    bool ReadRecords(const QString &filePath, const std::function<bool(const QList<QStringList> &records)> &handleBlock);
+
+    /**
+     * @brief Read rows from a delimited file into a table of the worker
+     * The first record names the columns; fields are matched to table columns by
+     * name, table columns the file does not have stay empty and file columns the
+     * table does not have are dropped. Appended rows go through the batch API one
+     * block at a time. A table without columns takes the columns of the file when
+     * its rows are replaced
+     * @param worker Worker holding the table (not owned)
+     * @param tableName Name of the table receiving the rows
+     * @param filePath Delimited file to read
+     * @param mode AppendRows or ReplaceRows
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool ImportTable(XMLWorker *worker, const QString &tableName, const QString &filePath, ImportMode mode);
+
+    /**
+     * @brief Write a table with a header line of column names
+     * @param table Table to write
+     * @param device Open device receiving UTF-8 text
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool WriteTable(const TableData &table, QIODevice *device);
+
+    /**
+     * @brief Write a table with a header line of column names to a file, replacing it only once complete
+     * @param table Table to write
+     * @param filePath File to write
+     * @return true on success, false otherwise (see GetErrorString)
+     */
+    bool WriteFile(const TableData &table, const QString &filePath);
+
+    /**
+     * @brief Get number of rows handled by the last call
+     * @return Records read by ReadRecords, rows imported by ImportTable or table rows written
+     */
+    qint64 GetRecordCount() const;
+
+    /**
+     * @brief Get description of the last error
+     * @return QString containing the error, empty if the last call succeeded
+     */
+    QString GetErrorString() const;
+
+private:
+    /**
+     * @brief Find the chunk boundaries of a byte range, each at the start of a record
+     * @return false if a quoted field is not closed before the end of the range
+     */
+    static bool FindChunkStarts(const char *data, qint64 begin, qint64 end, QVector<qint64> *chunkStarts);
+
+    /**
+     * @brief Split decoded text that starts and ends at record boundaries into records of fields
+     */
+    static void ParseChunk(QStringView text, QChar delimiter, QList<QStringList> *records);
+
+    /**
+     * @brief Append the delimited lines of a row range to a UTF-8 buffer
+     */
+    static void FormatRows(const TableData &table, int begin, int end, QChar delimiter, QByteArray *buffer);
+
+    /**
+     * @brief Quote a field if it contains the delimiter, quotes or line breaks, or is empty and alone on its line
+     * @param onlyField true if the field is the only one of its record
+     */
+    static QString EscapeField(const QString &field, QChar delimiter, bool onlyField);
+
+    QChar Delimiter;                     // Field separator
+    qint64 RecordCount;                  // Rows handled by the last call
+    QString ErrorString;                 // Description of the last error (empty if successful)
+
+    static const qint64 CHUNK_BYTES;     // Input parsed by one pool task
+    static const qint64 BLOCK_BYTES;     // Input parsed before its records are passed on
+    static const int CHUNK_ROWS;         // Rows formatted by one pool task
+};
+
+#endif // DELIMITEDFILE_H
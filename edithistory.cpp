@@ -0,0 +1,93 @@
+#include "edithistory.h"
+
+/**
+ * @brief Constructor initializes an empty history
+ */
+EditHistory::EditHistory()
+    : Commands()                       // Recorded commands
+    , Index(0)                         // Nothing applied yet
+{
+}
+
+/**
+ * @brief Discard all commands
+ */
+void EditHistory::Clear()
+{
+    Commands.clear();
+    Index = 0;
+}
+
+/**
+ * @brief Record a command that has just been applied, dropping all undone commands
+ */
+void EditHistory::Push(const Command &command)
+{
+    Commands.resize(Index);
+    Commands.append(command);
+    Index++;
+}
+
+/**
+ * @brief Check if a command can be undone
+ */
+bool EditHistory::CanUndo() const
+{
+    return Index > 0;
+}
+
+/**
+ * @brief Check if a command can be redone
+ */
+bool EditHistory::CanRedo() const
+{
+    return Index < Commands.size();
+}
+
+/**
+ * @brief Step back over the last applied command
+ */
+const EditHistory::Command &EditHistory::Undo()
+{
+    return Commands.at(--Index);
+}
+
+/**
+ * @brief Step forward over the next undone command
+ */
+const EditHistory::Command &EditHistory::Redo()
+{
+    return Commands.at(Index++);
+}
+
+/**
+ * @brief Get a short description of the command Undo would revert
+ */
+QString EditHistory::GetUndoText() const
+{
+    return CanUndo() ? GetCommandText(Commands.at(Index - 1)) : QString();
+}
+
+/**
+ * @brief Get a short description of the command Redo would apply
+ */
+QString EditHistory::GetRedoText() const
+{
+    return CanRedo() ? GetCommandText(Commands.at(Index)) : QString();
+}
+
+/**
+ * @brief Get a short description of a command
+ */
+QString EditHistory::GetCommandText(const Command &command)
+{
+    switch (command.Type) {
+    case CellEditCommand:
+        return "Edit Cell";
+    case RowInsertCommand:
+        return command.RowReferences.size() == 1 ? "Add Row" : "Add Rows";
+    case RowDeleteCommand:
+        return command.RowReferences.size() == 1 ? "Delete Row" : "Delete Rows";
+    }
+    return QString();
+}
@@ -0,0 +1,111 @@
+#ifndef EDITHISTORY_H
+#define EDITHISTORY_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief Undo and redo log of the changes made to one ChangeJournal
+ * Works like a QUndoStack without depending on the widgets module: commands are
+ * pushed as they happen, an index separates the undone commands from the rest,
+ * and pushing a new command drops everything that was undone. Commands hold only
+ * the delta of a change, addressed with the same row references as the journal,
+ * and are applied back by the model that owns both
+ */
+class EditHistory
+{
+public:
+    /**
+     * @brief Kind of change a command records
+     */
+    enum CommandType {
+        CellEditCommand,                 // Text of one cell was changed
+        RowInsertCommand,                // Empty rows were inserted at one view row
+        RowDeleteCommand                 // One or more runs of view rows were removed
+    };
+
+    /**
+     * @brief Delta of one change
+     * Cell edits use RowReference, Column and the two values. Row commands list
+     * their runs in the order they were applied: run i starts at view row
+     * ViewRows[i] and covers the next RunLengths[i] entries of RowReferences
+     */
+    struct Command {
+        CommandType Type;                // Kind of change
+        int RowReference;                // Edited cell row: committed row index or inserted row reference (cell edits only)
+        int Column;                      // Edited cell column (cell edits only)
+        int ViewRow;                     // View row of the edited cell when it was edited, a hint that may be stale (cell edits only)
+        bool HadPendingValue;            // Flag indicating the journal held text for the cell before (true) or the committed value applied (false)
+        QString OldValue;                // Pending text before the edit (only valid if HadPendingValue is true)
+        QString NewValue;                // Pending text after the edit
+        QVector<int> ViewRows;           // First view row of each run (row commands only)
+        QVector<int> RunLengths;         // Number of rows of each run (row commands only)
+        QVector<int> RowReferences;      // Row references of all runs in view order (row commands only)
+        QList<QStringList> RowData;      // Cell values of every deleted inserted row, in RowReferences order (row deletes only)
+    };
+
+    /**
+     * @brief Constructor for EditHistory
+     */
+    EditHistory();
+
+    /**
+     * @brief Discard all commands
+     */
+    void Clear();
+
+    /**
+     * @brief Record a command that has just been applied, dropping all undone commands
+     * @param command Delta of the change
+     */
+    void Push(const Command &command);
+
+    /**
+     * @brief Check if a command can be undone
+     * @return true if at least one command is applied, false otherwise
+     */
+    bool CanUndo() const;
+
+    /**
+     * @brief Check if a command can be redone
+     * @return true if at least one command was undone, false otherwise
+     */
+    bool CanRedo() const;
+
+    /**
+     * @brief Step back over the last applied command
+     * @return Command the caller has to revert (must only be called if CanUndo is true)
+     */
+    const Command &Undo();
+
+    /**
+     * @brief Step forward over the next undone command
+     * @return Command the caller has to apply again (must only be called if CanRedo is true)
+     */
+    const Command &Redo();
+
+    /**
+     * @brief Get a short description of the command Undo would revert
+     * @return Text such as "Edit Cell" (empty if nothing can be undone)
+     */
+    QString GetUndoText() const;
+
+    /**
+     * @brief Get a short description of the command Redo would apply
+     * @return Text such as "Delete Rows" (empty if nothing can be redone)
+     */
+    QString GetRedoText() const;
+
+private:
+    /**
+     * @brief Get a short description of a command
+     */
+    static QString GetCommandText(const Command &command);
+
+    QVector<Command> Commands;           // Applied commands followed by undone commands (empty if nothing changed)
+    int Index;                           // Number of applied commands, position of the next command to redo
+};
+
+#endif // EDITHISTORY_H
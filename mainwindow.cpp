@@ -14,31 +14,83 @@ MainWindow::MainWindow(QWidget *parent)
     , MainLayout(nullptr)              // Primary layout manager
     , FileLayout(nullptr)              // File operation layout
     , TableLayout(nullptr)             // Table selection layout
+    , FilterLayout(nullptr)            // Row filter layout
+    , CompareLayout(nullptr)           // Table comparison layout
     , ButtonLayout(nullptr)            // Action button layout
     , ChooseFileButton(nullptr)        // File selection button
     , LoadFileButton(nullptr)          // File loading button
     , FilePathLabel(nullptr)           // Current file path display
+    , LoadProgressBar(nullptr)         // Background load progress
+    , CancelLoadButton(nullptr)        // Background load abort button
     , TableComboBox(nullptr)           // Table selection dropdown
     , TableLabel(nullptr)              // Table selection label
+    , FilterLabel(nullptr)             // Row filter label
+    , FilterColumnComboBox(nullptr)    // Filter column dropdown
+    , FilterTypeComboBox(nullptr)      // Filter kind dropdown
+    , FilterValueEdit(nullptr)         // Filter value input
+    , FilterUpperEdit(nullptr)         // Range upper bound input
+    , ApplyFilterButton(nullptr)       // Filter apply button
+    , ClearFilterButton(nullptr)       // Filter reset button
+    , FilterStatusLabel(nullptr)       // Shown row count display
+    , CompareLabel(nullptr)            // Table comparison label
+    , CompareFileComboBox(nullptr)     // Compared file dropdown
+    , CompareKeyComboBox(nullptr)      // Compare key column dropdown
+    , OpenCompareButton(nullptr)       // Workspace open button
+    , CompareButton(nullptr)           // Table compare button
     , AddButton(nullptr)               // Row addition toggle button
     , DeleteButton(nullptr)            // Row deletion toggle button
     , EditButton(nullptr)              // Cell editing toggle button
     , UpdateButton(nullptr)            // Changes save button
     , CancelButton(nullptr)            // Changes discard button
+    , UndoButton(nullptr)              // Last change revert button
+    , RedoButton(nullptr)              // Undone change repeat button
+    , ImportButton(nullptr)            // Delimited file import button
+    , ExportButton(nullptr)            // Delimited file export button
+    , ProfileStatusLabel(nullptr)      // Stage timings display
+    , ProfileButton(nullptr)           // Timing recording toggle button
+    , ExportTraceButton(nullptr)       // Trace export button
     , DataTable(nullptr)               // Main data display table
+    , TableModel(nullptr)              // Model for the selected table
+    , FilterModel(nullptr)             // Row filter between model and view
     , Worker(nullptr)                  // XML processing worker
+    , Loader(nullptr)                  // Background load runner
+    , Saver(nullptr)                   // Background save runner
+    , Workspace(nullptr)               // Files to compare against
+    , WorkspaceWatcher(nullptr)        // Background workspace open result
+    , DiffWatcher(nullptr)             // Background comparison result
+    , DiffTitle("")                    // No comparison running
+    , DiffIgnoresPendingChanges(false) // No comparison running
+    , ExportWatcher(nullptr)           // Background export result
+    , ExportMessage("")                // No export running
+    , SortWatcher(nullptr)             // Background sort result
     , CurrentFilePath("")              // Path to active XML file
     , CurrentTableName("")             // Name of selected table
     , IsAddMode(false)                 // Add mode state flag
     , IsDeleteMode(false)              // Delete mode state flag
     , IsEditMode(false)                // Edit mode state flag
     , HasUnsavedChanges(false)         // Unsaved changes indicator
+    , IsLoading(false)                 // Background load indicator
+    , IsSaving(false)                  // Background save indicator
+    , SortColumn(-1)                   // Rows in table order
+    , SortDirection(Qt::AscendingOrder)  // Sort order of the next sort
+    , SortRevision(0)                  // No sort running
 {
+    // Initialize worker for XML operations and its background loader
+    Worker = new XMLWorker();
+    Worker->SetLoadMode(XMLWorker::LazyLoadMode);  // Parse only the tables the user opens
+    Loader = new XMLLoader(Worker, this);
+    Saver = new XMLSaver(Worker, this);
+    SortWatcher = new QFutureWatcher<QVector<int>>(this);
+    Workspace = new XMLWorkspace();
+    WorkspaceWatcher = new QFutureWatcher<bool>(this);
+    DiffWatcher = new QFutureWatcher<TableDiff>(this);
+    ExportWatcher = new QFutureWatcher<bool>(this);
+
     InitializeUI();
     SetupConnections();
 
-    // Initialize worker for XML operations
-    Worker = new XMLWorker();
+    // Timings can also be recorded right from startup
+    ProfileButton->setChecked(qEnvironmentVariableIsSet("XMLTABLEEDITOR_PROFILE"));
 
     // Set initial window properties
     setWindowTitle("Professional XML Table Editor");
@@ -51,6 +103,11 @@ MainWindow::MainWindow(QWidget *parent)
  */
 MainWindow::~MainWindow()
 {
+    delete Loader;  // Stop a running load before its worker goes away
+    delete Saver;   // Let a running save finish writing the file
+    WorkspaceWatcher->waitForFinished();  // Files may still be opening into the workspace
+    ExportWatcher->waitForFinished();  // Let a running export finish writing its file
+    delete Workspace;
     delete Worker;  // Clean up XML worker instance
 }
 
@@ -84,9 +141,20 @@ void MainWindow::InitializeUI()
     FilePathLabel->setMinimumWidth(300);
     FilePathLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
 
+    // Progress controls shown only while a file is loading
+    LoadProgressBar = new QProgressBar(this);
+    LoadProgressBar->setRange(0, 100);
+    LoadProgressBar->setMinimumWidth(150);
+    LoadProgressBar->setVisible(false);
+    CancelLoadButton = new QPushButton("Cancel Loading", this);
+    CancelLoadButton->setMinimumHeight(35);
+    CancelLoadButton->setVisible(false);
+
     FileLayout->addWidget(ChooseFileButton);
     FileLayout->addWidget(LoadFileButton);
     FileLayout->addWidget(FilePathLabel, 1);  // Stretch factor for path label
+    FileLayout->addWidget(LoadProgressBar);
+    FileLayout->addWidget(CancelLoadButton);
 
     // Setup table selection section
     TableLayout = new QHBoxLayout();
@@ -99,6 +167,69 @@ void MainWindow::InitializeUI()
     TableLayout->addWidget(TableLabel);
     TableLayout->addWidget(TableComboBox, 1);  // Stretch factor for combo box
 
+    // Setup row filter section, queries run against per-column indexes of the model
+    FilterLayout = new QHBoxLayout();
+    FilterLabel = new QLabel("Filter:", this);
+    FilterColumnComboBox = new QComboBox(this);
+    FilterTypeComboBox = new QComboBox(this);
+    FilterValueEdit = new QLineEdit(this);
+    FilterUpperEdit = new QLineEdit(this);
+    ApplyFilterButton = new QPushButton("Apply Filter", this);
+    ClearFilterButton = new QPushButton("Clear Filter", this);
+    FilterStatusLabel = new QLabel(this);
+
+    FilterTypeComboBox->addItem("equals", ColumnIndex::EqualQuery);
+    FilterTypeComboBox->addItem("starts with", ColumnIndex::PrefixQuery);
+    FilterTypeComboBox->addItem("between", ColumnIndex::RangeQuery);
+    FilterValueEdit->setPlaceholderText("Value");
+    FilterUpperEdit->setPlaceholderText("Upper bound");
+    FilterUpperEdit->setVisible(false);  // Only used by range filters
+    FilterColumnComboBox->setMinimumHeight(30);
+    FilterTypeComboBox->setMinimumHeight(30);
+    ApplyFilterButton->setMinimumHeight(30);
+    ClearFilterButton->setMinimumHeight(30);
+
+    // Disable filter controls until a table is displayed
+    FilterColumnComboBox->setEnabled(false);
+    FilterTypeComboBox->setEnabled(false);
+    FilterValueEdit->setEnabled(false);
+    FilterUpperEdit->setEnabled(false);
+    ApplyFilterButton->setEnabled(false);
+    ClearFilterButton->setEnabled(false);
+
+    FilterLayout->addWidget(FilterLabel);
+    FilterLayout->addWidget(FilterColumnComboBox);
+    FilterLayout->addWidget(FilterTypeComboBox);
+    FilterLayout->addWidget(FilterValueEdit, 1);  // Stretch factor for value input
+    FilterLayout->addWidget(FilterUpperEdit, 1);
+    FilterLayout->addWidget(ApplyFilterButton);
+    FilterLayout->addWidget(ClearFilterButton);
+    FilterLayout->addWidget(FilterStatusLabel);
+
+    // Setup table comparison section, compared files are opened into a workspace next to the edited file
+    CompareLayout = new QHBoxLayout();
+    CompareLabel = new QLabel("Compare with:", this);
+    CompareFileComboBox = new QComboBox(this);
+    CompareKeyComboBox = new QComboBox(this);
+    OpenCompareButton = new QPushButton("Open Files...", this);
+    CompareButton = new QPushButton("Compare Table", this);
+
+    CompareFileComboBox->setMinimumHeight(30);
+    CompareKeyComboBox->setMinimumHeight(30);
+    OpenCompareButton->setMinimumHeight(30);
+    CompareButton->setMinimumHeight(30);
+
+    // Disable compare controls until files are opened and a table is displayed
+    CompareFileComboBox->setEnabled(false);
+    CompareKeyComboBox->setEnabled(false);
+    CompareButton->setEnabled(false);
+
+    CompareLayout->addWidget(CompareLabel);
+    CompareLayout->addWidget(CompareFileComboBox, 1);  // Stretch factor for file selection
+    CompareLayout->addWidget(CompareKeyComboBox);
+    CompareLayout->addWidget(OpenCompareButton);
+    CompareLayout->addWidget(CompareButton);
+
     // Setup action buttons section
     ButtonLayout = new QHBoxLayout();
     AddButton = new QPushButton("Add Row", this);
@@ -106,6 +237,10 @@ void MainWindow::InitializeUI()
     EditButton = new QPushButton("Edit Cells", this);
     UpdateButton = new QPushButton("Update XML", this);
     CancelButton = new QPushButton("Cancel", this);
+    UndoButton = new QPushButton("Undo", this);
+    RedoButton = new QPushButton("Redo", this);
+    ImportButton = new QPushButton("Import...", this);
+    ExportButton = new QPushButton("Export...", this);
 
     // Configure action buttons
     AddButton->setMinimumHeight(35);
@@ -113,6 +248,12 @@ void MainWindow::InitializeUI()
     EditButton->setMinimumHeight(35);
     UpdateButton->setMinimumHeight(35);
     CancelButton->setMinimumHeight(35);
+    UndoButton->setMinimumHeight(35);
+    RedoButton->setMinimumHeight(35);
+    ImportButton->setMinimumHeight(35);
+    ExportButton->setMinimumHeight(35);
+    UndoButton->setShortcut(QKeySequence::Undo);
+    RedoButton->setShortcut(QKeySequence::Redo);
 
     // Set initial button states
     AddButton->setCheckable(true);      // Make toggle button
@@ -126,6 +267,10 @@ void MainWindow::InitializeUI()
     EditButton->setStyleSheet(combinedStyle);
     UpdateButton->setStyleSheet(combinedStyle);
     CancelButton->setStyleSheet(combinedStyle);
+    UndoButton->setStyleSheet(combinedStyle);
+    RedoButton->setStyleSheet(combinedStyle);
+    ImportButton->setStyleSheet(combinedStyle);
+    ExportButton->setStyleSheet(combinedStyle);
     
     // Disable action buttons until table is selected
     AddButton->setEnabled(false);
@@ -133,26 +278,57 @@ void MainWindow::InitializeUI()
     EditButton->setEnabled(false);
     UpdateButton->setEnabled(false);
     CancelButton->setEnabled(false);
+    UndoButton->setEnabled(false);      // Enabled once there is a change to undo
+    RedoButton->setEnabled(false);      // Enabled once a change was undone
+    ImportButton->setEnabled(false);
+    ExportButton->setEnabled(false);
 
     ButtonLayout->addWidget(AddButton);
     ButtonLayout->addWidget(DeleteButton);
     ButtonLayout->addWidget(EditButton);
     ButtonLayout->addWidget(UpdateButton);
     ButtonLayout->addWidget(CancelButton);
+    ButtonLayout->addWidget(UndoButton);
+    ButtonLayout->addWidget(RedoButton);
+    ButtonLayout->addWidget(ImportButton);
+    ButtonLayout->addWidget(ExportButton);
     ButtonLayout->addStretch();  // Push buttons to left
 
-    // Setup main data table
-    DataTable = new QTableWidget(this);
+    // Setup main data table backed by a virtual model
+    TableModel = new XMLTableModel(this);
+    FilterModel = new XMLFilterProxyModel(this);
+    FilterModel->setSourceModel(TableModel);
+    DataTable = new QTableView(this);
+    DataTable->setModel(FilterModel);
     DataTable->setAlternatingRowColors(true);
+    DataTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);  // Uniform row heights, no per-row measuring
     DataTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    DataTable->setSelectionMode(QAbstractItemView::ExtendedSelection);  // Several rows can be deleted at once
     DataTable->horizontalHeader()->setStretchLastSection(true);
+    DataTable->horizontalHeader()->setSectionsClickable(true);  // Clicking a header sorts by its column
+    DataTable->horizontalHeader()->setSortIndicatorShown(true);
+    DataTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);  // Unsorted until a header is clicked
     DataTable->setEditTriggers(QAbstractItemView::NoEditTriggers);  // Initially read-only
 
     // Add all layouts to main layout
     MainLayout->addLayout(FileLayout);
     MainLayout->addLayout(TableLayout);
+    MainLayout->addLayout(FilterLayout);
+    MainLayout->addLayout(CompareLayout);
     MainLayout->addLayout(ButtonLayout);
     MainLayout->addWidget(DataTable, 1);  // Table gets most space
+
+    // Setup timing overlay in the status bar, recording is off unless requested
+    ProfileStatusLabel = new QLabel(this);
+    ProfileButton = new QPushButton("Profile", this);
+    ExportTraceButton = new QPushButton("Export Trace...", this);
+
+    ProfileButton->setCheckable(true);  // Make toggle button
+    ExportTraceButton->setEnabled(false);  // Disabled until something was recorded
+
+    statusBar()->addWidget(ProfileStatusLabel, 1);  // Stretch factor for timing text
+    statusBar()->addPermanentWidget(ProfileButton);
+    statusBar()->addPermanentWidget(ExportTraceButton);
 }
 
 /**
@@ -163,20 +339,60 @@ void MainWindow::SetupConnections()
     // File operation connections
     connect(ChooseFileButton, &QPushButton::clicked, this, &MainWindow::OnChooseFileClicked);
     connect(LoadFileButton, &QPushButton::clicked, this, &MainWindow::OnLoadFileClicked);
+    connect(CancelLoadButton, &QPushButton::clicked, this, &MainWindow::OnCancelLoadClicked);
+
+    // Background loader connections (queued, emitted from the loader thread)
+    connect(Loader, &XMLLoader::ProgressChanged, this, &MainWindow::OnLoadProgressChanged);
+    connect(Loader, &XMLLoader::TableFound, this, &MainWindow::OnTableFound);
+    connect(Loader, &XMLLoader::LoadFinished, this, &MainWindow::OnLoadFinished);
+    connect(Saver, &XMLSaver::SaveFinished, this, &MainWindow::OnSaveFinished);
 
     // Table selection connection
     connect(TableComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::OnTableSelectionChanged);
 
+    // Row filter connections
+    connect(ApplyFilterButton, &QPushButton::clicked, this, &MainWindow::OnApplyFilterClicked);
+    connect(ClearFilterButton, &QPushButton::clicked, this, &MainWindow::OnClearFilterClicked);
+    connect(FilterValueEdit, &QLineEdit::returnPressed, this, &MainWindow::OnApplyFilterClicked);
+    connect(FilterUpperEdit, &QLineEdit::returnPressed, this, &MainWindow::OnApplyFilterClicked);
+    connect(FilterTypeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::OnFilterTypeChanged);
+
+    // Table comparison connections
+    connect(OpenCompareButton, &QPushButton::clicked, this, &MainWindow::OnOpenCompareFilesClicked);
+    connect(CompareButton, &QPushButton::clicked, this, &MainWindow::OnCompareClicked);
+    connect(WorkspaceWatcher, &QFutureWatcher<bool>::finished, this, &MainWindow::OnCompareFilesOpened);
+    connect(DiffWatcher, &QFutureWatcher<TableDiff>::finished, this, &MainWindow::OnCompareFinished);
+
+    // Keep the shown row count current while rows are added or deleted
+    connect(FilterModel, &QAbstractItemModel::rowsInserted, this, &MainWindow::UpdateFilterStatus);
+    connect(FilterModel, &QAbstractItemModel::rowsRemoved, this, &MainWindow::UpdateFilterStatus);
+
     // Connect action buttons
     connect(AddButton, &QPushButton::clicked, this, &MainWindow::OnAddButtonClicked);
     connect(DeleteButton, &QPushButton::clicked, this, &MainWindow::OnDeleteButtonClicked);
     connect(EditButton, &QPushButton::clicked, this, &MainWindow::OnEditButtonClicked);
     connect(UpdateButton, &QPushButton::clicked, this, &MainWindow::OnUpdateButtonClicked);
     connect(CancelButton, &QPushButton::clicked, this, &MainWindow::OnCancelButtonClicked);
+    connect(UndoButton, &QPushButton::clicked, this, &MainWindow::OnUndoButtonClicked);
+    connect(RedoButton, &QPushButton::clicked, this, &MainWindow::OnRedoButtonClicked);
+    connect(TableModel, &XMLTableModel::HistoryChanged, this, &MainWindow::UpdateUndoButtons);
+    connect(TableModel, &XMLTableModel::TableFetched, this, &MainWindow::OnTableFetched);
+
+    // Delimited file connections
+    connect(ImportButton, &QPushButton::clicked, this, &MainWindow::OnImportClicked);
+    connect(ExportButton, &QPushButton::clicked, this, &MainWindow::OnExportClicked);
+    connect(ExportWatcher, &QFutureWatcher<bool>::finished, this, &MainWindow::OnExportFinished);
 
     // Table interaction connections
-    connect(DataTable, &QTableWidget::cellDoubleClicked, this, &MainWindow::OnRowDoubleClicked);
+    connect(DataTable, &QTableView::doubleClicked, this, &MainWindow::OnRowDoubleClicked);
+    connect(DataTable->horizontalHeader(), &QHeaderView::sectionClicked, this, &MainWindow::OnHeaderClicked);
+    connect(SortWatcher, &QFutureWatcher<QVector<int>>::finished, this, &MainWindow::OnSortFinished);
+
+    // Timing overlay connections
+    connect(ProfileButton, &QPushButton::toggled, this, &MainWindow::OnProfileToggled);
+    connect(ExportTraceButton, &QPushButton::clicked, this, &MainWindow::OnExportTraceClicked);
 }
 
 /**
@@ -210,7 +426,7 @@ void MainWindow::OnChooseFileClicked()
 }
 
 /**
- * @brief Handle load file button click to parse and load XML data
+ * @brief Handle load file button click to start loading XML data in the background
  */
 void MainWindow::OnLoadFileClicked()
 {
@@ -219,28 +435,125 @@ void MainWindow::OnLoadFileClicked()
         return;
     }
 
+    if (IsLoading) {
+        return;  // Previous load still running, wait for it or cancel it first
+    }
+
+    if (IsSaving) {
+        QMessageBox::information(this, "Info", "Please wait until the changes are saved.");
+        return;
+    }
+
     // Reset UI state
     TableComboBox->clear();
-    DataTable->setRowCount(0);
-    DataTable->setColumnCount(0);
+    TableModel->Clear();
+    ResetFilter();
+    CurrentTableName.clear();
+    ResetToggleButtons();
+    AddButton->setEnabled(false);
+    DeleteButton->setEnabled(false);
+    EditButton->setEnabled(false);
+    UpdateButton->setEnabled(false);
+    CancelButton->setEnabled(false);
+    ImportButton->setEnabled(false);
+    ExportButton->setEnabled(false);
 
-    // Load XML file using worker
-    if (Worker->LoadXMLFile(CurrentFilePath)) {
-        // Get available tables from the loaded file
-        QStringList _tableNames = Worker->GetTableNames();  // List of table names in the XML file (empty if none found)
-        
-        if (_tableNames.isEmpty()) {
-            QMessageBox::warning(this, "Warning", "No tables found in the XML file.");
-            return;
+    // Load XML file using worker on the background thread
+    if (Loader->Start(CurrentFilePath)) {
+        IsLoading = true;
+        ChooseFileButton->setEnabled(false);
+        LoadFileButton->setEnabled(false);
+        LoadProgressBar->setValue(0);
+        LoadProgressBar->setVisible(true);
+        CancelLoadButton->setVisible(true);
+        UpdateCompareButtons();
+    }
+}
+
+/**
+ * @brief Handle cancel loading button click
+ */
+void MainWindow::OnCancelLoadClicked()
+{
+    Loader->Cancel();
+    CancelLoadButton->setEnabled(false);  // Re-enabled once the loader has stopped
+}
+
+/**
+ * @brief Update progress bar while the background load runs
+ */
+void MainWindow::OnLoadProgressChanged(qint64 bytesRead, qint64 totalBytes)
+{
+    LoadProgressBar->setValue(totalBytes > 0 ? int(bytesRead * 100 / totalBytes) : 100);
+}
+
+/**
+ * @brief Add a table to the selection as soon as the loader has parsed it
+ */
+void MainWindow::OnTableFound(const QString &tableName)
+{
+    // The first table is selected (and displayed) automatically by the combo box
+    TableComboBox->addItem(tableName);
+    TableComboBox->setEnabled(true);
+}
+
+/**
+ * @brief Restore UI state once the background load has ended
+ */
+void MainWindow::OnLoadFinished(bool success, bool cancelled)
+{
+    IsLoading = false;
+    UpdateProfileStatus();
+    ChooseFileButton->setEnabled(true);
+    LoadFileButton->setEnabled(true);
+    LoadProgressBar->setVisible(false);
+    CancelLoadButton->setVisible(false);
+    CancelLoadButton->setEnabled(true);
+    UpdateCompareButtons();
+
+    if (!success) {
+        // Partially shown tables belong to a load that did not complete
+        TableComboBox->clear();
+        TableModel->Clear();
+        ResetFilter();
+        CurrentTableName.clear();
+
+        if (cancelled) {
+            QMessageBox::information(this, "Info", "Loading was cancelled.");
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to load XML file. Please check if it is a valid XML file.");
         }
-        
-        // Populate table selection dropdown
-        TableComboBox->addItems(_tableNames);
-        TableComboBox->setEnabled(true);
-        
-        QMessageBox::information(this, "Success", "XML file loaded successfully.");
+        return;
+    }
+
+    if (TableComboBox->count() == 0) {
+        QMessageBox::warning(this, "Warning", "No tables found in the XML file.");
+        return;
+    }
+
+    // Editing is allowed only once the whole file is loaded
+    OnTableSelectionChanged();
+
+    QMessageBox::information(this, "Success", "XML file loaded successfully.");
+}
+
+/**
+ * @brief Report the result once the background save has ended
+ */
+void MainWindow::OnSaveFinished(bool success)
+{
+    IsSaving = false;
+    UpdateProfileStatus();
+    UpdateButton->setEnabled(!CurrentTableName.isEmpty() && !IsLoading);
+
+    if (success) {
+        // Edits made while saving are still in the model journal and saved by the next update
+        HasUnsavedChanges = false;
+        QMessageBox::information(this, "Success", "Changes saved successfully to XML file.");
     } else {
-        QMessageBox::critical(this, "Error", "Failed to load XML file. Please check if it is a valid XML file.");
+        // Changes are already applied to the worker, keep them marked as unsaved so saving can be retried
+        HasUnsavedChanges = true;
+        QMessageBox::critical(this, "Error", "Failed to save changes to XML file.");
     }
 }
 
@@ -252,14 +565,17 @@ void MainWindow::OnTableSelectionChanged()
     if (TableComboBox->currentIndex() >= 0) {
         CurrentTableName = TableComboBox->currentText();
         LoadTableData();
+        UpdateProfileStatus();
 
-        // Configure for table usage
+        // Configure for table usage, editing waits until a background load has finished
         TableComboBox->setEnabled(true);
-        AddButton->setEnabled(true);
-        DeleteButton->setEnabled(true);
-        EditButton->setEnabled(true);
-        UpdateButton->setEnabled(true);
-        CancelButton->setEnabled(true);
+        AddButton->setEnabled(!IsLoading);
+        DeleteButton->setEnabled(!IsLoading);
+        EditButton->setEnabled(!IsLoading);
+        UpdateButton->setEnabled(!IsLoading && !IsSaving);
+        CancelButton->setEnabled(!IsLoading);
+        ImportButton->setEnabled(!IsLoading);
+        ExportButton->setEnabled(!IsLoading && !ExportWatcher->isRunning());
 
         // Reset any active modes
         ResetToggleButtons();
@@ -305,7 +621,8 @@ void MainWindow::OnDeleteButtonClicked()
         DeleteButton->setChecked(true);
 
         QMessageBox::information(this, "Delete Mode",
-                                 "Delete mode activated. Double-click any row to delete it.");
+                                 "Delete mode activated. Double-click any row to delete it, "
+                                 "or select several rows and double-click one of them to delete them all.");
     }
 }
 
@@ -335,33 +652,34 @@ void MainWindow::OnEditButtonClicked()
  */
 void MainWindow::OnUpdateButtonClicked()
 {
-    if (!HasUnsavedChanges && !IsAddMode && !IsDeleteMode && !IsEditMode) {
+    if (!TableModel->HasPendingChanges() && !HasUnsavedChanges) {
         QMessageBox::information(this, "Info", "No changes to save.");
         return;
     }
 
-    bool success = false;
+    if (IsSaving) {
+        return;  // Previous save still running, the next one starts from its result
+    }
 
-    if (IsAddMode || IsEditMode) {
-        // Save current table state for add or edit operations
-        success = Worker->UpdateCompleteTable(CurrentTableName, DataTable);
-    } else if (IsDeleteMode) {
-        // For delete operations, apply changes now using current table state
-        success = Worker->UpdateCompleteTable(CurrentTableName, DataTable);
-    } else {
-        // No active mode but changes exist
-        success = Worker->UpdateCompleteTable(CurrentTableName, DataTable);
+    // The worker appends inserted rows after its last row, so the model reads the rest of a paged table
+    // first and folds them in at the same place
+    if (!TableModel->GetChangeJournal().GetInsertedRows().isEmpty()) {
+        TableModel->FetchAll();
     }
 
+    // Write only the recorded cell edits, inserted rows and deleted rows
+    bool success = Worker->ApplyTableChanges(CurrentTableName, TableModel->GetChangeJournal());
+
     if (success) {
-        // Save changes to file
-        if (Worker->SaveXMLFile()) {
-            QMessageBox::information(this, "Success", "Changes saved successfully to XML file.");
-
-            // Reset all modes and reload data
-            ResetToggleButtons();
-            LoadTableData();
-            HasUnsavedChanges = false;
+        // The model table now matches the worker table, no reload needed
+        TableModel->CommitChanges();
+        ResetToggleButtons();
+        HasUnsavedChanges = true;  // Until the background save reports success
+
+        // Write a snapshot of the worker in the background and keep editing meanwhile
+        if (Saver->Start()) {
+            IsSaving = true;
+            UpdateButton->setEnabled(false);
         } else {
             QMessageBox::critical(this, "Error", "Failed to save changes to XML file.");
         }
@@ -373,22 +691,34 @@ void MainWindow::OnUpdateButtonClicked()
 /**
  * @brief Handle row double-click for deletion in delete mode
  */
-void MainWindow::OnRowDoubleClicked(int row, int column)
+void MainWindow::OnRowDoubleClicked(const QModelIndex &index)
 {
-    Q_UNUSED(column)  // Column parameter not needed for row deletion
+    int row = FilterModel->mapToSource(index).row();  // Table row that was double-clicked (-1 if index is invalid)
 
     if (IsDeleteMode && row >= 0) {
+        // Double-clicking one of several selected rows deletes the whole selection at once
+        QList<int> _rows;  // Table rows to delete
+        for (const QModelIndex &_selectedIndex : DataTable->selectionModel()->selectedRows()) {  // Selected row in the view
+            _rows.append(FilterModel->mapToSource(_selectedIndex).row());
+        }
+        if (!_rows.contains(row)) {
+            _rows = QList<int>() << row;
+        }
+
+        const QString _question = _rows.size() == 1  // Confirmation text for the rows being deleted
+            ? QString("Are you sure you want to delete row %1?").arg(row + 1)
+            : QString("Are you sure you want to delete the %1 selected rows?").arg(_rows.size());
         int _result = QMessageBox::question(  // Dialog result: QMessageBox::Yes or QMessageBox::No
-            this, 
+            this,
             "Confirm Deletion",
-            QString("Are you sure you want to delete row %1?").arg(row + 1),
+            _question,
             QMessageBox::Yes | QMessageBox::No
         );
 
         if (_result == QMessageBox::Yes) {
             // Only delete from the displayed table, not from the XML file
             // The actual XML update happens when the Update button is clicked
-            DeleteRow(row);
+            DeleteRows(_rows);
             HasUnsavedChanges = true;  // Mark that changes need to be saved
         }
     }
@@ -440,30 +770,514 @@ void MainWindow::ResetToggleButtons()
  */
 void MainWindow::LoadTableData()
 {
-    if (CurrentTableName.isEmpty() || !Worker->IsFileLoaded()) {
+    if (CurrentTableName.isEmpty() || !Worker->IsTableAvailable(CurrentTableName)) {
         return;
     }
 
-    if (Worker->LoadTableData(CurrentTableName, DataTable)) {
-        DataTable->resizeColumnsToContents();
+    XML_PROFILE_SCOPE("Show table");
+
+    if (Worker->LoadTableData(CurrentTableName, TableModel)) {
+        ResetFilter();
+        SortColumn = -1;  // A sort still running belongs to the previous table and is discarded
+        UpdateSortIndicator();
+        {
+            XML_PROFILE_SCOPE("Resize columns");
+            DataTable->resizeColumnsToContents();
+        }
         HasUnsavedChanges = false;
     } else {
         QMessageBox::warning(this, "Warning", "Failed to load table data.");
     }
 }
 
+/**
+ * @brief Fill the filter and compare key column selections from the displayed table and show all rows
+ */
+void MainWindow::ResetFilter()
+{
+    const QStringList _columnHeaders = TableModel->GetColumnHeaders();  // Columns of the displayed table
+    const bool _hasColumns = !_columnHeaders.isEmpty();  // Flag indicating a table with columns is displayed
+
+    FilterModel->ClearFilter();
+    FilterColumnComboBox->clear();
+    FilterColumnComboBox->addItems(_columnHeaders);
+    FilterValueEdit->clear();
+    FilterUpperEdit->clear();
+
+    FilterColumnComboBox->setEnabled(_hasColumns);
+    FilterTypeComboBox->setEnabled(_hasColumns);
+    FilterValueEdit->setEnabled(_hasColumns);
+    FilterUpperEdit->setEnabled(_hasColumns);
+    ApplyFilterButton->setEnabled(_hasColumns);
+    ClearFilterButton->setEnabled(false);
+    UpdateFilterStatus();
+
+    CompareKeyComboBox->clear();
+    CompareKeyComboBox->addItem("Match whole rows", QString());
+    for (const QString &_columnHeader : _columnHeaders) {  // Column that may identify rows across files
+        CompareKeyComboBox->addItem(QString("Match by %1").arg(_columnHeader), _columnHeader);
+    }
+    UpdateCompareButtons();
+}
+
+/**
+ * @brief Update the filter status text with shown and total row counts
+ */
+void MainWindow::UpdateFilterStatus()
+{
+    if (!FilterModel->IsFilterActive()) {
+        FilterStatusLabel->clear();
+        return;
+    }
+
+    FilterStatusLabel->setText(QString("%1 of %2 rows").arg(FilterModel->rowCount()).arg(TableModel->rowCount()));
+}
+
+/**
+ * @brief Show the latest stage timings in the status bar
+ */
+void MainWindow::UpdateProfileStatus()
+{
+    if (!XMLProfiler::IsEnabled()) {
+        return;
+    }
+
+    const QString _summary = XMLProfiler::GetSummary();  // Latest duration of every stage (empty if nothing recorded)
+    ProfileStatusLabel->setText(_summary.isEmpty() ? "Profiling: nothing recorded yet" : _summary);
+    ProfileStatusLabel->setToolTip(XMLProfiler::GetReport());
+    ExportTraceButton->setEnabled(!_summary.isEmpty());
+}
+
+/**
+ * @brief Turn recording of worker timings on or off
+ */
+void MainWindow::OnProfileToggled(bool enabled)
+{
+    XMLProfiler::SetEnabled(enabled);
+    ProfileButton->setStyleSheet(enabled ? ACTIVE_BUTTON_STYLE : NORMAL_BUTTON_STYLE);
+
+    if (enabled) {
+        XMLProfiler::Reset();  // Start a fresh recording
+        UpdateProfileStatus();
+    } else {
+        ProfileStatusLabel->clear();
+        ProfileStatusLabel->setToolTip(QString());
+    }
+}
+
+/**
+ * @brief Write the recorded timings as a Chrome trace JSON file
+ */
+void MainWindow::OnExportTraceClicked()
+{
+    QString _filePath = QFileDialog::getSaveFileName(  // Path of the trace file (empty if canceled)
+        this,
+        "Export Trace",
+        QDir::homePath() + "/xmltableeditor-trace.json",
+        "Chrome Trace Files (*.json);;All Files (*.*)"
+    );
+
+    if (_filePath.isEmpty()) {
+        return;
+    }
+
+    if (XMLProfiler::ExportChromeTrace(_filePath)) {
+        QMessageBox::information(this, "Success", "Trace written. Open it in chrome://tracing or ui.perfetto.dev.");
+    } else {
+        QMessageBox::critical(this, "Error", "Failed to write trace file.");
+    }
+}
+
+/**
+ * @brief Show only rows of the selected column that match the filter value
+ */
+void MainWindow::OnApplyFilterClicked()
+{
+    const int _column = FilterColumnComboBox->currentIndex();  // Column to filter (-1 if no table displayed)
+    if (_column < 0) {
+        return;
+    }
+
+    const ColumnIndex::QueryType _type = ColumnIndex::QueryType(FilterTypeComboBox->currentData().toInt());  // Kind of filter selected
+    const QString _value = FilterValueEdit->text();  // Filter value, lower bound for ranges
+    const QString _upperValue = _type == ColumnIndex::RangeQuery ? FilterUpperEdit->text() : QString();  // Upper bound for ranges
+
+    if (_type == ColumnIndex::RangeQuery && _value.isEmpty() && _upperValue.isEmpty()) {
+        OnClearFilterClicked();  // An unbounded range matches every row
+        return;
+    }
+
+    {
+        XML_PROFILE_SCOPE("Filter rows");
+        FilterModel->SetMatchingRows(TableModel->FindRows(_column, _type, _value, _upperValue));
+    }
+    ClearFilterButton->setEnabled(true);
+    UpdateFilterStatus();
+    UpdateProfileStatus();
+}
+
+/**
+ * @brief Show all rows of the table again
+ */
+void MainWindow::OnClearFilterClicked()
+{
+    FilterModel->ClearFilter();
+    ClearFilterButton->setEnabled(false);
+    UpdateFilterStatus();
+}
+
+/**
+ * @brief Sort the table by a column in the background when its header is clicked
+ */
+void MainWindow::OnHeaderClicked(int section)
+{
+    // The header has already flipped its indicator, which gives the requested order
+    const Qt::SortOrder _order = DataTable->horizontalHeader()->sortIndicatorOrder();  // Order requested by the click
+
+    if (SortWatcher->isRunning() || section < 0 || section >= TableModel->columnCount()) {
+        UpdateSortIndicator();  // One sort at a time, keep showing the running one
+        return;
+    }
+
+    SortColumn = section;
+    SortDirection = _order;
+
+    // The sorter shares the table and copies only pending values, so editing can go on meanwhile;
+    // it reads rows not fetched yet first, so the revision of its rows is only known afterwards
+    ColumnSorter _sorter = TableModel->CreateSorter(section);  // Sort job for the current view rows
+    SortRevision = TableModel->GetRevision();
+    SortWatcher->setFuture(QtConcurrent::run([_sorter, _order]() mutable {
+        return _sorter.Sort(_order);
+    }));
+    statusBar()->showMessage("Sorting...");
+}
+
+/**
+ * @brief Show the rows in the order computed by the background sort
+ */
+void MainWindow::OnSortFinished()
+{
+    statusBar()->clearMessage();
+
+    if (SortColumn < 0 || !TableModel->ApplyRowOrder(SortWatcher->result(), SortRevision)) {
+        // Rows were added, removed or replaced while sorting, the order no longer fits
+        SortColumn = -1;
+        UpdateSortIndicator();
+        return;
+    }
+
+    UpdateSortIndicator();
+
+    // Reordering drops the filter of the proxy, find the matching rows again at their new positions
+    if (ClearFilterButton->isEnabled()) {
+        OnApplyFilterClicked();
+    }
+    UpdateProfileStatus();
+}
+
+/**
+ * @brief Hand a table the model has read completely back to the worker
+ */
+void MainWindow::OnTableFetched()
+{
+    if (!IsLoading) {
+        Worker->CacheFetchedTable(TableModel->GetTableData());
+    }
+}
+
+/**
+ * @brief Open more XML files in the background to compare the displayed table against
+ */
+void MainWindow::OnOpenCompareFilesClicked()
+{
+    if (WorkspaceWatcher->isRunning()) {
+        return;
+    }
+
+    const QStringList _filePaths = QFileDialog::getOpenFileNames(  // Paths of the selected XML files (empty if canceled)
+        this,
+        "Open Files to Compare",
+        CurrentFilePath.isEmpty() ? QDir::homePath() : QFileInfo(CurrentFilePath).absolutePath(),
+        "XML Files (*.xml);;All Files (*.*)"
+    );
+
+    if (_filePaths.isEmpty()) {
+        return;
+    }
+
+    // The workspace loads the files concurrently on its own pool, this task only waits for them
+    XMLWorkspace *_workspace = Workspace;  // Workspace receiving the files (outlives the task, see destructor)
+    WorkspaceWatcher->setFuture(QtConcurrent::run([_workspace, _filePaths]() {
+        return _workspace->OpenFiles(_filePaths);
+    }));
+    statusBar()->showMessage(QString("Opening %1 file(s) to compare...").arg(_filePaths.size()));
+    UpdateCompareButtons();
+}
+
+/**
+ * @brief List the files of the workspace once the background open has ended
+ */
+void MainWindow::OnCompareFilesOpened()
+{
+    statusBar()->clearMessage();
+
+    const QString _selectedPath = CompareFileComboBox->currentData().toString();  // Previously selected file (empty if none)
+    CompareFileComboBox->clear();
+    for (const QString &_filePath : Workspace->GetFilePaths()) {  // Workspace file in the order it was opened
+        CompareFileComboBox->addItem(QFileInfo(_filePath).fileName(), _filePath);
+        CompareFileComboBox->setItemData(CompareFileComboBox->count() - 1, _filePath, Qt::ToolTipRole);
+    }
+
+    // Newly opened files are usually what the user wants to compare against next
+    const int _selectedIndex = _selectedPath.isEmpty() ? CompareFileComboBox->count() - 1 : CompareFileComboBox->findData(_selectedPath);  // Item to select
+    CompareFileComboBox->setCurrentIndex(_selectedIndex);
+    UpdateCompareButtons();
+    UpdateProfileStatus();
+
+    if (!WorkspaceWatcher->result()) {
+        QMessageBox::warning(this, "Warning", "Some files could not be opened. Please check if they are valid XML files.");
+    }
+}
+
+/**
+ * @brief Compare the displayed table with the table of the same name in the selected file, in the background
+ */
+void MainWindow::OnCompareClicked()
+{
+    XMLWorker *_otherWorker = Workspace->GetWorker(CompareFileComboBox->currentIndex());  // Worker holding the compared file (nullptr if none selected)
+    if (!_otherWorker || CurrentTableName.isEmpty() || IsLoading || WorkspaceWatcher->isRunning() || DiffWatcher->isRunning()) {
+        return;
+    }
+
+    // Both sides are the committed tables, copies that share their storage with the workers
+    TableData _leftTable;   // Displayed table as last saved to the worker
+    TableData _rightTable;  // Table of the same name in the compared file
+    if (!Worker->GetTable(CurrentTableName, &_leftTable)) {
+        QMessageBox::warning(this, "Warning", "Failed to load table data.");
+        return;
+    }
+    if (!_otherWorker->GetTable(CurrentTableName, &_rightTable)) {
+        QMessageBox::warning(this, "Warning", QString("Table '%1' not found in %2.").arg(CurrentTableName, CompareFileComboBox->currentText()));
+        return;
+    }
+
+    const QString _keyColumnName = CompareKeyComboBox->currentData().toString();  // Column matching rows (empty to match whole rows)
+    if (!_keyColumnName.isEmpty() && !_rightTable.GetColumnHeaders().contains(_keyColumnName)) {
+        QMessageBox::warning(this, "Warning", QString("Column '%1' not found in %2.").arg(_keyColumnName, CompareFileComboBox->currentText()));
+        return;
+    }
+
+    DiffTitle = QString("%1: %2 against %3").arg(CurrentTableName, QFileInfo(CurrentFilePath).fileName(), CompareFileComboBox->currentText());
+    DiffIgnoresPendingChanges = TableModel->HasPendingChanges();
+    DiffWatcher->setFuture(QtConcurrent::run([_leftTable, _rightTable, _keyColumnName]() {
+        TableDiff _diff(_leftTable, _rightTable, _keyColumnName);  // Comparison of both versions
+        _diff.Compare();  // The key column was checked above, so this cannot fail
+        return _diff;
+    }));
+    statusBar()->showMessage("Comparing...");
+    UpdateCompareButtons();
+}
+
+/**
+ * @brief Show the differences found by the background comparison
+ */
+void MainWindow::OnCompareFinished()
+{
+    statusBar()->clearMessage();
+    UpdateCompareButtons();
+    UpdateProfileStatus();
+
+    const TableDiff _diff = DiffWatcher->result();  // Differences of the finished comparison
+    QString _summary = QString("%1 removed, %2 changed, %3 added, %4 unchanged rows")  // Counts shown above the differences
+        .arg(_diff.GetChangeCount(TableDiff::RemovedRow))
+        .arg(_diff.GetChangeCount(TableDiff::ChangedRow))
+        .arg(_diff.GetChangeCount(TableDiff::AddedRow))
+        .arg(_diff.GetUnchangedRowCount());
+    if (!_diff.GetLeftOnlyColumns().isEmpty()) {
+        _summary += "\nColumns only in this file (not compared): " + _diff.GetLeftOnlyColumns().join(", ");
+    }
+    if (!_diff.GetRightOnlyColumns().isEmpty()) {
+        _summary += "\nColumns only in the other file (not compared): " + _diff.GetRightOnlyColumns().join(", ");
+    }
+    if (DiffIgnoresPendingChanges) {
+        _summary += "\nUnsaved changes of this table are not included.";
+    }
+
+    // The differences are shown as a read-only table next to the main window
+    QDialog *_dialog = new QDialog(this);  // Non-modal window deleted when closed
+    _dialog->setAttribute(Qt::WA_DeleteOnClose);
+    _dialog->setWindowTitle(DiffTitle);
+    QVBoxLayout *_layout = new QVBoxLayout(_dialog);  // Summary above the differences
+    QLabel *_summaryLabel = new QLabel(_summary, _dialog);  // Row counts and skipped columns
+    XMLTableModel *_diffModel = new XMLTableModel(_dialog);  // Model serving the differences
+    QTableView *_diffTable = new QTableView(_dialog);  // View of the differences
+
+    _diffModel->SetTableData(_diff.CreateResultTable());
+    _diffTable->setModel(_diffModel);
+    _diffTable->setAlternatingRowColors(true);
+    _diffTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    _diffTable->horizontalHeader()->setStretchLastSection(true);
+    _diffTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    _diffTable->resizeColumnsToContents();
+
+    _layout->addWidget(_summaryLabel);
+    _layout->addWidget(_diffTable, 1);  // Differences get most space
+    _dialog->resize(1000, 600);
+    _dialog->show();
+}
+
+/**
+ * @brief Read rows from a CSV or TSV file into the displayed table
+ */
+void MainWindow::OnImportClicked()
+{
+    if (CurrentTableName.isEmpty() || IsLoading) {
+        return;
+    }
+
+    if (IsSaving) {
+        QMessageBox::information(this, "Info", "Please wait until the changes are saved.");
+        return;
+    }
+
+    if (TableModel->HasPendingChanges()) {
+        QMessageBox::information(this, "Info", "Please update or cancel the pending changes before importing.");
+        return;
+    }
+
+    QString _filePath = QFileDialog::getOpenFileName(  // Path of the delimited file (empty if canceled)
+        this,
+        "Import Rows",
+        CurrentFilePath.isEmpty() ? QDir::homePath() : QFileInfo(CurrentFilePath).absolutePath(),
+        "Delimited Files (*.csv *.tsv *.txt);;All Files (*.*)"
+    );
+
+    if (_filePath.isEmpty()) {
+        return;
+    }
+
+    // Rows are matched to the table columns by the header line of the file
+    QMessageBox _modeBox(QMessageBox::Question, "Import Rows",  // Choice between appending and replacing
+                         QString("Append the rows of %1 to table '%2' or replace its rows?").arg(QFileInfo(_filePath).fileName(), CurrentTableName),
+                         QMessageBox::Cancel, this);
+    QPushButton *_appendButton = _modeBox.addButton("Append Rows", QMessageBox::AcceptRole);  // Keep the existing rows
+    QPushButton *_replaceButton = _modeBox.addButton("Replace Rows", QMessageBox::DestructiveRole);  // Drop the existing rows
+    _modeBox.exec();
+    if (_modeBox.clickedButton() != _appendButton && _modeBox.clickedButton() != _replaceButton) {
+        return;
+    }
+
+    // Parsing runs on all cores, but the worker belongs to this thread, so the window waits for it
+    DelimitedFile _file(DelimitedFile::GetDefaultDelimiter(_filePath));  // Importer for the chosen file
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool _imported = _file.ImportTable(Worker, CurrentTableName, _filePath,  // Flag indicating the rows were imported
+                                            _modeBox.clickedButton() == _replaceButton ? DelimitedFile::ReplaceRows : DelimitedFile::AppendRows);
+    QApplication::restoreOverrideCursor();
+    UpdateProfileStatus();
+
+    if (!_imported) {
+        QMessageBox::critical(this, "Error", QString("Failed to import rows: %1.").arg(_file.GetErrorString()));
+        return;
+    }
+
+    // The worker holds the imported rows, they are written to the file by the next update
+    LoadTableData();
+    HasUnsavedChanges = true;
+    QMessageBox::information(this, "Success", QString("Imported %1 rows. Click Update XML to save them.").arg(_file.GetRecordCount()));
+}
+
+/**
+ * @brief Write the displayed table as a CSV or TSV file in the background
+ */
+void MainWindow::OnExportClicked()
+{
+    if (CurrentTableName.isEmpty() || IsLoading || ExportWatcher->isRunning()) {
+        return;
+    }
+
+    QString _filePath = QFileDialog::getSaveFileName(  // Path of the delimited file (empty if canceled)
+        this,
+        "Export Rows",
+        (CurrentFilePath.isEmpty() ? QDir::homePath() : QFileInfo(CurrentFilePath).absolutePath()) + "/" + CurrentTableName + ".csv",
+        "CSV Files (*.csv);;TSV Files (*.tsv);;All Files (*.*)"
+    );
+
+    if (_filePath.isEmpty()) {
+        return;
+    }
+
+    // The committed table is written from a copy that shares its storage with the model
+    TableModel->FetchAll();
+    const TableData _table = TableModel->GetTableData();  // Rows to write
+    ExportMessage = QString("Exported %1 rows to %2.").arg(_table.GetRowCount()).arg(QFileInfo(_filePath).fileName());
+    if (TableModel->HasPendingChanges()) {
+        ExportMessage += "\nUnsaved changes of this table are not included.";
+    }
+
+    ExportWatcher->setFuture(QtConcurrent::run([_table, _filePath]() {
+        DelimitedFile _file(DelimitedFile::GetDefaultDelimiter(_filePath));  // Exporter for the chosen file
+        return _file.WriteFile(_table, _filePath);
+    }));
+    ExportButton->setEnabled(false);
+    statusBar()->showMessage("Exporting...");
+}
+
+/**
+ * @brief Report the result once the background export has ended
+ */
+void MainWindow::OnExportFinished()
+{
+    statusBar()->clearMessage();
+    ExportButton->setEnabled(!CurrentTableName.isEmpty() && !IsLoading);
+    UpdateProfileStatus();
+
+    if (ExportWatcher->result()) {
+        QMessageBox::information(this, "Success", ExportMessage);
+    } else {
+        QMessageBox::critical(this, "Error", "Failed to write the exported file.");
+    }
+}
+
+/**
+ * @brief Enable the compare controls while no workspace open or comparison is running
+ */
+void MainWindow::UpdateCompareButtons()
+{
+    const bool _opening = WorkspaceWatcher->isRunning();  // Flag indicating files are being opened into the workspace
+    const bool _hasFiles = CompareFileComboBox->count() > 0;  // Flag indicating there is a file to compare against
+
+    OpenCompareButton->setEnabled(!_opening);
+    CompareFileComboBox->setEnabled(!_opening && _hasFiles);
+    CompareKeyComboBox->setEnabled(!CurrentTableName.isEmpty());
+    CompareButton->setEnabled(!_opening && _hasFiles && !CurrentTableName.isEmpty() && !IsLoading && !DiffWatcher->isRunning());
+}
+
+/**
+ * @brief Show the sort indicator of the requested sort, or none
+ */
+void MainWindow::UpdateSortIndicator()
+{
+    DataTable->horizontalHeader()->setSortIndicator(SortColumn, SortDirection);
+}
+
+/**
+ * @brief Show the upper bound field only for range filters
+ */
+void MainWindow::OnFilterTypeChanged()
+{
+    const bool _isRange = FilterTypeComboBox->currentData().toInt() == ColumnIndex::RangeQuery;  // Flag indicating a range filter is selected
+    FilterUpperEdit->setVisible(_isRange);
+    FilterValueEdit->setPlaceholderText(_isRange ? "Lower bound" : "Value");
+}
+
 /**
  * @brief Add new empty row to the bottom of the table
  */
 void MainWindow::AddNewRow()
 {
-    int _newRow = DataTable->rowCount();  // Index of the new row to be added (0-based)
-    DataTable->insertRow(_newRow);
-
-    // Fill new row with empty items to make them editable
-    for (int _col = 0; _col < DataTable->columnCount(); ++_col) {  // Loop through columns (0 to columnCount-1)
-        QTableWidgetItem *_item = new QTableWidgetItem("");  // New empty cell item
-        DataTable->setItem(_newRow, _col, _item);
+    // Appended after the last row of the table, also when only some pages are fetched
+    if (TableModel->AppendRow() < 0) {
+        return;
     }
 
     // Enable editing for the new row
@@ -473,12 +1287,12 @@ void MainWindow::AddNewRow()
 }
 
 /**
- * @brief Delete specified row from the table display
+ * @brief Delete specified rows from the table display in one batch
  */
-void MainWindow::DeleteRow(int row)
+void MainWindow::DeleteRows(const QList<int> &rows)
 {
-    if (row >= 0 && row < DataTable->rowCount()) {
-        DataTable->removeRow(row);
+    if (TableModel->RemoveRowSet(rows)) {
+        DataTable->clearSelection();
         HasUnsavedChanges = true;
     }
 }
@@ -502,8 +1316,14 @@ void MainWindow::OnCancelButtonClicked()
         // Reset all toggle buttons and modes
         ResetToggleButtons();
         
-        // Reload the data from the original XML file
-        LoadTableData();
+        // Undo every pending change, the committed table already matches the worker so nothing is reloaded
+        TableModel->DiscardChanges();
+
+        // Resetting the model drops the filter of the proxy, find the matching rows of the restored table again
+        if (ClearFilterButton->isEnabled()) {
+            OnApplyFilterClicked();
+        }
+        UpdateFilterStatus();
         
         // Reset unsaved changes flag
         HasUnsavedChanges = false;
@@ -512,6 +1332,37 @@ void MainWindow::OnCancelButtonClicked()
     }
 }
 
+/**
+ * @brief Revert the last pending change
+ */
+void MainWindow::OnUndoButtonClicked()
+{
+    if (TableModel->Undo()) {
+        HasUnsavedChanges = true;
+    }
+}
+
+/**
+ * @brief Apply the last undone change again
+ */
+void MainWindow::OnRedoButtonClicked()
+{
+    if (TableModel->Redo()) {
+        HasUnsavedChanges = true;
+    }
+}
+
+/**
+ * @brief Enable the undo and redo buttons and describe their next step
+ */
+void MainWindow::UpdateUndoButtons()
+{
+    UndoButton->setEnabled(TableModel->CanUndo());
+    RedoButton->setEnabled(TableModel->CanRedo());
+    UndoButton->setToolTip(TableModel->CanUndo() ? QString("Undo %1").arg(TableModel->GetUndoText()) : QString());
+    RedoButton->setToolTip(TableModel->CanRedo() ? QString("Redo %1").arg(TableModel->GetRedoText()) : QString());
+}
+
 /**
  * @brief Enable table cell editing mode
  */
@@ -2,7 +2,8 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTableWidget>
+#include <QApplication>
+#include <QTableView>
 #include <QComboBox>
 #include <QPushButton>
 #include <QVBoxLayout>
@@ -11,7 +12,19 @@
 #include <QMessageBox>
 #include <QHeaderView>
 #include <QLabel>
+#include <QProgressBar>
+#include <QLineEdit>
+#include <QStatusBar>
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 #include "xmlworker.h"
+#include "xmlloader.h"
+#include "xmlsaver.h"
+#include "xmlfilterproxymodel.h"
+#include "xmlworkspace.h"
+#include "tablediff.h"
+#include "delimitedfile.h"
 
 QT_BEGIN_NAMESPACE
 QT_END_NAMESPACE
@@ -47,11 +60,57 @@ private slots:
      */
     void OnLoadFileClicked();
 
+    /**
+     * @brief Handle cancel loading button click
+     */
+    void OnCancelLoadClicked();
+
+    /**
+     * @brief Update progress bar while the background load runs
+     * @param bytesRead Number of bytes consumed so far
+     * @param totalBytes Size of the file in bytes
+     */
+    void OnLoadProgressChanged(qint64 bytesRead, qint64 totalBytes);
+
+    /**
+     * @brief Add a table to the selection as soon as the loader has parsed it
+     * @param tableName Name of the parsed table
+     */
+    void OnTableFound(const QString &tableName);
+
+    /**
+     * @brief Restore UI state once the background load has ended
+     * @param success true if the file was loaded completely
+     * @param cancelled true if the user cancelled the load
+     */
+    void OnLoadFinished(bool success, bool cancelled);
+
+    /**
+     * @brief Report the result once the background save has ended
+     * @param success true if the file was written
+     */
+    void OnSaveFinished(bool success);
+
     /**
      * @brief Handle table selection change in combo box
      */
     void OnTableSelectionChanged();
 
+    /**
+     * @brief Show only rows of the selected column that match the filter value
+     */
+    void OnApplyFilterClicked();
+
+    /**
+     * @brief Show all rows of the table again
+     */
+    void OnClearFilterClicked();
+
+    /**
+     * @brief Show the upper bound field only for range filters
+     */
+    void OnFilterTypeChanged();
+
     /**
      * @brief Handle add button toggle
      */
@@ -77,10 +136,88 @@ private slots:
      */
     void OnCancelButtonClicked();
 
+    /**
+     * @brief Revert the last pending change
+     */
+    void OnUndoButtonClicked();
+
+    /**
+     * @brief Apply the last undone change again
+     */
+    void OnRedoButtonClicked();
+
+    /**
+     * @brief Enable the undo and redo buttons and describe their next step
+     */
+    void UpdateUndoButtons();
+
     /**
      * @brief Handle row double click for deletion
+     * @param index Model index of the double-clicked cell
      */
-    void OnRowDoubleClicked(int row, int column);
+    void OnRowDoubleClicked(const QModelIndex &index);
+
+    /**
+     * @brief Sort the table by a column in the background when its header is clicked
+     * @param section Column index (0-based) of the clicked header
+     */
+    void OnHeaderClicked(int section);
+
+    /**
+     * @brief Show the rows in the order computed by the background sort
+     */
+    void OnSortFinished();
+
+    /**
+     * @brief Hand a table the model has read completely back to the worker, so it is not parsed again
+     */
+    void OnTableFetched();
+
+    /**
+     * @brief Open more XML files in the background to compare the displayed table against
+     */
+    void OnOpenCompareFilesClicked();
+
+    /**
+     * @brief List the files of the workspace once the background open has ended
+     */
+    void OnCompareFilesOpened();
+
+    /**
+     * @brief Compare the displayed table with the table of the same name in the selected file, in the background
+     */
+    void OnCompareClicked();
+
+    /**
+     * @brief Show the differences found by the background comparison
+     */
+    void OnCompareFinished();
+
+    /**
+     * @brief Read rows from a CSV or TSV file into the displayed table
+     */
+    void OnImportClicked();
+
+    /**
+     * @brief Write the displayed table as a CSV or TSV file in the background
+     */
+    void OnExportClicked();
+
+    /**
+     * @brief Report the result once the background export has ended
+     */
+    void OnExportFinished();
+
+    /**
+     * @brief Turn recording of worker timings on or off
+     * @param enabled true to record timings, false to stop recording
+     */
+    void OnProfileToggled(bool enabled);
+
+    /**
+     * @brief Write the recorded timings as a Chrome trace JSON file
+     */
+    void OnExportTraceClicked();
 
 private:
     /**
@@ -108,15 +245,41 @@ private:
      */
     void LoadTableData();
 
+    /**
+     * @brief Fill the filter and compare key column selections from the displayed table and show all rows
+     */
+    void ResetFilter();
+
+    /**
+     * @brief Update the filter status text with shown and total row counts
+     */
+    void UpdateFilterStatus();
+
+    /**
+     * @brief Show the latest stage timings in the status bar
+     */
+    void UpdateProfileStatus();
+
+    /**
+     * @brief Show the sort indicator of the requested sort, or none
+     */
+    void UpdateSortIndicator();
+
+    /**
+     * @brief Enable the compare controls while no workspace open or comparison is running
+     */
+    void UpdateCompareButtons();
+
     /**
      * @brief Add new empty row to the table
      */
     void AddNewRow();
 
     /**
-     * @brief Delete specified row from table
+     * @brief Delete specified rows from table in one batch
+     * @param rows Table rows to delete (0-based)
      */
-    void DeleteRow(int row);
+    void DeleteRows(const QList<int> &rows);
 
     /**
      * @brief Enable table editing mode
@@ -133,31 +296,75 @@ private:
     QVBoxLayout *MainLayout;             // Main vertical layout for organizing UI elements
     QHBoxLayout *FileLayout;             // Layout for file operation controls
     QHBoxLayout *TableLayout;            // Layout for table selection controls
+    QHBoxLayout *FilterLayout;           // Layout for row filter controls
+    QHBoxLayout *CompareLayout;          // Layout for table comparison controls
     QHBoxLayout *ButtonLayout;           // Layout for action button controls
 
     QPushButton *ChooseFileButton;       // Button to choose XML file from filesystem
     QPushButton *LoadFileButton;         // Button to load the selected XML file
     QLabel *FilePathLabel;               // Label showing current file path (empty if no file selected)
+    QProgressBar *LoadProgressBar;       // Progress of the background load (hidden when idle)
+    QPushButton *CancelLoadButton;       // Button to abort the background load (hidden when idle)
 
     QComboBox *TableComboBox;            // Dropdown for table selection (empty until file loaded)
     QLabel *TableLabel;                  // Label for table selection section
 
+    QLabel *FilterLabel;                 // Label for row filter section
+    QComboBox *FilterColumnComboBox;     // Column the filter is applied to (empty until table loaded)
+    QComboBox *FilterTypeComboBox;       // Kind of filter: equals, starts with or between
+    QLineEdit *FilterValueEdit;          // Filter value, lower bound for range filters
+    QLineEdit *FilterUpperEdit;          // Upper bound for range filters (hidden for other kinds)
+    QPushButton *ApplyFilterButton;      // Button to apply the filter
+    QPushButton *ClearFilterButton;      // Button to show all rows again
+    QLabel *FilterStatusLabel;           // Number of shown rows while a filter is active (empty otherwise)
+
+    QLabel *CompareLabel;                // Label for table comparison section
+    QComboBox *CompareFileComboBox;      // Workspace file to compare against, path as item data (empty until files are opened)
+    QComboBox *CompareKeyComboBox;       // Column matching rows across files, name as item data (empty data to match whole rows)
+    QPushButton *OpenCompareButton;      // Button to open files into the workspace
+    QPushButton *CompareButton;          // Button to compare the displayed table
+
     QPushButton *AddButton;              // Toggle button for adding rows (green when active)
     QPushButton *DeleteButton;           // Toggle button for deleting rows (green when active)
     QPushButton *EditButton;             // Toggle button for editing cells (green when active)
     QPushButton *UpdateButton;           // Button to save changes to the XML file
     QPushButton *CancelButton;           // Button to discard all pending changes
+    QPushButton *UndoButton;             // Button to revert the last pending change (disabled if none)
+    QPushButton *RedoButton;             // Button to apply the last undone change again (disabled if none)
+    QPushButton *ImportButton;           // Button to read rows from a delimited file into the table
+    QPushButton *ExportButton;           // Button to write the table as a delimited file
+
+    QLabel *ProfileStatusLabel;          // Latest stage timings in the status bar (empty while profiling is off)
+    QPushButton *ProfileButton;          // Toggle button for recording worker timings
+    QPushButton *ExportTraceButton;      // Button to write the recorded timings as a trace file
 
-    QTableWidget *DataTable;             // Main data display table for XML content
+    QTableView *DataTable;               // Main data display view for XML content
+    XMLTableModel *TableModel;           // Model serving the selected table to DataTable
+    XMLFilterProxyModel *FilterModel;    // Proxy between TableModel and DataTable showing only matching rows
 
     // State variables
     XMLWorker *Worker;                   // Worker object for XML operations
+    XMLLoader *Loader;                   // Runs Worker loads on a background thread
+    XMLSaver *Saver;                     // Writes Worker snapshots on a background thread
+    XMLWorkspace *Workspace;             // Files opened to compare against, sharing one string pool
+    QFutureWatcher<bool> *WorkspaceWatcher;  // Reports the end of the background workspace open
+    QFutureWatcher<TableDiff> *DiffWatcher;  // Reports the differences of the background comparison
+    QString DiffTitle;                   // Table and files of the running comparison
+    bool DiffIgnoresPendingChanges;      // Flag indicating the compared table had unsaved changes (true) or not (false)
+    QFutureWatcher<bool> *ExportWatcher; // Reports the end of the background export
+    QString ExportMessage;               // Result text of the running export
+    QFutureWatcher<QVector<int>> *SortWatcher;  // Reports the row order of the background sort
     QString CurrentFilePath;             // Path to currently loaded XML file (empty if none loaded)
     QString CurrentTableName;            // Name of currently selected table (empty if none selected)
     bool IsAddMode;                      // Flag indicating add mode is active (true) or inactive (false)
     bool IsDeleteMode;                   // Flag indicating delete mode is active (true) or inactive (false)
     bool IsEditMode;                     // Flag indicating edit mode is active (true) or inactive (false)
     bool HasUnsavedChanges;              // Flag indicating pending changes (true) or no changes (false)
+    bool IsLoading;                      // Flag indicating a background load is running (true) or not (false)
+    bool IsSaving;                       // Flag indicating a background save is running (true) or not (false)
+    int SortColumn;                      // Column the rows are sorted or being sorted by (-1 if unsorted)
+    Qt::SortOrder SortDirection;         // Order of the requested sort (only used while SortColumn >= 0)
+    quint64 SortRevision;                // Model revision the running sort was started at
 
     // Constants
     static const QString NORMAL_BUTTON_STYLE;  // Default button style
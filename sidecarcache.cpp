@@ -0,0 +1,198 @@
+#include "sidecarcache.h"
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDebug>
+#include "xmlprofiler.h"
+
+const QString SidecarCache::SIDECAR_SUFFIX = ".xtcache";   // Sidecar file name suffix
+const quint32 SidecarCache::MAGIC = 0x58544331;            // "XTC1"
+const quint32 SidecarCache::FORMAT_VERSION = 2;            // Current sidecar layout (2 adds typed columns)
+const int SidecarCache::SAMPLE_COUNT = 16;                 // Hashed blocks per file
+const int SidecarCache::SAMPLE_SIZE = 65536;               // Bytes per hashed block
+
+/**
+ * @brief Get path of the sidecar belonging to an XML file
+ */
+QString SidecarCache::GetSidecarPath(const QString &filePath)
+{
+    return filePath + SIDECAR_SUFFIX;
+}
+
+/**
+ * @brief Write the sidecar of an XML file from the store parsed from it
+ */
+bool SidecarCache::Write(const QString &filePath, const TableStore &store)
+{
+    XML_PROFILE_SCOPE("Write sidecar");
+
+    QFile _xmlFile(filePath);  // XML file the sidecar describes
+    QByteArray _fingerprint;   // Hash of size and sampled content
+    if (!_xmlFile.open(QIODevice::ReadOnly) || !ComputeFingerprint(_xmlFile, &_fingerprint)) {
+        qDebug() << "Error: Cannot read" << filePath << "for its sidecar";
+        return false;
+    }
+    const QFileInfo _fileInfo(_xmlFile);  // Size and modification time of the XML file
+    _xmlFile.close();
+
+    const QString _sidecarPath = GetSidecarPath(filePath);  // File written
+    QSaveFile _sidecarFile(_sidecarPath);  // Sidecar, replaced only once fully written
+    if (!_sidecarFile.open(QIODevice::WriteOnly)) {
+        qDebug() << "Warning: Cannot write sidecar" << _sidecarPath;
+        return false;
+    }
+
+    QDataStream _stream(&_sidecarFile);  // Binary writer over the sidecar
+    _stream.setVersion(QDataStream::Qt_5_15);
+
+    // Column arrays are written in native byte order, a reader with another byte order ignores the file
+    _stream << MAGIC << FORMAT_VERSION << quint8(Q_BYTE_ORDER == Q_LITTLE_ENDIAN)
+            << qint64(_fileInfo.size()) << qint64(_fileInfo.lastModified().toMSecsSinceEpoch()) << _fingerprint;
+
+    const QXmlStreamAttributes _rootAttributes = store.GetRootAttributes();  // Attributes written back on save
+    _stream << store.GetRootName() << qint32(_rootAttributes.size());
+    for (const QXmlStreamAttribute &_attribute : _rootAttributes) {  // Current root attribute
+        _stream << _attribute.namespaceUri().toString() << _attribute.qualifiedName().toString() << _attribute.value().toString();
+    }
+
+    const QList<QSharedPointer<TableData>> _tables = store.GetTables();  // Tables in document order
+    _stream << qint32(_tables.size());
+    for (const QSharedPointer<TableData> &_table : _tables) {  // Current table
+        _table->WriteSnapshot(_stream);
+    }
+
+    if (_stream.status() != QDataStream::Ok || !_sidecarFile.commit()) {
+        qDebug() << "Warning: Failed to write sidecar" << _sidecarPath << ":" << _sidecarFile.errorString();
+        return false;
+    }
+
+    XML_PROFILE_COUNT("Sidecar bytes written", QFileInfo(_sidecarPath).size());
+    qDebug() << "Wrote sidecar" << _sidecarPath << "with" << _tables.size() << "tables";
+    return true;
+}
+
+/**
+ * @brief Fill a table store from the sidecar of an XML file
+ */
+bool SidecarCache::Read(const QString &filePath, TableStore *store)
+{
+    XML_PROFILE_SCOPE("Read sidecar");
+
+    QFile _sidecarFile(GetSidecarPath(filePath));  // Sidecar to read (may not exist)
+    if (!store || !_sidecarFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Read through a mapping so the column arrays are copied straight out of the page cache
+    const qint64 _sidecarSize = _sidecarFile.size();  // Bytes in the sidecar
+    uchar *_mapping = _sidecarSize > 0 ? _sidecarFile.map(0, _sidecarSize) : nullptr;  // Mapped sidecar (nullptr if mapping failed)
+    QByteArray _sidecarData = _mapping ? QByteArray::fromRawData(reinterpret_cast<const char *>(_mapping), qsizetype(_sidecarSize))
+                                       : _sidecarFile.readAll();  // Sidecar content
+    QBuffer _sidecarBuffer(&_sidecarData);  // Device over the sidecar content
+    _sidecarBuffer.open(QIODevice::ReadOnly);
+
+    QDataStream _stream(&_sidecarBuffer);  // Binary reader over the sidecar
+    _stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 _magic = 0;          // File type marker
+    quint32 _version = 0;        // Layout version
+    quint8 _littleEndian = 0;    // Byte order of the column arrays
+    qint64 _fileSize = 0;        // XML file size when the sidecar was written
+    qint64 _modified = 0;        // XML modification time when the sidecar was written
+    QByteArray _fingerprint;     // XML fingerprint when the sidecar was written
+    _stream >> _magic >> _version >> _littleEndian >> _fileSize >> _modified >> _fingerprint;
+
+    if (_stream.status() != QDataStream::Ok || _magic != MAGIC || _version != FORMAT_VERSION
+        || _littleEndian != quint8(Q_BYTE_ORDER == Q_LITTLE_ENDIAN)) {
+        qDebug() << "Ignoring sidecar of" << filePath << ": unknown format";
+        return false;
+    }
+
+    // Size and time are checked first, the fingerprint only reads a few blocks of a matching file
+    QFile _xmlFile(filePath);  // XML file the sidecar must describe
+    const QFileInfo _fileInfo(filePath);  // Current size and modification time
+    QByteArray _currentFingerprint;  // Current hash of size and sampled content
+    if (_fileInfo.size() != _fileSize || _fileInfo.lastModified().toMSecsSinceEpoch() != _modified
+        || !_xmlFile.open(QIODevice::ReadOnly) || !ComputeFingerprint(_xmlFile, &_currentFingerprint)
+        || _currentFingerprint != _fingerprint) {
+        qDebug() << "Ignoring sidecar of" << filePath << ": file changed";
+        return false;
+    }
+
+    QString _rootName;         // Root element tag name
+    qint32 _attributeCount = 0;  // Number of root attributes
+    _stream >> _rootName >> _attributeCount;
+
+    QXmlStreamAttributes _rootAttributes;  // Root element attributes
+    for (int _i = 0; _i < _attributeCount && _stream.status() == QDataStream::Ok; ++_i) {  // Position of the attribute
+        QString _namespaceUri;    // Namespace of the attribute (empty if none)
+        QString _qualifiedName;   // Attribute name including its prefix
+        QString _value;           // Attribute value
+        _stream >> _namespaceUri >> _qualifiedName >> _value;
+        if (_namespaceUri.isEmpty()) {
+            _rootAttributes.append(_qualifiedName, _value);
+        } else {
+            _rootAttributes.append(_namespaceUri, _qualifiedName.mid(_qualifiedName.indexOf(':') + 1), _value);
+        }
+    }
+
+    store->Clear();
+    store->SetRootElement(_rootName, _rootAttributes);
+
+    qint32 _tableCount = 0;  // Number of tables
+    _stream >> _tableCount;
+    for (int _i = 0; _i < _tableCount && _stream.status() == QDataStream::Ok; ++_i) {  // Position of the table
+        QSharedPointer<TableData> _table(new TableData(QString(), store->GetStringPool()));  // Table sharing the store pool
+        if (!_table->ReadSnapshot(_stream)) {
+            break;
+        }
+        store->AddTable(_table);
+    }
+
+    if (_stream.status() != QDataStream::Ok || store->GetTables().size() != _tableCount) {
+        qDebug() << "Ignoring sidecar of" << filePath << ": damaged";
+        store->Clear();
+        return false;
+    }
+
+    qDebug() << "Read" << _tableCount << "tables from sidecar of" << filePath;
+    return true;
+}
+
+/**
+ * @brief Compute the cache key of an XML file
+ */
+bool SidecarCache::ComputeFingerprint(QFile &file, QByteArray *fingerprint)
+{
+    // Hashing a few evenly spaced blocks keeps the check independent of the file size;
+    // together with size and modification time it catches rewrites that keep both
+    QCryptographicHash _hash(QCryptographicHash::Sha1);  // Hash over size and sampled blocks
+    const qint64 _fileSize = file.size();  // Bytes in the file
+    _hash.addData(QByteArray::number(_fileSize));
+
+    // The last block always ends at the file end, where appended rows and the root end tag are
+    const qint64 _lastStart = qMax<qint64>(0, _fileSize - SAMPLE_SIZE);  // Start of the final block
+    const qint64 _stride = qMax<qint64>(SAMPLE_SIZE, _fileSize / SAMPLE_COUNT);  // Distance between sampled blocks
+    for (qint64 _offset = 0; _offset < _fileSize; _offset += _stride) {  // Start of the current block
+        const qint64 _sampleStart = qMin(_offset, _lastStart);  // Block start, clamped to the final block
+        if (!file.seek(_sampleStart)) {
+            return false;
+        }
+        const QByteArray _sample = file.read(SAMPLE_SIZE);  // Bytes of the current block
+        if (_sample.isEmpty()) {
+            return false;
+        }
+        _hash.addData(_sample);
+
+        if (_sampleStart == _lastStart) {
+            break;
+        }
+        if (_offset + _stride >= _fileSize) {
+            _offset = _lastStart - _stride;  // Sample the final block next
+        }
+    }
+
+    *fingerprint = _hash.result();
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef SIDECARCACHE_H
+#define SIDECARCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include "tablestore.h"
+
+/**
+ * @brief Binary copy of a parsed table store kept next to its XML file
+ * The sidecar holds the root element and the columnar storage of every table,
+ * so reopening an unchanged file fills the table store without parsing XML.
+ * It is keyed by the XML file size, modification time and a content fingerprint;
+ * a sidecar that does not match is ignored and replaced by the next full parse
+ */
+class SidecarCache
+{
+public:
+    /**
+     * @brief Get path of the sidecar belonging to an XML file
+     * @param filePath Path of the XML file
+     * @return Path of the sidecar (the XML path with SIDECAR_SUFFIX appended)
+     */
+    static QString GetSidecarPath(const QString &filePath);
+
+    /**
+     * @brief Write the sidecar of an XML file from the store parsed from it
+     * @param filePath Path of the XML file the store was parsed from or saved to
+     * @param store Table store holding the complete file content
+     * @return true if the sidecar was written, false on error (an older sidecar is kept)
+     */
+    static bool Write(const QString &filePath, const TableStore &store);
+
+    /**
+     * @brief Fill a table store from the sidecar of an XML file
+     * @param filePath Path of the XML file
+     * @param store Empty table store receiving the tables
+     * @return true if an up-to-date sidecar was read, false if there is none, it is stale or it is damaged (the store is cleared)
+     */
+    static bool Read(const QString &filePath, TableStore *store);
+
+private:
+    /**
+     * @brief Compute the cache key of an XML file
+     * @param file XML file opened for reading
+     * @param fingerprint Receives a hash over the file size and sampled content
+     * @return true if the file could be read, false otherwise
+     */
+    static bool ComputeFingerprint(QFile &file, QByteArray *fingerprint);
+
+    static const QString SIDECAR_SUFFIX;     // Appended to the XML path to name the sidecar
+    static const quint32 MAGIC;              // First word of every sidecar
+    static const quint32 FORMAT_VERSION;     // Layout version, older sidecars are ignored
+    static const int SAMPLE_COUNT;           // Blocks of the XML file hashed into the fingerprint
+    static const int SAMPLE_SIZE;            // Bytes per hashed block
+};
+
+#endif // SIDECARCACHE_H
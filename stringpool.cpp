@@ -0,0 +1,69 @@
+#include "stringpool.h"
+
+/**
+ * @brief Constructor registers the empty string as id 0
+ */
+StringPool::StringPool()
+    : Strings()                        // Unique strings
+    , Ids()                            // Reverse lookup
+    , Lock()                           // Container guard
+{
+    Strings.append(QString());
+}
+
+/**
+ * @brief Get id of a value, adding it to the pool if it is new
+ */
+quint32 StringPool::Intern(QStringView value)
+{
+    if (value.isEmpty()) {
+        return 0;
+    }
+
+    {
+        QReadLocker _readLocker(&Lock);  // Shared access for the common already-pooled case
+        auto _iterator = Ids.constFind(value);  // Existing entry for the value (end if new)
+        if (_iterator != Ids.constEnd()) {
+            return _iterator.value();
+        }
+    }
+
+    QWriteLocker _writeLocker(&Lock);  // Exclusive access while adding the value
+    auto _iterator = Ids.constFind(value);  // Entry added by another thread in the meantime (end if still new)
+    if (_iterator != Ids.constEnd()) {
+        return _iterator.value();
+    }
+
+    // Keys view the pooled copy, whose character data never moves once appended
+    const quint32 _id = quint32(Strings.size());  // Id assigned to the new string
+    Strings.append(value.toString());
+    Ids.insert(QStringView(Strings.last()), _id);
+    return _id;
+}
+
+/**
+ * @brief Get pooled string by id
+ */
+QString StringPool::GetString(quint32 id) const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the list
+    return id < quint32(Strings.size()) ? Strings.at(id) : QString();
+}
+
+/**
+ * @brief Get view of a pooled string by id
+ */
+QStringView StringPool::GetView(quint32 id) const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the list
+    return id < quint32(Strings.size()) ? QStringView(Strings.at(id)) : QStringView();
+}
+
+/**
+ * @brief Get number of unique strings in the pool
+ */
+int StringPool::GetSize() const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the list
+    return Strings.size();
+}
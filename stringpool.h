@@ -0,0 +1,56 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+#include <QStringView>
+#include <QList>
+#include <QHash>
+#include <QReadWriteLock>
+
+/**
+ * @brief Append-only pool of unique strings addressed by 32-bit ids
+ * Repeated values are stored once; id 0 is always the empty string.
+ * Safe for concurrent interning and reading from several threads
+ */
+class StringPool
+{
+public:
+    /**
+     * @brief Constructor for StringPool
+     */
+    StringPool();
+
+    /**
+     * @brief Get id of a value, adding it to the pool if it is new
+     * @param value Text to intern
+     * @return Id of the pooled string
+     */
+    quint32 Intern(QStringView value);
+
+    /**
+     * @brief Get pooled string by id
+     * @param id Id returned by Intern
+     * @return QString sharing the pooled data, empty if id is unknown
+     */
+    QString GetString(quint32 id) const;
+
+    /**
+     * @brief Get view of a pooled string by id
+     * @param id Id returned by Intern
+     * @return QStringView valid for the lifetime of the pool
+     */
+    QStringView GetView(quint32 id) const;
+
+    /**
+     * @brief Get number of unique strings in the pool
+     * @return String count including the empty string
+     */
+    int GetSize() const;
+
+private:
+    QList<QString> Strings;              // Unique strings indexed by id (entry 0 is the empty string)
+    QHash<QStringView, quint32> Ids;     // Views into Strings mapped to their id
+    mutable QReadWriteLock Lock;         // Guards Strings and Ids
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,106 @@
+#include "tablecache.h"
+
+/**
+ * @brief Constructor initializes an empty cache
+ */
+TableCache::TableCache(int capacity)
+    : Tables()                         // Cached tables
+    , UsageOrder()                     // LRU order
+    , DirtyKeys()                      // Pinned tables
+    , Capacity(capacity)               // Clean table limit
+{
+}
+
+/**
+ * @brief Remove all tables, including dirty ones
+ */
+void TableCache::Clear()
+{
+    Tables.clear();
+    UsageOrder.clear();
+    DirtyKeys.clear();
+}
+
+/**
+ * @brief Find a table and mark it as most recently used
+ */
+QSharedPointer<TableData> TableCache::Find(int key)
+{
+    auto _iterator = Tables.constFind(key);  // Cached entry (end if not cached)
+    if (_iterator == Tables.constEnd()) {
+        return QSharedPointer<TableData>();
+    }
+
+    UsageOrder.removeOne(key);
+    UsageOrder.append(key);
+    return _iterator.value();
+}
+
+/**
+ * @brief Find a table without changing the usage order
+ */
+QSharedPointer<TableData> TableCache::Peek(int key) const
+{
+    return Tables.value(key);
+}
+
+/**
+ * @brief Add a table as most recently used
+ */
+void TableCache::Insert(int key, const QSharedPointer<TableData> &table)
+{
+    if (Tables.contains(key)) {
+        UsageOrder.removeOne(key);
+    }
+
+    Tables.insert(key, table);
+    UsageOrder.append(key);
+    EvictSurplus();
+}
+
+/**
+ * @brief Pin a cached table because it holds unsaved edits
+ */
+void TableCache::MarkDirty(int key)
+{
+    if (Tables.contains(key)) {
+        DirtyKeys.insert(key);
+    }
+}
+
+/**
+ * @brief Check if a table is pinned by unsaved edits
+ */
+bool TableCache::IsDirty(int key) const
+{
+    return DirtyKeys.contains(key);
+}
+
+/**
+ * @brief Get number of cached tables
+ */
+int TableCache::GetSize() const
+{
+    return Tables.size();
+}
+
+/**
+ * @brief Drop least recently used clean tables until the capacity is respected
+ */
+void TableCache::EvictSurplus()
+{
+    int _cleanCount = Tables.size() - DirtyKeys.size();  // Number of tables that may be evicted
+
+    // The most recently used entry is never evicted, it was just requested
+    for (int _i = 0; _cleanCount > Capacity && _i < UsageOrder.size() - 1;) {  // Position in the usage order
+        const int _key = UsageOrder.at(_i);  // Candidate for eviction
+        if (DirtyKeys.contains(_key)) {
+            _i++;
+            continue;
+        }
+
+        Tables.remove(_key);
+        UsageOrder.removeAt(_i);
+        _cleanCount--;
+    }
+}
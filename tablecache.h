@@ -0,0 +1,82 @@
+#ifndef TABLECACHE_H
+#define TABLECACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSharedPointer>
+#include "tablestore.h"
+
+/**
+ * @brief Bounded least-recently-used cache of parsed tables
+ * Tables are addressed by their position in the document. Tables marked dirty
+ * hold edits that exist nowhere else, so they are pinned and never evicted;
+ * they do not count against the capacity
+ */
+class TableCache
+{
+public:
+    /**
+     * @brief Constructor for TableCache
+     * @param capacity Maximum number of clean tables kept parsed
+     */
+    explicit TableCache(int capacity);
+
+    /**
+     * @brief Remove all tables, including dirty ones
+     */
+    void Clear();
+
+    /**
+     * @brief Find a table and mark it as most recently used
+     * @param key Position of the table in the document
+     * @return Shared pointer to the table, null if it is not cached
+     */
+    QSharedPointer<TableData> Find(int key);
+
+    /**
+     * @brief Find a table without changing the usage order
+     * @param key Position of the table in the document
+     * @return Shared pointer to the table, null if it is not cached
+     */
+    QSharedPointer<TableData> Peek(int key) const;
+
+    /**
+     * @brief Add a table as most recently used, evicting the least recently used clean tables above capacity
+     * @param key Position of the table in the document
+     * @param table Parsed table
+     */
+    void Insert(int key, const QSharedPointer<TableData> &table);
+
+    /**
+     * @brief Pin a cached table because it holds unsaved edits
+     * @param key Position of the table in the document
+     */
+    void MarkDirty(int key);
+
+    /**
+     * @brief Check if a table is pinned by unsaved edits
+     * @param key Position of the table in the document
+     * @return true if the table is dirty, false otherwise
+     */
+    bool IsDirty(int key) const;
+
+    /**
+     * @brief Get number of cached tables
+     * @return Count of clean and dirty tables
+     */
+    int GetSize() const;
+
+private:
+    /**
+     * @brief Drop least recently used clean tables until the capacity is respected
+     */
+    void EvictSurplus();
+
+    QHash<int, QSharedPointer<TableData>> Tables;  // Cached tables by document position
+    QList<int> UsageOrder;               // Cached keys, least recently used first
+    QSet<int> DirtyKeys;                 // Keys of tables holding unsaved edits (never evicted)
+    int Capacity;                        // Maximum number of clean tables kept
+};
+
+#endif // TABLECACHE_H
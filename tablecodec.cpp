@@ -0,0 +1,617 @@
+#include "tablecodec.h"
+#include <QChar>
+#include <QPair>
+#include <QVarLengthArray>
+#include <cstring>
+
+const int TableCodec::CANCEL_ROW_INTERVAL = 1024;              // Same granularity as the progress reports of the general parser
+const int TableCodec::WRITE_BUFFER_BYTES = 1024 * 1024;        // Large enough to amortize device calls
+
+/**
+ * @brief Check for a start or end tag of a name at a position, followed by white space, '>' or '/'
+ */
+template <int N>
+bool TableCodec::MatchTag(const char *position, const char *end, const char (&tag)[N])
+{
+    if (end - position < N || std::memcmp(position, tag, N - 1) != 0) {
+        return false;
+    }
+
+    const char _next = position[N - 1];  // Byte after the tag name
+    return _next == ' ' || _next == '\t' || _next == '\n' || _next == '\r' || _next == '>' || _next == '/';
+}
+
+/**
+ * @brief Parse one table element in the fixed layout
+ */
+TableCodec::ParseResult TableCodec::ParseTable(const char *data, qint64 length, const QSharedPointer<StringPool> &stringPool,
+                                               const QAtomicInt *cancelled, QSharedPointer<TableData> *table)
+{
+    const char *_position = data;         // Next byte to read
+    const char *const _end = data + length;  // Byte past the table element
+
+    if (!MatchTag(_position, _end, "<table")) {
+        return NotMatched;
+    }
+    _position += 6;
+
+    QString _tableName;           // Value of the table "name" attribute
+    bool _emptyElement = false;   // Flag indicating the element closed with "/>" (true) or not (false)
+    if (!ReadAttributes(_position, _end, &_tableName, &_emptyElement)) {
+        return NotMatched;
+    }
+
+    QSharedPointer<TableData> _table(new TableData(_tableName, stringPool));  // Table being filled
+    bool _headersKnown = false;   // Flag indicating column headers were taken from the first row (true) or not yet (false)
+
+    QVector<const char *> _tagStarts;  // Start tag bytes of every cell of the first row (nullptr for empty cells)
+    QVector<int> _tagLengths;          // Length of every first row cell start tag
+    QString _rowText;                  // Decoded text of all cells of the current row
+    QVector<int> _cellEnds;            // End of every cell text in _rowText
+    QVector<QStringView> _rowViews;    // Cell values of the current row, viewing _rowText
+
+    while (!_emptyElement) {
+        SkipSpace(_position, _end);
+
+        if (MatchTag(_position, _end, "</table")) {
+            _position += 7;
+            if (!ReadEndTag(_position, _end)) {
+                return NotMatched;
+            }
+            break;
+        }
+
+        if (!MatchTag(_position, _end, "<row")) {
+            return NotMatched;  // Text, comments or other elements between rows
+        }
+        _position += 4;
+
+        bool _emptyRow = false;  // Flag indicating the row closed with "/>" (true) or not (false)
+        if (!ReadAttributes(_position, _end, nullptr, &_emptyRow)) {
+            return NotMatched;
+        }
+
+        QStringList _cellNames;  // Cell names of the first row
+        _rowText.clear();
+        _cellEnds.clear();
+
+        while (!_emptyRow) {
+            SkipSpace(_position, _end);
+
+            if (MatchTag(_position, _end, "</row")) {
+                _position += 5;
+                if (!ReadEndTag(_position, _end)) {
+                    return NotMatched;
+                }
+                break;
+            }
+
+            const int _cell = _cellEnds.size();  // Position of the cell in the row
+            bool _emptyCell = false;             // Flag indicating the cell closed with "/>" (true) or not (false)
+
+            if (_headersKnown && _cell < _tagStarts.size() && _tagStarts.at(_cell)
+                && _end - _position >= _tagLengths.at(_cell)
+                && std::memcmp(_position, _tagStarts.at(_cell), _tagLengths.at(_cell)) == 0) {
+                // Same bytes as the first row cell of this position, so the same column and no attributes to read
+                _position += _tagLengths.at(_cell);
+            } else {
+                if (!MatchTag(_position, _end, "<cell")) {
+                    return NotMatched;
+                }
+
+                const char *_tagStart = _position;  // First byte of the cell start tag
+                _position += 5;
+
+                QString _columnName;  // Value of the cell "name" attribute
+                if (!ReadAttributes(_position, _end, _headersKnown ? nullptr : &_columnName, &_emptyCell)) {
+                    return NotMatched;
+                }
+
+                if (!_headersKnown) {
+                    _cellNames.append(_columnName.isEmpty() ? QString("Column_%1").arg(_cellNames.size() + 1) : _columnName);
+                    _tagStarts.append(_emptyCell ? nullptr : _tagStart);
+                    _tagLengths.append(int(_position - _tagStart));
+                }
+            }
+
+            if (!_emptyCell) {
+                const char *_textEnd = static_cast<const char *>(std::memchr(_position, '<', _end - _position));  // Markup after the text
+                if (!_textEnd || !AppendDecoded(_position, _textEnd, false, &_rowText)) {
+                    return NotMatched;
+                }
+
+                _position = _textEnd;
+                if (!MatchTag(_position, _end, "</cell")) {
+                    return NotMatched;  // Child elements, comments or CDATA inside the cell
+                }
+                _position += 6;
+                if (!ReadEndTag(_position, _end)) {
+                    return NotMatched;
+                }
+            }
+
+            _cellEnds.append(_rowText.size());
+        }
+
+        // First row defines the column structure, same as the general parser
+        if (!_headersKnown) {
+            _table->SetColumnHeaders(_cellNames);
+            _headersKnown = true;
+        }
+
+        // Views are taken once the row text no longer grows
+        _rowViews.clear();
+        int _cellStart = 0;  // Start of the current cell text in _rowText
+        for (int _cellEnd : _cellEnds) {  // End of the current cell text in _rowText
+            _rowViews.append(QStringView(_rowText).mid(_cellStart, _cellEnd - _cellStart));
+            _cellStart = _cellEnd;
+        }
+        _table->AppendRowViews(_rowViews);
+
+        if (cancelled && _table->GetRowCount() % CANCEL_ROW_INTERVAL == 0 && cancelled->loadRelaxed()) {
+            return Cancelled;
+        }
+    }
+
+    SkipSpace(_position, _end);
+    if (_position != _end) {
+        return NotMatched;
+    }
+
+    // Numbers, dates and flags are kept as native values from here on
+    _table->InferColumnTypes();
+    *table = _table;
+    return Parsed;
+}
+
+/**
+ * @brief Check if a root element can be written without the general writer
+ */
+bool TableCodec::CanWriteRoot(const QXmlStreamAttributes &rootAttributes)
+{
+    for (const QXmlStreamAttribute &_attribute : rootAttributes) {  // Attribute as read from the source
+        if (!_attribute.namespaceUri().isEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write the XML declaration and the root start tag
+ */
+bool TableCodec::WriteRootStart(QIODevice *device, const QString &rootName, const QXmlStreamAttributes &rootAttributes, bool empty)
+{
+    QByteArray _buffer("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");  // Declaration and start tag
+    _buffer += GetIndent(0);
+    _buffer += '<';
+    _buffer += rootName.toUtf8();
+
+    for (const QXmlStreamAttribute &_attribute : rootAttributes) {  // Attribute written by its qualified name
+        _buffer += ' ';
+        _buffer += _attribute.qualifiedName().toString().toUtf8();
+        _buffer += "=\"";
+        if (!AppendEscaped(_attribute.value(), true, &_buffer)) {
+            return false;
+        }
+        _buffer += '"';
+    }
+
+    _buffer += empty ? "/>\n" : ">";
+    return device->write(_buffer) == _buffer.size();
+}
+
+/**
+ * @brief Write the root end tag after the last table
+ */
+bool TableCodec::WriteRootEnd(QIODevice *device, const QString &rootName)
+{
+    const QByteArray _buffer = GetIndent(0) + "</" + rootName.toUtf8() + ">\n";  // End tag and final line break
+    return device->write(_buffer) == _buffer.size();
+}
+
+/**
+ * @brief Write one table element from precomputed tag templates
+ */
+bool TableCodec::WriteTable(QIODevice *device, const TableData &table, int depth)
+{
+    const QStringList _columnHeaders = table.GetColumnHeaders();  // Column names written as cell attributes
+    const int _rowCount = table.GetRowCount();                    // Number of rows to write
+
+    // Every tag of a row is known before the first row is written
+    QVector<QByteArray> _cellStarts;  // Line break, indentation and start tag of the cell of every column
+    QVector<bool> _textColumns;       // Flag per column indicating cells can be viewed without formatting
+    for (int _col = 0; _col < _columnHeaders.size(); ++_col) {  // Current column index (0-based)
+        QByteArray _cellStart = GetIndent(depth + 2) + "<cell name=\"";  // Start tag of this column
+        if (!AppendEscaped(_columnHeaders.at(_col), true, &_cellStart)) {
+            return false;
+        }
+        _cellStart += "\">";
+        _cellStarts.append(_cellStart);
+        _textColumns.append(table.GetColumnType(_col) == TableData::TextColumn);
+    }
+
+    const QByteArray _rowStart = GetIndent(depth + 1) + (_columnHeaders.isEmpty() ? "<row/>" : "<row>");  // Row start tag
+    const QByteArray _rowEnd = _columnHeaders.isEmpty() ? QByteArray() : GetIndent(depth + 1) + "</row>";  // Row end tag
+
+    QByteArray _buffer;  // Serialized bytes not yet written
+    _buffer.reserve(WRITE_BUFFER_BYTES + 64 * 1024);
+    _buffer += GetIndent(depth);
+    _buffer += "<table name=\"";
+    if (!AppendEscaped(table.GetName(), true, &_buffer)) {
+        return false;
+    }
+    _buffer += _rowCount > 0 ? "\">" : "\"/>";
+
+    for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+        _buffer += _rowStart;
+
+        for (int _col = 0; _col < _cellStarts.size(); ++_col) {  // Current column index (0-based)
+            _buffer += _cellStarts.at(_col);
+            const bool _escaped = _textColumns.at(_col) ? AppendEscaped(table.GetCellView(_row, _col), false, &_buffer)
+                                                        : AppendEscaped(table.GetCell(_row, _col), false, &_buffer);  // Text written
+            if (!_escaped) {
+                return false;
+            }
+            _buffer += "</cell>";
+        }
+
+        _buffer += _rowEnd;
+
+        if (_buffer.size() >= WRITE_BUFFER_BYTES) {
+            if (device->write(_buffer) != _buffer.size()) {
+                return false;
+            }
+            _buffer.resize(0);  // Keeps the reserved capacity
+        }
+    }
+
+    if (_rowCount > 0) {
+        _buffer += GetIndent(depth);
+        _buffer += "</table>";
+    }
+
+    return device->write(_buffer) == _buffer.size();
+}
+
+/**
+ * @brief Skip white space between markup
+ */
+void TableCodec::SkipSpace(const char *&position, const char *end)
+{
+    while (position < end && (*position == ' ' || *position == '\n' || *position == '\t' || *position == '\r')) {
+        ++position;
+    }
+}
+
+/**
+ * @brief Read the attributes of a start tag up to and including its closing '>' or "/>"
+ */
+bool TableCodec::ReadAttributes(const char *&position, const char *end, QString *nameValue, bool *emptyElement)
+{
+    QVarLengthArray<QPair<const char *, int>, 4> _names;  // Attribute names read so far, to reject duplicates
+    QString _ignoredValue;                                // Decoded value of attributes other than "name"
+
+    if (nameValue) {
+        nameValue->clear();
+    }
+
+    while (true) {
+        const char *_beforeSpace = position;  // Position before white space
+        SkipSpace(position, end);
+        if (position >= end) {
+            return false;
+        }
+
+        if (*position == '>') {
+            ++position;
+            *emptyElement = false;
+            return true;
+        }
+
+        if (*position == '/') {
+            if (end - position < 2 || position[1] != '>') {
+                return false;
+            }
+            position += 2;
+            *emptyElement = true;
+            return true;
+        }
+
+        if (position == _beforeSpace) {
+            return false;  // Attributes must be separated by white space
+        }
+
+        // ASCII names only, anything else is left to the general parser
+        const char *_name = position;  // First byte of the attribute name
+        const char _first = *position;  // First character of the name
+        if (!((_first >= 'a' && _first <= 'z') || (_first >= 'A' && _first <= 'Z') || _first == '_' || _first == ':')) {
+            return false;
+        }
+        while (position < end && ((*position >= 'a' && *position <= 'z') || (*position >= 'A' && *position <= 'Z')
+                                  || (*position >= '0' && *position <= '9') || *position == '_' || *position == ':'
+                                  || *position == '-' || *position == '.')) {
+            ++position;
+        }
+        const int _nameLength = int(position - _name);  // Number of bytes of the name
+
+        for (const QPair<const char *, int> &_previous : _names) {  // Name read earlier in the same tag
+            if (_previous.second == _nameLength && std::memcmp(_previous.first, _name, _nameLength) == 0) {
+                return false;
+            }
+        }
+        _names.append(qMakePair(_name, _nameLength));
+
+        SkipSpace(position, end);
+        if (position >= end || *position != '=') {
+            return false;
+        }
+        ++position;
+        SkipSpace(position, end);
+        if (position >= end || (*position != '"' && *position != '\'')) {
+            return false;
+        }
+
+        const char *_value = position + 1;  // First byte of the value
+        const char *_valueEnd = static_cast<const char *>(std::memchr(_value, *position, end - _value));  // Closing quote
+        if (!_valueEnd) {
+            return false;
+        }
+
+        const bool _isName = _nameLength == 4 && std::memcmp(_name, "name", 4) == 0;  // Flag indicating the "name" attribute
+        QString *_target = _isName && nameValue ? nameValue : &_ignoredValue;  // Receives the decoded value
+        _target->clear();
+        if (!AppendDecoded(_value, _valueEnd, true, _target)) {
+            return false;
+        }
+
+        position = _valueEnd + 1;
+    }
+}
+
+/**
+ * @brief Skip white space and the '>' of an end tag whose name was matched
+ */
+bool TableCodec::ReadEndTag(const char *&position, const char *end)
+{
+    SkipSpace(position, end);
+    if (position >= end || *position != '>') {
+        return false;
+    }
+    ++position;
+    return true;
+}
+
+/**
+ * @brief Append text or an attribute value with references resolved and line breaks normalized
+ */
+bool TableCodec::AppendDecoded(const char *begin, const char *end, bool attribute, QString *text)
+{
+    const char *_run = begin;  // First byte not yet appended
+    bool _ascii = true;        // Flag indicating the pending run is ASCII only (true) or not (false)
+
+    for (const char *_position = begin; _position < end; ++_position) {  // Byte being checked
+        const uchar _byte = uchar(*_position);  // Current byte
+        if (_byte >= 0x80) {
+            _ascii = false;
+            continue;
+        }
+        if (_byte >= 0x20 && _byte != '&' && _byte != '<' && _byte != '>') {
+            continue;
+        }
+        if (!attribute && (_byte == '\n' || _byte == '\t')) {
+            continue;
+        }
+
+        if (_byte == '>') {
+            if (!attribute && _position - begin >= 2 && _position[-1] == ']' && _position[-2] == ']') {
+                return false;  // "]]>" is not allowed in text
+            }
+            continue;
+        }
+
+        if (!AppendRun(_run, _position, _ascii, text)) {
+            return false;
+        }
+        _ascii = true;
+
+        if (_byte == '\r' || _byte == '\n' || _byte == '\t') {
+            // Line breaks become "\n" in text; attribute values turn all of them and tabs into spaces
+            if (_byte == '\r' && _position + 1 < end && _position[1] == '\n') {
+                ++_position;
+            }
+            text->append(attribute ? QChar(' ') : QChar('\n'));
+        } else if (_byte == '&') {
+            const char *_referenceEnd = static_cast<const char *>(std::memchr(_position, ';', end - _position));  // Closing ';'
+            if (!_referenceEnd) {
+                return false;
+            }
+
+            const char *_reference = _position + 1;  // First byte after '&'
+            const int _length = int(_referenceEnd - _reference);  // Bytes between '&' and ';'
+            if (_length == 2 && std::memcmp(_reference, "lt", 2) == 0) {
+                text->append(QChar('<'));
+            } else if (_length == 2 && std::memcmp(_reference, "gt", 2) == 0) {
+                text->append(QChar('>'));
+            } else if (_length == 3 && std::memcmp(_reference, "amp", 3) == 0) {
+                text->append(QChar('&'));
+            } else if (_length == 4 && std::memcmp(_reference, "quot", 4) == 0) {
+                text->append(QChar('"'));
+            } else if (_length == 4 && std::memcmp(_reference, "apos", 4) == 0) {
+                text->append(QChar('\''));
+            } else if (_length >= 2 && _length <= 10 && _reference[0] == '#') {
+                const bool _hex = _reference[1] == 'x';  // Flag indicating a hexadecimal reference
+                const char *_digit = _reference + (_hex ? 2 : 1);  // Current digit
+                if (_digit == _referenceEnd) {
+                    return false;
+                }
+
+                uint _code = 0;  // Referenced code point
+                for (; _digit < _referenceEnd; ++_digit) {
+                    const char _c = *_digit;  // Current digit character
+                    uint _value;              // Value of the digit
+                    if (_c >= '0' && _c <= '9') {
+                        _value = uint(_c - '0');
+                    } else if (_hex && _c >= 'a' && _c <= 'f') {
+                        _value = uint(_c - 'a' + 10);
+                    } else if (_hex && _c >= 'A' && _c <= 'F') {
+                        _value = uint(_c - 'A' + 10);
+                    } else {
+                        return false;
+                    }
+                    _code = _code * (_hex ? 16 : 10) + _value;
+                    if (_code > 0x10FFFF) {
+                        return false;
+                    }
+                }
+
+                const bool _valid = _code == 0x9 || _code == 0xA || _code == 0xD || (_code >= 0x20 && _code <= 0xD7FF)
+                                    || (_code >= 0xE000 && _code <= 0xFFFD) || _code >= 0x10000;  // Flag indicating an XML character
+                if (!_valid) {
+                    return false;
+                }
+
+                if (_code >= 0x10000) {
+                    text->append(QChar(QChar::highSurrogate(_code)));
+                    text->append(QChar(QChar::lowSurrogate(_code)));
+                } else {
+                    text->append(QChar(ushort(_code)));
+                }
+            } else {
+                return false;  // Entities declared in a DTD are left to the general parser
+            }
+
+            _position = _referenceEnd;
+        } else {
+            return false;  // '<' or a control character
+        }
+
+        _run = _position + 1;
+    }
+
+    return AppendRun(_run, end, _ascii, text);
+}
+
+/**
+ * @brief Append a run of undecoded bytes
+ */
+bool TableCodec::AppendRun(const char *begin, const char *end, bool ascii, QString *text)
+{
+    const int _length = int(end - begin);  // Number of bytes in the run
+    if (_length == 0) {
+        return true;
+    }
+
+    if (ascii) {
+        text->append(QLatin1String(begin, _length));
+        return true;
+    }
+
+    // A byte order mark at the start of a run may be dropped by the decoder
+    if (_length >= 3 && uchar(begin[0]) == 0xEF && uchar(begin[1]) == 0xBB && uchar(begin[2]) == 0xBF) {
+        return false;
+    }
+
+    const QString _decoded = QString::fromUtf8(begin, _length);  // Decoded run
+    for (const QChar _char : _decoded) {  // Character checked for replacements and non-characters
+        if (_char.unicode() >= 0xFFFD) {
+            return false;  // Invalid UTF-8 (decoded as U+FFFD), U+FFFE and U+FFFF
+        }
+    }
+
+    text->append(_decoded);
+    return true;
+}
+
+/**
+ * @brief Append text escaped the way QXmlStreamWriter escapes it, encoded as UTF-8
+ */
+bool TableCodec::AppendEscaped(QStringView text, bool attribute, QByteArray *buffer)
+{
+    const QChar *_data = text.data();     // Characters being encoded
+    const qsizetype _size = text.size();  // Number of characters
+    const qsizetype _start = buffer->size();  // Buffer size before the text
+
+    // "&quot;" is the longest encoding of one UTF-16 code unit, so the text fits without further checks
+    buffer->resize(_start + 6 * _size);
+    char *_out = buffer->data() + _start;  // Next byte to fill
+
+    for (qsizetype _i = 0; _i < _size; ++_i) {  // Current character index
+        const ushort _c = _data[_i].unicode();  // Current UTF-16 code unit
+
+        if (_c >= 0x80) {
+            if (_c < 0x800) {
+                *_out++ = char(0xC0 | (_c >> 6));
+                *_out++ = char(0x80 | (_c & 0x3F));
+            } else if (QChar::isHighSurrogate(_c)) {
+                if (_i + 1 >= _size || !QChar::isLowSurrogate(_data[_i + 1].unicode())) {
+                    buffer->resize(_start);
+                    return false;
+                }
+                const uint _code = QChar::surrogateToUcs4(_c, _data[++_i].unicode());  // Supplementary code point
+                *_out++ = char(0xF0 | (_code >> 18));
+                *_out++ = char(0x80 | ((_code >> 12) & 0x3F));
+                *_out++ = char(0x80 | ((_code >> 6) & 0x3F));
+                *_out++ = char(0x80 | (_code & 0x3F));
+            } else if (QChar::isLowSurrogate(_c) || _c >= 0xFFFE) {
+                buffer->resize(_start);
+                return false;
+            } else {
+                *_out++ = char(0xE0 | (_c >> 12));
+                *_out++ = char(0x80 | ((_c >> 6) & 0x3F));
+                *_out++ = char(0x80 | (_c & 0x3F));
+            }
+            continue;
+        }
+
+        const char *_escape = nullptr;  // Reference replacing the character (nullptr to copy it)
+        switch (_c) {
+        case '<':
+            _escape = "&lt;";
+            break;
+        case '>':
+            _escape = "&gt;";
+            break;
+        case '&':
+            _escape = "&amp;";
+            break;
+        case '"':
+            _escape = "&quot;";
+            break;
+        case '\t':
+            _escape = attribute ? "&#9;" : nullptr;
+            break;
+        case '\n':
+            _escape = attribute ? "&#10;" : nullptr;
+            break;
+        case '\r':
+            _escape = attribute ? "&#13;" : nullptr;
+            break;
+        default:
+            if (_c < 0x20) {
+                buffer->resize(_start);
+                return false;  // Control characters cannot be represented in XML 1.0
+            }
+            break;
+        }
+
+        if (_escape) {
+            while (*_escape) {
+                *_out++ = *_escape++;
+            }
+        } else {
+            *_out++ = char(_c);
+        }
+    }
+
+    buffer->resize(_out - buffer->constData());
+    return true;
+}
+
+/**
+ * @brief Get the line break and indentation of a nesting depth
+ */
+QByteArray TableCodec::GetIndent(int depth)
+{
+    return QByteArray(1, '\n') + QByteArray(4 * depth, ' ');
+}
@@ -0,0 +1,138 @@
+#ifndef TABLECODEC_H
+#define TABLECODEC_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QIODevice>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <QXmlStreamAttributes>
+#include "stringpool.h"
+#include "tablestore.h"
+
+/**
+ * @brief Parser and serializer specialized for the fixed table/row/cell layout
+ * Parsing works on the UTF-8 bytes of one table element. Tags are matched
+ * against compile-time literals, and the start tag of every cell of the first
+ * row is kept as a byte pattern: a later cell whose start tag is byte-identical
+ * to the pattern of its position is known to be that column without reading its
+ * attributes. Anything outside the layout (comments, CDATA, processing
+ * instructions, other elements, entities other than the predefined and
+ * character references) makes the parse report NotMatched, and the caller falls
+ * back to QXmlStreamReader. Writing fills precomputed byte templates of every
+ * row and cell tag and produces exactly what QXmlStreamWriter writes with
+ * auto-formatting and an indent of 4 spaces
+ */
+class TableCodec
+{
+public:
+    /**
+     * @brief Outcome of ParseTable
+     */
+    enum ParseResult {
+        Parsed,                          // Table read completely
+        NotMatched,                      // Bytes use XML outside the fixed layout, use the general parser
+        Cancelled                        // Stopped because the cancel flag was set
+    };
+
+    /**
+     * @brief Parse one table element in the fixed layout
+     * Columns are named by the cells of the first row, as in the general parser
+     * @param data UTF-8 bytes starting with the table start tag
+     * @param length Number of bytes up to and including the table end tag
+     * @param stringPool Pool for dictionary encoded values (a private pool is created if null)
+     * @param cancelled Flag polled while parsing, non-zero to stop (nullptr to never stop)
+     * @param table Receives the parsed table, with inferred column types (only set if Parsed)
+     * @return Parsed, NotMatched or Cancelled
+     */
+    static ParseResult ParseTable(const char *data, qint64 length, const QSharedPointer<StringPool> &stringPool,
+                                  const QAtomicInt *cancelled, QSharedPointer<TableData> *table);
+
+    /**
+     * @brief Check if a root element can be written without the general writer
+     * @param rootAttributes Attributes of the root element
+     * @return false if an attribute needs a namespace declaration, true otherwise
+     */
+    static bool CanWriteRoot(const QXmlStreamAttributes &rootAttributes);
+
+    /**
+     * @brief Write the XML declaration and the root start tag
+     * @param device Opened output device
+     * @param rootName Tag name of the root element
+     * @param rootAttributes Attributes of the root element (see CanWriteRoot)
+     * @param empty true to close the root right away because no table follows
+     * @return true if all bytes were written, false otherwise
+     */
+    static bool WriteRootStart(QIODevice *device, const QString &rootName, const QXmlStreamAttributes &rootAttributes, bool empty);
+
+    /**
+     * @brief Write the root end tag after the last table
+     * @param device Opened output device
+     * @param rootName Tag name of the root element
+     * @return true if all bytes were written, false otherwise
+     */
+    static bool WriteRootEnd(QIODevice *device, const QString &rootName);
+
+    /**
+     * @brief Write one table element, starting on a new line
+     * @param device Opened output device
+     * @param table Table to write
+     * @param depth Nesting depth of the table element (1 below the root, 0 for a table on its own)
+     * @return true if all bytes were written, false on device errors or text XML cannot hold
+     */
+    static bool WriteTable(QIODevice *device, const TableData &table, int depth);
+
+private:
+    /**
+     * @brief Check for a start or end tag of a name at a position, followed by white space, '>' or '/'
+     */
+    template <int N>
+    static bool MatchTag(const char *position, const char *end, const char (&tag)[N]);
+
+    /**
+     * @brief Skip white space between markup
+     */
+    static void SkipSpace(const char *&position, const char *end);
+
+    /**
+     * @brief Read the attributes of a start tag up to and including its closing '>' or "/>"
+     * @return false if the tag is malformed or an attribute value cannot be decoded
+     */
+    static bool ReadAttributes(const char *&position, const char *end, QString *nameValue, bool *emptyElement);
+
+    /**
+     * @brief Skip white space and the '>' of an end tag whose name was matched
+     * @return false if anything else follows the name
+     */
+    static bool ReadEndTag(const char *&position, const char *end);
+
+    /**
+     * @brief Append text or an attribute value with references resolved and line breaks normalized
+     * @return false on markup, invalid characters or references other than the predefined and character references
+     */
+    static bool AppendDecoded(const char *begin, const char *end, bool attribute, QString *text);
+
+    /**
+     * @brief Append a run of undecoded bytes
+     * @return false if the bytes are not valid UTF-8
+     */
+    static bool AppendRun(const char *begin, const char *end, bool ascii, QString *text);
+
+    /**
+     * @brief Append text escaped the way QXmlStreamWriter escapes it, encoded as UTF-8
+     * @return false if the text holds characters XML cannot represent
+     */
+    static bool AppendEscaped(QStringView text, bool attribute, QByteArray *buffer);
+
+    /**
+     * @brief Get the line break and indentation of a nesting depth
+     */
+    static QByteArray GetIndent(int depth);
+
+    static const int CANCEL_ROW_INTERVAL;        // Rows parsed between two polls of the cancel flag
+    static const int WRITE_BUFFER_BYTES;         // Serialized bytes collected before they are written
+};
+
+#endif // TABLECODEC_H
@@ -0,0 +1,383 @@
+#include "tablediff.h"
+#include <QDebug>
+#include <QFuture>
+#include <QHash>
+#include <QPair>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include "xmlprofiler.h"
+
+const int TableDiff::MIN_CHUNK_ROWS = 16384;  // Smaller chunks cost more in scheduling than they gain
+
+/**
+ * @brief Row range hashed by one pool task
+ */
+struct HashChunk {
+    int Begin;                           // First row of the chunk
+    int End;                             // Row past the chunk
+};
+
+/**
+ * @brief Constructor for a comparison of two empty tables
+ */
+TableDiff::TableDiff()
+    : TableDiff(TableData(), TableData())
+{
+}
+
+/**
+ * @brief Constructor captures both versions of the table
+ */
+TableDiff::TableDiff(const TableData &left, const TableData &right, const QString &keyColumnName)
+    : Left(left)                       // Shared older version
+    , Right(right)                     // Shared newer version
+    , KeyColumnName(keyColumnName)     // Row identity
+    , CommonColumns()                  // Resolved by Compare
+    , LeftOnlyColumns()                // Resolved by Compare
+    , RightOnlyColumns()               // Resolved by Compare
+    , LeftColumns()                    // Resolved by Compare
+    , RightColumns()                   // Resolved by Compare
+    , Changes()                        // Nothing compared yet
+    , UnchangedRowCount(0)             // Nothing compared yet
+{
+}
+
+/**
+ * @brief Compute the differences, blocking until done
+ */
+bool TableDiff::Compare()
+{
+    XML_PROFILE_SCOPE("Diff tables");
+
+    CommonColumns.clear();
+    LeftOnlyColumns.clear();
+    RightOnlyColumns.clear();
+    LeftColumns.clear();
+    RightColumns.clear();
+    Changes.clear();
+    UnchangedRowCount = 0;
+
+    // Columns are matched by name, so reordered columns still compare
+    const QStringList _leftHeaders = Left.GetColumnHeaders();    // Column names of the older version
+    const QStringList _rightHeaders = Right.GetColumnHeaders();  // Column names of the newer version
+    for (int _col = 0; _col < _leftHeaders.size(); ++_col) {  // Left column index (0-based)
+        const int _rightColumn = _rightHeaders.indexOf(_leftHeaders.at(_col));  // Matching right column (-1 if missing)
+        if (_rightColumn < 0 || RightColumns.contains(_rightColumn)) {
+            LeftOnlyColumns.append(_leftHeaders.at(_col));
+            continue;
+        }
+        CommonColumns.append(_leftHeaders.at(_col));
+        LeftColumns.append(_col);
+        RightColumns.append(_rightColumn);
+    }
+    for (int _col = 0; _col < _rightHeaders.size(); ++_col) {  // Right column index (0-based)
+        if (!RightColumns.contains(_col)) {
+            RightOnlyColumns.append(_rightHeaders.at(_col));
+        }
+    }
+
+    const int _keyPosition = KeyColumnName.isEmpty() ? -1 : CommonColumns.indexOf(KeyColumnName);  // Key among the compared columns (-1 without key)
+    if (!KeyColumnName.isEmpty() && _keyPosition < 0) {
+        qDebug() << "Error: Key column" << KeyColumnName << "is not in both tables";
+        return false;
+    }
+
+    // Native values only match across tables that store the column the same way
+    QVector<bool> _nativeColumns(CommonColumns.size());  // Flag per compared column indicating cells are hashed by value
+    for (int _i = 0; _i < CommonColumns.size(); ++_i) {  // Position of the compared column
+        const TableData::ColumnType _leftType = Left.GetColumnType(LeftColumns.at(_i));  // Storage type in the older version
+        _nativeColumns[_i] = _leftType != TableData::TextColumn && _leftType == Right.GetColumnType(RightColumns.at(_i))
+                             && Left.GetDecimalScale(LeftColumns.at(_i)) == Right.GetDecimalScale(RightColumns.at(_i));
+    }
+
+    QVector<quint64> _leftRowHashes;   // Content hash of every left row
+    QVector<quint64> _rightRowHashes;  // Content hash of every right row
+    QVector<quint64> _leftKeyHashes;   // Key hash of every left row (only with a key column)
+    QVector<quint64> _rightKeyHashes;  // Key hash of every right row (only with a key column)
+    HashRows(Left, LeftColumns, _nativeColumns, _keyPosition, &_leftRowHashes, &_leftKeyHashes);
+    HashRows(Right, RightColumns, _nativeColumns, _keyPosition, &_rightRowHashes, &_rightKeyHashes);
+    XML_PROFILE_COUNT("Rows hashed", _leftRowHashes.size() + _rightRowHashes.size());
+
+    // Sorting by hash, then row, pairs equal keys in document order
+    const QVector<quint64> &_leftKeys = _keyPosition < 0 ? _leftRowHashes : _leftKeyHashes;     // Hash rows are matched by (left)
+    const QVector<quint64> &_rightKeys = _keyPosition < 0 ? _rightRowHashes : _rightKeyHashes;  // Hash rows are matched by (right)
+    QVector<QPair<quint64, int>> _leftOrder(_leftKeys.size());    // Key hash and row of every left row
+    QVector<QPair<quint64, int>> _rightOrder(_rightKeys.size());  // Key hash and row of every right row
+    for (int _row = 0; _row < _leftOrder.size(); ++_row) {  // Left row index (0-based)
+        _leftOrder[_row] = qMakePair(_leftKeys.at(_row), _row);
+    }
+    for (int _row = 0; _row < _rightOrder.size(); ++_row) {  // Right row index (0-based)
+        _rightOrder[_row] = qMakePair(_rightKeys.at(_row), _row);
+    }
+    QFuture<void> _leftSort = QtConcurrent::run([&_leftOrder]() {
+        std::sort(_leftOrder.begin(), _leftOrder.end());
+    });
+    std::sort(_rightOrder.begin(), _rightOrder.end());
+    _leftSort.waitForFinished();
+
+    int _left = 0;   // Next entry of _leftOrder
+    int _right = 0;  // Next entry of _rightOrder
+    while (_left < _leftOrder.size() || _right < _rightOrder.size()) {
+        if (_right == _rightOrder.size() || (_left < _leftOrder.size() && _leftOrder.at(_left).first < _rightOrder.at(_right).first)) {
+            Changes.append({RemovedRow, _leftOrder.at(_left).second, -1});
+            _left++;
+        } else if (_left == _leftOrder.size() || _rightOrder.at(_right).first < _leftOrder.at(_left).first) {
+            Changes.append({AddedRow, -1, _rightOrder.at(_right).second});
+            _right++;
+        } else {
+            // Equal hashes only propose a match, the cells decide which rows pair up
+            const quint64 _hash = _leftOrder.at(_left).first;  // Hash shared by the run of rows
+            int _leftEnd = _left;    // Entry of _leftOrder past the run
+            int _rightEnd = _right;  // Entry of _rightOrder past the run
+            while (_leftEnd < _leftOrder.size() && _leftOrder.at(_leftEnd).first == _hash) {
+                _leftEnd++;
+            }
+            while (_rightEnd < _rightOrder.size() && _rightOrder.at(_rightEnd).first == _hash) {
+                _rightEnd++;
+            }
+
+            QVector<bool> _paired(_rightEnd - _right, false);  // Flag per right row of the run indicating it was paired
+            int _firstUnpaired = 0;  // First right row of the run not paired yet
+            for (int _i = _left; _i < _leftEnd; ++_i) {  // Entry of the left row in _leftOrder
+                const int _leftRow = _leftOrder.at(_i).second;  // Left row looking for a partner
+                int _match = -1;  // Run position of the paired right row (-1 if none)
+                for (int _j = _firstUnpaired; _j < _paired.size() && _match < 0; ++_j) {  // Run position of the candidate
+                    const int _rightRow = _rightOrder.at(_right + _j).second;  // Candidate right row
+                    if (!_paired.at(_j) && (_keyPosition < 0 ? RowsEqual(_leftRow, _rightRow, _nativeColumns)
+                                                             : CellsEqual(_leftRow, _rightRow, _keyPosition, _nativeColumns.at(_keyPosition)))) {
+                        _match = _j;
+                    }
+                }
+                if (_match < 0) {
+                    Changes.append({RemovedRow, _leftRow, -1});
+                    continue;
+                }
+
+                _paired[_match] = true;
+                while (_firstUnpaired < _paired.size() && _paired.at(_firstUnpaired)) {
+                    _firstUnpaired++;
+                }
+                const int _rightRow = _rightOrder.at(_right + _match).second;  // Paired right row
+                if (_keyPosition < 0 || (_leftRowHashes.at(_leftRow) == _rightRowHashes.at(_rightRow) && RowsEqual(_leftRow, _rightRow, _nativeColumns))) {
+                    UnchangedRowCount++;
+                } else {
+                    Changes.append({ChangedRow, _leftRow, _rightRow});
+                }
+            }
+            for (int _j = 0; _j < _paired.size(); ++_j) {  // Run position of the right row
+                if (!_paired.at(_j)) {
+                    Changes.append({AddedRow, -1, _rightOrder.at(_right + _j).second});
+                }
+            }
+            _left = _leftEnd;
+            _right = _rightEnd;
+        }
+    }
+
+    std::sort(Changes.begin(), Changes.end(), [](const RowChange &a, const RowChange &b) {
+        const bool _aRemoved = a.Type == RemovedRow;  // Flag indicating a is ordered by its left row (true) or right row (false)
+        const bool _bRemoved = b.Type == RemovedRow;  // Flag indicating b is ordered by its left row (true) or right row (false)
+        if (_aRemoved != _bRemoved) {
+            return _aRemoved;
+        }
+        return _aRemoved ? a.LeftRow < b.LeftRow : a.RightRow < b.RightRow;
+    });
+
+    return true;
+}
+
+/**
+ * @brief Get the differences found by Compare
+ */
+QVector<TableDiff::RowChange> TableDiff::GetChanges() const
+{
+    return Changes;
+}
+
+/**
+ * @brief Get number of differences of one kind
+ */
+int TableDiff::GetChangeCount(ChangeType type) const
+{
+    return int(std::count_if(Changes.cbegin(), Changes.cend(), [type](const RowChange &change) {
+        return change.Type == type;
+    }));
+}
+
+/**
+ * @brief Get number of rows found equal in both tables
+ */
+int TableDiff::GetUnchangedRowCount() const
+{
+    return UnchangedRowCount;
+}
+
+/**
+ * @brief Get names of the columns that were compared
+ */
+QStringList TableDiff::GetCommonColumns() const
+{
+    return CommonColumns;
+}
+
+/**
+ * @brief Get names of the columns only the left table has
+ */
+QStringList TableDiff::GetLeftOnlyColumns() const
+{
+    return LeftOnlyColumns;
+}
+
+/**
+ * @brief Get names of the columns only the right table has
+ */
+QStringList TableDiff::GetRightOnlyColumns() const
+{
+    return RightOnlyColumns;
+}
+
+/**
+ * @brief Build a table listing the differences for display or export
+ */
+TableData TableDiff::CreateResultTable() const
+{
+    TableData _result(Left.GetName(), Left.GetStringPool());  // Differences, sharing the pool of the compared tables
+    _result.SetColumnHeaders(QStringList("change") + CommonColumns);
+
+    for (const RowChange &_change : Changes) {  // Reported difference
+        QStringList _rowData;  // Change kind followed by the compared cells
+        _rowData.reserve(CommonColumns.size() + 1);
+        switch (_change.Type) {
+        case RemovedRow:
+            _rowData.append("removed");
+            for (int _column : LeftColumns) {  // Left column index (0-based)
+                _rowData.append(Left.GetCell(_change.LeftRow, _column));
+            }
+            break;
+        case AddedRow:
+            _rowData.append("added");
+            for (int _column : RightColumns) {  // Right column index (0-based)
+                _rowData.append(Right.GetCell(_change.RightRow, _column));
+            }
+            break;
+        case ChangedRow:
+            _rowData.append("changed");
+            for (int _i = 0; _i < CommonColumns.size(); ++_i) {  // Position of the compared column
+                const QString _oldValue = Left.GetCell(_change.LeftRow, LeftColumns.at(_i));    // Cell in the older version
+                const QString _newValue = Right.GetCell(_change.RightRow, RightColumns.at(_i)); // Cell in the newer version
+                _rowData.append(_oldValue == _newValue ? _newValue : _oldValue + " -> " + _newValue);
+            }
+            break;
+        }
+        _result.AppendRow(_rowData);
+    }
+
+    return _result;
+}
+
+/**
+ * @brief Compute the row hash, and the key hash if a key column is used, of every row on the thread pool
+ */
+void TableDiff::HashRows(const TableData &table, const QVector<int> &columns, const QVector<bool> &nativeColumns, int keyPosition,
+                         QVector<quint64> *rowHashes, QVector<quint64> *keyHashes)
+{
+    const int _rowCount = table.GetRowCount();  // Number of rows to hash
+    rowHashes->resize(_rowCount);
+    if (keyPosition >= 0) {
+        keyHashes->resize(_rowCount);
+    }
+
+    const QVector<int> _bounds = GetChunkBounds(_rowCount);  // Boundaries of the hashed chunks
+    QVector<HashChunk> _chunks;  // Rows hashed by one task each
+    for (int _i = 0; _i + 1 < _bounds.size(); ++_i) {  // Position of the chunk
+        _chunks.append({_bounds.at(_i), _bounds.at(_i + 1)});
+    }
+
+    quint64 *_rowHashes = rowHashes->data();  // Detached once here, tasks write disjoint ranges
+    quint64 *_keyHashes = keyPosition >= 0 ? keyHashes->data() : nullptr;  // Detached once here (nullptr without key)
+    QtConcurrent::blockingMap(_chunks, [&table, &columns, &nativeColumns, keyPosition, _rowHashes, _keyHashes](HashChunk &chunk) {
+        for (int _row = chunk.Begin; _row < chunk.End; ++_row) {  // Current row index (0-based)
+            quint64 _rowHash = 0;  // Hash of the cells seen so far
+            for (int _i = 0; _i < columns.size(); ++_i) {  // Position of the compared column
+                const quint64 _cellHash = HashCell(table, _row, columns.at(_i), nativeColumns.at(_i));  // Hash of the current cell
+                _rowHash = CombineHash(_rowHash, _cellHash);
+                if (_i == keyPosition) {
+                    _keyHashes[_row] = _cellHash;
+                }
+            }
+            _rowHashes[_row] = _rowHash;
+        }
+    });
+}
+
+/**
+ * @brief Hash one cell by its text, or by its native value if both tables store the column with the same type
+ */
+quint64 TableDiff::HashCell(const TableData &table, int row, int column, bool native)
+{
+    qint64 _value = 0;  // Native value of the cell (only valid if the cell holds one)
+    if (!table.GetTypedValue(row, column, &_value)) {
+        return quint64(qHash(table.GetCellView(row, column)));
+    }
+
+    // The other table may hold the same value as text, so it is formatted unless both store it natively
+    return native ? quint64(qHash(_value, 1)) : quint64(qHash(QStringView(table.GetCell(row, column))));
+}
+
+/**
+ * @brief Check if a left and a right row hold the same cells in all compared columns
+ */
+bool TableDiff::RowsEqual(int leftRow, int rightRow, const QVector<bool> &nativeColumns) const
+{
+    for (int _i = 0; _i < nativeColumns.size(); ++_i) {  // Position of the compared column
+        if (!CellsEqual(leftRow, rightRow, _i, nativeColumns.at(_i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check if a left and a right cell of a compared column are equal, the way HashCell compares them
+ */
+bool TableDiff::CellsEqual(int leftRow, int rightRow, int position, bool native) const
+{
+    const int _leftColumn = LeftColumns.at(position);    // Column of the cell in the older version
+    const int _rightColumn = RightColumns.at(position);  // Column of the cell in the newer version
+    qint64 _leftValue = 0;   // Native value of the left cell (only valid if it holds one)
+    qint64 _rightValue = 0;  // Native value of the right cell (only valid if it holds one)
+    const bool _leftTyped = Left.GetTypedValue(leftRow, _leftColumn, &_leftValue);      // Flag indicating the left cell holds a native value
+    const bool _rightTyped = Right.GetTypedValue(rightRow, _rightColumn, &_rightValue); // Flag indicating the right cell holds a native value
+
+    if (native && _leftTyped && _rightTyped) {
+        return _leftValue == _rightValue;
+    }
+    if (!_leftTyped && !_rightTyped) {
+        return Left.GetCellView(leftRow, _leftColumn) == Right.GetCellView(rightRow, _rightColumn);
+    }
+    return Left.GetCell(leftRow, _leftColumn) == Right.GetCell(rightRow, _rightColumn);
+}
+
+/**
+ * @brief Mix a cell hash into a row hash so the cell position matters
+ */
+quint64 TableDiff::CombineHash(quint64 seed, quint64 value)
+{
+    return seed ^ (value + Q_UINT64_C(0x9e3779b97f4a7c15) + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * @brief Split a number of rows into chunks, one per pool thread at most
+ */
+QVector<int> TableDiff::GetChunkBounds(int rowCount)
+{
+    const int _maxChunks = qMax(1, QThreadPool::globalInstance()->maxThreadCount());  // One chunk per pool thread
+    const int _chunkCount = qBound(1, rowCount / MIN_CHUNK_ROWS, _maxChunks);  // Chunks actually used
+    QVector<int> _bounds;  // Chunk boundaries
+    for (int _i = 0; _i <= _chunkCount; ++_i) {  // Position of the boundary
+        _bounds.append(int(qint64(rowCount) * _i / _chunkCount));
+    }
+    return _bounds;
+}
@@ -0,0 +1,165 @@
+#ifndef TABLEDIFF_H
+#define TABLEDIFF_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "tablestore.h"
+
+/**
+ * @brief Compares two versions of a table by row hashes
+ * Every row is reduced once to a 64-bit hash of its cells in the columns both
+ * tables have, on the global thread pool; rows are then matched by sorting and
+ * merging the hashes. Equal hashes only propose a match: the cells of both rows
+ * are compared before rows are paired or counted as unchanged, so a hash
+ * collision cannot hide a difference. Rows are matched by the key column if one
+ * is given, and by their complete content otherwise, in which case an edited row
+ * shows up as one removed and one added row. Cells of columns stored with the
+ * same native type in both tables are hashed and compared by value without being
+ * formatted. The diff holds implicitly shared copies of both tables, so it can
+ * run on another thread
+ */
+class TableDiff
+{
+public:
+    /**
+     * @brief Kind of difference reported for a row
+     */
+    enum ChangeType {
+        RemovedRow,                      // Row only exists in the left table
+        ChangedRow,                      // Row with the same key has other values in the right table
+        AddedRow                         // Row only exists in the right table
+    };
+
+    /**
+     * @brief One reported difference
+     */
+    struct RowChange {
+        ChangeType Type;                 // Kind of difference
+        int LeftRow;                     // Row in the left table (-1 for added rows)
+        int RightRow;                    // Row in the right table (-1 for removed rows)
+    };
+
+    /**
+     * @brief Constructor for a comparison of two empty tables
+     */
+    TableDiff();
+
+    /**
+     * @brief Constructor for TableDiff
+     * @param left Older version of the table
+     * @param right Newer version of the table
+     * @param keyColumnName Column identifying a row in both versions (empty to match whole rows)
+     */
+    TableDiff(const TableData &left, const TableData &right, const QString &keyColumnName = QString());
+
+    /**
+     * @brief Compute the differences, blocking until done
+     * Rows with equal keys are paired in document order
+     * @return true if the tables were compared, false if the key column is missing in either table
+     */
+    bool Compare();
+
+    /**
+     * @brief Get the differences found by Compare
+     * Removed rows come first in left table order, followed by changed and added rows in right table order
+     * @return Differences, empty if the tables are equal in their common columns
+     */
+    QVector<RowChange> GetChanges() const;
+
+    /**
+     * @brief Get number of differences of one kind
+     * @param type RemovedRow, ChangedRow or AddedRow
+     * @return Number of rows reported with that kind
+     */
+    int GetChangeCount(ChangeType type) const;
+
+    /**
+     * @brief Get number of rows found equal in both tables
+     * @return Row count of the unchanged rows
+     */
+    int GetUnchangedRowCount() const;
+
+    /**
+     * @brief Get names of the columns that were compared
+     * @return Column names present in both tables, in left table order
+     */
+    QStringList GetCommonColumns() const;
+
+    /**
+     * @brief Get names of the columns only the left table has
+     * @return QStringList containing column names (not compared)
+     */
+    QStringList GetLeftOnlyColumns() const;
+
+    /**
+     * @brief Get names of the columns only the right table has
+     * @return QStringList containing column names (not compared)
+     */
+    QStringList GetRightOnlyColumns() const;
+
+    /**
+     * @brief Build a table listing the differences for display or export
+     * The first column names the change ("removed", "changed" or "added"), followed by the
+     * common columns; cells of changed rows that differ read "old -> new"
+     * @return Table with one row per difference, in GetChanges order
+     */
+    TableData CreateResultTable() const;
+
+private:
+    /**
+     * @brief Compute the row hash, and the key hash if a key column is used, of every row on the thread pool
+     * @param table Table to hash
+     * @param columns Index of every compared column in the table
+     * @param nativeColumns Flag per compared column indicating cells are hashed by native value
+     * @param keyPosition Position of the key column among the compared columns (-1 if none)
+     * @param rowHashes Receives the hash of every row
+     * @param keyHashes Receives the hash of every key cell (left untouched if keyPosition is -1)
+     */
+    static void HashRows(const TableData &table, const QVector<int> &columns, const QVector<bool> &nativeColumns, int keyPosition,
+                         QVector<quint64> *rowHashes, QVector<quint64> *keyHashes);
+
+    /**
+     * @brief Hash one cell by its text, or by its native value if both tables store the column with the same type
+     */
+    static quint64 HashCell(const TableData &table, int row, int column, bool native);
+
+    /**
+     * @brief Check if a left and a right row hold the same cells in all compared columns
+     * @param nativeColumns Flag per compared column indicating cells are compared by native value
+     */
+    bool RowsEqual(int leftRow, int rightRow, const QVector<bool> &nativeColumns) const;
+
+    /**
+     * @brief Check if a left and a right cell of a compared column are equal, the way HashCell compares them
+     * @param position Position of the column among the compared columns
+     * @param native true to compare native values if both cells hold one
+     */
+    bool CellsEqual(int leftRow, int rightRow, int position, bool native) const;
+
+    /**
+     * @brief Mix a cell hash into a row hash so the cell position matters
+     */
+    static quint64 CombineHash(quint64 seed, quint64 value);
+
+    /**
+     * @brief Split a number of rows into chunks, one per pool thread at most
+     * @return Chunk boundaries, starting with 0 and ending with rowCount
+     */
+    static QVector<int> GetChunkBounds(int rowCount);
+
+    TableData Left;                      // Older version (implicitly shared with the caller)
+    TableData Right;                     // Newer version (implicitly shared with the caller)
+    QString KeyColumnName;               // Column matching rows across versions (empty to match whole rows)
+    QStringList CommonColumns;           // Compared column names in left table order
+    QStringList LeftOnlyColumns;         // Column names missing in the right table
+    QStringList RightOnlyColumns;        // Column names missing in the left table
+    QVector<int> LeftColumns;            // Left table index of every compared column
+    QVector<int> RightColumns;           // Right table index of every compared column
+    QVector<RowChange> Changes;          // Differences found by the last Compare call
+    int UnchangedRowCount;               // Rows found equal by the last Compare call
+
+    static const int MIN_CHUNK_ROWS;     // Rows below which a chunk is not split further
+};
+
+#endif // TABLEDIFF_H
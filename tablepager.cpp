@@ -0,0 +1,206 @@
+#include "tablepager.h"
+#include <QDebug>
+
+/**
+ * @brief Constructor prepares reading the rows of a DOM table
+ */
+TablePager::TablePager(const QString &tableName, const QDomElement &tableElement, const QStringList &columnHeaders, int rowCount,
+                       const QString &rowElementName, const QString &cellElementName)
+    : TableName(tableName)             // Table name attribute
+    , ColumnHeaders(columnHeaders)     // Column names from the table index
+    , RowCount(rowCount)               // Rows of the whole table
+    , ReadRowCount(0)                  // Nothing read yet
+    , RowElementName(rowElementName)   // Row tag name
+    , CellElementName(cellElementName) // Cell tag name
+    , IsStream(false)                  // DOM table
+    , AtEnd(false)                     // Set below for empty tables
+    , Failed(false)                    // No error yet
+    , NextRowElement(tableElement.firstChildElement(rowElementName))  // First row to read
+    , SourceData()                     // Unused for DOM tables
+    , MappedFile()                     // Unused for DOM tables
+    , Reader()                         // Unused for DOM tables
+{
+    AtEnd = NextRowElement.isNull();
+}
+
+/**
+ * @brief Constructor prepares parsing the rows of a table byte range
+ */
+TablePager::TablePager(const QString &tableName, const QByteArray &sourceData, qint64 declarationLength, qint64 start, qint64 end, int rowCount,
+                       const QSharedPointer<QFile> &mappedFile, const QString &rowElementName, const QString &cellElementName)
+    : TableName(tableName)             // Table name attribute
+    , ColumnHeaders()                  // Taken from the first row
+    , RowCount(rowCount)               // Rows counted by the scanner
+    , ReadRowCount(0)                  // Nothing read yet
+    , RowElementName(rowElementName)   // Row tag name
+    , CellElementName(cellElementName) // Cell tag name
+    , IsStream(true)                   // Byte range
+    , AtEnd(false)                     // Known once the table end tag is reached
+    , Failed(false)                    // No error yet
+    , NextRowElement()                 // Unused for byte ranges
+    , SourceData(sourceData)           // Shared document bytes
+    , MappedFile(mappedFile)           // Shared file mapping
+    , Reader()                         // Set up below
+{
+    // The declaration keeps the document encoding; prefixes are declared on the root, outside the range
+    Reader.setNamespaceProcessing(false);
+    Reader.addData(QByteArray::fromRawData(SourceData.constData(), declarationLength));
+    Reader.addData(QByteArray::fromRawData(SourceData.constData() + start, end - start));
+
+    if (!Reader.readNextStartElement()) {
+        qDebug() << "Error: Table" << tableName << "does not start with an element";
+        AtEnd = true;
+        Failed = true;
+    }
+}
+
+/**
+ * @brief Get name of the table
+ */
+QString TablePager::GetTableName() const
+{
+    return TableName;
+}
+
+/**
+ * @brief Get column names of the table
+ */
+QStringList TablePager::GetColumnHeaders() const
+{
+    return ColumnHeaders;
+}
+
+/**
+ * @brief Get number of rows of the whole table
+ */
+int TablePager::GetRowCount() const
+{
+    return RowCount;
+}
+
+/**
+ * @brief Get number of rows read so far
+ */
+int TablePager::GetReadRowCount() const
+{
+    return ReadRowCount;
+}
+
+/**
+ * @brief Check if rows are left to read
+ */
+bool TablePager::CanReadMore() const
+{
+    return !AtEnd;
+}
+
+/**
+ * @brief Check if reading stopped on malformed XML
+ */
+bool TablePager::HasError() const
+{
+    return Failed;
+}
+
+/**
+ * @brief Read the next rows of the table
+ */
+bool TablePager::ReadRows(int maxRows, QList<QStringList> *rows)
+{
+    rows->clear();
+    if (AtEnd || maxRows <= 0) {
+        return !Failed;
+    }
+
+    if (IsStream) {
+        return ReadStreamRows(maxRows, rows);
+    }
+
+    ReadDomRows(maxRows, rows);
+    return true;
+}
+
+/**
+ * @brief Read the cell values of a DOM row element
+ */
+QStringList TablePager::ReadDomRow(const QDomElement &rowElement, const QString &cellElementName)
+{
+    QStringList _rowData;  // Text of every cell of the row
+    for (QDomElement _cellElement = rowElement.firstChildElement(cellElementName); !_cellElement.isNull();
+         _cellElement = _cellElement.nextSiblingElement(cellElementName)) {
+        _rowData.append(_cellElement.text());
+    }
+    return _rowData;
+}
+
+/**
+ * @brief Read the cells of the row element the reader is positioned on, up to its end tag
+ */
+void TablePager::ReadStreamRow(QXmlStreamReader &reader, const QString &cellElementName, QStringList *rowData, QStringList *cellNames)
+{
+    while (reader.readNextStartElement()) {
+        if (reader.name() != cellElementName) {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        if (cellNames) {
+            QString _columnName = reader.attributes().value("name").toString();  // Column name from cell attribute
+            cellNames->append(_columnName.isEmpty() ? QString("Column_%1").arg(cellNames->size() + 1) : _columnName);
+        }
+
+        rowData->append(reader.readElementText(QXmlStreamReader::IncludeChildElements));
+    }
+}
+
+/**
+ * @brief Read the next rows of a DOM table
+ */
+void TablePager::ReadDomRows(int maxRows, QList<QStringList> *rows)
+{
+    while (!NextRowElement.isNull() && rows->size() < maxRows) {
+        rows->append(ReadDomRow(NextRowElement, CellElementName));
+        NextRowElement = NextRowElement.nextSiblingElement(RowElementName);
+    }
+
+    ReadRowCount += rows->size();
+    AtEnd = NextRowElement.isNull();
+}
+
+/**
+ * @brief Read the next rows of a table byte range
+ */
+bool TablePager::ReadStreamRows(int maxRows, QList<QStringList> *rows)
+{
+    while (rows->size() < maxRows) {
+        if (!Reader.readNextStartElement()) {
+            AtEnd = true;  // Table end tag reached, or an error below
+            break;
+        }
+
+        if (Reader.name() != RowElementName) {
+            Reader.skipCurrentElement();
+            continue;
+        }
+
+        // First row defines the column structure, same as a full parse
+        QStringList _rowData;  // Cell values of the current row
+        QStringList _cellNames;  // Cell names of the current row (only collected for the first row)
+        ReadStreamRow(Reader, CellElementName, &_rowData, ReadRowCount == 0 && rows->isEmpty() ? &_cellNames : nullptr);
+        if (ReadRowCount == 0 && rows->isEmpty()) {
+            ColumnHeaders = _cellNames;
+        }
+        rows->append(_rowData);
+    }
+
+    if (Reader.hasError()) {
+        qDebug() << "Error: XML parsing failed in table" << TableName << ":" << Reader.errorString();
+        AtEnd = true;
+        Failed = true;
+        rows->clear();
+        return false;
+    }
+
+    ReadRowCount += rows->size();
+    return true;
+}
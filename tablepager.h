@@ -0,0 +1,140 @@
+#ifndef TABLEPAGER_H
+#define TABLEPAGER_H
+
+#include <QByteArray>
+#include <QDomElement>
+#include <QFile>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QXmlStreamReader>
+
+/**
+ * @brief Reads the rows of one table a page at a time
+ * A pager either walks the row elements of a DOM table or parses the byte range
+ * of a table in the source file, and only ever decodes the rows that are asked
+ * for. Row count and, for DOM tables, column headers are known up front from
+ * the worker's metadata. A pager keeps the DOM nodes or the file mapping it
+ * reads from alive; it must not be used once the table was modified
+ */
+class TablePager
+{
+public:
+    /**
+     * @brief Constructor for a pager over a DOM table
+     * @param tableName Name of the table
+     * @param tableElement Table element whose direct row children are read
+     * @param columnHeaders Column names of the table
+     * @param rowCount Number of row elements in the table
+     * @param rowElementName Tag name of the row elements
+     * @param cellElementName Tag name of the cell elements
+     */
+    TablePager(const QString &tableName, const QDomElement &tableElement, const QStringList &columnHeaders, int rowCount,
+               const QString &rowElementName, const QString &cellElementName);
+
+    /**
+     * @brief Constructor for a pager over the bytes of a table element
+     * @param tableName Name of the table
+     * @param sourceData Document bytes (kept alive by the pager)
+     * @param declarationLength Length of the XML declaration at the start of sourceData (0 if none)
+     * @param start Offset of the table start tag
+     * @param end Offset just past the table end tag
+     * @param rowCount Number of row elements in the table
+     * @param mappedFile File whose mapping backs sourceData (null if sourceData owns its bytes)
+     * @param rowElementName Tag name of the row elements
+     * @param cellElementName Tag name of the cell elements
+     */
+    TablePager(const QString &tableName, const QByteArray &sourceData, qint64 declarationLength, qint64 start, qint64 end, int rowCount,
+               const QSharedPointer<QFile> &mappedFile, const QString &rowElementName, const QString &cellElementName);
+
+    /**
+     * @brief Get name of the table
+     * @return QString containing the table name
+     */
+    QString GetTableName() const;
+
+    /**
+     * @brief Get column names of the table
+     * For byte ranges they are taken from the first row, so they are only known once a row was read
+     * @return QStringList containing column names
+     */
+    QStringList GetColumnHeaders() const;
+
+    /**
+     * @brief Get number of rows of the whole table
+     * @return Row count taken from the metadata
+     */
+    int GetRowCount() const;
+
+    /**
+     * @brief Get number of rows read so far
+     * @return Number of rows handed out by ReadRows
+     */
+    int GetReadRowCount() const;
+
+    /**
+     * @brief Check if rows are left to read
+     * @return true if ReadRows can return more rows, false at the end of the table or after an error
+     */
+    bool CanReadMore() const;
+
+    /**
+     * @brief Check if reading stopped on malformed XML
+     * @return true if the table could not be read to its end, false otherwise
+     */
+    bool HasError() const;
+
+    /**
+     * @brief Read the next rows of the table
+     * @param maxRows Largest number of rows to read
+     * @param rows Receives the cell values of the rows read, in document order
+     * @return true if rows could be read, false on XML error
+     */
+    bool ReadRows(int maxRows, QList<QStringList> *rows);
+
+    /**
+     * @brief Read the cell values of a DOM row element
+     * Walks only direct cell children, so nested elements are never visited
+     * @param rowElement Row element to read
+     * @param cellElementName Tag name of the cell elements
+     * @return QStringList containing the text of every cell
+     */
+    static QStringList ReadDomRow(const QDomElement &rowElement, const QString &cellElementName);
+
+    /**
+     * @brief Read the cells of the row element the reader is positioned on, up to its end tag
+     * @param reader Reader positioned on the row start element
+     * @param cellElementName Tag name of the cell elements
+     * @param rowData Receives the text of every cell
+     * @param cellNames Receives the column name of every cell, numbered when unnamed (nullptr to skip)
+     */
+    static void ReadStreamRow(QXmlStreamReader &reader, const QString &cellElementName, QStringList *rowData, QStringList *cellNames);
+
+private:
+    /**
+     * @brief Read the next rows of a DOM table
+     */
+    void ReadDomRows(int maxRows, QList<QStringList> *rows);
+
+    /**
+     * @brief Read the next rows of a table byte range
+     */
+    bool ReadStreamRows(int maxRows, QList<QStringList> *rows);
+
+    QString TableName;                   // Name of the table
+    QStringList ColumnHeaders;           // Column names (empty for byte ranges until the first row is read)
+    int RowCount;                        // Number of rows of the whole table
+    int ReadRowCount;                    // Number of rows handed out so far
+    QString RowElementName;              // Tag name of the row elements
+    QString CellElementName;             // Tag name of the cell elements
+    bool IsStream;                       // Flag indicating a byte range is parsed (true) or a DOM table is walked (false)
+    bool AtEnd;                          // Flag indicating the last row was read or reading failed (true) or not (false)
+    bool Failed;                         // Flag indicating reading stopped on malformed XML (true) or not (false)
+    QDomElement NextRowElement;          // Next DOM row element to read (null at the end, DOM tables only)
+    QByteArray SourceData;               // Document bytes the reader parses (byte ranges only)
+    QSharedPointer<QFile> MappedFile;    // Keeps the mapping behind SourceData alive (null if not mapped)
+    QXmlStreamReader Reader;             // Reader over the declaration and the table bytes (byte ranges only)
+};
+
+#endif // TABLEPAGER_H
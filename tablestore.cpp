@@ -0,0 +1,1166 @@
+#include "tablestore.h"
+#include <QDate>
+#include <limits>
+#include "xmlprofiler.h"
+
+// Columns with more distinct values than this are stored as plain text instead of pool ids
+const int TableData::DICTIONARY_MAX_CARDINALITY = 65536;
+
+// Slots of typed columns: EMPTY_SLOT is an empty cell, the MAX_OUTLIERS slots after it address
+// Outliers, every other slot is a native value. Values inside that range are kept as outliers
+const qint64 TableData::EMPTY_SLOT = std::numeric_limits<qint32>::min();
+const int TableData::MAX_OUTLIERS = 65536;
+const int TableData::OUTLIER_RATIO = 64;
+const int TableData::MAX_DECIMAL_SCALE = 9;
+
+/**
+ * @brief Get 10 raised to a small exponent
+ */
+static qint64 PowerOfTen(int exponent)
+{
+    qint64 _power = 1;  // Result
+    for (int _i = 0; _i < exponent; ++_i) {  // Factors applied so far
+        _power *= 10;
+    }
+    return _power;
+}
+
+/**
+ * @brief Parse a non-empty run of ASCII digits, at most 18 so the value cannot overflow
+ */
+static bool ParseDigits(QStringView text, qint64 *value)
+{
+    if (text.isEmpty() || text.size() > 18) {
+        return false;
+    }
+
+    qint64 _value = 0;  // Digits parsed so far
+    for (QChar _char : text) {  // Current character
+        if (_char.unicode() < '0' || _char.unicode() > '9') {
+            return false;
+        }
+        _value = _value * 10 + (_char.unicode() - '0');
+    }
+
+    *value = _value;
+    return true;
+}
+
+/**
+ * @brief Write a number as a fixed count of digits with leading zeros
+ */
+static void WriteDigits(QChar *target, int digitCount, int value)
+{
+    for (int _i = digitCount - 1; _i >= 0; --_i) {  // Position of the digit, from the right
+        target[_i] = QChar(ushort('0' + value % 10));
+        value /= 10;
+    }
+}
+
+/**
+ * @brief Write an array as its element count followed by its bytes in native byte order
+ */
+template <typename T>
+static void WriteRawArray(QDataStream &stream, const T *data, qint64 count)
+{
+    const qint64 _byteCount = count * qint64(sizeof(T));  // Bytes to write
+    stream << count;
+
+    // Raw writes take an int length in older Qt versions, large columns go out in pieces
+    for (qint64 _written = 0; _written < _byteCount;) {  // Bytes written so far
+        const int _chunk = int(qMin<qint64>(_byteCount - _written, 1 << 30));  // Bytes of the current piece
+        stream.writeRawData(reinterpret_cast<const char *>(data) + _written, _chunk);
+        _written += _chunk;
+    }
+}
+
+/**
+ * @brief Read an array written by WriteRawArray into a QVector or QString
+ */
+template <typename Container>
+static bool ReadRawArray(QDataStream &stream, Container *array)
+{
+    qint64 _count = 0;  // Element count
+    stream >> _count;
+
+    // A corrupt count must not turn into a huge allocation
+    const qint64 _byteCount = _count * qint64(sizeof(*array->data()));  // Bytes to read
+    if (stream.status() != QDataStream::Ok || _count < 0 || _byteCount > stream.device()->bytesAvailable()) {
+        return false;
+    }
+
+    array->resize(qsizetype(_count));
+    for (qint64 _read = 0; _read < _byteCount;) {  // Bytes read so far
+        const int _chunk = int(qMin<qint64>(_byteCount - _read, 1 << 30));  // Bytes of the current piece
+        if (stream.readRawData(reinterpret_cast<char *>(array->data()) + _read, _chunk) != _chunk) {
+            return false;
+        }
+        _read += _chunk;
+    }
+    return true;
+}
+
+/**
+ * @brief Constructor initializes an empty dictionary encoded column
+ */
+TableData::ColumnData::ColumnData()
+    : Type(TextColumn)                 // Columns start as text
+    , DictionaryEncoded(true)          // Columns start dictionary encoded
+    , Codes()                          // Pool ids per row
+    , DistinctCodes()                  // Distinct pool ids
+    , Buffer()                         // Plain text buffer
+    , Starts()                         // Plain text offsets
+    , Lengths()                        // Plain text lengths
+    , UnusedLength(0)                  // Unreferenced buffer characters
+    , Scale(0)                         // No fraction digits
+    , Wide(false)                      // 32-bit slots
+    , NarrowSlots()                    // 32-bit slots
+    , WideSlots()                      // 64-bit slots
+    , Outliers()                       // Texts kept as they are
+{
+}
+
+/**
+ * @brief Constructor initializes an empty table
+ */
+TableData::TableData(const QString &tableName, const QSharedPointer<StringPool> &stringPool)
+    : Name(tableName)                  // Table name attribute
+    , ColumnHeaders()                  // Column names of the table
+    , Columns()                        // Columnar cell storage
+    , Pool(stringPool.isNull() ? QSharedPointer<StringPool>(new StringPool()) : stringPool)  // Dictionary value pool
+    , RowCount(0)                      // Number of stored rows
+{
+}
+
+/**
+ * @brief Get name of the table
+ */
+QString TableData::GetName() const
+{
+    return Name;
+}
+
+/**
+ * @brief Get column headers of the table
+ */
+QStringList TableData::GetColumnHeaders() const
+{
+    return ColumnHeaders;
+}
+
+/**
+ * @brief Replace column headers, adding empty columns or dropping trailing ones
+ */
+void TableData::SetColumnHeaders(const QStringList &columnHeaders)
+{
+    while (Columns.size() > columnHeaders.size()) {
+        Columns.removeLast();
+    }
+
+    while (Columns.size() < columnHeaders.size()) {
+        ColumnData _column;  // New column filled with empty values for existing rows
+        _column.Codes.fill(0, RowCount);
+        if (RowCount > 0) {
+            _column.DistinctCodes.insert(0);
+        }
+        Columns.append(_column);
+    }
+
+    ColumnHeaders.clear();
+    ColumnHeaders.reserve(columnHeaders.size());
+    for (const QString &_header : columnHeaders) {  // Column name as given by the caller
+        ColumnHeaders.append(Pool->GetString(Pool->Intern(_header)));
+    }
+}
+
+/**
+ * @brief Get number of rows stored in the table
+ */
+int TableData::GetRowCount() const
+{
+    return RowCount;
+}
+
+/**
+ * @brief Get number of columns of the table
+ */
+int TableData::GetColumnCount() const
+{
+    return ColumnHeaders.size();
+}
+
+/**
+ * @brief Get value of a single cell
+ */
+QString TableData::GetCell(int row, int column) const
+{
+    if (row < 0 || row >= RowCount || column < 0 || column >= Columns.size()) {
+        return QString();
+    }
+
+    const ColumnData &_column = Columns.at(column);  // Storage of the requested column
+    if (_column.Type != TextColumn) {
+        return FormatSlot(_column, GetSlot(_column, row));
+    }
+    return _column.DictionaryEncoded ? Pool->GetString(_column.Codes.at(row)) : GetValueView(_column, row).toString();
+}
+
+/**
+ * @brief Get read-only view of a single cell without copying its text
+ */
+QStringView TableData::GetCellView(int row, int column) const
+{
+    if (row < 0 || row >= RowCount || column < 0 || column >= Columns.size()) {
+        return QStringView();
+    }
+
+    return GetValueView(Columns.at(column), row);
+}
+
+/**
+ * @brief Store columns of uniformly typed values as native values
+ */
+void TableData::InferColumnTypes()
+{
+    XML_PROFILE_SCOPE("Infer column types");
+
+    for (ColumnData &_column : Columns) {
+        if (_column.Type != TextColumn || RowCount == 0) {
+            continue;
+        }
+
+        // Canonical forms of the types never overlap, so every value counts for at most one type
+        QVector<int> _typeCounts(BoolColumn + 1, 0);        // Values of each type (decimals excluded)
+        QVector<int> _decimalCounts(MAX_DECIMAL_SCALE + 1, 0);  // Decimal values by number of fraction digits
+        int _valueCount = 0;                                // Non-empty values
+        for (int _row = 0; _row < RowCount; ++_row) {  // Current row index (0-based)
+            const QStringView _value = GetValueView(_column, _row);  // Stored text of the row
+            if (_value.isEmpty()) {
+                continue;
+            }
+
+            int _scale = 0;  // Fraction digits of a decimal value
+            const ColumnType _type = ClassifyValue(_value, &_scale);  // Type whose canonical form the value is
+            if (_type == DecimalColumn) {
+                _decimalCounts[_scale]++;
+            } else {
+                _typeCounts[_type]++;
+            }
+            _valueCount++;
+        }
+
+        ColumnType _bestType = TextColumn;  // Type held by most values
+        int _bestScale = 0;                 // Fraction digits of the best type
+        int _bestCount = 0;                 // Values of the best type
+        for (ColumnType _type : {IntegerColumn, DateColumn, BoolColumn}) {  // Candidate type
+            if (_typeCounts.at(_type) > _bestCount) {
+                _bestType = _type;
+                _bestCount = _typeCounts.at(_type);
+            }
+        }
+        for (int _scale = 1; _scale <= MAX_DECIMAL_SCALE; ++_scale) {  // Candidate number of fraction digits
+            if (_decimalCounts.at(_scale) > _bestCount) {
+                _bestType = DecimalColumn;
+                _bestScale = _scale;
+                _bestCount = _decimalCounts.at(_scale);
+            }
+        }
+
+        const int _allowedOutliers = qMin(_valueCount / OUTLIER_RATIO, MAX_OUTLIERS);  // Values that may stay text
+        if (_bestCount > 0 && _valueCount - _bestCount <= _allowedOutliers) {
+            ConvertToTyped(_column, _bestType, _bestScale);
+        }
+    }
+}
+
+/**
+ * @brief Get storage type of a column
+ */
+TableData::ColumnType TableData::GetColumnType(int column) const
+{
+    return column >= 0 && column < Columns.size() ? Columns.at(column).Type : TextColumn;
+}
+
+/**
+ * @brief Get number of fraction digits of a decimal column
+ */
+int TableData::GetDecimalScale(int column) const
+{
+    return GetColumnType(column) == DecimalColumn ? Columns.at(column).Scale : 0;
+}
+
+/**
+ * @brief Get native value of a cell of a typed column
+ */
+bool TableData::GetTypedValue(int row, int column, qint64 *value) const
+{
+    if (row < 0 || row >= RowCount || GetColumnType(column) == TextColumn) {
+        return false;
+    }
+
+    const qint64 _slot = GetSlot(Columns.at(column), row);  // Stored slot of the cell
+    if (_slot >= EMPTY_SLOT && _slot <= EMPTY_SLOT + MAX_OUTLIERS) {
+        return false;
+    }
+
+    *value = _slot;
+    return true;
+}
+
+/**
+ * @brief Get a cell of an integer or decimal column as a number
+ */
+bool TableData::GetNumericValue(int row, int column, double *value) const
+{
+    const ColumnType _type = GetColumnType(column);  // Storage type of the column
+    qint64 _typedValue = 0;  // Native value of the cell
+    if ((_type != IntegerColumn && _type != DecimalColumn) || !GetTypedValue(row, column, &_typedValue)) {
+        return false;
+    }
+
+    *value = _type == DecimalColumn ? double(_typedValue) / double(PowerOfTen(Columns.at(column).Scale)) : double(_typedValue);
+    return true;
+}
+
+/**
+ * @brief Parse text the way a typed column stores it
+ */
+bool TableData::ParseTypedValue(int column, QStringView text, qint64 *value) const
+{
+    const ColumnType _type = GetColumnType(column);  // Storage type of the column
+    return _type != TextColumn && ParseCanonical(_type, Columns.at(column).Scale, text, value);
+}
+
+/**
+ * @brief Check whether a column is stored dictionary encoded
+ */
+bool TableData::IsDictionaryColumn(int column) const
+{
+    return column >= 0 && column < Columns.size() && Columns.at(column).DictionaryEncoded;
+}
+
+/**
+ * @brief Get the pool used for dictionary encoded values
+ */
+QSharedPointer<StringPool> TableData::GetStringPool() const
+{
+    return Pool;
+}
+
+/**
+ * @brief Get all cell values of a row
+ */
+QStringList TableData::GetRow(int row) const
+{
+    QStringList _rowData;  // Cell values of the requested row
+    if (row < 0 || row >= RowCount) {
+        return _rowData;
+    }
+
+    _rowData.reserve(Columns.size());
+    for (int _col = 0; _col < Columns.size(); ++_col) {  // Current column index (0-based)
+        _rowData.append(GetCell(row, _col));
+    }
+
+    return _rowData;
+}
+
+/**
+ * @brief Set value of a single cell
+ */
+void TableData::SetCell(int row, int column, const QString &value)
+{
+    if (row < 0 || row >= RowCount || column < 0 || column >= Columns.size()) {
+        return;
+    }
+
+    ReplaceValue(Columns[column], row, value);
+}
+
+/**
+ * @brief Append row to the end of the table
+ */
+void TableData::AppendRow(const QStringList &rowData)
+{
+    for (int _col = 0; _col < Columns.size(); ++_col) {  // Current column index (0-based)
+        InsertValue(Columns[_col], RowCount, _col < rowData.size() ? QStringView(rowData.at(_col)) : QStringView());
+    }
+
+    RowCount++;
+}
+
+/**
+ * @brief Append row to the end of the table from views into text owned by the caller
+ */
+void TableData::AppendRowViews(const QVector<QStringView> &rowData)
+{
+    for (int _col = 0; _col < Columns.size(); ++_col) {  // Current column index (0-based)
+        InsertValue(Columns[_col], RowCount, _col < rowData.size() ? rowData.at(_col) : QStringView());
+    }
+
+    RowCount++;
+}
+
+/**
+ * @brief Insert row before the given position
+ */
+bool TableData::InsertRow(int row, const QStringList &rowData)
+{
+    if (row < 0 || row > RowCount) {
+        return false;
+    }
+
+    for (int _col = 0; _col < Columns.size(); ++_col) {  // Current column index (0-based)
+        InsertValue(Columns[_col], row, _col < rowData.size() ? QStringView(rowData.at(_col)) : QStringView());
+    }
+
+    RowCount++;
+    return true;
+}
+
+/**
+ * @brief Remove row from the table
+ */
+bool TableData::RemoveRow(int row)
+{
+    if (row < 0 || row >= RowCount) {
+        return false;
+    }
+
+    return RemoveRows(QList<int>() << row) == 1;
+}
+
+/**
+ * @brief Remove several rows in one compacting pass over every column
+ */
+int TableData::RemoveRows(const QList<int> &sortedRows)
+{
+    // Mark rows to drop once, then compact each column with the same mask
+    QVector<bool> _removed(RowCount, false);  // Flag per row indicating it is dropped (true) or kept (false)
+    int _removedCount = 0;                    // Number of distinct rows dropped
+
+    for (int _row : sortedRows) {
+        if (_row >= 0 && _row < RowCount && !_removed.at(_row)) {
+            _removed[_row] = true;
+            _removedCount++;
+        }
+    }
+
+    if (_removedCount == 0) {
+        return 0;
+    }
+
+    for (ColumnData &_column : Columns) {
+        int _writeRow = 0;  // Next position receiving a kept row
+
+        for (int _row = 0; _row < RowCount; ++_row) {  // Current source row index (0-based)
+            if (_removed.at(_row)) {
+                if (_column.Type == TextColumn && !_column.DictionaryEncoded) {
+                    _column.UnusedLength += _column.Lengths.at(_row);
+                }
+                continue;
+            }
+
+            if (_writeRow != _row) {
+                if (_column.Type != TextColumn) {
+                    if (_column.Wide) {
+                        _column.WideSlots[_writeRow] = _column.WideSlots.at(_row);
+                    } else {
+                        _column.NarrowSlots[_writeRow] = _column.NarrowSlots.at(_row);
+                    }
+                } else if (_column.DictionaryEncoded) {
+                    _column.Codes[_writeRow] = _column.Codes.at(_row);
+                } else {
+                    _column.Starts[_writeRow] = _column.Starts.at(_row);
+                    _column.Lengths[_writeRow] = _column.Lengths.at(_row);
+                }
+            }
+            _writeRow++;
+        }
+
+        if (_column.Type != TextColumn) {
+            _column.WideSlots.resize(_column.Wide ? _writeRow : 0);
+            _column.NarrowSlots.resize(_column.Wide ? 0 : _writeRow);
+        } else if (_column.DictionaryEncoded) {
+            _column.Codes.resize(_writeRow);
+        } else {
+            _column.Starts.resize(_writeRow);
+            _column.Lengths.resize(_writeRow);
+            CompactBuffer(_column);
+        }
+    }
+
+    RowCount -= _removedCount;
+    return _removedCount;
+}
+
+/**
+ * @brief Remove all rows while keeping the column headers
+ */
+void TableData::ClearRows()
+{
+    for (ColumnData &_column : Columns) {
+        _column = ColumnData();
+    }
+
+    RowCount = 0;
+}
+
+/**
+ * @brief Write the table in the binary snapshot format
+ */
+void TableData::WriteSnapshot(QDataStream &stream) const
+{
+    stream << Name << ColumnHeaders << qint32(RowCount);
+
+    for (const ColumnData &_column : Columns) {
+        stream << qint32(_column.Type);
+
+        if (_column.Type != TextColumn) {
+            stream << qint32(_column.Scale) << _column.Wide << _column.Outliers;
+            if (_column.Wide) {
+                WriteRawArray(stream, _column.WideSlots.constData(), _column.WideSlots.size());
+            } else {
+                WriteRawArray(stream, _column.NarrowSlots.constData(), _column.NarrowSlots.size());
+            }
+            continue;
+        }
+
+        stream << _column.DictionaryEncoded;
+
+        if (_column.DictionaryEncoded) {
+            // Pool ids are only meaningful with their text, the reader assigns ids of its own pool
+            stream << qint32(_column.DistinctCodes.size());
+            for (quint32 _code : _column.DistinctCodes) {  // Pool id used by the column
+                stream << _code << Pool->GetString(_code);
+            }
+            WriteRawArray(stream, _column.Codes.constData(), _column.Codes.size());
+        } else {
+            WriteRawArray(stream, _column.Buffer.utf16(), _column.Buffer.size());
+            WriteRawArray(stream, _column.Starts.constData(), _column.Starts.size());
+            WriteRawArray(stream, _column.Lengths.constData(), _column.Lengths.size());
+            stream << qint64(_column.UnusedLength);
+        }
+    }
+}
+
+/**
+ * @brief Replace the table content with a table written by WriteSnapshot
+ */
+bool TableData::ReadSnapshot(QDataStream &stream)
+{
+    qint32 _rowCount = 0;  // Stored row count
+    stream >> Name >> ColumnHeaders >> _rowCount;
+    if (stream.status() != QDataStream::Ok || _rowCount < 0) {
+        return false;
+    }
+
+    Columns.clear();
+    RowCount = 0;
+
+    for (int _col = 0; _col < ColumnHeaders.size(); ++_col) {  // Current column index (0-based)
+        ColumnData _column;  // Column being read
+        qint32 _type = TextColumn;  // Storage type of the column
+        stream >> _type;
+        if (stream.status() != QDataStream::Ok || _type < TextColumn || _type > BoolColumn) {
+            return false;
+        }
+        _column.Type = ColumnType(_type);
+
+        if (_column.Type != TextColumn) {
+            qint32 _scale = 0;  // Fraction digits of a decimal column
+            stream >> _scale >> _column.Wide >> _column.Outliers;
+            if (stream.status() != QDataStream::Ok || _scale < 0 || _scale > MAX_DECIMAL_SCALE
+                || (_column.Type == DecimalColumn) != (_scale > 0) || _column.Outliers.size() > MAX_OUTLIERS) {
+                return false;
+            }
+            _column.Scale = _scale;
+            _column.DictionaryEncoded = false;
+
+            const bool _slotsRead = _column.Wide ? ReadRawArray(stream, &_column.WideSlots) && _column.WideSlots.size() == _rowCount
+                                                 : ReadRawArray(stream, &_column.NarrowSlots) && _column.NarrowSlots.size() == _rowCount;  // Flag indicating one slot per row was read (true) or not (false)
+            if (!_slotsRead) {
+                return false;
+            }
+            for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+                const qint64 _slot = GetSlot(_column, _row);  // Slot of the row
+                if (_slot > EMPTY_SLOT + _column.Outliers.size() && _slot <= EMPTY_SLOT + MAX_OUTLIERS) {
+                    return false;  // Outlier that was not written
+                }
+            }
+
+            Columns.append(_column);
+            continue;
+        }
+
+        stream >> _column.DictionaryEncoded;
+
+        if (_column.DictionaryEncoded) {
+            qint32 _distinctCount = 0;  // Number of distinct values
+            stream >> _distinctCount;
+            if (stream.status() != QDataStream::Ok || _distinctCount < 0 || _distinctCount > DICTIONARY_MAX_CARDINALITY) {
+                return false;
+            }
+
+            // Translate written ids to ids of this pool through one dense table
+            QVector<quint32> _writtenCodes(_distinctCount);  // Ids as written
+            QVector<quint32> _poolCodes(_distinctCount);     // Ids in this table's pool
+            quint32 _maxWrittenCode = 0;                     // Largest written id
+            QString _value;                                  // Text of the current value
+            for (int _i = 0; _i < _distinctCount; ++_i) {  // Position in the written dictionary
+                stream >> _writtenCodes[_i] >> _value;
+                _poolCodes[_i] = Pool->Intern(_value);
+                _maxWrittenCode = qMax(_maxWrittenCode, _writtenCodes.at(_i));
+                _column.DistinctCodes.insert(_poolCodes.at(_i));
+            }
+
+            if (!ReadRawArray(stream, &_column.Codes) || _column.Codes.size() != _rowCount) {
+                return false;
+            }
+
+            QVector<quint32> _codeMap(_distinctCount > 0 ? qsizetype(_maxWrittenCode) + 1 : 0, quint32(-1));  // Written id to pool id (-1 if unused)
+            for (int _i = 0; _i < _distinctCount; ++_i) {
+                _codeMap[_writtenCodes.at(_i)] = _poolCodes.at(_i);
+            }
+            for (quint32 &_code : _column.Codes) {  // Id of the current row
+                if (_code >= quint32(_codeMap.size()) || _codeMap.at(_code) == quint32(-1)) {
+                    return false;
+                }
+                _code = _codeMap.at(_code);
+            }
+        } else {
+            qint64 _unusedLength = 0;  // Unreferenced characters in the buffer
+            if (!ReadRawArray(stream, &_column.Buffer) || !ReadRawArray(stream, &_column.Starts) || !ReadRawArray(stream, &_column.Lengths)) {
+                return false;
+            }
+            stream >> _unusedLength;
+            if (_column.Starts.size() != _rowCount || _column.Lengths.size() != _rowCount) {
+                return false;
+            }
+
+            _column.UnusedLength = qsizetype(_unusedLength);
+            for (int _row = 0; _row < _rowCount; ++_row) {  // Current row index (0-based)
+                if (qint64(_column.Starts.at(_row)) + _column.Lengths.at(_row) > _column.Buffer.size()) {
+                    return false;
+                }
+            }
+        }
+
+        Columns.append(_column);
+    }
+
+    RowCount = _rowCount;
+    return stream.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief Get view of a value stored in a column
+ */
+QStringView TableData::GetValueView(const ColumnData &column, int row) const
+{
+    if (column.Type != TextColumn) {
+        // Only empty cells and outliers have text of their own
+        const qint64 _slot = GetSlot(column, row);  // Stored slot of the row
+        return _slot > EMPTY_SLOT && _slot <= EMPTY_SLOT + MAX_OUTLIERS ? QStringView(column.Outliers.at(int(_slot - EMPTY_SLOT - 1)))
+                                                                         : QStringView();
+    }
+
+    if (column.DictionaryEncoded) {
+        return Pool->GetView(column.Codes.at(row));
+    }
+
+    return QStringView(column.Buffer).mid(column.Starts.at(row), column.Lengths.at(row));
+}
+
+/**
+ * @brief Add value at a row position of a column
+ */
+void TableData::InsertValue(ColumnData &column, int row, QStringView value)
+{
+    if (column.Type != TextColumn) {
+        qint64 _slot = 0;  // Slot of the value
+        if (EncodeSlot(column, value, &_slot)) {
+            PutSlot(column, row, _slot, true);
+            return;
+        }
+        ConvertTypedToPlain(column);  // Too many outliers, the column stays text from now on
+    }
+
+    if (column.DictionaryEncoded) {
+        const quint32 _code = Pool->Intern(value);  // Pool id of the value
+        column.DistinctCodes.insert(_code);
+        column.Codes.insert(row, _code);
+
+        if (column.DistinctCodes.size() > DICTIONARY_MAX_CARDINALITY) {
+            ConvertToPlain(column);
+        }
+        return;
+    }
+
+    column.Starts.insert(row, quint32(column.Buffer.size()));
+    column.Lengths.insert(row, quint32(value.size()));
+    column.Buffer.append(value);
+}
+
+/**
+ * @brief Replace value at a row position of a column
+ */
+void TableData::ReplaceValue(ColumnData &column, int row, QStringView value)
+{
+    if (column.Type != TextColumn) {
+        qint64 _slot = 0;  // Slot of the value
+        if (EncodeSlot(column, value, &_slot)) {
+            PutSlot(column, row, _slot, false);
+            return;
+        }
+        ConvertTypedToPlain(column);  // Too many outliers, the column stays text from now on
+    }
+
+    if (column.DictionaryEncoded) {
+        const quint32 _code = Pool->Intern(value);  // Pool id of the value
+        column.DistinctCodes.insert(_code);
+        column.Codes[row] = _code;
+
+        if (column.DistinctCodes.size() > DICTIONARY_MAX_CARDINALITY) {
+            ConvertToPlain(column);
+        }
+        return;
+    }
+
+    // Overwrite in place when the new text fits, otherwise append to the buffer
+    if (quint32(value.size()) <= column.Lengths.at(row)) {
+        column.UnusedLength += column.Lengths.at(row) - value.size();
+        column.Buffer.replace(column.Starts.at(row), value.size(), value.data(), value.size());
+    } else {
+        column.UnusedLength += column.Lengths.at(row);
+        column.Starts[row] = quint32(column.Buffer.size());
+        column.Buffer.append(value);
+    }
+    column.Lengths[row] = quint32(value.size());
+
+    CompactBuffer(column);
+}
+
+/**
+ * @brief Switch a dictionary encoded column to plain text storage
+ */
+void TableData::ConvertToPlain(ColumnData &column)
+{
+    ColumnData _plainColumn;  // Column rebuilt with plain text storage
+    _plainColumn.DictionaryEncoded = false;
+    _plainColumn.Starts.reserve(column.Codes.size());
+    _plainColumn.Lengths.reserve(column.Codes.size());
+
+    for (quint32 _code : column.Codes) {
+        const QStringView _value = Pool->GetView(_code);  // Pooled text of the current row
+        _plainColumn.Starts.append(quint32(_plainColumn.Buffer.size()));
+        _plainColumn.Lengths.append(quint32(_value.size()));
+        _plainColumn.Buffer.append(_value);
+    }
+
+    column = _plainColumn;
+}
+
+/**
+ * @brief Rewrite a plain column buffer without unreferenced text once at least half of it is unused
+ */
+void TableData::CompactBuffer(ColumnData &column)
+{
+    if (column.Type != TextColumn || column.DictionaryEncoded || column.UnusedLength * 2 < column.Buffer.size()) {
+        return;
+    }
+
+    QString _buffer;  // Buffer holding only referenced text
+    _buffer.reserve(column.Buffer.size() - column.UnusedLength);
+
+    for (int _row = 0; _row < column.Starts.size(); ++_row) {  // Current row index (0-based)
+        const quint32 _start = quint32(_buffer.size());  // New offset of the row's text
+        _buffer.append(QStringView(column.Buffer).mid(column.Starts.at(_row), column.Lengths.at(_row)));
+        column.Starts[_row] = _start;
+    }
+
+    column.Buffer = _buffer;
+    column.UnusedLength = 0;
+}
+
+/**
+ * @brief Switch a text column to native values of a type
+ */
+void TableData::ConvertToTyped(ColumnData &column, ColumnType type, int scale)
+{
+    ColumnData _typedColumn;  // Column rebuilt with native values
+    _typedColumn.Type = type;
+    _typedColumn.DictionaryEncoded = false;
+    _typedColumn.Scale = scale;
+
+    QVector<qint64> _slots(RowCount);  // Slot of every row
+    QHash<QStringView, qint64> _outlierSlots;  // Slot of each distinct outlier, views into the text column
+    bool _fitsNarrow = true;  // Flag indicating every slot fits 32 bits (true) or not (false)
+    for (int _row = 0; _row < RowCount; ++_row) {  // Current row index (0-based)
+        const QStringView _value = GetValueView(column, _row);  // Stored text of the row
+        qint64 &_slot = _slots[_row];  // Slot of the row
+        if (!_value.isEmpty() && !ParseCanonical(type, scale, _value, &_slot)) {
+            auto _iterator = _outlierSlots.constFind(_value);  // Earlier outlier with the same text (end if new)
+            if (_iterator == _outlierSlots.constEnd()) {
+                EncodeSlot(_typedColumn, _value, &_slot);  // Inference admits at most MAX_OUTLIERS outliers
+                _iterator = _outlierSlots.insert(_value, _slot);
+            }
+            _slot = _iterator.value();
+        } else if (_value.isEmpty()) {
+            _slot = EMPTY_SLOT;
+        }
+        _fitsNarrow = _fitsNarrow && _slot >= std::numeric_limits<qint32>::min() && _slot <= std::numeric_limits<qint32>::max();
+    }
+
+    if (_fitsNarrow) {
+        _typedColumn.NarrowSlots.resize(RowCount);
+        for (int _row = 0; _row < RowCount; ++_row) {  // Current row index (0-based)
+            _typedColumn.NarrowSlots[_row] = qint32(_slots.at(_row));
+        }
+    } else {
+        _typedColumn.Wide = true;
+        _typedColumn.WideSlots = _slots;
+    }
+
+    column = _typedColumn;
+}
+
+/**
+ * @brief Switch a typed column back to plain text storage
+ */
+void TableData::ConvertTypedToPlain(ColumnData &column)
+{
+    ColumnData _plainColumn;  // Column rebuilt with plain text storage
+    _plainColumn.DictionaryEncoded = false;
+    _plainColumn.Starts.reserve(RowCount);
+    _plainColumn.Lengths.reserve(RowCount);
+
+    for (int _row = 0; _row < RowCount; ++_row) {  // Current row index (0-based)
+        const QString _value = FormatSlot(column, GetSlot(column, _row));  // Text of the current row
+        _plainColumn.Starts.append(quint32(_plainColumn.Buffer.size()));
+        _plainColumn.Lengths.append(quint32(_value.size()));
+        _plainColumn.Buffer.append(_value);
+    }
+
+    column = _plainColumn;
+}
+
+/**
+ * @brief Get the slot of a row of a typed column
+ */
+qint64 TableData::GetSlot(const ColumnData &column, int row)
+{
+    return column.Wide ? column.WideSlots.at(row) : qint64(column.NarrowSlots.at(row));
+}
+
+/**
+ * @brief Store a slot at a row position of a typed column, widening the column if needed
+ */
+void TableData::PutSlot(ColumnData &column, int row, qint64 slot, bool insert)
+{
+    if (!column.Wide && (slot < std::numeric_limits<qint32>::min() || slot > std::numeric_limits<qint32>::max())) {
+        column.WideSlots = QVector<qint64>(column.NarrowSlots.cbegin(), column.NarrowSlots.cend());
+        column.NarrowSlots = QVector<qint32>();
+        column.Wide = true;
+    }
+
+    if (column.Wide) {
+        if (insert) {
+            column.WideSlots.insert(row, slot);
+        } else {
+            column.WideSlots[row] = slot;
+        }
+    } else if (insert) {
+        column.NarrowSlots.insert(row, qint32(slot));
+    } else {
+        column.NarrowSlots[row] = qint32(slot);
+    }
+}
+
+/**
+ * @brief Translate text to the slot a typed column stores for it
+ */
+bool TableData::EncodeSlot(ColumnData &column, QStringView value, qint64 *slot)
+{
+    if (value.isEmpty()) {
+        *slot = EMPTY_SLOT;
+        return true;
+    }
+    if (ParseCanonical(column.Type, column.Scale, value, slot)) {
+        return true;
+    }
+
+    // Replaced outliers are not reclaimed, a column edited that often simply becomes text again
+    if (column.Outliers.size() >= MAX_OUTLIERS) {
+        return false;
+    }
+    column.Outliers.append(value.toString());
+    *slot = EMPTY_SLOT + column.Outliers.size();
+    return true;
+}
+
+/**
+ * @brief Get the text a slot of a typed column stands for
+ */
+QString TableData::FormatSlot(const ColumnData &column, qint64 slot)
+{
+    if (slot == EMPTY_SLOT) {
+        return QString();
+    }
+    if (slot > EMPTY_SLOT && slot <= EMPTY_SLOT + MAX_OUTLIERS) {
+        return column.Outliers.at(int(slot - EMPTY_SLOT - 1));
+    }
+
+    switch (column.Type) {
+    case IntegerColumn:
+        return QString::number(slot);
+    case DecimalColumn: {
+        const qint64 _factor = PowerOfTen(column.Scale);  // Scale of the stored value
+        const qint64 _magnitude = qAbs(slot);  // Value without sign
+        QString _fraction = QString::number(_magnitude % _factor);  // Fraction digits without leading zeros
+        return (slot < 0 ? QString("-") : QString()) + QString::number(_magnitude / _factor) + QLatin1Char('.')
+               + _fraction.rightJustified(column.Scale, QLatin1Char('0'));
+    }
+    case DateColumn: {
+        const QDate _date = QDate::fromJulianDay(slot);  // Stored date
+        QString _text(10, QLatin1Char('-'));  // yyyy-MM-dd
+        WriteDigits(_text.data(), 4, _date.year());
+        WriteDigits(_text.data() + 5, 2, _date.month());
+        WriteDigits(_text.data() + 8, 2, _date.day());
+        return _text;
+    }
+    case BoolColumn:
+        return slot ? QStringLiteral("true") : QStringLiteral("false");
+    case TextColumn:
+        break;
+    }
+
+    return QString();
+}
+
+/**
+ * @brief Parse canonical text of a type into its native value
+ */
+bool TableData::ParseCanonical(ColumnType type, int scale, QStringView text, qint64 *value)
+{
+    const bool _negative = text.startsWith(QLatin1Char('-'));  // Flag indicating a leading minus sign (true) or none (false)
+    qint64 _value = 0;  // Parsed native value
+
+    switch (type) {
+    case IntegerColumn: {
+        // QString::number never writes a plus sign, leading zeros or "-0"
+        const QStringView _digits = text.mid(_negative ? 1 : 0);  // Digits after the sign
+        if (!ParseDigits(_digits, &_value) || (_digits.size() > 1 && _digits.at(0) == QLatin1Char('0')) || (_negative && _value == 0)) {
+            return false;
+        }
+        _value = _negative ? -_value : _value;
+        break;
+    }
+    case DecimalColumn: {
+        const qsizetype _point = text.indexOf(QLatin1Char('.'));  // Position of the decimal point (-1 if none)
+        if (scale < 1 || _point < 0 || text.size() - _point - 1 != scale) {
+            return false;
+        }
+        const QStringView _whole = text.mid(_negative ? 1 : 0, _point - (_negative ? 1 : 0));  // Digits before the point
+        qint64 _wholeValue = 0;     // Value before the point
+        qint64 _fractionValue = 0;  // Value of the fraction digits
+        if (_whole.size() + scale > 18 || !ParseDigits(_whole, &_wholeValue) || (_whole.size() > 1 && _whole.at(0) == QLatin1Char('0'))
+            || !ParseDigits(text.mid(_point + 1), &_fractionValue)) {
+            return false;
+        }
+        _value = _wholeValue * PowerOfTen(scale) + _fractionValue;
+        if (_negative && _value == 0) {
+            return false;
+        }
+        _value = _negative ? -_value : _value;
+        break;
+    }
+    case DateColumn: {
+        qint64 _year = 0;   // Year digits
+        qint64 _month = 0;  // Month digits
+        qint64 _day = 0;    // Day digits
+        if (text.size() != 10 || text.at(4) != QLatin1Char('-') || text.at(7) != QLatin1Char('-') || !ParseDigits(text.mid(0, 4), &_year)
+            || !ParseDigits(text.mid(5, 2), &_month) || !ParseDigits(text.mid(8, 2), &_day)) {
+            return false;
+        }
+        const QDate _date(int(_year), int(_month), int(_day));  // Parsed date (invalid for year 0 or a day that does not exist)
+        if (!_date.isValid()) {
+            return false;
+        }
+        _value = _date.toJulianDay();
+        break;
+    }
+    case BoolColumn:
+        if (text == QLatin1String("true")) {
+            _value = 1;
+        } else if (text == QLatin1String("false")) {
+            _value = 0;
+        } else {
+            return false;
+        }
+        break;
+    case TextColumn:
+        return false;
+    }
+
+    if (_value >= EMPTY_SLOT && _value <= EMPTY_SLOT + MAX_OUTLIERS) {
+        return false;  // Collides with the empty and outlier slots
+    }
+
+    *value = _value;
+    return true;
+}
+
+/**
+ * @brief Find the type whose canonical form a text is
+ */
+TableData::ColumnType TableData::ClassifyValue(QStringView text, int *scale)
+{
+    qint64 _value = 0;  // Parsed value (unused)
+    if (text.isEmpty()) {
+        return TextColumn;
+    }
+
+    if (text.at(0) == QLatin1Char('t') || text.at(0) == QLatin1Char('f')) {
+        return ParseCanonical(BoolColumn, 0, text, &_value) ? BoolColumn : TextColumn;
+    }
+    if (text.size() == 10 && text.at(4) == QLatin1Char('-')) {
+        return ParseCanonical(DateColumn, 0, text, &_value) ? DateColumn : TextColumn;
+    }
+
+    const qsizetype _point = text.indexOf(QLatin1Char('.'));  // Position of the decimal point (-1 if none)
+    if (_point >= 0) {
+        *scale = int(text.size() - _point - 1);
+        return *scale >= 1 && *scale <= MAX_DECIMAL_SCALE && ParseCanonical(DecimalColumn, *scale, text, &_value) ? DecimalColumn : TextColumn;
+    }
+
+    return ParseCanonical(IntegerColumn, 0, text, &_value) ? IntegerColumn : TextColumn;
+}
+
+/**
+ * @brief Constructor initializes an empty store
+ */
+TableStore::TableStore()
+    : Tables()                         // Tables in document order
+    , TableIndexByName()               // Name lookup for tables
+    , RootName("")                     // Root element tag name
+    , RootAttributes()                 // Root element attributes
+    , Pool(new StringPool())           // Shared string pool
+    , SharedPool()                     // Private pool per load
+    , Lock()                           // Table list guard
+{
+}
+
+/**
+ * @brief Remove all tables and root information
+ */
+void TableStore::Clear()
+{
+    QWriteLocker _locker(&Lock);  // Exclusive access while modifying the store
+    Tables.clear();
+    TableIndexByName.clear();
+    RootName.clear();
+    RootAttributes.clear();
+    Pool = SharedPool.isNull() ? QSharedPointer<StringPool>(new StringPool()) : SharedPool;
+}
+
+/**
+ * @brief Append table to the store and register its name
+ */
+void TableStore::AddTable(const QSharedPointer<TableData> &table)
+{
+    QWriteLocker _locker(&Lock);  // Exclusive access while modifying the store
+    if (table.isNull()) {
+        return;
+    }
+
+    const QString _tableName = table->GetName();  // Name used for lookups (empty for unnamed tables)
+    if (!_tableName.isEmpty() && !TableIndexByName.contains(_tableName)) {
+        TableIndexByName.insert(_tableName, Tables.size());
+    }
+
+    Tables.append(table);
+}
+
+/**
+ * @brief Find table by name
+ */
+QSharedPointer<TableData> TableStore::FindTable(const QString &tableName) const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the store
+    const int _index = TableIndexByName.value(tableName, -1);  // Position of the table in Tables (-1 if not found)
+    return _index >= 0 ? Tables.at(_index) : QSharedPointer<TableData>();
+}
+
+/**
+ * @brief Get names of all named tables in document order
+ */
+QStringList TableStore::GetTableNames() const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the store
+    QStringList _tableNames;  // Names of all named tables
+
+    for (const QSharedPointer<TableData> &_table : Tables) {
+        if (!_table->GetName().isEmpty()) {
+            _tableNames.append(_table->GetName());
+        }
+    }
+
+    return _tableNames;
+}
+
+/**
+ * @brief Get all tables in document order
+ */
+QList<QSharedPointer<TableData>> TableStore::GetTables() const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the store
+    return Tables;
+}
+
+/**
+ * @brief Set root element information of the source document
+ */
+void TableStore::SetRootElement(const QString &rootName, const QXmlStreamAttributes &rootAttributes)
+{
+    QWriteLocker _locker(&Lock);  // Exclusive access while modifying the store
+    RootName = rootName;
+    RootAttributes = rootAttributes;
+}
+
+/**
+ * @brief Get root element tag name
+ */
+QString TableStore::GetRootName() const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the store
+    return RootName;
+}
+
+/**
+ * @brief Get root element attributes
+ */
+QXmlStreamAttributes TableStore::GetRootAttributes() const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the store
+    return RootAttributes;
+}
+
+/**
+ * @brief Get the pool shared by all tables of the store
+ */
+QSharedPointer<StringPool> TableStore::GetStringPool() const
+{
+    QReadLocker _locker(&Lock);  // Shared access while reading the store
+    return Pool;
+}
+
+/**
+ * @brief Use a pool shared with other stores instead of a private pool per load
+ */
+void TableStore::SetStringPool(const QSharedPointer<StringPool> &stringPool)
+{
+    QWriteLocker _locker(&Lock);  // Exclusive access while modifying the store
+    SharedPool = stringPool;
+    Pool = SharedPool.isNull() ? QSharedPointer<StringPool>(new StringPool()) : SharedPool;
+}
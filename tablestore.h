@@ -0,0 +1,419 @@
+#ifndef TABLESTORE_H
+#define TABLESTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QSharedPointer>
+#include <QSet>
+#include <QVector>
+#include <QXmlStreamAttributes>
+#include <QReadWriteLock>
+#include <QDataStream>
+#include "stringpool.h"
+
+/**
+ * @brief Compact columnar in-memory representation of a single XML table
+ * Each column keeps its own contiguous storage. Low-cardinality columns are
+ * dictionary encoded as 32-bit ids into a shared StringPool; other columns keep
+ * all their text in one UTF-16 buffer addressed by offset and length. After
+ * InferColumnTypes, columns of integers, decimals, ISO dates or booleans hold
+ * one native value per row instead (32-bit while every value fits, 64-bit
+ * otherwise). Only values whose text is exactly the canonical form of the type
+ * are stored natively, so formatting them reproduces the original text; any
+ * other value of such a column is kept as text
+ */
+class TableData
+{
+public:
+    /**
+     * @brief Storage type of a column
+     */
+    enum ColumnType {
+        TextColumn,                      // Text, dictionary encoded or plain
+        IntegerColumn,                   // Integers without sign or leading zeros beyond "-" and "0"
+        DecimalColumn,                   // Decimals with a fixed number of fraction digits, stored scaled
+        DateColumn,                      // ISO dates (yyyy-MM-dd), stored as Julian day
+        BoolColumn                       // "true" or "false", stored as 1 or 0
+    };
+
+    /**
+     * @brief Constructor for TableData
+     * @param tableName Name of the table (value of the table "name" attribute)
+     * @param stringPool Pool for dictionary encoded values (a private pool is created if null)
+     */
+    explicit TableData(const QString &tableName = QString(), const QSharedPointer<StringPool> &stringPool = QSharedPointer<StringPool>());
+
+    /**
+     * @brief Get name of the table
+     * @return QString containing the table name
+     */
+    QString GetName() const;
+
+    /**
+     * @brief Get column headers of the table
+     * @return QStringList containing column names
+     */
+    QStringList GetColumnHeaders() const;
+
+    /**
+     * @brief Replace column headers, resizing every stored row to the new column count
+     * Names are interned into the table's pool, so tables sharing a pool share their header strings
+     * @param columnHeaders QStringList containing column names
+     */
+    void SetColumnHeaders(const QStringList &columnHeaders);
+
+    /**
+     * @brief Get number of rows stored in the table
+     * @return Row count (0 if table is empty)
+     */
+    int GetRowCount() const;
+
+    /**
+     * @brief Get number of columns of the table
+     * @return Column count (0 if no headers are known)
+     */
+    int GetColumnCount() const;
+
+    /**
+     * @brief Get value of a single cell
+     * @param row Row index (0-based)
+     * @param column Column index (0-based)
+     * @return QString containing the cell text, empty if position is out of range
+     */
+    QString GetCell(int row, int column) const;
+
+    /**
+     * @brief Get read-only view of a single cell without copying its text
+     * Cells stored as native values have no text to view, check GetTypedValue first
+     * or use GetCell for them
+     * @param row Row index (0-based)
+     * @param column Column index (0-based)
+     * @return QStringView valid until the table is modified, empty if position is out of range or the cell holds a native value
+     */
+    QStringView GetCellView(int row, int column) const;
+
+    /**
+     * @brief Store columns of uniformly typed values as native values
+     * A column is converted when every non-empty value but at most one in OUTLIER_RATIO
+     * (and at most MAX_OUTLIERS) is the canonical text of one type; the rest stays text
+     */
+    void InferColumnTypes();
+
+    /**
+     * @brief Get storage type of a column
+     * @param column Column index (0-based)
+     * @return Inferred type, TextColumn if not typed or out of range
+     */
+    ColumnType GetColumnType(int column) const;
+
+    /**
+     * @brief Get number of fraction digits of a decimal column
+     * @param column Column index (0-based)
+     * @return Digits after the decimal point, 0 for other columns
+     */
+    int GetDecimalScale(int column) const;
+
+    /**
+     * @brief Get native value of a cell of a typed column
+     * @param row Row index (0-based)
+     * @param column Column index (0-based)
+     * @param value Receives the integer, the decimal scaled by 10^GetDecimalScale, the Julian day or 1/0
+     * @return true if the cell holds a native value, false for empty and text cells and out of range positions
+     */
+    bool GetTypedValue(int row, int column, qint64 *value) const;
+
+    /**
+     * @brief Get a cell of an integer or decimal column as a number
+     * @param row Row index (0-based)
+     * @param column Column index (0-based)
+     * @param value Receives the number
+     * @return true if the cell holds a native integer or decimal, false otherwise
+     */
+    bool GetNumericValue(int row, int column, double *value) const;
+
+    /**
+     * @brief Parse text the way a typed column stores it
+     * @param column Column index (0-based)
+     * @param text Text to parse
+     * @param value Receives the native value as GetTypedValue reports it
+     * @return true if the column is typed and the text is the canonical form of a value, false otherwise
+     */
+    bool ParseTypedValue(int column, QStringView text, qint64 *value) const;
+
+    /**
+     * @brief Check whether a column is stored dictionary encoded
+     * @param column Column index (0-based)
+     * @return true if values are pool ids, false if they are stored as plain text
+     */
+    bool IsDictionaryColumn(int column) const;
+
+    /**
+     * @brief Get the pool used for dictionary encoded values
+     * @return Shared pointer to the string pool
+     */
+    QSharedPointer<StringPool> GetStringPool() const;
+
+    /**
+     * @brief Get all cell values of a row
+     * @param row Row index (0-based)
+     * @return QStringList containing the row data, empty if row is out of range
+     */
+    QStringList GetRow(int row) const;
+
+    /**
+     * @brief Set value of a single cell
+     * @param row Row index (0-based)
+     * @param column Column index (0-based)
+     * @param value New cell text
+     */
+    void SetCell(int row, int column, const QString &value);
+
+    /**
+     * @brief Append row to the end of the table
+     * @param rowData QStringList containing cell values (padded or truncated to column count)
+     */
+    void AppendRow(const QStringList &rowData);
+
+    /**
+     * @brief Append row to the end of the table from views into text owned by the caller
+     * Same as AppendRow, without building a QStringList; the text is copied into the table
+     * @param rowData Cell values (padded or truncated to column count)
+     */
+    void AppendRowViews(const QVector<QStringView> &rowData);
+
+    /**
+     * @brief Insert row before the given position
+     * @param row Position of the new row (0-based, GetRowCount() appends)
+     * @param rowData QStringList containing cell values (padded or truncated to column count)
+     * @return true if row was inserted, false if position is out of range
+     */
+    bool InsertRow(int row, const QStringList &rowData);
+
+    /**
+     * @brief Remove row from the table
+     * @param row Row index (0-based)
+     * @return true if row was removed, false if index is out of range
+     */
+    bool RemoveRow(int row);
+
+    /**
+     * @brief Remove several rows in one compacting pass
+     * @param sortedRows Row indices in ascending order (out of range indices are ignored)
+     * @return Number of rows removed
+     */
+    int RemoveRows(const QList<int> &sortedRows);
+
+    /**
+     * @brief Remove all rows while keeping the column headers
+     */
+    void ClearRows();
+
+    /**
+     * @brief Write the table in the binary snapshot format, column storage is written as it is
+     * @param stream Stream receiving the table
+     */
+    void WriteSnapshot(QDataStream &stream) const;
+
+    /**
+     * @brief Replace the table content with a table written by WriteSnapshot
+     * Dictionary values are interned into this table's pool once per distinct value,
+     * all other column storage is copied in one block per column
+     * @param stream Stream positioned at the table
+     * @return true if the table was read, false if the data is truncated or inconsistent
+     */
+    bool ReadSnapshot(QDataStream &stream);
+
+private:
+    /**
+     * @brief Storage of one column
+     */
+    struct ColumnData {
+        ColumnType Type;                 // TextColumn, or the type of the native values
+        bool DictionaryEncoded;          // Flag indicating values are pool ids (true) or plain text (false) (text only)
+        QVector<quint32> Codes;          // Pool id per row (dictionary encoding only)
+        QSet<quint32> DistinctCodes;     // Distinct ids seen so far (dictionary encoding only)
+        QString Buffer;                  // Concatenated text of all rows (plain encoding only)
+        QVector<quint32> Starts;         // Start of each row's text in Buffer (plain encoding only)
+        QVector<quint32> Lengths;        // Length of each row's text in Buffer (plain encoding only)
+        qsizetype UnusedLength;          // Characters in Buffer no longer referenced by any row (plain encoding only)
+        int Scale;                       // Digits after the decimal point (DecimalColumn only)
+        bool Wide;                       // Flag indicating slots are in WideSlots (true) or NarrowSlots (false) (typed only)
+        QVector<qint32> NarrowSlots;     // Slot per row while every slot fits 32 bits (typed only)
+        QVector<qint64> WideSlots;       // Slot per row once a slot needs 64 bits (typed only)
+        QStringList Outliers;            // Text of values that are not canonical for the type, addressed by slot (typed only)
+
+        ColumnData();
+    };
+
+    /**
+     * @brief Get view of a value stored in a column
+     */
+    QStringView GetValueView(const ColumnData &column, int row) const;
+
+    /**
+     * @brief Add value at a row position of a column
+     */
+    void InsertValue(ColumnData &column, int row, QStringView value);
+
+    /**
+     * @brief Replace value at a row position of a column
+     */
+    void ReplaceValue(ColumnData &column, int row, QStringView value);
+
+    /**
+     * @brief Switch a dictionary encoded column to plain text storage
+     */
+    void ConvertToPlain(ColumnData &column);
+
+    /**
+     * @brief Rewrite a plain column buffer without unreferenced text
+     */
+    void CompactBuffer(ColumnData &column);
+
+    /**
+     * @brief Switch a text column to native values of a type
+     */
+    void ConvertToTyped(ColumnData &column, ColumnType type, int scale);
+
+    /**
+     * @brief Switch a typed column back to plain text storage
+     */
+    void ConvertTypedToPlain(ColumnData &column);
+
+    /**
+     * @brief Get the slot of a row of a typed column
+     */
+    static qint64 GetSlot(const ColumnData &column, int row);
+
+    /**
+     * @brief Store a slot at a row position of a typed column, widening the column if needed
+     * @param insert Insert before the row (true) or replace the row (false)
+     */
+    static void PutSlot(ColumnData &column, int row, qint64 slot, bool insert);
+
+    /**
+     * @brief Translate text to the slot a typed column stores for it, adding an outlier if needed
+     * @return true if the slot was computed, false if the column has no room for another outlier
+     */
+    static bool EncodeSlot(ColumnData &column, QStringView value, qint64 *slot);
+
+    /**
+     * @brief Get the text a slot of a typed column stands for
+     */
+    static QString FormatSlot(const ColumnData &column, qint64 slot);
+
+    /**
+     * @brief Parse canonical text of a type into its native value
+     * @return true if formatting the value gives back exactly the text, false otherwise (empty text included)
+     */
+    static bool ParseCanonical(ColumnType type, int scale, QStringView text, qint64 *value);
+
+    /**
+     * @brief Find the type whose canonical form a text is
+     * @param scale Receives the number of fraction digits for DecimalColumn
+     * @return Type of the text, TextColumn if it is no canonical value of any type
+     */
+    static ColumnType ClassifyValue(QStringView text, int *scale);
+
+    QString Name;                        // Table name from the "name" attribute (empty if unnamed)
+    QStringList ColumnHeaders;           // Column names taken from the first row (empty if table has no rows)
+    QList<ColumnData> Columns;           // Storage of each column (same size as ColumnHeaders)
+    QSharedPointer<StringPool> Pool;     // Pool of dictionary encoded values (never null)
+    int RowCount;                        // Number of rows stored in every column (0 if table is empty)
+
+    static const int DICTIONARY_MAX_CARDINALITY;  // Distinct values after which a column falls back to plain text
+    static const qint64 EMPTY_SLOT;               // Slot of an empty cell, outlier slots follow it
+    static const int MAX_OUTLIERS;                // Outlier texts after which a typed column falls back to plain text
+    static const int OUTLIER_RATIO;               // Non-empty values per allowed outlier when inferring a type
+    static const int MAX_DECIMAL_SCALE;           // Most fraction digits of a decimal column
+};
+
+/**
+ * @brief Ordered collection of tables read from one XML file
+ * Keeps the document root information needed to write the tables back.
+ * The table list is guarded so a loader thread can publish tables while the
+ * GUI thread reads the ones already completed
+ */
+class TableStore
+{
+public:
+    /**
+     * @brief Constructor for TableStore
+     */
+    TableStore();
+
+    /**
+     * @brief Remove all tables and root information
+     */
+    void Clear();
+
+    /**
+     * @brief Append table to the store
+     * @param table Table to append (tables without a name are kept for saving but not listed)
+     */
+    void AddTable(const QSharedPointer<TableData> &table);
+
+    /**
+     * @brief Find table by name
+     * @param tableName Name of the table to find
+     * @return Shared pointer to the table, null if not found
+     */
+    QSharedPointer<TableData> FindTable(const QString &tableName) const;
+
+    /**
+     * @brief Get names of all named tables in document order
+     * @return QStringList containing table names
+     */
+    QStringList GetTableNames() const;
+
+    /**
+     * @brief Get all tables in document order, including unnamed ones
+     * @return QList of shared table pointers
+     */
+    QList<QSharedPointer<TableData>> GetTables() const;
+
+    /**
+     * @brief Set root element information of the source document
+     * @param rootName Tag name of the root element
+     * @param rootAttributes Attributes of the root element
+     */
+    void SetRootElement(const QString &rootName, const QXmlStreamAttributes &rootAttributes);
+
+    /**
+     * @brief Get root element tag name
+     * @return QString containing the tag name
+     */
+    QString GetRootName() const;
+
+    /**
+     * @brief Get root element attributes
+     * @return QXmlStreamAttributes of the root element
+     */
+    QXmlStreamAttributes GetRootAttributes() const;
+
+    /**
+     * @brief Get the pool shared by all tables of the store
+     * @return Shared pointer to the string pool
+     */
+    QSharedPointer<StringPool> GetStringPool() const;
+
+    /**
+     * @brief Use a pool shared with other stores instead of a private pool per load
+     * Takes effect immediately and survives Clear, so it must be set before tables are added
+     * @param stringPool Pool shared with other stores (null to go back to a private pool per load)
+     */
+    void SetStringPool(const QSharedPointer<StringPool> &stringPool);
+
+private:
+    QList<QSharedPointer<TableData>> Tables;     // Tables in document order (empty if nothing loaded)
+    QHash<QString, int> TableIndexByName;        // Table name to index in Tables (first table wins on duplicates)
+    QString RootName;                            // Root element tag name (empty if nothing loaded)
+    QXmlStreamAttributes RootAttributes;         // Root element attributes (empty if root has none)
+    QSharedPointer<StringPool> Pool;             // String pool shared by the tables of this store (never null)
+    QSharedPointer<StringPool> SharedPool;       // Pool shared with other stores, kept across Clear (null for a private pool per load)
+    mutable QReadWriteLock Lock;                 // Guards all members against concurrent loader access
+};
+
+#endif // TABLESTORE_H
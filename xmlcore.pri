@@ -0,0 +1,48 @@
+# Widget-free XML table engine shared by the editor, the command line tool and the benchmarks
+QT += core xml concurrent
+
+INCLUDEPATH += $$PWD
+
+# Source files
+SOURCES += \
+    $$PWD/changejournal.cpp \
+    $$PWD/columnindex.cpp \
+    $$PWD/columnsorter.cpp \
+    $$PWD/delimitedfile.cpp \
+    $$PWD/edithistory.cpp \
+    $$PWD/sidecarcache.cpp \
+    $$PWD/stringpool.cpp \
+    $$PWD/tablecache.cpp \
+    $$PWD/tablecodec.cpp \
+    $$PWD/tablediff.cpp \
+    $$PWD/tablepager.cpp \
+    $$PWD/tablestore.cpp \
+    $$PWD/xmlfilterproxymodel.cpp \
+    $$PWD/xmlprofiler.cpp \
+    $$PWD/xmlscanner.cpp \
+    $$PWD/xmlstructuralindex.cpp \
+    $$PWD/xmltablemodel.cpp \
+    $$PWD/xmlworker.cpp \
+    $$PWD/xmlworkspace.cpp
+
+# Header files
+HEADERS += \
+    $$PWD/changejournal.h \
+    $$PWD/columnindex.h \
+    $$PWD/columnsorter.h \
+    $$PWD/delimitedfile.h \
+    $$PWD/edithistory.h \
+    $$PWD/sidecarcache.h \
+    $$PWD/stringpool.h \
+    $$PWD/tablecache.h \
+    $$PWD/tablecodec.h \
+    $$PWD/tablediff.h \
+    $$PWD/tablepager.h \
+    $$PWD/tablestore.h \
+    $$PWD/xmlfilterproxymodel.h \
+    $$PWD/xmlprofiler.h \
+    $$PWD/xmlscanner.h \
+    $$PWD/xmlstructuralindex.h \
+    $$PWD/xmltablemodel.h \
+    $$PWD/xmlworker.h \
+    $$PWD/xmlworkspace.h
@@ -0,0 +1,299 @@
+#include "xmlfilterproxymodel.h"
+#include <algorithm>
+
+/**
+ * @brief Constructor initializes a proxy that shows every row
+ */
+XMLFilterProxyModel::XMLFilterProxyModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+    , MatchingRows()                   // No filter rows
+    , FilterActive(false)              // Show every row
+    , RemovingRows(false)              // No removal pending
+{
+}
+
+/**
+ * @brief Set the flat table model being filtered
+ */
+void XMLFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    beginResetModel();
+
+    if (QAbstractItemModel *_oldSource = this->sourceModel()) {  // Previously filtered model (null if none)
+        disconnect(_oldSource, nullptr, this, nullptr);
+    }
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+    MatchingRows.clear();
+    FilterActive = false;
+
+    if (sourceModel) {
+        connect(sourceModel, &QAbstractItemModel::dataChanged, this, &XMLFilterProxyModel::OnSourceDataChanged);
+        connect(sourceModel, &QAbstractItemModel::headerDataChanged, this, &XMLFilterProxyModel::OnSourceHeaderDataChanged);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted, this, &XMLFilterProxyModel::OnSourceRowsAboutToBeInserted);
+        connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &XMLFilterProxyModel::OnSourceRowsInserted);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &XMLFilterProxyModel::OnSourceRowsAboutToBeRemoved);
+        connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &XMLFilterProxyModel::OnSourceRowsRemoved);
+        connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, &XMLFilterProxyModel::OnSourceAboutToReset);
+        connect(sourceModel, &QAbstractItemModel::modelReset, this, &XMLFilterProxyModel::OnSourceReset);
+        connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, &XMLFilterProxyModel::OnSourceAboutToReset);
+        connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &XMLFilterProxyModel::OnSourceReset);
+    }
+
+    endResetModel();
+}
+
+/**
+ * @brief Show only the given source rows
+ */
+void XMLFilterProxyModel::SetMatchingRows(const QVector<int> &sourceRows)
+{
+    beginResetModel();
+    MatchingRows = sourceRows;
+    FilterActive = true;
+    endResetModel();
+}
+
+/**
+ * @brief Show every source row again
+ */
+void XMLFilterProxyModel::ClearFilter()
+{
+    if (!FilterActive) {
+        return;
+    }
+
+    beginResetModel();
+    MatchingRows.clear();
+    FilterActive = false;
+    endResetModel();
+}
+
+/**
+ * @brief Check if rows are currently filtered
+ */
+bool XMLFilterProxyModel::IsFilterActive() const
+{
+    return FilterActive;
+}
+
+/**
+ * @brief Get number of shown rows
+ */
+int XMLFilterProxyModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+
+    return FilterActive ? MatchingRows.size() : sourceModel()->rowCount();
+}
+
+/**
+ * @brief Get number of columns of the source model
+ */
+int XMLFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+
+    return sourceModel()->columnCount();
+}
+
+/**
+ * @brief Create an index for a shown cell
+ */
+QModelIndex XMLFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount()) {
+        return QModelIndex();
+    }
+
+    return createIndex(row, column);
+}
+
+/**
+ * @brief Get parent of an index, always invalid for the flat table
+ */
+QModelIndex XMLFilterProxyModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+/**
+ * @brief Translate a shown cell to the source cell
+ */
+QModelIndex XMLFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel() || proxyIndex.row() >= rowCount()) {
+        return QModelIndex();
+    }
+
+    const int _sourceRow = FilterActive ? MatchingRows.at(proxyIndex.row()) : proxyIndex.row();  // Source row of the shown row
+    return sourceModel()->index(_sourceRow, proxyIndex.column());
+}
+
+/**
+ * @brief Translate a source cell to the shown cell, invalid if the row is filtered out
+ */
+QModelIndex XMLFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid()) {
+        return QModelIndex();
+    }
+
+    const int _proxyRow = FindProxyRow(sourceIndex.row());  // Shown row of the source row (-1 if hidden)
+    return _proxyRow >= 0 ? createIndex(_proxyRow, sourceIndex.column()) : QModelIndex();
+}
+
+/**
+ * @brief Forward changed source cells that are shown
+ */
+void XMLFilterProxyModel::OnSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    if (!FilterActive) {
+        emit dataChanged(mapFromSource(topLeft), mapFromSource(bottomRight), roles);
+        return;
+    }
+
+    // Shown rows inside the changed range form one contiguous proxy range
+    auto _first = std::lower_bound(MatchingRows.cbegin(), MatchingRows.cend(), topLeft.row());  // First shown row in the range
+    auto _last = std::upper_bound(_first, MatchingRows.cend(), bottomRight.row());  // First shown row past the range
+    if (_first == _last) {
+        return;
+    }
+
+    emit dataChanged(createIndex(int(_first - MatchingRows.cbegin()), topLeft.column()),
+                     createIndex(int(_last - MatchingRows.cbegin()) - 1, bottomRight.column()), roles);
+}
+
+/**
+ * @brief Forward changed source header sections
+ */
+void XMLFilterProxyModel::OnSourceHeaderDataChanged(Qt::Orientation orientation, int first, int last)
+{
+    if (orientation == Qt::Horizontal || !FilterActive) {
+        emit headerDataChanged(orientation, first, last);
+    } else if (rowCount() > 0) {
+        emit headerDataChanged(orientation, 0, rowCount() - 1);
+    }
+}
+
+/**
+ * @brief Start inserting rows while every source row is shown
+ */
+void XMLFilterProxyModel::OnSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+{
+    if (!parent.isValid() && !FilterActive) {
+        beginInsertRows(QModelIndex(), first, last);
+    }
+}
+
+/**
+ * @brief Shift shown rows and show source rows that were inserted
+ */
+void XMLFilterProxyModel::OnSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    if (!FilterActive) {
+        endInsertRows();
+        return;
+    }
+
+    const int _count = last - first + 1;  // Number of inserted source rows
+    const int _position = int(std::lower_bound(MatchingRows.cbegin(), MatchingRows.cend(), first) - MatchingRows.cbegin());  // Shown row the new rows are placed at
+
+    beginInsertRows(QModelIndex(), _position, _position + _count - 1);
+    for (int _i = _position; _i < MatchingRows.size(); ++_i) {  // Shown row following the insertion point
+        MatchingRows[_i] += _count;
+    }
+    for (int _i = 0; _i < _count; ++_i) {  // Number of inserted rows added so far
+        MatchingRows.insert(_position + _i, first + _i);
+    }
+    endInsertRows();
+}
+
+/**
+ * @brief Start removing shown rows that are about to disappear from the source
+ */
+void XMLFilterProxyModel::OnSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    RemovingRows = false;
+    if (parent.isValid()) {
+        return;
+    }
+
+    if (!FilterActive) {
+        beginRemoveRows(QModelIndex(), first, last);
+        RemovingRows = true;
+        return;
+    }
+
+    const int _firstShown = int(std::lower_bound(MatchingRows.cbegin(), MatchingRows.cend(), first) - MatchingRows.cbegin());  // First shown row being removed
+    const int _endShown = int(std::upper_bound(MatchingRows.cbegin(), MatchingRows.cend(), last) - MatchingRows.cbegin());  // First shown row kept after the removed ones
+    if (_firstShown < _endShown) {
+        beginRemoveRows(QModelIndex(), _firstShown, _endShown - 1);
+        MatchingRows.remove(_firstShown, _endShown - _firstShown);
+        RemovingRows = true;
+    }
+}
+
+/**
+ * @brief Shift shown rows after source rows were removed
+ */
+void XMLFilterProxyModel::OnSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    if (FilterActive) {
+        const int _count = last - first + 1;  // Number of removed source rows
+        for (int &_sourceRow : MatchingRows) {  // Shown source row, renumbered if it followed the removed rows
+            if (_sourceRow > last) {
+                _sourceRow -= _count;
+            }
+        }
+    }
+
+    if (RemovingRows) {
+        RemovingRows = false;
+        endRemoveRows();
+    }
+}
+
+/**
+ * @brief Drop the filter when the source starts a reset or layout change
+ */
+void XMLFilterProxyModel::OnSourceAboutToReset()
+{
+    beginResetModel();
+}
+
+/**
+ * @brief Finish the reset started by OnSourceAboutToReset
+ */
+void XMLFilterProxyModel::OnSourceReset()
+{
+    MatchingRows.clear();
+    FilterActive = false;
+    endResetModel();
+}
+
+/**
+ * @brief Get shown row of a source row
+ */
+int XMLFilterProxyModel::FindProxyRow(int sourceRow) const
+{
+    if (!FilterActive) {
+        return sourceModel() && sourceRow < sourceModel()->rowCount() ? sourceRow : -1;
+    }
+
+    auto _iterator = std::lower_bound(MatchingRows.cbegin(), MatchingRows.cend(), sourceRow);  // Candidate position of the row
+    return _iterator != MatchingRows.cend() && *_iterator == sourceRow ? int(_iterator - MatchingRows.cbegin()) : -1;
+}
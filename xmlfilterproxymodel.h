@@ -0,0 +1,129 @@
+#ifndef XMLFILTERPROXYMODEL_H
+#define XMLFILTERPROXYMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QVector>
+
+/**
+ * @brief Proxy model showing only a given set of source rows
+ * The matching rows are supplied from outside (typically by XMLTableModel::FindRows),
+ * so the proxy never evaluates rows itself and holds nothing but row numbers.
+ * Rows inserted into the source while a filter is active stay visible so they can be edited
+ */
+class XMLFilterProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor for XMLFilterProxyModel
+     * @param parent Parent object pointer
+     */
+    explicit XMLFilterProxyModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Set the flat table model being filtered
+     */
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    /**
+     * @brief Show only the given source rows
+     * @param sourceRows Source row indices in ascending order
+     */
+    void SetMatchingRows(const QVector<int> &sourceRows);
+
+    /**
+     * @brief Show every source row again
+     */
+    void ClearFilter();
+
+    /**
+     * @brief Check if rows are currently filtered
+     * @return true if only matching rows are shown, false if all rows are shown
+     */
+    bool IsFilterActive() const;
+
+    /**
+     * @brief Get number of shown rows
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Get number of columns of the source model
+     */
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Create an index for a shown cell
+     */
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Get parent of an index, always invalid for the flat table
+     */
+    QModelIndex parent(const QModelIndex &child) const override;
+
+    /**
+     * @brief Translate a shown cell to the source cell
+     */
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+
+    /**
+     * @brief Translate a source cell to the shown cell, invalid if the row is filtered out
+     */
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+private slots:
+    /**
+     * @brief Forward changed source cells that are shown
+     */
+    void OnSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+
+    /**
+     * @brief Forward changed source header sections
+     */
+    void OnSourceHeaderDataChanged(Qt::Orientation orientation, int first, int last);
+
+    /**
+     * @brief Start removing shown rows that are about to disappear from the source
+     */
+    void OnSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+
+    /**
+     * @brief Shift shown rows after source rows were removed
+     */
+    void OnSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+
+    /**
+     * @brief Start inserting rows while every source row is shown
+     */
+    void OnSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+
+    /**
+     * @brief Shift shown rows and show source rows that were inserted
+     */
+    void OnSourceRowsInserted(const QModelIndex &parent, int first, int last);
+
+    /**
+     * @brief Drop the filter when the source starts a reset or layout change
+     */
+    void OnSourceAboutToReset();
+
+    /**
+     * @brief Finish the reset started by OnSourceAboutToReset
+     */
+    void OnSourceReset();
+
+private:
+    /**
+     * @brief Get shown row of a source row
+     * @return Position in MatchingRows, -1 if the row is not shown
+     */
+    int FindProxyRow(int sourceRow) const;
+
+    QVector<int> MatchingRows;           // Shown source rows in ascending order (only used while FilterActive is true)
+    bool FilterActive;                   // Flag indicating only MatchingRows are shown (true) or every row is shown (false)
+    bool RemovingRows;                   // Flag indicating beginRemoveRows was called for a pending source removal (true) or not (false)
+};
+
+#endif // XMLFILTERPROXYMODEL_H
@@ -0,0 +1,98 @@
+#include "xmlloader.h"
+
+/**
+ * @brief Constructor initializes an idle loader
+ */
+XMLLoader::XMLLoader(XMLWorker *worker, QObject *parent)
+    : QObject(parent)
+    , Worker(worker)                   // Worker performing the load
+    , LoadThread(nullptr)              // Background thread
+    , Cancelled(0)                     // Cancellation request flag
+    , LastReportedPercent(-1)          // Progress throttling state
+{
+}
+
+/**
+ * @brief Destructor cancels and waits for a running load
+ */
+XMLLoader::~XMLLoader()
+{
+    if (LoadThread) {
+        Cancel();
+        LoadThread->wait();
+        delete LoadThread;  // Queued cleanup will never run once the loader is gone
+    }
+}
+
+/**
+ * @brief Start loading a file on the background thread
+ */
+bool XMLLoader::Start(const QString &filePath)
+{
+    if (IsRunning() || !Worker) {
+        return false;
+    }
+
+    Cancelled.storeRelaxed(0);
+    LastReportedPercent = -1;
+
+    LoadThread = QThread::create([this, filePath]() {
+        const bool _success = Worker->LoadXMLFile(filePath, this);  // Result of the load on the background thread
+        emit LoadFinished(_success, Cancelled.loadRelaxed() != 0);
+    });
+
+    // Forget the thread once it is done, it deletes itself
+    connect(LoadThread, &QThread::finished, this, [this]() {
+        LoadThread->deleteLater();
+        LoadThread = nullptr;
+    });
+
+    LoadThread->start();
+    return true;
+}
+
+/**
+ * @brief Request the running load to stop as soon as possible
+ */
+void XMLLoader::Cancel()
+{
+    Cancelled.storeRelaxed(1);
+}
+
+/**
+ * @brief Check if a load is currently running
+ */
+bool XMLLoader::IsRunning() const
+{
+    return LoadThread != nullptr;
+}
+
+/**
+ * @brief Forward read progress from the worker thread, at most once per percent
+ */
+void XMLLoader::OnLoadProgress(qint64 bytesRead, qint64 totalBytes)
+{
+    const int _percent = totalBytes > 0 ? int(bytesRead * 100 / totalBytes) : 100;  // Progress of the load (0-100)
+    if (_percent == LastReportedPercent) {
+        return;
+    }
+
+    LastReportedPercent = _percent;
+    emit ProgressChanged(bytesRead, totalBytes);
+}
+
+/**
+ * @brief Forward a completely parsed table from the worker thread
+ */
+void XMLLoader::OnTableLoaded(const QString &tableName)
+{
+    emit TableFound(tableName);
+}
+
+/**
+ * @brief Report the cancellation state to the worker thread
+ */
+bool XMLLoader::IsLoadCancelled() const
+{
+    return Cancelled.loadRelaxed() != 0;
+}
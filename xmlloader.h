@@ -0,0 +1,94 @@
+#ifndef XMLLOADER_H
+#define XMLLOADER_H
+
+#include <QObject>
+#include <QThread>
+#include <QAtomicInt>
+#include <QString>
+#include "xmlworker.h"
+
+/**
+ * @brief Runs XMLWorker::LoadXMLFile on a background thread
+ * Progress, discovered tables and completion are delivered as queued signals
+ * to the thread that owns the loader, so the GUI stays responsive while a
+ * large file is parsed
+ */
+class XMLLoader : public QObject, public XMLLoadObserver
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor for XMLLoader
+     * @param worker Worker that performs the load (must outlive the loader)
+     * @param parent Parent object pointer
+     */
+    explicit XMLLoader(XMLWorker *worker, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor cancels and waits for a running load
+     */
+    ~XMLLoader();
+
+    /**
+     * @brief Start loading a file on the background thread
+     * @param filePath Path to the XML file to load
+     * @return true if loading started, false if another load is still running
+     */
+    bool Start(const QString &filePath);
+
+    /**
+     * @brief Request the running load to stop as soon as possible
+     */
+    void Cancel();
+
+    /**
+     * @brief Check if a load is currently running
+     * @return true while the background thread is active, false otherwise
+     */
+    bool IsRunning() const;
+
+    /**
+     * @brief Forward read progress from the worker thread
+     */
+    void OnLoadProgress(qint64 bytesRead, qint64 totalBytes) override;
+
+    /**
+     * @brief Forward a completely parsed table from the worker thread
+     */
+    void OnTableLoaded(const QString &tableName) override;
+
+    /**
+     * @brief Report the cancellation state to the worker thread
+     */
+    bool IsLoadCancelled() const override;
+
+signals:
+    /**
+     * @brief Emitted when more of the file has been read
+     * @param bytesRead Number of bytes consumed so far
+     * @param totalBytes Size of the file in bytes
+     */
+    void ProgressChanged(qint64 bytesRead, qint64 totalBytes);
+
+    /**
+     * @brief Emitted for each table as soon as it can be displayed
+     * @param tableName Name of the parsed table
+     */
+    void TableFound(const QString &tableName);
+
+    /**
+     * @brief Emitted when the load has ended
+     * @param success true if the file was loaded completely, false on error or cancel
+     * @param cancelled true if the load stopped because Cancel was called
+     */
+    void LoadFinished(bool success, bool cancelled);
+
+private:
+    XMLWorker *Worker;                   // Worker performing the load (not owned)
+    QThread *LoadThread;                 // Background thread of the running load (nullptr if idle)
+    QAtomicInt Cancelled;                // Non-zero once Cancel was requested for the running load
+    int LastReportedPercent;             // Last progress percentage emitted (-1 before the first report)
+};
+
+#endif // XMLLOADER_H
@@ -0,0 +1,272 @@
+#include "xmlprofiler.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QVector>
+#include <QDebug>
+
+QAtomicInt XMLProfiler::Enabled(0);  // Profiling starts disabled
+
+/**
+ * @brief One recorded trace event
+ */
+struct ProfilerEvent {
+    const char *Name;                    // Stage or counter name (not owned)
+    qint64 StartNanoseconds;             // Start time of a stage, sample time of a counter
+    qint64 Value;                        // Duration of a stage, new value of a counter
+    int ThreadIndex;                     // Small index of the recording thread
+    bool IsCounter;                      // Flag indicating a counter sample (true) or a stage run (false)
+};
+
+/**
+ * @brief Everything recorded by the profiler, guarded by its mutex
+ */
+struct ProfilerState {
+    QMutex Mutex;                                    // Guards every other member
+    QVector<ProfilerEvent> Events;                   // Trace events in recording order
+    qint64 DroppedEvents = 0;                        // Events not kept because the trace was full
+    QList<XMLProfiler::StageStatistics> Stages;      // Statistics in the order stages first ran
+    QHash<QByteArray, int> StagePositions;           // Stage name to its position in Stages
+    QMap<QString, qint64> Counters;                  // Counter name to current value
+    QHash<Qt::HANDLE, int> ThreadIndexes;            // Recording thread to its trace thread index
+};
+
+static const int MAX_TRACE_EVENTS = 1 << 20;  // Trace events kept before further ones are only counted in the statistics
+
+/**
+ * @brief Get the profiler state, created on first use
+ */
+static ProfilerState &GetState()
+{
+    static ProfilerState _state;  // Shared by all threads
+    return _state;
+}
+
+/**
+ * @brief Get the trace thread index of the calling thread, the state mutex must be held
+ */
+static int GetThreadIndex(ProfilerState &state)
+{
+    const Qt::HANDLE _thread = QThread::currentThreadId();  // Native id of the calling thread
+    auto _iterator = state.ThreadIndexes.constFind(_thread);  // Known index (end if first event of the thread)
+    if (_iterator == state.ThreadIndexes.constEnd()) {
+        _iterator = state.ThreadIndexes.insert(_thread, state.ThreadIndexes.size());
+    }
+    return _iterator.value();
+}
+
+/**
+ * @brief Format nanoseconds as milliseconds for display
+ */
+static QString FormatMilliseconds(qint64 nanoseconds)
+{
+    return QString::number(double(nanoseconds) / 1e6, 'f', 1) + " ms";
+}
+
+/**
+ * @brief Quote a name as a JSON string
+ */
+static QByteArray QuoteJson(const char *text)
+{
+    QByteArray _quoted("\"");  // Escaped text between quotes
+    for (const char *_c = text; *_c; ++_c) {  // Current character
+        if (*_c == '"' || *_c == '\\') {
+            _quoted += '\\';
+        }
+        _quoted += *_c;
+    }
+    _quoted += '"';
+    return _quoted;
+}
+
+/**
+ * @brief Turn recording on or off, recorded data is kept
+ */
+void XMLProfiler::SetEnabled(bool enabled)
+{
+    if (enabled) {
+        GetTimestamp();  // Start the clock before the first timed scope
+    }
+    Enabled.storeRelaxed(enabled ? 1 : 0);
+}
+
+/**
+ * @brief Discard all recorded events, statistics and counters
+ */
+void XMLProfiler::Reset()
+{
+    ProfilerState &_state = GetState();  // Recorded data
+    QMutexLocker _locker(&_state.Mutex);
+    _state.Events.clear();
+    _state.DroppedEvents = 0;
+    _state.Stages.clear();
+    _state.StagePositions.clear();
+    _state.Counters.clear();
+}
+
+/**
+ * @brief Get statistics of every stage in the order the stages first ran
+ */
+QList<XMLProfiler::StageStatistics> XMLProfiler::GetStageStatistics()
+{
+    ProfilerState &_state = GetState();  // Recorded data
+    QMutexLocker _locker(&_state.Mutex);
+    return _state.Stages;
+}
+
+/**
+ * @brief Get current value of every counter
+ */
+QMap<QString, qint64> XMLProfiler::GetCounters()
+{
+    ProfilerState &_state = GetState();  // Recorded data
+    QMutexLocker _locker(&_state.Mutex);
+    return _state.Counters;
+}
+
+/**
+ * @brief Get one line with the latest duration of every stage, for a status bar
+ */
+QString XMLProfiler::GetSummary()
+{
+    QStringList _parts;  // "stage duration" of every stage
+    for (const StageStatistics &_stage : GetStageStatistics()) {  // Recorded stage
+        _parts.append(_stage.Stage + " " + FormatMilliseconds(_stage.LastNanoseconds));
+    }
+    return _parts.join(" | ");
+}
+
+/**
+ * @brief Get a multi-line report with all statistics and counters, for a tooltip or log
+ */
+QString XMLProfiler::GetReport()
+{
+    QStringList _lines;  // One line per stage and counter
+    for (const StageStatistics &_stage : GetStageStatistics()) {  // Recorded stage
+        _lines.append(QString("%1: %2 runs, total %3, max %4, last %5")
+                          .arg(_stage.Stage)
+                          .arg(_stage.Count)
+                          .arg(FormatMilliseconds(_stage.TotalNanoseconds), FormatMilliseconds(_stage.MaxNanoseconds),
+                               FormatMilliseconds(_stage.LastNanoseconds)));
+    }
+
+    const QMap<QString, qint64> _counters = GetCounters();  // Current counter values
+    for (auto _iterator = _counters.constBegin(); _iterator != _counters.constEnd(); ++_iterator) {  // Current counter
+        _lines.append(QString("%1: %2").arg(_iterator.key()).arg(_iterator.value()));
+    }
+    return _lines.join('\n');
+}
+
+/**
+ * @brief Write all recorded events as a Chrome trace JSON file
+ */
+bool XMLProfiler::ExportChromeTrace(const QString &filePath)
+{
+    QSaveFile _traceFile(filePath);  // Trace file, replaced only once fully written
+    if (!_traceFile.open(QIODevice::WriteOnly)) {
+        qDebug() << "Error: Cannot open trace file for writing" << filePath;
+        return false;
+    }
+
+    ProfilerState &_state = GetState();  // Recorded data
+    QMutexLocker _locker(&_state.Mutex);
+
+    // Timestamps and durations are microseconds in the trace format
+    const QByteArray _processId = QByteArray::number(QCoreApplication::applicationPid());  // "pid" of every event
+    QByteArray _eventText;  // JSON of the current event
+    bool _written = _traceFile.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") >= 0;  // Result of writing (false on device error)
+    for (int _i = 0; _i < _state.Events.size() && _written; ++_i) {  // Position in the trace
+        const ProfilerEvent &_event = _state.Events.at(_i);  // Event being written
+        _eventText = _i > 0 ? "\n," : "\n";
+        _eventText += "{\"name\":" + QuoteJson(_event.Name)
+                    + ",\"ph\":\"" + (_event.IsCounter ? "C" : "X")
+                    + "\",\"pid\":" + _processId
+                    + ",\"tid\":" + QByteArray::number(_event.ThreadIndex)
+                    + ",\"ts\":" + QByteArray::number(double(_event.StartNanoseconds) / 1e3, 'f', 3);
+        if (_event.IsCounter) {
+            _eventText += ",\"args\":{\"value\":" + QByteArray::number(_event.Value) + "}}";
+        } else {
+            _eventText += ",\"dur\":" + QByteArray::number(double(_event.Value) / 1e3, 'f', 3) + "}";
+        }
+        _written = _traceFile.write(_eventText) >= 0;
+    }
+    _written = _written && _traceFile.write("\n]}\n") >= 0;
+
+    if (_state.DroppedEvents > 0) {
+        qDebug() << "Trace was full," << _state.DroppedEvents << "events are only part of the statistics";
+    }
+    _locker.unlock();
+
+    if (!_written || !_traceFile.commit()) {
+        qDebug() << "Error: Failed to write trace file" << filePath << ":" << _traceFile.errorString();
+        return false;
+    }
+
+    qDebug() << "Wrote trace file:" << filePath;
+    return true;
+}
+
+/**
+ * @brief Get the current time of the profiler clock
+ */
+qint64 XMLProfiler::GetTimestamp()
+{
+    static const QElapsedTimer _clock = []() {
+        QElapsedTimer _timer;  // Monotonic clock started on first use
+        _timer.start();
+        return _timer;
+    }();
+    return _clock.nsecsElapsed();
+}
+
+/**
+ * @brief Store one finished run of a stage
+ */
+void XMLProfiler::RecordStage(const char *stage, qint64 startNanoseconds, qint64 endNanoseconds)
+{
+    const qint64 _duration = endNanoseconds - startNanoseconds;  // Length of the run
+    ProfilerState &_state = GetState();  // Recorded data
+    QMutexLocker _locker(&_state.Mutex);
+
+    const QByteArray _stageKey = QByteArray::fromRawData(stage, int(qstrlen(stage)));  // Lookup key, not copied
+    auto _iterator = _state.StagePositions.constFind(_stageKey);  // Position of the stage (end if first run)
+    if (_iterator == _state.StagePositions.constEnd()) {
+        _iterator = _state.StagePositions.insert(QByteArray(stage), _state.Stages.size());
+        _state.Stages.append({QString::fromUtf8(stage), 0, 0, 0, 0});
+    }
+
+    StageStatistics &_statistics = _state.Stages[_iterator.value()];  // Statistics of the stage
+    _statistics.Count++;
+    _statistics.TotalNanoseconds += _duration;
+    _statistics.MaxNanoseconds = qMax(_statistics.MaxNanoseconds, _duration);
+    _statistics.LastNanoseconds = _duration;
+
+    if (_state.Events.size() < MAX_TRACE_EVENTS) {
+        _state.Events.append({stage, startNanoseconds, _duration, GetThreadIndex(_state), false});
+    } else {
+        _state.DroppedEvents++;
+    }
+}
+
+/**
+ * @brief Add to a counter and store its new value as a trace event
+ */
+void XMLProfiler::RecordCount(const char *counter, qint64 amount)
+{
+    const qint64 _timestamp = GetTimestamp();  // Sample time of the new value
+    ProfilerState &_state = GetState();  // Recorded data
+    QMutexLocker _locker(&_state.Mutex);
+
+    qint64 &_value = _state.Counters[QString::fromUtf8(counter)];  // Counter total (0 before the first count)
+    _value += amount;
+
+    if (_state.Events.size() < MAX_TRACE_EVENTS) {
+        _state.Events.append({counter, _timestamp, _value, GetThreadIndex(_state), true});
+    } else {
+        _state.DroppedEvents++;
+    }
+}
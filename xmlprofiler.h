@@ -0,0 +1,163 @@
+#ifndef XMLPROFILER_H
+#define XMLPROFILER_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Process-wide scoped timers and counters for the hot paths of the XML engine
+ * Stages are timed with XML_PROFILE_SCOPE and quantities are counted with
+ * XML_PROFILE_COUNT. While profiling is disabled both cost a single relaxed
+ * atomic load. While enabled, every timed scope is kept as a trace event that
+ * can be exported in the Chrome trace format (chrome://tracing, Perfetto) and
+ * is folded into per-stage statistics for a short summary. Safe to use from
+ * any thread
+ */
+class XMLProfiler
+{
+public:
+    /**
+     * @brief Accumulated timings of one stage
+     */
+    struct StageStatistics {
+        QString Stage;                   // Stage name as passed to XML_PROFILE_SCOPE
+        int Count;                       // Number of times the stage ran
+        qint64 TotalNanoseconds;         // Time spent in all runs
+        qint64 MaxNanoseconds;           // Longest single run
+        qint64 LastNanoseconds;          // Duration of the most recent run
+    };
+
+    /**
+     * @brief Times the enclosing scope as one run of a stage
+     */
+    class ScopedTimer
+    {
+    public:
+        /**
+         * @brief Start timing if profiling is enabled
+         * @param stage Stage name (must be a string literal or otherwise outlive the profiler)
+         */
+        explicit ScopedTimer(const char *stage)
+            : Stage(stage)                                                 // Timed stage
+            , StartNanoseconds(IsEnabled() ? GetTimestamp() : -1)          // Start time (-1 if profiling is disabled)
+        {
+        }
+
+        /**
+         * @brief Record the run if timing was started
+         */
+        ~ScopedTimer()
+        {
+            if (StartNanoseconds >= 0) {
+                RecordStage(Stage, StartNanoseconds, GetTimestamp());
+            }
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        const char *Stage;               // Timed stage (not owned)
+        qint64 StartNanoseconds;         // Start time on the profiler clock (-1 if not timing)
+    };
+
+    /**
+     * @brief Turn recording on or off, recorded data is kept
+     * @param enabled true to record timers and counters, false to ignore them
+     */
+    static void SetEnabled(bool enabled);
+
+    /**
+     * @brief Check if timers and counters are recorded
+     * @return true if profiling is enabled, false otherwise
+     */
+    static bool IsEnabled()
+    {
+        return Enabled.loadRelaxed() != 0;
+    }
+
+    /**
+     * @brief Discard all recorded events, statistics and counters
+     */
+    static void Reset();
+
+    /**
+     * @brief Add to a counter if profiling is enabled
+     * @param counter Counter name (must be a string literal or otherwise outlive the profiler)
+     * @param amount Value added to the counter
+     */
+    static void AddCount(const char *counter, qint64 amount)
+    {
+        if (IsEnabled()) {
+            RecordCount(counter, amount);
+        }
+    }
+
+    /**
+     * @brief Get statistics of every stage in the order the stages first ran
+     * @return QList of stage statistics
+     */
+    static QList<StageStatistics> GetStageStatistics();
+
+    /**
+     * @brief Get current value of every counter
+     * @return QMap of counter name to value
+     */
+    static QMap<QString, qint64> GetCounters();
+
+    /**
+     * @brief Get one line with the latest duration of every stage, for a status bar
+     * @return Summary text (empty if nothing was recorded)
+     */
+    static QString GetSummary();
+
+    /**
+     * @brief Get a multi-line report with all statistics and counters, for a tooltip or log
+     * @return Report text (empty if nothing was recorded)
+     */
+    static QString GetReport();
+
+    /**
+     * @brief Write all recorded events as a Chrome trace JSON file
+     * @param filePath Target file
+     * @return true if the file was written, false on error
+     */
+    static bool ExportChromeTrace(const QString &filePath);
+
+private:
+    /**
+     * @brief Get the current time of the profiler clock
+     * @return Nanoseconds since the first use of the profiler
+     */
+    static qint64 GetTimestamp();
+
+    /**
+     * @brief Store one finished run of a stage
+     */
+    static void RecordStage(const char *stage, qint64 startNanoseconds, qint64 endNanoseconds);
+
+    /**
+     * @brief Add to a counter and store its new value as a trace event
+     */
+    static void RecordCount(const char *counter, qint64 amount);
+
+    static QAtomicInt Enabled;           // Non-zero while profiling is enabled
+};
+
+#define XMLPROFILER_CONCAT_INNER(left, right) left##right
+#define XMLPROFILER_CONCAT(left, right) XMLPROFILER_CONCAT_INNER(left, right)
+
+/**
+ * @brief Time the rest of the enclosing scope as one run of a stage
+ */
+#define XML_PROFILE_SCOPE(stage) XMLProfiler::ScopedTimer XMLPROFILER_CONCAT(_profileTimer, __LINE__)(stage)
+
+/**
+ * @brief Add an amount to a named counter
+ */
+#define XML_PROFILE_COUNT(counter, amount) XMLProfiler::AddCount(counter, amount)
+
+#endif // XMLPROFILER_H
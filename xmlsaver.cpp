@@ -0,0 +1,61 @@
+#include "xmlsaver.h"
+#include <QScopedPointer>
+
+/**
+ * @brief Constructor initializes an idle saver
+ */
+XMLSaver::XMLSaver(XMLWorker *worker, QObject *parent)
+    : QObject(parent)
+    , Worker(worker)                   // Worker providing the content
+    , SaveThread(nullptr)              // Background thread
+{
+}
+
+/**
+ * @brief Destructor waits for a running save
+ */
+XMLSaver::~XMLSaver()
+{
+    if (SaveThread) {
+        SaveThread->wait();
+        delete SaveThread;  // Queued cleanup will never run once the saver is gone
+    }
+}
+
+/**
+ * @brief Snapshot the worker and start writing the snapshot on the background thread
+ */
+bool XMLSaver::Start(const QString &filePath)
+{
+    if (IsRunning() || !Worker) {
+        return false;
+    }
+
+    // The snapshot is taken on the calling thread, the only one touching the worker
+    XMLWorker *_snapshot = Worker->CreateSaveSnapshot();  // Independent copy written in the background (nullptr if nothing loaded)
+    if (!_snapshot) {
+        return false;
+    }
+
+    SaveThread = QThread::create([this, _snapshot, filePath]() {
+        QScopedPointer<XMLWorker> _saveWorker(_snapshot);  // Snapshot released once written
+        emit SaveFinished(_saveWorker->SaveXMLFile(filePath));
+    });
+
+    // Forget the thread once it is done, it deletes itself
+    connect(SaveThread, &QThread::finished, this, [this]() {
+        SaveThread->deleteLater();
+        SaveThread = nullptr;
+    });
+
+    SaveThread->start();
+    return true;
+}
+
+/**
+ * @brief Check if a save is currently running
+ */
+bool XMLSaver::IsRunning() const
+{
+    return SaveThread != nullptr;
+}
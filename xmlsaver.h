@@ -0,0 +1,57 @@
+#ifndef XMLSAVER_H
+#define XMLSAVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include "xmlworker.h"
+
+/**
+ * @brief Runs XMLWorker::SaveXMLFile on a background thread
+ * The worker content is captured in a snapshot when the save starts, so the
+ * worker and its tables can keep being read and edited while the snapshot is
+ * written. Completion is delivered as a queued signal to the thread that owns the saver
+ */
+class XMLSaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor for XMLSaver
+     * @param worker Worker whose content is saved (must outlive the saver)
+     * @param parent Parent object pointer
+     */
+    explicit XMLSaver(XMLWorker *worker, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor waits for a running save so that the file is never left half replaced
+     */
+    ~XMLSaver();
+
+    /**
+     * @brief Snapshot the worker and start writing the snapshot on the background thread
+     * @param filePath Target file (empty to overwrite the loaded file)
+     * @return true if saving started, false if another save is running or nothing is loaded
+     */
+    bool Start(const QString &filePath = QString());
+
+    /**
+     * @brief Check if a save is currently running
+     * @return true while the background thread is active, false otherwise
+     */
+    bool IsRunning() const;
+
+signals:
+    /**
+     * @brief Emitted when the save has ended
+     * @param success true if the file was written and replaced, false otherwise (the previous file is kept)
+     */
+    void SaveFinished(bool success);
+
+private:
+    XMLWorker *Worker;                   // Worker whose content is saved (not owned)
+    QThread *SaveThread;                 // Background thread of the running save (nullptr if idle)
+};
+
+#endif // XMLSAVER_H
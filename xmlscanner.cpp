@@ -0,0 +1,264 @@
+#include "xmlscanner.h"
+#include <QXmlStreamReader>
+#include <cstring>
+
+/**
+ * @brief Constructor prepares a scanner over existing bytes
+ */
+XMLScanner::XMLScanner(const char *data, qint64 size)
+    : Data(data)                       // Document bytes
+    , Size(size)                       // Document length
+    , Index(data, size)                // Structural byte masks
+    , TableRanges()                    // Scan result
+    , RootStartTagEnd(0)               // Root start tag end offset
+    , DeclarationLength(0)             // XML declaration length
+    , ErrorString()                    // Last error
+{
+}
+
+/**
+ * @brief Scan the document for the root element and its direct table children
+ */
+bool XMLScanner::Scan(const QString &tableElementName, const QString &rowElementName)
+{
+    TableRanges.clear();
+    RootStartTagEnd = 0;
+    DeclarationLength = 0;
+    ErrorString.clear();
+
+    const QByteArray _tableTag = tableElementName.toUtf8();  // Table tag name as raw bytes
+    const QByteArray _rowTag = rowElementName.toUtf8();      // Row tag name as raw bytes (empty if rows are not counted)
+    int _depth = 0;             // Element nesting depth at the current position (0 outside the root)
+    bool _inTable = false;      // Flag indicating the scan is inside a table element (true) or not (false)
+    qint64 _position = 0;       // Current byte offset
+
+    while (_position < Size) {
+        const qint64 _tagStart = Index.FindNext(_position, XMLStructuralIndex::MarkupStartClass);  // Offset of the next '<' (-1 if none)
+        if (_tagStart < 0) {
+            break;
+        }
+
+        const char _next = _tagStart + 1 < Size ? Data[_tagStart + 1] : '\0';  // Character following the '<'
+        qint64 _tagEnd = -1;  // Offset of the last character of the construct
+
+        if (_next == '?') {
+            // Processing instruction or XML declaration
+            _tagEnd = FindSequence(_tagStart + 2, "?>", 2);
+            if (_tagEnd >= 0) {
+                _tagEnd += 1;
+                // The declaration may only follow an optional UTF-8 byte order mark
+                const bool _atDocumentStart = _tagStart == 0 || (_tagStart == 3 && memcmp(Data, "\xEF\xBB\xBF", 3) == 0);  // Flag indicating nothing but a BOM precedes the PI
+                if (_atDocumentStart && _tagEnd - _tagStart > 5 && memcmp(Data + _tagStart, "<?xml", 5) == 0
+                    && strchr(" \t\r\n", Data[_tagStart + 5])) {
+                    DeclarationLength = _tagEnd + 1;
+                }
+            }
+        } else if (_next == '!') {
+            if (Size - _tagStart >= 4 && memcmp(Data + _tagStart, "<!--", 4) == 0) {
+                _tagEnd = FindSequence(_tagStart + 4, "-->", 3);
+                _tagEnd = _tagEnd >= 0 ? _tagEnd + 2 : -1;
+            } else if (Size - _tagStart >= 9 && memcmp(Data + _tagStart, "<![CDATA[", 9) == 0) {
+                _tagEnd = FindSequence(_tagStart + 9, "]]>", 3);
+                _tagEnd = _tagEnd >= 0 ? _tagEnd + 2 : -1;
+            } else {
+                _tagEnd = FindDoctypeEnd(_tagStart + 2);
+            }
+        } else if (_next == '/') {
+            // End tag closes the current element
+            _tagEnd = FindTagEnd(_tagStart + 2);
+            if (_tagEnd >= 0) {
+                _depth--;
+                if (_depth == 1 && _inTable) {
+                    TableRanges.last().End = _tagEnd + 1;
+                    _inTable = false;
+                } else if (_depth <= 0) {
+                    if (RootStartTagEnd == 0) {
+                        ErrorString = QString("End tag without start tag at byte %1").arg(_tagStart);
+                        return false;
+                    }
+                    return true;  // Root closed, trailing comments and whitespace are irrelevant
+                }
+            }
+        } else {
+            // Start tag or empty element tag
+            _tagEnd = FindTagEnd(_tagStart + 1);
+            if (_tagEnd >= 0) {
+                const bool _selfClosing = Data[_tagEnd - 1] == '/';  // Flag indicating an empty element tag
+
+                if (_depth == 0) {
+                    RootStartTagEnd = _tagEnd + 1;
+                    if (_selfClosing) {
+                        return true;
+                    }
+                } else if (_depth == 1 && ReadTagName(_tagStart) == _tableTag) {
+                    ElementRange _range;  // Range of the table starting here
+                    _range.Name = ReadNameAttribute(_tagStart, _tagEnd);
+                    _range.Start = _tagStart;
+                    _range.End = _tagEnd + 1;
+                    _range.RowCount = 0;
+                    TableRanges.append(_range);
+                    _inTable = !_selfClosing;
+                } else if (_depth == 2 && _inTable && !_rowTag.isEmpty() && ReadTagName(_tagStart) == _rowTag) {
+                    // Every tag is visited anyway, counting rows here spares parsing a table to learn its size
+                    TableRanges.last().RowCount++;
+                }
+
+                if (!_selfClosing) {
+                    _depth++;
+                }
+            }
+        }
+
+        if (_tagEnd < 0) {
+            ErrorString = QString("Unterminated markup at byte %1").arg(_tagStart);
+            return false;
+        }
+
+        _position = _tagEnd + 1;
+    }
+
+    if (RootStartTagEnd == 0) {
+        ErrorString = "No root element found";
+    } else {
+        ErrorString = "Root element is not closed";
+    }
+    return false;
+}
+
+/**
+ * @brief Get ranges of the tables found by Scan
+ */
+const QVector<XMLScanner::ElementRange> &XMLScanner::GetTableRanges() const
+{
+    return TableRanges;
+}
+
+/**
+ * @brief Get offset just past the root start tag
+ */
+qint64 XMLScanner::GetRootStartTagEnd() const
+{
+    return RootStartTagEnd;
+}
+
+/**
+ * @brief Get length of the XML declaration at the start of the document
+ */
+qint64 XMLScanner::GetDeclarationLength() const
+{
+    return DeclarationLength;
+}
+
+/**
+ * @brief Get description of the last scan error
+ */
+QString XMLScanner::GetErrorString() const
+{
+    return ErrorString;
+}
+
+/**
+ * @brief Find a byte sequence starting at an offset
+ */
+qint64 XMLScanner::FindSequence(qint64 from, const char *sequence, qint64 length) const
+{
+    while (from + length <= Size) {
+        const void *_found = memchr(Data + from, sequence[0], size_t(Size - from - length + 1));  // Candidate first byte
+        if (!_found) {
+            return -1;
+        }
+
+        const qint64 _candidate = static_cast<const char *>(_found) - Data;  // Offset of the candidate match
+        if (memcmp(Data + _candidate, sequence, size_t(length)) == 0) {
+            return _candidate;
+        }
+        from = _candidate + 1;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Find the '>' closing a tag, skipping quoted attribute values
+ */
+qint64 XMLScanner::FindTagEnd(qint64 from)
+{
+    while (from < Size) {
+        const qint64 _delimiter = Index.FindNext(from, XMLStructuralIndex::TagDelimiterClass);  // Next '>' or quote (-1 if none)
+        if (_delimiter < 0 || Data[_delimiter] == '>') {
+            return _delimiter;
+        }
+
+        // Attribute value, a '>' inside it does not end the tag
+        const void *_closingQuote = memchr(Data + _delimiter + 1, Data[_delimiter], size_t(Size - _delimiter - 1));  // Quote ending the value
+        if (!_closingQuote) {
+            return -1;
+        }
+        from = static_cast<const char *>(_closingQuote) - Data + 1;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Find the '>' closing a DOCTYPE declaration, skipping its internal subset
+ */
+qint64 XMLScanner::FindDoctypeEnd(qint64 from) const
+{
+    char _quote = '\0';   // Quote character of the literal being skipped ('\0' outside literals)
+    int _bracketDepth = 0;  // Nesting of the internal subset brackets
+
+    for (qint64 _i = from; _i < Size; ++_i) {  // Current byte offset
+        const char _c = Data[_i];  // Current byte
+        if (_quote) {
+            if (_c == _quote) {
+                _quote = '\0';
+            }
+        } else if (_c == '"' || _c == '\'') {
+            _quote = _c;
+        } else if (_c == '[') {
+            _bracketDepth++;
+        } else if (_c == ']') {
+            _bracketDepth--;
+        } else if (_c == '>' && _bracketDepth <= 0) {
+            return _i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Get the tag name following a '<'
+ */
+QByteArray XMLScanner::ReadTagName(qint64 tagStart) const
+{
+    qint64 _end = tagStart + 1;  // Offset just past the tag name
+    while (_end < Size) {
+        const char _c = Data[_end];  // Current byte
+        if (_c == ' ' || _c == '\t' || _c == '\n' || _c == '\r' || _c == '/' || _c == '>') {
+            break;
+        }
+        _end++;
+    }
+
+    return QByteArray::fromRawData(Data + tagStart + 1, _end - tagStart - 1);
+}
+
+/**
+ * @brief Decode the "name" attribute of a start tag
+ */
+QString XMLScanner::ReadNameAttribute(qint64 tagStart, qint64 tagEnd) const
+{
+    // Let the XML reader decode entities; the declaration keeps the document encoding
+    QXmlStreamReader _reader;  // Reader over the declaration and the single start tag
+    _reader.setNamespaceProcessing(false);
+    _reader.addData(QByteArray::fromRawData(Data, DeclarationLength));
+    _reader.addData(QByteArray::fromRawData(Data + tagStart, tagEnd - tagStart + 1));
+
+    if (!_reader.readNextStartElement()) {
+        return QString();
+    }
+
+    return _reader.attributes().value("name").toString();
+}
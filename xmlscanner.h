@@ -0,0 +1,109 @@
+#ifndef XMLSCANNER_H
+#define XMLSCANNER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "xmlstructuralindex.h"
+
+/**
+ * @brief Byte level pre-scanner locating the table elements of an XML document
+ * Only tag boundaries are tracked (comments, CDATA, processing instructions,
+ * DOCTYPE and quoted attribute values are skipped correctly); nothing is
+ * decoded and well-formedness is left to the parser that later reads each
+ * range. Markup starts and tag ends are located through a vectorized
+ * XMLStructuralIndex. Expects an ASCII compatible encoding such as UTF-8 or Latin-1
+ */
+class XMLScanner
+{
+public:
+    /**
+     * @brief Byte range of one table element, from its '<' up to and including its closing '>'
+     */
+    struct ElementRange {
+        QString Name;                    // Value of the "name" attribute (empty if unnamed)
+        qint64 Start;                    // Offset of the start tag
+        qint64 End;                      // Offset just past the end tag
+        int RowCount;                    // Number of direct row children (0 if no row element name was given)
+    };
+
+    /**
+     * @brief Constructor for XMLScanner
+     * @param data Document bytes (must stay valid while the scanner is used)
+     * @param size Number of bytes in data
+     */
+    XMLScanner(const char *data, qint64 size);
+
+    /**
+     * @brief Scan the document for the root element and its direct table children
+     * @param tableElementName Tag name of the table elements
+     * @param rowElementName Tag name of the row elements counted per table (empty to count nothing)
+     * @return true if the document structure could be scanned, false otherwise (see GetErrorString)
+     */
+    bool Scan(const QString &tableElementName, const QString &rowElementName = QString());
+
+    /**
+     * @brief Get ranges of the tables found by Scan
+     * @return Table ranges in document order
+     */
+    const QVector<ElementRange> &GetTableRanges() const;
+
+    /**
+     * @brief Get offset just past the root start tag
+     * @return Length of the prolog plus root start tag, 0 if no root was found
+     */
+    qint64 GetRootStartTagEnd() const;
+
+    /**
+     * @brief Get length of the XML declaration at the start of the document
+     * @return Number of bytes up to and including "?>" of the declaration, 0 if there is none
+     */
+    qint64 GetDeclarationLength() const;
+
+    /**
+     * @brief Get description of the last scan error
+     * @return QString containing the error, empty if the scan succeeded
+     */
+    QString GetErrorString() const;
+
+private:
+    /**
+     * @brief Find a byte sequence starting at an offset
+     * @return Offset of the first match, -1 if not found
+     */
+    qint64 FindSequence(qint64 from, const char *sequence, qint64 length) const;
+
+    /**
+     * @brief Find the '>' closing a tag, skipping quoted attribute values
+     * @return Offset of the closing '>', -1 if the tag is not terminated
+     */
+    qint64 FindTagEnd(qint64 from);
+
+    /**
+     * @brief Find the '>' closing a DOCTYPE declaration, skipping its internal subset
+     * @return Offset of the closing '>', -1 if the declaration is not terminated
+     */
+    qint64 FindDoctypeEnd(qint64 from) const;
+
+    /**
+     * @brief Get the tag name following a '<'
+     * @return Raw bytes of the tag name
+     */
+    QByteArray ReadTagName(qint64 tagStart) const;
+
+    /**
+     * @brief Decode the "name" attribute of a start tag
+     * @return Attribute value, empty if the tag has none
+     */
+    QString ReadNameAttribute(qint64 tagStart, qint64 tagEnd) const;
+
+    const char *Data;                    // Document bytes (not owned)
+    qint64 Size;                         // Number of bytes in Data
+    XMLStructuralIndex Index;            // Structural byte masks over Data
+    QVector<ElementRange> TableRanges;   // Tables found by the last scan (empty before Scan)
+    qint64 RootStartTagEnd;              // Offset just past the root start tag (0 if no root found)
+    qint64 DeclarationLength;            // Length of the XML declaration (0 if there is none)
+    QString ErrorString;                 // Last scan error (empty if successful)
+};
+
+#endif // XMLSCANNER_H
@@ -0,0 +1,199 @@
+#include "xmlstructuralindex.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <immintrin.h>
+#define XMLINDEX_HAVE_SSE2
+#if defined(__AVX2__) || defined(Q_CC_GNU) || defined(Q_CC_CLANG)
+#define XMLINDEX_HAVE_AVX2                 // Compiled in directly with -mavx2, otherwise through a function target attribute
+#endif
+#endif
+
+#if defined(XMLINDEX_HAVE_AVX2) && !defined(__AVX2__)
+#define XMLINDEX_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define XMLINDEX_AVX2_TARGET
+#endif
+
+const qint64 XMLStructuralIndex::BLOCK_SIZE = 64;         // One block per 64-bit mask
+
+/**
+ * @brief Classify 64 bytes one at a time
+ */
+static void ClassifyBlockScalar(const char *block, quint64 *masks)
+{
+    quint64 _markupStart = 0;   // Bits of '<' bytes
+    quint64 _tagDelimiter = 0;  // Bits of '>', '"' and '\'' bytes
+
+    for (int _i = 0; _i < 64; ++_i) {  // Byte position in the block
+        const char _c = block[_i];  // Current byte
+        _markupStart |= quint64(_c == '<') << _i;
+        _tagDelimiter |= quint64(_c == '>' || _c == '"' || _c == '\'') << _i;
+    }
+
+    masks[XMLStructuralIndex::MarkupStartClass] = _markupStart;
+    masks[XMLStructuralIndex::TagDelimiterClass] = _tagDelimiter;
+}
+
+#ifdef XMLINDEX_HAVE_SSE2
+/**
+ * @brief Classify 64 bytes as four 16-byte vectors
+ */
+static void ClassifyBlockSse2(const char *block, quint64 *masks)
+{
+    const __m128i _less = _mm_set1_epi8('<');           // Markup start byte in every lane
+    const __m128i _greater = _mm_set1_epi8('>');        // Tag end byte in every lane
+    const __m128i _doubleQuote = _mm_set1_epi8('"');    // Attribute quote in every lane
+    const __m128i _singleQuote = _mm_set1_epi8('\'');   // Attribute quote in every lane
+    quint64 _markupStart = 0;   // Bits of '<' bytes
+    quint64 _tagDelimiter = 0;  // Bits of '>', '"' and '\'' bytes
+
+    for (int _i = 0; _i < 64; _i += 16) {  // Byte position of the current vector
+        const __m128i _bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + _i));  // 16 document bytes
+        const __m128i _delimiters = _mm_or_si128(_mm_cmpeq_epi8(_bytes, _greater),
+                                                 _mm_or_si128(_mm_cmpeq_epi8(_bytes, _doubleQuote), _mm_cmpeq_epi8(_bytes, _singleQuote)));  // Lanes holding a tag delimiter
+        _markupStart |= quint64(quint16(_mm_movemask_epi8(_mm_cmpeq_epi8(_bytes, _less)))) << _i;
+        _tagDelimiter |= quint64(quint16(_mm_movemask_epi8(_delimiters))) << _i;
+    }
+
+    masks[XMLStructuralIndex::MarkupStartClass] = _markupStart;
+    masks[XMLStructuralIndex::TagDelimiterClass] = _tagDelimiter;
+}
+#endif
+
+#ifdef XMLINDEX_HAVE_AVX2
+/**
+ * @brief Classify 64 bytes as two 32-byte vectors
+ */
+XMLINDEX_AVX2_TARGET static void ClassifyBlockAvx2(const char *block, quint64 *masks)
+{
+    const __m256i _less = _mm256_set1_epi8('<');           // Markup start byte in every lane
+    const __m256i _greater = _mm256_set1_epi8('>');        // Tag end byte in every lane
+    const __m256i _doubleQuote = _mm256_set1_epi8('"');    // Attribute quote in every lane
+    const __m256i _singleQuote = _mm256_set1_epi8('\'');   // Attribute quote in every lane
+    quint64 _markupStart = 0;   // Bits of '<' bytes
+    quint64 _tagDelimiter = 0;  // Bits of '>', '"' and '\'' bytes
+
+    for (int _i = 0; _i < 64; _i += 32) {  // Byte position of the current vector
+        const __m256i _bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + _i));  // 32 document bytes
+        const __m256i _delimiters = _mm256_or_si256(_mm256_cmpeq_epi8(_bytes, _greater),
+                                                    _mm256_or_si256(_mm256_cmpeq_epi8(_bytes, _doubleQuote), _mm256_cmpeq_epi8(_bytes, _singleQuote)));  // Lanes holding a tag delimiter
+        _markupStart |= quint64(quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_bytes, _less)))) << _i;
+        _tagDelimiter |= quint64(quint32(_mm256_movemask_epi8(_delimiters))) << _i;
+    }
+
+    masks[XMLStructuralIndex::MarkupStartClass] = _markupStart;
+    masks[XMLStructuralIndex::TagDelimiterClass] = _tagDelimiter;
+}
+#endif
+
+/**
+ * @brief Check once whether the running CPU supports AVX2
+ */
+static bool CpuHasAvx2()
+{
+#if defined(__AVX2__)
+    return true;
+#elif defined(XMLINDEX_HAVE_AVX2)
+    static const bool _hasAvx2 = __builtin_cpu_supports("avx2");  // Result of the CPUID check
+    return _hasAvx2;
+#else
+    return false;
+#endif
+}
+
+typedef void (*ClassifyBlockFunction)(const char *block, quint64 *masks);  // Block classifier signature
+
+/**
+ * @brief Pick the fastest block classifier supported by the running CPU
+ */
+static ClassifyBlockFunction SelectClassifier()
+{
+#ifdef XMLINDEX_HAVE_AVX2
+    if (CpuHasAvx2()) {
+        return ClassifyBlockAvx2;
+    }
+#endif
+#ifdef XMLINDEX_HAVE_SSE2
+    return ClassifyBlockSse2;
+#else
+    return ClassifyBlockScalar;
+#endif
+}
+
+static const ClassifyBlockFunction ClassifyBlock = SelectClassifier();  // Classifier used by every index
+
+/**
+ * @brief Constructor prepares an index over existing bytes
+ */
+XMLStructuralIndex::XMLStructuralIndex(const char *data, qint64 size)
+    : Data(data)                       // Document bytes
+    , Size(size)                       // Document length
+    , BlockStart(-1)                   // No block classified yet
+    , Masks()                          // Empty masks
+{
+}
+
+/**
+ * @brief Find the next byte of a class
+ */
+qint64 XMLStructuralIndex::FindNext(qint64 from, ByteClass byteClass)
+{
+    if (from < 0) {
+        from = 0;
+    }
+
+    for (qint64 _blockStart = from - from % BLOCK_SIZE; _blockStart < Size; _blockStart += BLOCK_SIZE) {  // Block being searched
+        if (_blockStart != BlockStart) {
+            LoadBlock(_blockStart);
+        }
+
+        quint64 _mask = Masks[byteClass];  // Matching bytes of the block
+        if (from > _blockStart) {
+            _mask &= ~quint64(0) << (from - _blockStart);  // Ignore bytes before the start offset
+        }
+
+        if (_mask) {
+            return _blockStart + qCountTrailingZeroBits(_mask);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Get name of the instruction set used to classify blocks
+ */
+const char *XMLStructuralIndex::GetImplementationName()
+{
+#ifdef XMLINDEX_HAVE_AVX2
+    if (ClassifyBlock == ClassifyBlockAvx2) {
+        return "AVX2";
+    }
+#endif
+#ifdef XMLINDEX_HAVE_SSE2
+    if (ClassifyBlock == ClassifyBlockSse2) {
+        return "SSE2";
+    }
+#endif
+    return "scalar";
+}
+
+/**
+ * @brief Compute the masks of the block starting at an offset
+ */
+void XMLStructuralIndex::LoadBlock(qint64 blockStart)
+{
+    BlockStart = blockStart;
+
+    if (Size - blockStart >= BLOCK_SIZE) {
+        ClassifyBlock(Data + blockStart, Masks);
+        return;
+    }
+
+    // The last block is padded with zero bytes, which belong to no class
+    char _paddedBlock[64] = {};  // Copy of the final partial block
+    memcpy(_paddedBlock, Data + blockStart, size_t(Size - blockStart));
+    ClassifyBlock(_paddedBlock, Masks);
+}
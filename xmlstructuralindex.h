@@ -0,0 +1,62 @@
+#ifndef XMLSTRUCTURALINDEX_H
+#define XMLSTRUCTURALINDEX_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Vectorized index of the structural bytes of an XML document
+ * The document is classified in 64-byte blocks into one bit mask per byte
+ * class, using AVX2 or SSE2 where the CPU supports it and a scalar loop
+ * otherwise. Lookups walk the masks with bit scans instead of testing every
+ * byte. Masks are computed on demand for the block being queried, so the index
+ * needs no memory proportional to the document size
+ */
+class XMLStructuralIndex
+{
+public:
+    /**
+     * @brief Classes of structural bytes tracked by the index
+     */
+    enum ByteClass {
+        MarkupStartClass,                // '<' starting a tag, comment, CDATA section or processing instruction
+        TagDelimiterClass,               // '>' closing a tag, or a quote starting an attribute value
+        ByteClassCount                   // Number of classes (not a class)
+    };
+
+    /**
+     * @brief Constructor for XMLStructuralIndex
+     * @param data Document bytes (must stay valid while the index is used)
+     * @param size Number of bytes in data
+     */
+    XMLStructuralIndex(const char *data, qint64 size);
+
+    /**
+     * @brief Find the next byte of a class
+     * @param from Offset to start searching at
+     * @param byteClass Class of the byte to find
+     * @return Offset of the first matching byte at or after from, -1 if there is none
+     */
+    qint64 FindNext(qint64 from, ByteClass byteClass);
+
+    /**
+     * @brief Get name of the instruction set used to classify blocks
+     * @return "AVX2", "SSE2" or "scalar"
+     */
+    static const char *GetImplementationName();
+
+private:
+    /**
+     * @brief Compute the masks of the block starting at an offset
+     * @param blockStart Offset of the block, a multiple of BLOCK_SIZE
+     */
+    void LoadBlock(qint64 blockStart);
+
+    const char *Data;                    // Document bytes (not owned)
+    qint64 Size;                         // Number of bytes in Data
+    qint64 BlockStart;                   // Offset of the block the masks describe (-1 before the first lookup)
+    quint64 Masks[ByteClassCount];       // One bit per byte of the current block for every class
+
+    static const qint64 BLOCK_SIZE;      // Bytes classified at once, one per mask bit
+};
+
+#endif // XMLSTRUCTURALINDEX_H
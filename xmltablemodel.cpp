@@ -0,0 +1,913 @@
+#include "xmltablemodel.h"
+#include "xmlprofiler.h"
+#include <QSet>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+const int XMLTableModel::FETCH_PAGE_ROWS = 256;          // A few screens of rows per fetchMore
+const int XMLTableModel::FETCH_ALL_BLOCK_ROWS = 65536;   // Bounds the rows held outside the table while reading the rest
+
+/**
+ * @brief Constructor initializes an empty model
+ */
+XMLTableModel::XMLTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , Table()                          // Committed table
+    , Journal()                        // Pending changes
+    , History()                        // No undo steps yet
+    , RowMap()                         // View row mapping
+    , RowMapActive(false)              // Identity mapping until rows change
+    , ColumnIndexes()                  // No search indexes yet
+    , Revision(0)                      // No structural change yet
+    , Pager()                          // Complete table, nothing to fetch
+{
+}
+
+/**
+ * @brief Replace the displayed table and discard pending changes
+ */
+void XMLTableModel::SetTableData(const TableData &tableData)
+{
+    XML_PROFILE_SCOPE("Populate model");
+    beginResetModel();
+    Table = tableData;
+    Journal.Clear();
+    History.Clear();
+    RowMap.clear();
+    RowMapActive = false;
+    ColumnIndexes.clear();
+    Revision++;
+    Pager.reset();
+    endResetModel();
+    emit HistoryChanged();
+}
+
+/**
+ * @brief Replace the displayed table by one read page by page, and discard pending changes
+ */
+void XMLTableModel::SetTablePager(const QSharedPointer<TablePager> &pager)
+{
+    XML_PROFILE_SCOPE("Populate model");
+    beginResetModel();
+    Table = TableData(pager->GetTableName());
+    Table.SetColumnHeaders(pager->GetColumnHeaders());
+    Journal.Clear();
+    History.Clear();
+    RowMap.clear();
+    RowMapActive = false;
+    ColumnIndexes.clear();
+    Revision++;
+    Pager = pager;
+
+    // The first page fills the viewport, the view asks for more as it scrolls
+    const bool _complete = FetchRows(FETCH_PAGE_ROWS, false);  // Flag indicating the table fit into the first page (true) or not (false)
+    endResetModel();
+    emit HistoryChanged();
+    if (_complete) {
+        emit TableFetched();
+    }
+}
+
+/**
+ * @brief Read every row the pager has not handed out yet
+ */
+void XMLTableModel::FetchAll()
+{
+    bool _complete = false;  // Flag indicating the last row was read (true) or reading stopped on an error (false)
+    while (!Pager.isNull()) {
+        _complete = FetchRows(FETCH_ALL_BLOCK_ROWS, true);
+    }
+
+    if (_complete) {
+        emit TableFetched();
+    }
+}
+
+/**
+ * @brief Get number of rows of the whole table, including rows not fetched yet
+ */
+int XMLTableModel::GetTotalRowCount() const
+{
+    const int _unfetchedRows = Pager.isNull() ? 0 : qMax(0, Pager->GetRowCount() - Pager->GetReadRowCount());  // Rows the pager still holds
+    return rowCount() + _unfetchedRows;
+}
+
+/**
+ * @brief Get the committed table without pending changes
+ */
+const TableData &XMLTableModel::GetTableData() const
+{
+    return Table;
+}
+
+/**
+ * @brief Get pending changes recorded since the table was set
+ */
+const ChangeJournal &XMLTableModel::GetChangeJournal() const
+{
+    return Journal;
+}
+
+/**
+ * @brief Check if there are edits not yet applied to the worker
+ */
+bool XMLTableModel::HasPendingChanges() const
+{
+    return !Journal.IsEmpty();
+}
+
+/**
+ * @brief Fold pending changes into the committed table after they were applied to the worker
+ */
+void XMLTableModel::CommitChanges()
+{
+    if (Journal.IsEmpty()) {
+        return;
+    }
+
+    // Work out the committed index every view row will have once the journal is folded:
+    // committed rows move up past deleted rows, inserted rows are appended in insertion order
+    QVector<int> _newRowMap;  // View row to committed row after the fold (only built while RowMapActive is true)
+    if (RowMapActive) {
+        const QList<int> _deletedRows = Journal.GetDeletedRows();  // Deleted committed rows, ascending
+        const int _keptCount = Table.GetRowCount() - _deletedRows.size();  // Surviving committed rows
+
+        QVector<int> _insertReferences;  // Inserted row references of the view
+        for (int _rowReference : RowMap) {  // Committed row index or inserted row reference
+            if (ChangeJournal::IsInsertedRow(_rowReference)) {
+                _insertReferences.append(_rowReference);
+            }
+        }
+        std::sort(_insertReferences.begin(), _insertReferences.end(), std::greater<int>());  // Insertion order
+
+        _newRowMap.resize(RowMap.size());
+        for (int _viewRow = 0; _viewRow < RowMap.size(); ++_viewRow) {  // Current view row (0-based)
+            const int _rowReference = RowMap.at(_viewRow);  // Committed row index or inserted row reference
+            if (ChangeJournal::IsInsertedRow(_rowReference)) {
+                const int _rank = int(std::lower_bound(_insertReferences.begin(), _insertReferences.end(), _rowReference,
+                                                       std::greater<int>()) - _insertReferences.begin());  // Position in insertion order
+                _newRowMap[_viewRow] = _keptCount + _rank;
+            } else {
+                const int _deletedBefore = int(std::lower_bound(_deletedRows.begin(), _deletedRows.end(), _rowReference)
+                                               - _deletedRows.begin());  // Deleted rows above this one
+                _newRowMap[_viewRow] = _rowReference - _deletedBefore;
+            }
+        }
+    }
+
+    // Same order as XMLWorker::ApplyTableChanges: edits address committed rows before they shift
+    for (const ChangeJournal::CellEdit &_edit : Journal.GetCellEdits()) {  // Pending edit of a committed cell
+        Table.SetCell(_edit.Row, _edit.Column, _edit.Value);
+    }
+    Table.RemoveRows(Journal.GetDeletedRows());
+    for (const QStringList &_rowData : Journal.GetInsertedRows()) {  // Inserted row in insertion order
+        Table.AppendRow(_rowData);
+    }
+
+    Journal.Clear();
+    History.Clear();  // Row references of the history no longer exist
+    ColumnIndexes.clear();
+
+    // Every view row shows the same cells as before, only the references change
+    bool _isIdentity = true;  // Flag indicating view rows equal committed rows after the fold (true) or not (false)
+    for (int _viewRow = 0; _viewRow < _newRowMap.size() && _isIdentity; ++_viewRow) {  // Current view row (0-based)
+        _isIdentity = _newRowMap.at(_viewRow) == _viewRow;
+    }
+    RowMap = _isIdentity ? QVector<int>() : _newRowMap;
+    RowMapActive = !_isIdentity;
+    emit HistoryChanged();
+}
+
+/**
+ * @brief Check if a pending change can be undone
+ */
+bool XMLTableModel::CanUndo() const
+{
+    return History.CanUndo();
+}
+
+/**
+ * @brief Check if an undone change can be applied again
+ */
+bool XMLTableModel::CanRedo() const
+{
+    return History.CanRedo();
+}
+
+/**
+ * @brief Get a short description of the change Undo would revert
+ */
+QString XMLTableModel::GetUndoText() const
+{
+    return History.GetUndoText();
+}
+
+/**
+ * @brief Get a short description of the change Redo would apply
+ */
+QString XMLTableModel::GetRedoText() const
+{
+    return History.GetRedoText();
+}
+
+/**
+ * @brief Revert the last pending change
+ */
+bool XMLTableModel::Undo()
+{
+    if (!History.CanUndo()) {
+        return false;
+    }
+
+    ApplyCommand(History.Undo(), true, true);
+    emit HistoryChanged();
+    return true;
+}
+
+/**
+ * @brief Apply the last undone change again
+ */
+bool XMLTableModel::Redo()
+{
+    if (!History.CanRedo()) {
+        return false;
+    }
+
+    ApplyCommand(History.Redo(), false, true);
+    emit HistoryChanged();
+    return true;
+}
+
+/**
+ * @brief Undo every pending change in one step, without reloading the table
+ */
+void XMLTableModel::DiscardChanges()
+{
+    if (!History.CanUndo()) {
+        return;
+    }
+
+    // One reset instead of a signal per undone row keeps discarding many changes cheap for the views
+    beginResetModel();
+    while (History.CanUndo()) {
+        ApplyCommand(History.Undo(), true, false);
+    }
+
+    // Without inserts and deletes left, an unsorted view shows the committed rows again
+    bool _isIdentity = RowMap.size() == Table.GetRowCount();  // Flag indicating the row map can be dropped (true) or not (false)
+    for (int _viewRow = 0; _viewRow < RowMap.size() && _isIdentity; ++_viewRow) {  // Current view row (0-based)
+        _isIdentity = RowMap.at(_viewRow) == _viewRow;
+    }
+    if (_isIdentity) {
+        RowMap.clear();
+        RowMapActive = false;
+    }
+    Revision++;
+    endResetModel();
+    emit HistoryChanged();
+}
+
+/**
+ * @brief Create a sorter for the current view rows that can run on another thread
+ */
+ColumnSorter XMLTableModel::CreateSorter(int column)
+{
+    FetchAll();
+
+    QVector<int> _rowReferences(rowCount());  // Row reference of every view row
+    for (int _viewRow = 0; _viewRow < _rowReferences.size(); ++_viewRow) {  // Current view row (0-based)
+        _rowReferences[_viewRow] = GetRowReference(_viewRow);
+    }
+
+    // Only edited and inserted cells are copied, the rest is read from the shared table
+    QHash<int, QString> _pendingValues;  // Pending text of the column by row reference
+    for (const ChangeJournal::CellEdit &_edit : Journal.GetCellEdits()) {  // Pending edit of a committed cell
+        if (_edit.Column == column) {
+            _pendingValues.insert(_edit.Row, _edit.Value);
+        }
+    }
+    if (RowMapActive) {
+        for (int _rowReference : RowMap) {  // Committed row index or inserted row reference
+            QString _value;  // Text of the inserted cell
+            if (ChangeJournal::IsInsertedRow(_rowReference) && Journal.FindCellValue(_rowReference, column, &_value)) {
+                _pendingValues.insert(_rowReference, _value);
+            }
+        }
+    }
+
+    return ColumnSorter(Table, column, _rowReferences, _pendingValues);
+}
+
+/**
+ * @brief Get counter of structural changes
+ */
+quint64 XMLTableModel::GetRevision() const
+{
+    return Revision;
+}
+
+/**
+ * @brief Reorder the view rows
+ */
+bool XMLTableModel::ApplyRowOrder(const QVector<int> &viewRows, quint64 revision)
+{
+    if (revision != Revision || viewRows.size() != rowCount()) {
+        return false;
+    }
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+    MaterializeRowMap();
+    QVector<int> _newRowMap(RowMap.size());  // Row reference of every view row in the new order
+    QVector<int> _newViewRow(RowMap.size());  // New position of every old view row
+    for (int _viewRow = 0; _viewRow < viewRows.size(); ++_viewRow) {  // New view row (0-based)
+        _newRowMap[_viewRow] = RowMap.at(viewRows.at(_viewRow));
+        _newViewRow[viewRows.at(_viewRow)] = _viewRow;
+    }
+    RowMap = _newRowMap;
+    Revision++;
+
+    // Keep selections and the current cell on the same rows
+    const QModelIndexList _oldIndexes = persistentIndexList();  // Indexes held by views and selections
+    QModelIndexList _newIndexes;  // Same cells at their new rows
+    _newIndexes.reserve(_oldIndexes.size());
+    for (const QModelIndex &_oldIndex : _oldIndexes) {  // Current persistent index
+        _newIndexes.append(index(_newViewRow.at(_oldIndex.row()), _oldIndex.column()));
+    }
+    changePersistentIndexList(_oldIndexes, _newIndexes);
+
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    return true;
+}
+
+/**
+ * @brief Get column names of the displayed table
+ */
+QStringList XMLTableModel::GetColumnHeaders() const
+{
+    return Table.GetColumnHeaders();
+}
+
+/**
+ * @brief Get displayed cell values of a row including pending changes
+ */
+QStringList XMLTableModel::GetRowData(int row) const
+{
+    QStringList _rowData;  // Cell values of the requested row
+    for (int _col = 0; _col < Table.GetColumnCount(); ++_col) {  // Current column index (0-based)
+        _rowData.append(GetCellText(row, _col));
+    }
+    return _rowData;
+}
+
+/**
+ * @brief Find rows whose displayed cell matches a query, including pending changes
+ */
+QVector<int> XMLTableModel::FindRows(int column, ColumnIndex::QueryType type, const QString &value, const QString &upperValue)
+{
+    if (column < 0 || column >= Table.GetColumnCount()) {
+        return QVector<int>();
+    }
+
+    FetchAll();  // Indexes cover the complete table
+
+    QSharedPointer<ColumnIndex> &_index = ColumnIndexes[column];  // Search index of the column (null before the first query)
+    if (!_index) {
+        _index.reset(new ColumnIndex(column));
+    }
+
+    const QVector<int> _committedMatches = _index->Find(Table, type, value, upperValue);  // Matching committed rows, ignoring pending changes
+    if (Journal.IsEmpty() && !RowMapActive) {
+        return _committedMatches;  // View rows are committed rows
+    }
+
+    // Committed rows whose cell is edited are decided by their pending text instead of the index
+    QSet<int> _editedRows;  // Committed rows with a pending edit in the column
+    QVector<int> _editedMatches;  // Edited committed rows whose pending text matches
+    for (const ChangeJournal::CellEdit &_edit : Journal.GetCellEdits()) {  // Pending edit of a committed cell
+        if (_edit.Column != column) {
+            continue;
+        }
+        _editedRows.insert(_edit.Row);
+        if (ColumnIndex::Matches(type, _edit.Value, value, upperValue)) {
+            _editedMatches.append(_edit.Row);
+        }
+    }
+
+    QVector<int> _committedRows;  // Matching committed rows including pending edits, ascending
+    _committedRows.reserve(_committedMatches.size() + _editedMatches.size());
+    for (int _row : _committedMatches) {  // Row matching by its committed text
+        if (!_editedRows.contains(_row)) {
+            _committedRows.append(_row);
+        }
+    }
+    _committedRows.append(_editedMatches);
+    std::sort(_committedRows.begin(), _committedRows.end());
+
+    if (!RowMapActive) {
+        return _committedRows;
+    }
+
+    // Rows were inserted, removed or reordered, translate through the row map and check inserted rows directly
+    QVector<int> _viewRowOfCommitted(Table.GetRowCount(), -1);  // View row of each committed row (-1 if deleted)
+    QVector<int> _viewRows;  // Matching view rows
+    for (int _viewRow = 0; _viewRow < RowMap.size(); ++_viewRow) {  // Current view row (0-based)
+        const int _rowReference = RowMap.at(_viewRow);  // Committed row index or inserted row reference
+        if (!ChangeJournal::IsInsertedRow(_rowReference)) {
+            _viewRowOfCommitted[_rowReference] = _viewRow;
+        } else if (ColumnIndex::Matches(type, GetCellText(_viewRow, column), value, upperValue)) {
+            _viewRows.append(_viewRow);
+        }
+    }
+
+    for (int _row : _committedRows) {  // Matching committed row
+        if (_viewRowOfCommitted.at(_row) >= 0) {
+            _viewRows.append(_viewRowOfCommitted.at(_row));
+        }
+    }
+
+    std::sort(_viewRows.begin(), _viewRows.end());
+    return _viewRows;
+}
+
+/**
+ * @brief Remove the displayed table
+ */
+void XMLTableModel::Clear()
+{
+    SetTableData(TableData());
+}
+
+/**
+ * @brief Get number of rows of the displayed table
+ */
+int XMLTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return RowMapActive ? RowMap.size() : Table.GetRowCount();
+}
+
+/**
+ * @brief Get number of columns of the displayed table
+ */
+int XMLTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : Table.GetColumnCount();
+}
+
+/**
+ * @brief Check if the pager has rows left that the view can ask for
+ */
+bool XMLTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !Pager.isNull();
+}
+
+/**
+ * @brief Read the next page of rows from the pager
+ */
+void XMLTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (!parent.isValid() && FetchRows(FETCH_PAGE_ROWS, true)) {
+        emit TableFetched();
+    }
+}
+
+/**
+ * @brief Get cell text for display and editing roles
+ */
+QVariant XMLTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QVariant();
+    }
+
+    return GetCellText(index.row(), index.column());
+}
+
+/**
+ * @brief Get column names for the horizontal header and row numbers for the vertical header
+ */
+QVariant XMLTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    if (orientation == Qt::Horizontal) {
+        const QStringList _columnHeaders = Table.GetColumnHeaders();  // Column names of the displayed table
+        return section >= 0 && section < _columnHeaders.size() ? QVariant(_columnHeaders.at(section)) : QVariant();
+    }
+
+    return section + 1;  // Row numbers are shown 1-based
+}
+
+/**
+ * @brief Get item flags for a cell
+ */
+Qt::ItemFlags XMLTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+/**
+ * @brief Record edited cell text in the journal
+ */
+bool XMLTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole) {
+        return false;
+    }
+
+    const QString _newValue = value.toString();  // Text entered by the user
+    if (GetCellText(index.row(), index.column()) == _newValue) {
+        return false;
+    }
+
+    // Fetched rows keep their committed index while paging, so the journal addresses them without reading the rest
+
+    EditHistory::Command _command = EditHistory::Command();  // Delta of the edit for undo
+    _command.Type = EditHistory::CellEditCommand;
+    _command.RowReference = GetRowReference(index.row());
+    _command.Column = index.column();
+    _command.ViewRow = index.row();
+    _command.HadPendingValue = Journal.FindCellValue(_command.RowReference, _command.Column, &_command.OldValue);
+    _command.NewValue = _newValue;
+
+    Journal.RecordCellEdit(_command.RowReference, _command.Column, _newValue);
+    History.Push(_command);
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    emit HistoryChanged();
+    return true;
+}
+
+/**
+ * @brief Insert empty rows, recorded in the journal
+ */
+bool XMLTableModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || row > rowCount() || count <= 0) {
+        return false;
+    }
+
+    // Rows fetched later are shown above the inserted rows at the end of the view (see FetchRows),
+    // so inserting after the last known row appends after the whole table without reading the rest
+    MaterializeRowMap();
+
+    EditHistory::Command _command = EditHistory::Command();  // Delta of the insert for undo
+    _command.Type = EditHistory::RowInsertCommand;
+    _command.ViewRows.append(row);
+    _command.RunLengths.append(count);
+
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    for (int _i = 0; _i < count; ++_i) {  // Number of rows inserted so far
+        const int _rowReference = Journal.RecordRowInsert(Table.GetColumnCount());  // Reference of the new row
+        RowMap.insert(row + _i, _rowReference);
+        _command.RowReferences.append(_rowReference);
+    }
+    Revision++;
+    endInsertRows();
+
+    History.Push(_command);
+    emit HistoryChanged();
+    return true;
+}
+
+/**
+ * @brief Append one empty row after the last row of the whole table
+ */
+int XMLTableModel::AppendRow()
+{
+    const int _row = rowCount();  // View row of the new row, rows fetched later are shown above it
+    return insertRows(_row, 1) ? _row : -1;
+}
+
+/**
+ * @brief Remove rows, recorded in the journal
+ */
+bool XMLTableModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > rowCount()) {
+        return false;
+    }
+
+    FetchAll();  // The journal addresses rows of the complete table
+
+    EditHistory::Command _command = EditHistory::Command();  // Delta of the delete for undo
+    _command.Type = EditHistory::RowDeleteCommand;
+    RemoveRowRun(row, count, &_command);
+
+    History.Push(_command);
+    emit HistoryChanged();
+    return true;
+}
+
+/**
+ * @brief Remove any set of rows, one removal per contiguous run, recorded in the journal
+ */
+bool XMLTableModel::RemoveRowSet(const QList<int> &rows)
+{
+    QList<int> _sortedRows = rows;  // Rows to remove in ascending order without duplicates
+    std::sort(_sortedRows.begin(), _sortedRows.end());
+    _sortedRows.erase(std::unique(_sortedRows.begin(), _sortedRows.end()), _sortedRows.end());
+
+    if (_sortedRows.isEmpty() || _sortedRows.first() < 0 || _sortedRows.last() >= rowCount()) {
+        return false;
+    }
+
+    FetchAll();  // The journal addresses rows of the complete table
+
+    // Remove runs from the bottom up so that the row numbers of the remaining runs stay valid,
+    // all runs together are undone as a single step
+    EditHistory::Command _command = EditHistory::Command();  // Delta of the delete for undo
+    _command.Type = EditHistory::RowDeleteCommand;
+    for (int _end = _sortedRows.size(); _end > 0;) {  // Position just past the current run
+        int _start = _end - 1;  // Position of the first row of the current run
+        while (_start > 0 && _sortedRows.at(_start - 1) == _sortedRows.at(_start) - 1) {
+            _start--;
+        }
+
+        RemoveRowRun(_sortedRows.at(_start), _end - _start, &_command);
+        _end = _start;
+    }
+
+    History.Push(_command);
+    emit HistoryChanged();
+    return true;
+}
+
+/**
+ * @brief Translate a view row to a journal row reference
+ */
+int XMLTableModel::GetRowReference(int row) const
+{
+    return RowMapActive ? RowMap.at(row) : row;
+}
+
+/**
+ * @brief Get displayed text of a cell including pending changes
+ */
+QString XMLTableModel::GetCellText(int row, int column) const
+{
+    if (row < 0 || row >= rowCount() || column < 0 || column >= Table.GetColumnCount()) {
+        return QString();
+    }
+
+    const int _rowReference = GetRowReference(row);  // Committed row index or inserted row reference
+    QString _pendingValue;  // Pending text of the cell (only valid if found in the journal)
+
+    if ((ChangeJournal::IsInsertedRow(_rowReference) || Journal.HasCellEdits())
+        && Journal.FindCellValue(_rowReference, column, &_pendingValue)) {
+        return _pendingValue;
+    }
+
+    return Table.GetCell(_rowReference, column);
+}
+
+/**
+ * @brief Build the explicit row map before the first structural change
+ */
+void XMLTableModel::MaterializeRowMap()
+{
+    if (RowMapActive) {
+        return;
+    }
+
+    RowMap.resize(Table.GetRowCount());
+    for (int _row = 0; _row < RowMap.size(); ++_row) {  // Committed row index (0-based)
+        RowMap[_row] = _row;
+    }
+    RowMapActive = true;
+}
+
+/**
+ * @brief Remove a run of view rows and record it in the journal and in a delete command
+ */
+void XMLTableModel::RemoveRowRun(int row, int count, EditHistory::Command *command)
+{
+    MaterializeRowMap();
+
+    command->ViewRows.append(row);
+    command->RunLengths.append(count);
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    for (int _i = 0; _i < count; ++_i) {  // Number of rows removed so far
+        const int _rowReference = RowMap.at(row + _i);  // Committed row index or inserted row reference
+        QStringList _rowData;  // Cell values of an inserted row, which the journal forgets on delete
+        if (Journal.FindRowData(_rowReference, &_rowData)) {
+            command->RowData.append(_rowData);
+        }
+        command->RowReferences.append(_rowReference);
+        Journal.RecordRowDelete(_rowReference);
+    }
+    RowMap.remove(row, count);
+    Revision++;
+    endRemoveRows();
+}
+
+/**
+ * @brief Revert or apply again a command of the history
+ */
+void XMLTableModel::ApplyCommand(const EditHistory::Command &command, bool undo, bool notify)
+{
+    if (command.Type == EditHistory::CellEditCommand) {
+        if (!undo) {
+            Journal.RecordCellEdit(command.RowReference, command.Column, command.NewValue);
+        } else if (command.HadPendingValue) {
+            Journal.RecordCellEdit(command.RowReference, command.Column, command.OldValue);
+        } else {
+            Journal.DiscardCellEdit(command.RowReference, command.Column);
+        }
+
+        const int _viewRow = notify ? FindViewRow(command.RowReference, command.ViewRow) : -1;  // Row showing the cell (-1 if not notified)
+        if (_viewRow >= 0) {
+            const QModelIndex _index = index(_viewRow, command.Column);  // Changed cell
+            emit dataChanged(_index, _index, {Qt::DisplayRole, Qt::EditRole});
+        }
+        return;
+    }
+
+    MaterializeRowMap();
+
+    // Inserting again (redo of an insert, undo of a delete) restores the rows in the journal first
+    const bool _showRows = (command.Type == EditHistory::RowInsertCommand) != undo;  // Flag indicating rows come back (true) or go away (false)
+    QStringList _emptyRow;  // Cells of a freshly inserted row
+    for (int _col = 0; _col < Table.GetColumnCount(); ++_col) {  // Current column index (0-based)
+        _emptyRow.append(QString());
+    }
+    int _dataIndex = 0;  // Position in RowData of the next deleted inserted row
+    for (int _rowReference : command.RowReferences) {  // Row reference of the command
+        if (!_showRows) {
+            Journal.RecordRowDelete(_rowReference);
+        } else if (command.Type == EditHistory::RowDeleteCommand && ChangeJournal::IsInsertedRow(_rowReference)) {
+            Journal.RestoreRow(_rowReference, command.RowData.value(_dataIndex++));
+        } else {
+            Journal.RestoreRow(_rowReference, _emptyRow);
+        }
+    }
+
+    // Runs were applied in order, so they are reverted in reverse order at the view rows they had
+    QVector<int> _runStarts;  // Offset of each run in RowReferences
+    int _offset = 0;  // Offset of the current run
+    for (int _length : command.RunLengths) {  // Number of rows of the current run
+        _runStarts.append(_offset);
+        _offset += _length;
+    }
+    for (int _step = 0; _step < _runStarts.size(); ++_step) {  // Number of runs handled so far
+        const int _run = undo ? _runStarts.size() - 1 - _step : _step;  // Run handled in this step
+        const QVector<int> _rowReferences = command.RowReferences.mid(_runStarts.at(_run), command.RunLengths.at(_run));  // References of the run
+        if (_showRows) {
+            InsertViewRows(command.ViewRows.at(_run), _rowReferences, notify);
+        } else {
+            RemoveViewRows(command.ViewRows.at(_run), _rowReferences, notify);
+        }
+    }
+    Revision++;
+}
+
+/**
+ * @brief Show rows again at a view row
+ */
+void XMLTableModel::InsertViewRows(int row, const QVector<int> &rowReferences, bool notify)
+{
+    if (rowReferences.isEmpty()) {
+        return;
+    }
+
+    // A sort since the change may have moved rows, the position is then only approximate
+    const int _row = qBound(0, row, RowMap.size());  // View row the run starts at
+    if (notify) {
+        beginInsertRows(QModelIndex(), _row, _row + rowReferences.size() - 1);
+    }
+    RowMap.insert(_row, rowReferences.size(), 0);
+    std::copy(rowReferences.begin(), rowReferences.end(), RowMap.begin() + _row);
+    if (notify) {
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief Stop showing rows, wherever they are in the view now
+ */
+void XMLTableModel::RemoveViewRows(int row, const QVector<int> &rowReferences, bool notify)
+{
+    QVector<int> _viewRows;  // Current view rows of the references, ascending
+    if (row >= 0 && row + rowReferences.size() <= RowMap.size()
+        && std::equal(rowReferences.begin(), rowReferences.end(), RowMap.begin() + row)) {
+        for (int _i = 0; _i < rowReferences.size(); ++_i) {  // Position in the run
+            _viewRows.append(row + _i);
+        }
+    } else {
+        // Rows were reordered since, look every reference up
+        const QSet<int> _references(rowReferences.begin(), rowReferences.end());  // References to hide
+        for (int _viewRow = 0; _viewRow < RowMap.size(); ++_viewRow) {  // Current view row (0-based)
+            if (_references.contains(RowMap.at(_viewRow))) {
+                _viewRows.append(_viewRow);
+            }
+        }
+    }
+
+    // Remove contiguous runs from the bottom up so that the remaining view rows stay valid
+    for (int _end = _viewRows.size(); _end > 0;) {  // Position just past the current run
+        int _start = _end - 1;  // Position of the first row of the current run
+        while (_start > 0 && _viewRows.at(_start - 1) == _viewRows.at(_start) - 1) {
+            _start--;
+        }
+
+        const int _first = _viewRows.at(_start);  // First view row of the run
+        const int _count = _end - _start;  // Rows of the run
+        if (notify) {
+            beginRemoveRows(QModelIndex(), _first, _first + _count - 1);
+        }
+        RowMap.remove(_first, _count);
+        if (notify) {
+            endRemoveRows();
+        }
+        _end = _start;
+    }
+}
+
+/**
+ * @brief Get the view row that shows a row reference
+ */
+int XMLTableModel::FindViewRow(int rowReference, int hint) const
+{
+    if (!RowMapActive) {
+        return rowReference >= 0 && rowReference < Table.GetRowCount() ? rowReference : -1;
+    }
+
+    if (hint >= 0 && hint < RowMap.size() && RowMap.at(hint) == rowReference) {
+        return hint;
+    }
+
+    return RowMap.indexOf(rowReference);
+}
+
+/**
+ * @brief Read rows from the pager and append them to the committed table
+ */
+bool XMLTableModel::FetchRows(int maxRows, bool notify)
+{
+    if (Pager.isNull()) {
+        return false;
+    }
+
+    XML_PROFILE_SCOPE("Fetch rows");
+
+    QList<QStringList> _rows;  // Rows handed out by the pager (empty at the end or on an error, which the pager reports)
+    Pager->ReadRows(maxRows, &_rows);
+
+    if (!_rows.isEmpty()) {
+        if (Table.GetRowCount() == 0) {
+            Table.SetColumnHeaders(Pager->GetColumnHeaders());  // Byte ranges only know them after the first row
+        }
+
+        // Only inserts change the row map while paging, so fetched rows follow the last committed row and
+        // stay above the rows inserted at the end of the view, where the worker appends them too
+        const int _firstCommitted = Table.GetRowCount();  // Committed index of the first fetched row
+        int _firstRow = _firstCommitted;  // View row of the first fetched row
+        if (RowMapActive) {
+            _firstRow = RowMap.size();
+            while (_firstRow > 0 && ChangeJournal::IsInsertedRow(RowMap.at(_firstRow - 1))) {
+                _firstRow--;
+            }
+        }
+
+        if (notify) {
+            beginInsertRows(QModelIndex(), _firstRow, _firstRow + _rows.size() - 1);
+        }
+        for (const QStringList &_rowData : _rows) {  // Fetched row in document order
+            Table.AppendRow(_rowData);
+        }
+        if (RowMapActive) {
+            RowMap.insert(_firstRow, _rows.size(), 0);
+            std::iota(RowMap.begin() + _firstRow, RowMap.begin() + _firstRow + _rows.size(), _firstCommitted);
+        }
+        ColumnIndexes.clear();
+        Revision++;
+        if (notify) {
+            endInsertRows();
+        }
+    }
+    XML_PROFILE_COUNT("Rows extracted", _rows.size());
+
+    if (Pager->CanReadMore()) {
+        return false;
+    }
+
+    // A table that could not be read to its end stays as far as it got and is never reported complete
+    const bool _complete = !Pager->HasError();  // Flag indicating every row was read (true) or not (false)
+    Pager.reset();
+    if (_complete) {
+        Table.InferColumnTypes();  // Same storage as a table parsed in one go
+    }
+    return _complete;
+}
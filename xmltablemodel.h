@@ -0,0 +1,338 @@
+#ifndef XMLTABLEMODEL_H
+#define XMLTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVariant>
+#include <QVector>
+#include <QHash>
+#include <QSharedPointer>
+#include "tablestore.h"
+#include "changejournal.h"
+#include "edithistory.h"
+#include "columnindex.h"
+#include "columnsorter.h"
+#include "tablepager.h"
+
+/**
+ * @brief Item model exposing one TableData to a QTableView
+ * Cells are served on demand through data(), so only visible rows are ever touched.
+ * Edits never modify the committed table; they are recorded in a ChangeJournal
+ * that the worker applies on save. Every edit also pushes its delta to an
+ * EditHistory, so pending changes can be undone and redone one at a time.
+ * A table can also be served from a TablePager: rows are then read a page at a
+ * time through fetchMore as the view scrolls, and the rest of the table is read
+ * before the first change, sort or search, which need every row
+ */
+class XMLTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor for XMLTableModel
+     * @param parent Parent object pointer
+     */
+    explicit XMLTableModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Replace the displayed table and discard pending changes
+     * @param tableData Committed table to display (implicitly shared, never modified)
+     */
+    void SetTableData(const TableData &tableData);
+
+    /**
+     * @brief Replace the displayed table by one read page by page, and discard pending changes
+     * Only the first page is read here, further pages are read through fetchMore
+     * @param pager Pager positioned at the first row of the table
+     */
+    void SetTablePager(const QSharedPointer<TablePager> &pager);
+
+    /**
+     * @brief Read every row the pager has not handed out yet
+     */
+    void FetchAll();
+
+    /**
+     * @brief Get number of rows of the whole table, including rows not fetched yet
+     * @return Total row count before pending changes
+     */
+    int GetTotalRowCount() const;
+
+    /**
+     * @brief Get the committed table without pending changes
+     * @return Reference to the committed table (only the fetched rows while a pager is active)
+     */
+    const TableData &GetTableData() const;
+
+    /**
+     * @brief Get pending changes recorded since the table was set
+     * @return Reference to the change journal
+     */
+    const ChangeJournal &GetChangeJournal() const;
+
+    /**
+     * @brief Check if there are edits not yet applied to the worker
+     * @return true if changes are pending, false otherwise
+     */
+    bool HasPendingChanges() const;
+
+    /**
+     * @brief Fold pending changes into the committed table after they were applied to the worker
+     * The committed table then matches the worker table without reloading it. View
+     * rows keep their order, so a sorted view stays sorted and the view is never reset.
+     * Inserted rows are appended after the committed rows, so a paged table with pending
+     * inserts must be fetched completely before the journal is applied to the worker
+     */
+    void CommitChanges();
+
+    /**
+     * @brief Check if a pending change can be undone
+     * @return true if at least one edit, insert or delete can be reverted, false otherwise
+     */
+    bool CanUndo() const;
+
+    /**
+     * @brief Check if an undone change can be applied again
+     * @return true if at least one undone change can be redone, false otherwise
+     */
+    bool CanRedo() const;
+
+    /**
+     * @brief Get a short description of the change Undo would revert
+     * @return Text such as "Edit Cell" (empty if nothing can be undone)
+     */
+    QString GetUndoText() const;
+
+    /**
+     * @brief Get a short description of the change Redo would apply
+     * @return Text such as "Delete Rows" (empty if nothing can be redone)
+     */
+    QString GetRedoText() const;
+
+    /**
+     * @brief Revert the last pending change
+     * @return true if a change was reverted, false if there was none
+     */
+    bool Undo();
+
+    /**
+     * @brief Apply the last undone change again
+     * @return true if a change was applied, false if there was none
+     */
+    bool Redo();
+
+    /**
+     * @brief Undo every pending change in one step, without reloading the table
+     * Undone changes stay available to Redo
+     */
+    void DiscardChanges();
+
+    /**
+     * @brief Create a sorter for the current view rows that can run on another thread
+     * Rows not fetched yet are read first, which changes the revision, so the revision
+     * passed to ApplyRowOrder must be read after this call
+     * @param column Column index (0-based) to sort by
+     * @return Sorter holding a shared copy of the table and the pending values of the column
+     */
+    ColumnSorter CreateSorter(int column);
+
+    /**
+     * @brief Get counter of structural changes, a row order computed at one revision only fits the same revision
+     * @return Current revision
+     */
+    quint64 GetRevision() const;
+
+    /**
+     * @brief Reorder the view rows, for example by the result of a ColumnSorter
+     * @param viewRows Current view rows in their new order
+     * @param revision Revision the order was computed at
+     * @return true if the rows were reordered, false if rows were inserted or removed since (nothing changes)
+     */
+    bool ApplyRowOrder(const QVector<int> &viewRows, quint64 revision);
+
+    /**
+     * @brief Get column names of the displayed table
+     * @return QStringList containing column names
+     */
+    QStringList GetColumnHeaders() const;
+
+    /**
+     * @brief Get displayed cell values of a row including pending changes
+     * @param row View row index (0-based, within the fetched rows)
+     * @return QStringList containing the row data
+     */
+    QStringList GetRowData(int row) const;
+
+    /**
+     * @brief Find rows whose displayed cell matches a query, including pending changes
+     * Committed rows are searched through a per-column index built on first use;
+     * only edited and inserted rows are checked one by one
+     * @param column Column index (0-based)
+     * @param type Kind of query
+     * @param value Value to compare with, lower bound for range queries
+     * @param upperValue Upper bound for range queries, ignored otherwise
+     * @return Matching view rows in ascending order
+     */
+    QVector<int> FindRows(int column, ColumnIndex::QueryType type, const QString &value, const QString &upperValue = QString());
+
+    /**
+     * @brief Remove the displayed table
+     */
+    void Clear();
+
+    /**
+     * @brief Get number of rows of the displayed table
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Get number of columns of the displayed table
+     */
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Check if the pager has rows left that the view can ask for
+     */
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    /**
+     * @brief Read the next page of rows from the pager
+     */
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * @brief Get cell text for display and editing roles
+     */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Get column names for the horizontal header and row numbers for the vertical header
+     */
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Get item flags, cells are editable when the view's edit triggers allow it
+     */
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    /**
+     * @brief Record edited cell text in the journal
+     */
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+    /**
+     * @brief Insert empty rows, recorded in the journal
+     * Rows not fetched yet are not read: they are shown above rows inserted at the end of the
+     * view, so a row equal to the fetched row count appends after the last row of the table
+     */
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    /**
+     * @brief Append one empty row after the last row of the whole table, recorded in the journal
+     * @return View row of the new row, -1 if nothing was inserted
+     */
+    int AppendRow();
+
+    /**
+     * @brief Remove rows, recorded in the journal
+     */
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    /**
+     * @brief Remove any set of rows, one removal per contiguous run, recorded in the journal
+     * @param rows View rows to remove (0-based, any order, duplicates ignored)
+     * @return true if the rows were removed, false if a row is out of range (nothing is removed)
+     */
+    bool RemoveRowSet(const QList<int> &rows);
+
+signals:
+    /**
+     * @brief Emitted whenever CanUndo, CanRedo or their texts may have changed
+     */
+    void HistoryChanged();
+
+    /**
+     * @brief Emitted once a pager has handed out the last row, with the complete and unmodified table in GetTableData
+     */
+    void TableFetched();
+
+private:
+    /**
+     * @brief Translate a view row to a journal row reference
+     * @param row View row index (0-based)
+     * @return Committed row index or inserted row reference
+     */
+    int GetRowReference(int row) const;
+
+    /**
+     * @brief Get displayed text of a cell including pending changes
+     */
+    QString GetCellText(int row, int column) const;
+
+    /**
+     * @brief Build the explicit row map before the first structural change
+     */
+    void MaterializeRowMap();
+
+    /**
+     * @brief Read rows from the pager and append them to the committed table
+     * @param maxRows Largest number of rows to read
+     * @param notify true to emit insert signals, false while the model is being reset
+     * @return true if the pager has handed out its last row with this call, false otherwise
+     */
+    bool FetchRows(int maxRows, bool notify);
+
+    /**
+     * @brief Remove a run of view rows and record it in the journal and in a delete command
+     * @param row First view row of the run (0-based, must be valid)
+     * @param count Number of rows of the run (must fit the view)
+     * @param command Delete command the run and the data of removed inserted rows are appended to
+     */
+    void RemoveRowRun(int row, int count, EditHistory::Command *command);
+
+    /**
+     * @brief Revert or apply again a command of the history
+     * @param command Delta to revert or apply
+     * @param undo true to revert the command, false to apply it again
+     * @param notify true to emit change signals for every row and cell, false while the model is being reset
+     */
+    void ApplyCommand(const EditHistory::Command &command, bool undo, bool notify);
+
+    /**
+     * @brief Show rows again at a view row, the rows must already be restored in the journal
+     * @param row View row the first row is inserted at (clamped to the current rows)
+     * @param rowReferences Row references of the rows in view order
+     * @param notify true to emit insert signals, false while the model is being reset
+     */
+    void InsertViewRows(int row, const QVector<int> &rowReferences, bool notify);
+
+    /**
+     * @brief Stop showing rows, wherever they are in the view now
+     * @param row View row the rows were shown at when the command was recorded, checked first
+     * @param rowReferences Row references of the rows to hide
+     * @param notify true to emit remove signals, false while the model is being reset
+     */
+    void RemoveViewRows(int row, const QVector<int> &rowReferences, bool notify);
+
+    /**
+     * @brief Get the view row that shows a row reference
+     * @param rowReference Committed row index or inserted row reference
+     * @param hint View row the reference was shown at before, checked first
+     * @return View row (0-based), -1 if the row is not shown
+     */
+    int FindViewRow(int rowReference, int hint) const;
+
+    TableData Table;                     // Committed table being displayed (empty if no table selected)
+    ChangeJournal Journal;               // Pending edits, inserts and deletes (empty if nothing changed)
+    EditHistory History;                 // Deltas of the pending changes for undo and redo (empty if nothing changed)
+    QVector<int> RowMap;                 // View row to row reference (only used once RowMapActive is true)
+    bool RowMapActive;                   // Flag indicating rows were inserted, removed or reordered (true) or view rows equal committed rows (false)
+    QHash<int, QSharedPointer<ColumnIndex>> ColumnIndexes;  // Search indexes of the committed table by column (built on first query)
+    quint64 Revision;                    // Incremented whenever view rows are added, removed or reordered
+    QSharedPointer<TablePager> Pager;    // Source of the rows not fetched yet (null once the table is complete)
+
+    static const int FETCH_PAGE_ROWS;    // Rows read per fetchMore call
+    static const int FETCH_ALL_BLOCK_ROWS;  // Rows read per step of FetchAll
+};
+
+#endif // XMLTABLEMODEL_H
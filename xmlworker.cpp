@@ -1,10 +1,15 @@
 #include "xmlworker.h"
+#include <algorithm>
+#include <numeric>
 
 // Define XML structure constants
 const QString XMLWorker::ROOT_ELEMENT_NAME = "database";     // Expected root element
 const QString XMLWorker::TABLE_ELEMENT_NAME = "table";       // Expected table element
 const QString XMLWorker::ROW_ELEMENT_NAME = "row";           // Expected row element
 const QString XMLWorker::CELL_ELEMENT_NAME = "cell";         // Expected cell element
+const int XMLWorker::PROGRESS_ROW_INTERVAL = 1024;           // Rows between progress reports
+const int XMLWorker::LAZY_TABLE_CACHE_CAPACITY = 4;          // Unedited tables kept parsed
+const int XMLWorker::PARALLEL_POLL_INTERVAL_MS = 50;         // Cancellation poll interval of parallel loads
 
 /**
  * @brief Constructor initializes XMLWorker with default values
@@ -13,6 +18,22 @@ XMLWorker::XMLWorker()
     : CurrentFilePath("")              // Path to active XML file
     , AvailableTableNames()            // List of discovered table names
     , FileLoaded(false)                // File loading status flag
+    , Mode(DomLoadMode)                // Load strategy for next file
+    , LoadedMode(DomLoadMode)          // Load strategy of current file
+    , SidecarCacheEnabled(false)       // Always parse unless enabled
+    , SharedPool()                     // Private pools
+    , Store()                          // Compact table storage
+    , Observer(nullptr)                // Progress receiver of running load
+    , StreamingLoadRunning(0)          // Partial streaming results flag
+    , ParallelLoadCancelled(0)         // Pool thread stop request
+    , TableIndex()                     // DOM table index
+    , SourceData()                     // Raw file content for lazy tables
+    , MappedFile()                     // Mapping owner of SourceData
+    , DeclarationLength(0)             // XML declaration length
+    , SourceIsUtf8(true)               // Source encoding allows patch saves
+    , TableRanges()                    // Lazy table byte ranges
+    , TableRangeIndex()                // Lazy table lookup by name
+    , LazyTables(LAZY_TABLE_CACHE_CAPACITY)  // Parsed lazy tables
 {
     // Initialize DOM document for XML processing
     XmlDocument = QDomDocument();
@@ -29,48 +50,188 @@ XMLWorker::~XMLWorker()
 /**
  * @brief Load and parse XML file from specified path
  * @param filePath Path to the XML file to load (absolute or relative path)
+ * @param observer Optional receiver of progress notifications (nullptr for none)
  * @return true if file loaded and parsed successfully, false otherwise
  */
-bool XMLWorker::LoadXMLFile(const QString &filePath)
+bool XMLWorker::LoadXMLFile(const QString &filePath, XMLLoadObserver *observer)
 {
+    XML_PROFILE_SCOPE("Load file");
+
     // Validate input parameters
     if (filePath.isEmpty()) {
         qDebug() << "Error: Empty file path provided";
         return false;
     }
 
-    // Open the XML file for reading
-    QFile _xmlFile(filePath);  // File object for accessing the XML file on disk
-    if (!_xmlFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    // Open the XML file for reading, binary so that the bytes can be mapped as they are on disk
+    QScopedPointer<QFile> _xmlFile(new QFile(filePath));  // File object for accessing the XML file on disk
+    if (!_xmlFile->open(QIODevice::ReadOnly)) {
         qDebug() << "Error: Cannot open file" << filePath;
         return false;
     }
 
-    // Variables for error reporting during XML parsing
-    QString _errorMessage;     // Error message if XML parsing fails (empty if successful)
-    int _errorLine = 0;        // Line where XML parsing error occurred (0 if no error)
-    int _errorColumn = 0;      // Column where XML parsing error occurred (0 if no error)
+    // Release data of the previously loaded file before parsing the new one
+    FileLoaded = false;
+    XmlDocument = QDomDocument();
+    Store.Clear();
+    TableIndex.clear();
+    SourceData.clear();
+    MappedFile.reset();
+    DeclarationLength = 0;
+    SourceIsUtf8 = true;
+    TableRanges.clear();
+    TableRangeIndex.clear();
+    LazyTables.Clear();
+    AvailableTableNames.clear();
+    ParallelLoadCancelled.storeRelaxed(0);  // A failed or cancelled earlier load must not stop this one
+    LoadedMode = Mode;
+    Observer = observer;
 
-    // Parse XML content into DOM document
-    if (!XmlDocument.setContent(&_xmlFile, &_errorMessage, &_errorLine, &_errorColumn)) {
-        qDebug() << "Error: XML parsing failed at line" << _errorLine
-                 << "column" << _errorColumn << ":" << _errorMessage;
-        _xmlFile.close();
-        return false;
+    const qint64 _fileSize = _xmlFile->size();  // Bytes in the file
+    if (Observer) {
+        Observer->OnLoadProgress(0, _fileSize);
     }
 
-    _xmlFile.close();
+    // Modes that end with a complete table store can take it from an up-to-date sidecar instead
+    const bool _storeMode = Mode == StreamingLoadMode || Mode == ParallelLoadMode;  // Flag indicating the load fills Store with every table
+    const bool _fromSidecar = _storeMode && SidecarCacheEnabled && SidecarCache::Read(filePath, &Store);  // Flag indicating no parse is needed
 
-    // Validate XML structure before proceeding
-    if (!ValidateXMLStructure()) {
-        qDebug() << "Error: Invalid XML structure";
-        return false;
+    // Parsers read the mapped pages through a buffer device, so only small chunks are ever copied
+    const QByteArray _fileData = _fromSidecar ? QByteArray() : MapFileData(*_xmlFile);  // File content, not copied when mapping succeeded
+    QBuffer _fileBuffer;  // Read-only device over the file content
+    _fileBuffer.setData(_fileData);
+    _fileBuffer.open(QIODevice::ReadOnly);
+
+    if (_fromSidecar) {
+        _xmlFile->close();
+        AvailableTableNames = Store.GetTableNames();
+
+        if (Observer) {
+            for (const QString &_tableName : AvailableTableNames) {
+                Observer->OnTableLoaded(_tableName);
+            }
+        }
+    } else if (Mode == StreamingLoadMode) {
+        // Read the document sequentially, tables become available as soon as they are parsed
+        StreamingLoadRunning.storeRelease(1);
+        bool _parsed = ParseXMLStream(_fileBuffer);  // Result of the streaming parse (false on XML error or cancel)
+        StreamingLoadRunning.storeRelease(0);
+        _xmlFile->close();
+
+        if (!_parsed) {
+            Store.Clear();
+            Observer = nullptr;
+            return false;
+        }
+
+        AvailableTableNames = Store.GetTableNames();
+    } else if (Mode == ParallelLoadMode) {
+        // Locate the tables like the lazy mode, then parse all of them at once; the mapping is no longer needed afterwards
+        SourceData = _fileData;
+        StreamingLoadRunning.storeRelease(1);
+        bool _parsed = ScanTableRanges() && ParseTableRangesParallel();  // Result of scan and parse (false on XML error or cancel)
+        StreamingLoadRunning.storeRelease(0);
+        SourceData.clear();
+        TableRanges.clear();
+        TableRangeIndex.clear();
+        DeclarationLength = 0;
+        _xmlFile->close();
+
+        if (!_parsed) {
+            Store.Clear();
+            AvailableTableNames.clear();
+            Observer = nullptr;
+            return false;
+        }
+
+        AvailableTableNames = Store.GetTableNames();
+    } else if (Mode == LazyLoadMode) {
+        // Keep the mapping and only locate the tables, rows are parsed once a table is requested
+        SourceData = _fileData;
+        _xmlFile->close();  // The mapping stays valid while the QFile object lives
+
+        if (!ScanTableRanges()) {
+            SourceData.clear();
+            Observer = nullptr;
+            return false;
+        }
+
+        if (Observer && Observer->IsLoadCancelled()) {
+            qDebug() << "Loading cancelled:" << filePath;
+            SourceData.clear();
+            TableRanges.clear();
+            TableRangeIndex.clear();
+            AvailableTableNames.clear();
+            Observer = nullptr;
+            return false;
+        }
+
+        if (Observer) {
+            for (const QString &_tableName : AvailableTableNames) {
+                Observer->OnTableLoaded(_tableName);
+            }
+        }
+
+        MappedFile.reset(_xmlFile.take());
+    } else {
+        // Variables for error reporting during XML parsing
+        QString _errorMessage;     // Error message if XML parsing fails (empty if successful)
+        int _errorLine = 0;        // Line where XML parsing error occurred (0 if no error)
+        int _errorColumn = 0;      // Column where XML parsing error occurred (0 if no error)
+
+        // Parse XML content into DOM document
+        bool _parsed = false;      // Result of the DOM parse (false on XML error)
+        {
+            XML_PROFILE_SCOPE("Parse DOM");
+            _parsed = XmlDocument.setContent(&_fileBuffer, &_errorMessage, &_errorLine, &_errorColumn);
+        }
+        if (!_parsed) {
+            qDebug() << "Error: XML parsing failed at line" << _errorLine
+                     << "column" << _errorColumn << ":" << _errorMessage;
+            _xmlFile->close();
+            Observer = nullptr;
+            return false;
+        }
+
+        _xmlFile->close();
+
+        // The DOM parse cannot be interrupted, honour a cancel request once it returns
+        if (Observer && Observer->IsLoadCancelled()) {
+            qDebug() << "Loading cancelled:" << filePath;
+            XmlDocument = QDomDocument();
+            Observer = nullptr;
+            return false;
+        }
+
+        // Validate XML structure before proceeding
+        if (!ValidateXMLStructure()) {
+            qDebug() << "Error: Invalid XML structure";
+            Observer = nullptr;
+            return false;
+        }
+
+        ParseXMLStructure();
+
+        if (Observer) {
+            for (const QString &_tableName : AvailableTableNames) {
+                Observer->OnTableLoaded(_tableName);
+            }
+        }
     }
 
-    // Store file path and extract table information
+    if (Observer) {
+        Observer->OnLoadProgress(_fileSize, _fileSize);
+    }
+
+    // The next open of the unchanged file skips the parse
+    if (_storeMode && SidecarCacheEnabled && !_fromSidecar) {
+        SidecarCache::Write(filePath, Store);
+    }
+
+    // Store file path and loading state
     CurrentFilePath = filePath;
-    ParseXMLStructure();
     FileLoaded = true;
+    Observer = nullptr;
 
     qDebug() << "Successfully loaded XML file:" << filePath;
     qDebug() << "Found" << AvailableTableNames.size() << "tables";
@@ -78,6 +239,63 @@ bool XMLWorker::LoadXMLFile(const QString &filePath)
     return true;
 }
 
+/**
+ * @brief Check if a table can already be displayed while a streaming load is still running
+ */
+bool XMLWorker::IsTableAvailable(const QString &tableName) const
+{
+    if (LoadedMode == LazyLoadMode) {
+        return FileLoaded && TableRangeIndex.contains(tableName);
+    }
+
+    if ((LoadedMode == StreamingLoadMode || LoadedMode == ParallelLoadMode) && (FileLoaded || StreamingLoadRunning.loadAcquire())) {
+        return !Store.FindTable(tableName).isNull();
+    }
+
+    return FileLoaded && TableIndex.contains(tableName);
+}
+
+/**
+ * @brief Select how the next LoadXMLFile call reads the document
+ */
+void XMLWorker::SetLoadMode(LoadMode mode)
+{
+    Mode = mode;
+}
+
+/**
+ * @brief Get the currently selected load mode
+ */
+XMLWorker::LoadMode XMLWorker::GetLoadMode() const
+{
+    return Mode;
+}
+
+/**
+ * @brief Enable the binary sidecar cache of StreamingLoadMode and ParallelLoadMode
+ */
+void XMLWorker::SetSidecarCacheEnabled(bool enabled)
+{
+    SidecarCacheEnabled = enabled;
+}
+
+/**
+ * @brief Check if the binary sidecar cache is used
+ */
+bool XMLWorker::IsSidecarCacheEnabled() const
+{
+    return SidecarCacheEnabled;
+}
+
+/**
+ * @brief Share one string pool with other workers
+ */
+void XMLWorker::SetStringPool(const QSharedPointer<StringPool> &stringPool)
+{
+    SharedPool = stringPool;
+    Store.SetStringPool(stringPool);
+}
+
 /**
  * @brief Get list of all available table names from loaded XML
  */
@@ -87,59 +305,156 @@ QStringList XMLWorker::GetTableNames() const
 }
 
 /**
- * @brief Load specific table data into provided QTableWidget
+ * @brief Load specific table data into provided table model
  * @param tableName Name of the table to load (must exist in XML document)
- * @param tableWidget Pointer to QTableWidget that will display the data
+ * @param tableModel Pointer to model that will serve the data to its views
  * @return true if data loaded successfully, false on error
  */
-bool XMLWorker::LoadTableData(const QString &tableName, QTableWidget *tableWidget)
+bool XMLWorker::LoadTableData(const QString &tableName, XMLTableModel *tableModel)
 {
-    // Validate input parameters
-    if (!FileLoaded || tableName.isEmpty() || !tableWidget) {
+    if (!tableModel) {
         qDebug() << "Error: Invalid parameters for loading table data";
         return false;
     }
 
-    // Find the specified table element
-    QDomElement _tableElement = FindTableElement(tableName);  // DOM element for requested table (null if not found)
-    if (_tableElement.isNull()) {
+    // Rows still to be extracted are read page by page as the view needs them
+    QSharedPointer<TablePager> _pager = CreateTablePager(tableName);  // Pager over the table (null if it is in memory)
+    if (!_pager.isNull()) {
+        tableModel->SetTablePager(_pager);
+        qDebug() << "Paging table" << tableName << "with" << _pager->GetRowCount() << "rows";
+        return true;
+    }
+
+    TableData _tableData;  // Table served by the model, shares the stored columns until edited
+    if (!GetTable(tableName, &_tableData)) {
+        return false;
+    }
+
+    tableModel->SetTableData(_tableData);
+    return true;
+}
+
+/**
+ * @brief Get column names and row count of a table without extracting its rows
+ */
+bool XMLWorker::GetTableMetadata(const QString &tableName, QStringList *columnHeaders, int *rowCount)
+{
+    if (!FileLoaded || tableName.isEmpty() || !columnHeaders || !rowCount) {
+        qDebug() << "Error: Invalid parameters for reading table metadata";
+        return false;
+    }
+
+    if (LoadedMode == DomLoadMode) {
+        const TableIndexEntry *_indexEntry = FindTableIndexEntry(tableName);  // Index entry of the table (nullptr if not found)
+        if (!_indexEntry) {
+            qDebug() << "Error: Table" << tableName << "not found";
+            return false;
+        }
+
+        *columnHeaders = _indexEntry->ColumnHeaders;
+        *rowCount = _indexEntry->RowCount;
+        return true;
+    }
+
+    QSharedPointer<TablePager> _pager = CreateTablePager(tableName);  // Pager over an unopened lazy table (null otherwise)
+    if (!_pager.isNull()) {
+        QList<QStringList> _firstRow;  // First row, which names the columns
+        if (!_pager->ReadRows(1, &_firstRow)) {
+            return false;
+        }
+
+        *columnHeaders = _pager->GetColumnHeaders();
+        *rowCount = _pager->GetRowCount();
+        return true;
+    }
+
+    QSharedPointer<TableData> _table = FindStoredTable(tableName, false);  // Table in memory (null if not found)
+    if (_table.isNull()) {
+        qDebug() << "Error: Table" << tableName << "not found";
+        return false;
+    }
+
+    *columnHeaders = _table->GetColumnHeaders();
+    *rowCount = _table->GetRowCount();
+    return true;
+}
+
+/**
+ * @brief Keep a table a model has read completely through a TablePager
+ */
+void XMLWorker::CacheFetchedTable(const TableData &tableData)
+{
+    if (!FileLoaded || LoadedMode != LazyLoadMode) {
+        return;
+    }
+
+    auto _iterator = TableRangeIndex.constFind(tableData.GetName());  // Range entry of the table (end if not found)
+    if (_iterator == TableRangeIndex.constEnd() || !LazyTables.Peek(_iterator.value()).isNull()) {
+        return;
+    }
+
+    // The copy shares the model's columns until either side is modified
+    LazyTables.Insert(_iterator.value(), QSharedPointer<TableData>(new TableData(tableData)));
+}
+
+/**
+ * @brief Copy a table into plain row/column storage
+ * @param tableName Name of the table to read (must exist in XML document)
+ * @param tableData Target receiving headers and rows
+ * @return true if table was found, false on error
+ */
+bool XMLWorker::GetTable(const QString &tableName, TableData *tableData)
+{
+    // Validate input parameters, completed tables of a running streaming load may already be read
+    if ((!FileLoaded && !StreamingLoadRunning.loadAcquire()) || tableName.isEmpty() || !tableData) {
+        qDebug() << "Error: Invalid parameters for reading table data";
+        return false;
+    }
+
+    XML_PROFILE_SCOPE("Extract table");
+
+    if (LoadedMode != DomLoadMode) {
+        // Serve the table directly from the compact store, the copy shares its storage until edited
+        QSharedPointer<TableData> _table = FindStoredTable(tableName, false);  // Stored table (null if not found)
+        if (_table.isNull()) {
+            qDebug() << "Error: Table" << tableName << "not found";
+            return false;
+        }
+
+        *tableData = *_table;
+
+        XML_PROFILE_COUNT("Rows extracted", _table->GetRowCount());
+        qDebug() << "Loaded table" << tableName << "with" << _table->GetRowCount() << "rows";
+        return true;
+    }
+
+    // Find the specified table through the index
+    TableIndexEntry *_indexEntry = FindTableIndexEntry(tableName);  // Index entry for requested table (nullptr if not found)
+    if (!_indexEntry) {
         qDebug() << "Error: Table" << tableName << "not found";
         return false;
     }
 
-    // Extract column headers and row data
-    QStringList _columnHeaders = ExtractColumnHeaders(_tableElement);  // List of column names from table
-    QMap<int, QStringList> _tableRows = ExtractTableRows(_tableElement);   // Map of row indices to row data
+    // Column headers come from the index, row data from the table element
+    QStringList _columnHeaders = _indexEntry->ColumnHeaders;  // List of column names from table
+    QMap<int, QStringList> _tableRows = ExtractTableRows(_indexEntry->Element);   // Map of row indices to row data
 
-    // Configure table widget dimensions
-    tableWidget->clear();
-    tableWidget->setColumnCount(_columnHeaders.size());
+    // Cache row elements so that later edits can be applied without rescanning the table
+    GetRowElements(*_indexEntry);
 
-    // Set column headers
-    tableWidget->setHorizontalHeaderLabels(_columnHeaders);
+    // Copy the extracted rows into compact table storage
+    *tableData = TableData(tableName);
+    tableData->SetColumnHeaders(_columnHeaders);
 
-    // Add all rows and cell data
-    int _rowIndex = 0;  // Actual row position in table widget (0-based)
-    
     // Iterate through all rows in the map using QMap iterator
     QMapIterator<int, QStringList> _iterator(_tableRows);  // Iterator for the map of rows
     while (_iterator.hasNext()) {  // Loop through all entries in the map
         _iterator.next();  // Move to next entry
-        
-        QStringList _rowData = _iterator.value();  // Cell values for current row
-        tableWidget->insertRow(_rowIndex);  // Add new row to table widget
-
-        // Process each cell in current row
-        for (int _col = 0; _col < _rowData.size() && _col < _columnHeaders.size(); ++_col) {  // Current column index (0-based)
-            QTableWidgetItem *_item = new QTableWidgetItem(_rowData[_col]);  // Table cell item containing XML cell data
-            tableWidget->setItem(_rowIndex, _col, _item);
-        }
-        
-        _rowIndex++;  // Increment actual row position for next iteration
+        tableData->AppendRow(_iterator.value());
     }
+    tableData->InferColumnTypes();
 
-    tableWidget->setRowCount(_rowIndex);
-
+    XML_PROFILE_COUNT("Rows extracted", _tableRows.size());
     qDebug() << "Loaded table" << tableName << "with" << _tableRows.size() << "rows";
     return true;
 }
@@ -148,29 +463,54 @@ bool XMLWorker::LoadTableData(const QString &tableName, QTableWidget *tableWidge
  * @brief Add new row to specified table in XML document
  */
 bool XMLWorker::AddRowToTable(const QString &tableName, const QStringList &rowData)
+{
+    return AddRowsToTable(tableName, QList<QStringList>() << rowData);
+}
+
+/**
+ * @brief Append a block of rows to a table, resolving the table once
+ */
+bool XMLWorker::AddRowsToTable(const QString &tableName, const QList<QStringList> &rows)
 {
     if (!FileLoaded || tableName.isEmpty()) {
-        qDebug() << "Error: Invalid parameters for adding row";
+        qDebug() << "Error: Invalid parameters for adding rows";
         return false;
     }
 
-    // Find target table element
-    QDomElement tableElement = FindTableElement(tableName);
-    if (tableElement.isNull()) {
+    if (LoadedMode != DomLoadMode) {
+        QSharedPointer<TableData> _table = FindStoredTable(tableName, true);  // Stored table (null if not found)
+        if (_table.isNull()) {
+            qDebug() << "Error: Table" << tableName << "not found for row addition";
+            return false;
+        }
+
+        for (const QStringList &_rowData : rows) {
+            _table->AppendRow(_rowData);
+        }
+
+        qDebug() << "Added" << rows.size() << "rows to table" << tableName;
+        return true;
+    }
+
+    // Find target table in the index
+    TableIndexEntry *_indexEntry = FindTableIndexEntry(tableName);  // Index entry for requested table (nullptr if not found)
+    if (!_indexEntry) {
         qDebug() << "Error: Table" << tableName << "not found for row addition";
         return false;
     }
 
-    // Get column headers for proper row structure
-    QStringList columnHeaders = ExtractColumnHeaders(tableElement);
-
-    // Create new row element with provided data
-    QDomElement newRowElement = CreateRowElement(rowData, columnHeaders);
-
-    // Append new row to table
-    tableElement.appendChild(newRowElement);
+    // New rows use the indexed column headers for proper row structure and share one template
+    const QDomElement _rowTemplate = CreateRowTemplate(_indexEntry->ColumnHeaders);  // Cell structure cloned for every new row
+    for (const QStringList &_rowData : rows) {
+        QDomElement _rowElement = CreateRowElement(_rowData, _rowTemplate);  // New DOM row element
+        _indexEntry->Element.appendChild(_rowElement);
+        if (_indexEntry->RowElementsCached) {
+            _indexEntry->RowElements.append(_rowElement);
+        }
+    }
+    _indexEntry->RowCount += rows.size();
 
-    qDebug() << "Added new row to table" << tableName;
+    qDebug() << "Added" << rows.size() << "rows to table" << tableName;
     return true;
 }
 
@@ -179,225 +519,1169 @@ bool XMLWorker::AddRowToTable(const QString &tableName, const QStringList &rowDa
  */
 bool XMLWorker::DeleteRowFromTable(const QString &tableName, int rowIndex)
 {
-    if (!FileLoaded || tableName.isEmpty() || rowIndex < 0) {
-        qDebug() << "Error: Invalid parameters for deleting row";
+    return DeleteRowsFromTable(tableName, QList<int>() << rowIndex);
+}
+
+/**
+ * @brief Delete a set of rows from a table in a single pass
+ */
+bool XMLWorker::DeleteRowsFromTable(const QString &tableName, const QList<int> &rowIndices)
+{
+    if (!FileLoaded || tableName.isEmpty()) {
+        qDebug() << "Error: Invalid parameters for deleting rows";
+        return false;
+    }
+
+    // Removal works on ascending, unique indices
+    QList<int> _sortedRows = rowIndices;  // Rows to delete in ascending order without duplicates
+    std::sort(_sortedRows.begin(), _sortedRows.end());
+    _sortedRows.erase(std::unique(_sortedRows.begin(), _sortedRows.end()), _sortedRows.end());
+
+    if (_sortedRows.isEmpty()) {
+        return true;
+    }
+
+    if (_sortedRows.first() < 0) {
+        qDebug() << "Error: Row index" << _sortedRows.first() << "is out of range";
         return false;
     }
 
-    // Find the table element
-    QDomElement _tableElement = FindTableElement(tableName);  // DOM element for requested table (null if not found)
-    if (_tableElement.isNull()) {
+    if (LoadedMode != DomLoadMode) {
+        QSharedPointer<TableData> _table = FindStoredTable(tableName, true);  // Stored table (null if not found)
+        if (_table.isNull()) {
+            qDebug() << "Error: Table" << tableName << "not found";
+            return false;
+        }
+
+        if (_sortedRows.last() >= _table->GetRowCount()) {
+            qDebug() << "Error: Row index" << _sortedRows.last() << "is out of range";
+            return false;
+        }
+
+        _table->RemoveRows(_sortedRows);
+
+        qDebug() << "Deleted" << _sortedRows.size() << "rows from table" << tableName;
+        return true;
+    }
+
+    // Find the table through the index
+    TableIndexEntry *_indexEntry = FindTableIndexEntry(tableName);  // Index entry for requested table (nullptr if not found)
+    if (!_indexEntry) {
         qDebug() << "Error: Table" << tableName << "not found";
         return false;
     }
+    QDomElement _tableElement = _indexEntry->Element;  // DOM element for requested table
 
-    // Get the row to delete
-    QDomNodeList _rowNodes = _tableElement.elementsByTagName(ROW_ELEMENT_NAME);  // List of row elements in table
-    if (rowIndex >= _rowNodes.size()) {
-        qDebug() << "Error: Row index" << rowIndex << "is out of range";
+    // Rows are numbered like ExtractTableRows, through the cached direct row children
+    QVector<QDomElement> &_rowElements = GetRowElements(*_indexEntry);  // Cached row elements in document order
+    if (_sortedRows.last() >= _rowElements.size()) {
+        qDebug() << "Error: Row index" << _sortedRows.last() << "is out of range";
         return false;
     }
 
-    // Remove the row
-    QDomNode _rowToDelete = _rowNodes.at(rowIndex);  // DOM node representing the row to be deleted
-    _tableElement.removeChild(_rowToDelete);
+    // Detach the rows and compact the cache in the same pass
+    QVector<QDomElement> _remainingRows;  // Cache entries of surviving rows
+    _remainingRows.reserve(_rowElements.size() - _sortedRows.size());
+    qsizetype _nextDeleted = 0;  // Position in the sorted row list
+
+    for (int _row = 0; _row < _rowElements.size(); ++_row) {  // Current row index (0-based)
+        if (_nextDeleted < _sortedRows.size() && _sortedRows.at(_nextDeleted) == _row) {
+            _tableElement.removeChild(_rowElements.at(_row));
+            _nextDeleted++;
+            continue;
+        }
+        _remainingRows.append(_rowElements.at(_row));
+    }
+
+    _rowElements = _remainingRows;
+    _indexEntry->RowCount = _rowElements.size();
 
-    qDebug() << "Deleted row" << rowIndex << "from table" << tableName;
+    qDebug() << "Deleted" << _sortedRows.size() << "rows from table" << tableName;
     return true;
 }
 
 /**
- * @brief Replace entire table with data from QTableWidget
+ * @brief Replace all rows of a table with rows produced by a callable
  * @param tableName Name of the table to update (must exist in XML document)
- * @param tableWidget Pointer to QTableWidget containing the new data
+ * @param columnHeaders Column names of the new rows
+ * @param rowCount Number of new rows
+ * @param rowSource Callable returning the cell values of a row index as QStringList
  * @return true if table updated successfully, false on error
  */
-bool XMLWorker::UpdateCompleteTable(const QString &tableName, QTableWidget *tableWidget)
+template <typename RowSource>
+bool XMLWorker::ReplaceTableRows(const QString &tableName, const QStringList &columnHeaders, int rowCount, RowSource rowSource)
 {
     // Validate input parameters
-    if (!FileLoaded || tableName.isEmpty() || !tableWidget) {
+    if (!FileLoaded || tableName.isEmpty() || rowCount < 0) {
         qDebug() << "Error: Invalid parameters for updating table data";
         return false;
     }
 
+    if (LoadedMode != DomLoadMode) {
+        QSharedPointer<TableData> _table = FindStoredTable(tableName, true);  // Stored table (null if not found)
+        if (_table.isNull()) {
+            qDebug() << "Error: Table" << tableName << "not found";
+            return false;
+        }
+
+        // Replace stored rows with the new content
+        _table->ClearRows();
+        _table->SetColumnHeaders(columnHeaders);
+        for (int _row = 0; _row < rowCount; ++_row) {  // Current row index (0-based)
+            _table->AppendRow(rowSource(_row));
+        }
+        _table->InferColumnTypes();
+
+        qDebug() << "Updated table" << tableName << "with" << rowCount << "rows";
+        return true;
+    }
+
     // Find the table element to update
-    QDomElement _tableElement = FindTableElement(tableName);  // DOM element for requested table (null if not found)
-    if (_tableElement.isNull()) {
+    TableIndexEntry *_indexEntry = FindTableIndexEntry(tableName);  // Index entry for requested table (nullptr if not found)
+    if (!_indexEntry) {
         qDebug() << "Error: Table" << tableName << "not found";
         return false;
     }
-
-    // Extract column headers from the table widget
-    QStringList _columnHeaders;  // List to store column header texts
-    for (int _col = 0; _col < tableWidget->columnCount(); ++_col) {  // Current column index (0-based)
-        QTableWidgetItem *_headerItem = tableWidget->horizontalHeaderItem(_col);  // Header item for current column
-        if (_headerItem) {
-            _columnHeaders.append(_headerItem->text());
-        } else {
-            // Generate default column name if no header exists
-            _columnHeaders.append(QString("Column_%1").arg(_col + 1));
+    QDomElement _tableElement = _indexEntry->Element;  // DOM element for requested table
+
+    // Build the replacement table beside the document instead of removing rows one by one:
+    // a shallow clone keeps the attributes, other direct children are moved over in order
+    QDomElement _newTableElement = _tableElement.cloneNode(false).toElement();  // Table element receiving the new rows
+    for (QDomNode _child = _tableElement.firstChild(); !_child.isNull();) {  // Current direct child of the old table
+        QDomNode _nextChild = _child.nextSibling();  // Following child, read before the current one is moved
+        if (!_child.isElement() || _child.toElement().tagName() != ROW_ELEMENT_NAME) {
+            _newTableElement.appendChild(_child);
         }
+        _child = _nextChild;
     }
 
-    // Remove all existing rows from the table element
-    QDomNodeList _rowNodes = _tableElement.elementsByTagName(ROW_ELEMENT_NAME);  // All row elements in the table
-    while (!_rowNodes.isEmpty() && _rowNodes.size() > 0) {
-        _tableElement.removeChild(_rowNodes.at(0));
-    }
-
-    // Add new rows from the table widget
-    for (int _row = 0; _row < tableWidget->rowCount(); ++_row) {  // Current row index (0-based)
-        QStringList _rowData;  // List to store cell values for current row
-        
-        // Collect data from each cell in the row
-        for (int _col = 0; _col < tableWidget->columnCount(); ++_col) {  // Current column index (0-based)
-            QTableWidgetItem *_cellItem = tableWidget->item(_row, _col);  // Cell item at current position
-            _rowData.append(_cellItem ? _cellItem->text() : "");  // Use empty string if cell is null
-        }
-        
+    // Add the new rows, rebuilding the row cache as we go
+    const QDomElement _rowTemplate = CreateRowTemplate(columnHeaders);  // Cell structure cloned for every row
+    _indexEntry->RowElements.clear();
+    _indexEntry->RowElements.reserve(rowCount);
+    for (int _row = 0; _row < rowCount; ++_row) {  // Current row index (0-based)
         // Create and add the new row element
-        QDomElement _rowElement = CreateRowElement(_rowData, _columnHeaders);  // New DOM row element
-        _tableElement.appendChild(_rowElement);
+        QDomElement _rowElement = CreateRowElement(rowSource(_row), _rowTemplate);  // New DOM row element
+        _newTableElement.appendChild(_rowElement);
+        _indexEntry->RowElements.append(_rowElement);
     }
 
-    qDebug() << "Updated table" << tableName << "with" << tableWidget->rowCount() << "rows";
+    // Swap the tables in one step, the old rows are released with the old element
+    _tableElement.parentNode().replaceChild(_newTableElement, _tableElement);
+    _indexEntry->Element = _newTableElement;
+
+    _indexEntry->RowElementsCached = true;
+    _indexEntry->RowCount = rowCount;
+    _indexEntry->ColumnHeaders = rowCount > 0 ? columnHeaders : QStringList();
+
+    qDebug() << "Updated table" << tableName << "with" << rowCount << "rows";
     return true;
 }
 
-/** * @brief Save current XML document state to file
+/**
+ * @brief Replace entire table with data from a table model
+ * @param tableName Name of the table to update (must exist in XML document)
+ * @param tableModel Pointer to model containing the new data
+ * @return true if table updated successfully, false on error
  */
-bool XMLWorker::SaveXMLFile()
+bool XMLWorker::UpdateCompleteTable(const QString &tableName, XMLTableModel *tableModel)
 {
-    if (!FileLoaded || CurrentFilePath.isEmpty()) {
-        qDebug() << "Error: No file loaded for saving";
-        return false;
-    }
-
-    QFile xmlFile(CurrentFilePath);
-    if (!xmlFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error: Cannot open file for writing" << CurrentFilePath;
+    if (!tableModel) {
+        qDebug() << "Error: Invalid parameters for updating table data";
         return false;
     }
 
-    // Write XML document with proper formatting
-    QTextStream stream(&xmlFile);
-    stream.setEncoding(QStringConverter::Utf8);
-    stream << XmlDocument.toString(4);  // Indent with 4 spaces
+    // Rows the view never asked for are read before the table is replaced
+    tableModel->FetchAll();
 
-    xmlFile.close();
-
-    qDebug() << "Successfully saved XML file:" << CurrentFilePath;
-    return true;
+    // Rows are read through the model so that its pending changes are included
+    return ReplaceTableRows(tableName, tableModel->GetColumnHeaders(), tableModel->rowCount(),
+                            [tableModel](int row) { return tableModel->GetRowData(row); });
 }
 
 /**
- * @brief Get path of currently loaded XML file
+ * @brief Replace entire table with plain row/column data
+ * @param tableName Name of the table to update (must exist in XML document)
+ * @param tableData New headers and rows of the table
+ * @return true if table updated successfully, false on error
  */
-QString XMLWorker::GetCurrentFilePath() const
+bool XMLWorker::ReplaceTable(const QString &tableName, const TableData &tableData)
 {
-    return CurrentFilePath;
+    return ReplaceTableRows(tableName, tableData.GetColumnHeaders(), tableData.GetRowCount(),
+                            [&tableData](int row) { return tableData.GetRow(row); });
 }
 
 /**
- * @brief Check if XML file is currently loaded and ready
+ * @brief Apply only the recorded changes to a table
+ * @param tableName Name of the table to modify (must exist in XML document)
+ * @param journal Pending cell edits, inserted rows and deleted rows
+ * @return true if all changes were applied successfully, false on error
  */
-bool XMLWorker::IsFileLoaded() const
+bool XMLWorker::ApplyTableChanges(const QString &tableName, const ChangeJournal &journal)
 {
-    return FileLoaded;
+    if (!FileLoaded || tableName.isEmpty()) {
+        qDebug() << "Error: Invalid parameters for applying table changes";
+        return false;
+    }
+
+    XML_PROFILE_SCOPE("Apply changes");
+    const QList<ChangeJournal::CellEdit> _cellEdits = journal.GetCellEdits();  // Edited cells of surviving rows
+    const QList<int> _deletedRows = journal.GetDeletedRows();                   // Deleted rows in ascending order
+    const QList<QStringList> _insertedRows = journal.GetInsertedRows();         // Appended rows in insertion order
+
+    // Edits address committed rows, so apply them before rows shift
+    if ((!_cellEdits.isEmpty() && !UpdateCells(tableName, _cellEdits))
+        || (!_deletedRows.isEmpty() && !DeleteRowsFromTable(tableName, _deletedRows))
+        || (!_insertedRows.isEmpty() && !AddRowsToTable(tableName, _insertedRows))) {
+        return false;
+    }
+
+    qDebug() << "Applied" << _cellEdits.size() << "cell edits," << _deletedRows.size() << "deletions and"
+             << _insertedRows.size() << "insertions to table" << tableName;
+    return true;
 }
 
 /**
- * @brief Parse loaded XML document and extract table structure information
+ * @brief Set the text of many cells of a table, resolving the table once
  */
-void XMLWorker::ParseXMLStructure()
+bool XMLWorker::UpdateCells(const QString &tableName, const QList<ChangeJournal::CellEdit> &cellEdits)
 {
-    AvailableTableNames.clear();
+    if (!FileLoaded || tableName.isEmpty()) {
+        qDebug() << "Error: Invalid parameters for updating cells";
+        return false;
+    }
 
-    QDomElement rootElement = XmlDocument.documentElement();
-    QDomNodeList tableNodes = rootElement.elementsByTagName(TABLE_ELEMENT_NAME);
+    if (LoadedMode != DomLoadMode) {
+        QSharedPointer<TableData> _table = FindStoredTable(tableName, true);  // Stored table (null if not found)
+        if (_table.isNull()) {
+            qDebug() << "Error: Table" << tableName << "not found";
+            return false;
+        }
 
-    // Extract table names from all table elements
-    for (int i = 0; i < tableNodes.size(); ++i) {
-        QDomElement tableElement = tableNodes.at(i).toElement();
-        if (!tableElement.isNull()) {
-            QString tableName = tableElement.attribute("name");
-            if (!tableName.isEmpty()) {
-                AvailableTableNames.append(tableName);
+        // Check every edit first so that a bad batch leaves the table untouched
+        for (const ChangeJournal::CellEdit &_edit : cellEdits) {
+            if (_edit.Row < 0 || _edit.Row >= _table->GetRowCount() || _edit.Column < 0) {
+                qDebug() << "Error: Cell" << _edit.Row << _edit.Column << "is out of range";
+                return false;
             }
         }
+
+        for (const ChangeJournal::CellEdit &_edit : cellEdits) {
+            _table->SetCell(_edit.Row, _edit.Column, _edit.Value);
+        }
+
+        qDebug() << "Updated" << cellEdits.size() << "cells of table" << tableName;
+        return true;
     }
 
-    qDebug() << "Parsed XML structure, found tables:" << AvailableTableNames;
-}
+    TableIndexEntry *_indexEntry = FindTableIndexEntry(tableName);  // Index entry for requested table (nullptr if not found)
+    if (!_indexEntry) {
+        qDebug() << "Error: Table" << tableName << "not found";
+        return false;
+    }
 
-/**
- * @brief Find table element by name in current XML document
- */
-QDomElement XMLWorker::FindTableElement(const QString &tableName)
-{
-    QDomElement rootElement = XmlDocument.documentElement();
-    QDomNodeList tableNodes = rootElement.elementsByTagName(TABLE_ELEMENT_NAME);
+    QVector<QDomElement> &_rowElements = GetRowElements(*_indexEntry);             // Cached row elements in document order
+    const QStringList _columnHeaders = _indexEntry->ColumnHeaders;                 // Column names for new cells
 
-    // Search for table with matching name attribute
-    for (int i = 0; i < tableNodes.size(); ++i) {
-        QDomElement tableElement = tableNodes.at(i).toElement();
-        if (tableElement.attribute("name") == tableName) {
-            return tableElement;
+    for (const ChangeJournal::CellEdit &_edit : cellEdits) {
+        if (_edit.Row < 0 || _edit.Row >= _rowElements.size() || _edit.Column < 0) {
+            qDebug() << "Error: Cell" << _edit.Row << _edit.Column << "is out of range";
+            return false;
         }
     }
 
-    return QDomElement();  // Return null element if not found
-}
-
-/**
- * @brief Extract column headers from table element structure
- */
-QStringList XMLWorker::ExtractColumnHeaders(const QDomElement &tableElement)
-{
-    QStringList headers;
+    // Locate each row through the cache and its cell among the row's children
+    for (const ChangeJournal::CellEdit &_edit : cellEdits) {
+        QDomElement _rowElement = _rowElements[_edit.Row];  // Row containing the edited cell
+        QDomElement _cellElement = _rowElement.firstChildElement(CELL_ELEMENT_NAME);  // Candidate cell element
+        for (int _col = 0; _col < _edit.Column && !_cellElement.isNull(); ++_col) {  // Cells skipped so far
+            _cellElement = _cellElement.nextSiblingElement(CELL_ELEMENT_NAME);
+        }
 
-    // Get first row to determine column structure
-    QDomNodeList rowNodes = tableElement.elementsByTagName(ROW_ELEMENT_NAME);
-    if (rowNodes.size() > 0) {
-        QDomElement firstRow = rowNodes.at(0).toElement();
-        QDomNodeList cellNodes = firstRow.elementsByTagName(CELL_ELEMENT_NAME);
+        if (_cellElement.isNull()) {
+            // Short row: add the missing cells up to the edited column
+            int _existingCells = 0;  // Number of cells already present in the row
+            for (QDomElement _cell = _rowElement.firstChildElement(CELL_ELEMENT_NAME); !_cell.isNull();
+                 _cell = _cell.nextSiblingElement(CELL_ELEMENT_NAME)) {
+                _existingCells++;
+            }
 
-        // Extract column names from cell attributes
-        for (int i = 0; i < cellNodes.size(); ++i) {
-            QDomElement cellElement = cellNodes.at(i).toElement();
-            QString columnName = cellElement.attribute("name");
-            headers.append(columnName.isEmpty() ? QString("Column_%1").arg(i + 1) : columnName);
+            for (int _col = _existingCells; _col <= _edit.Column; ++_col) {  // Index of the cell being added
+                _cellElement = XmlDocument.createElement(CELL_ELEMENT_NAME);
+                _cellElement.setAttribute("name", _col < _columnHeaders.size() ? _columnHeaders.at(_col) : QString("Column_%1").arg(_col + 1));
+                _rowElement.appendChild(_cellElement);
+            }
         }
+
+        SetCellElementText(_cellElement, _edit.Value);
     }
 
-    return headers;
+    qDebug() << "Updated" << cellEdits.size() << "cells of table" << tableName;
+    return true;
 }
 
 /**
- * @brief Extract all row data from table element
- * @param tableElement DOM element representing the table
- * @return QMap<int, QStringList> containing all row data, with row index as key
+ * @brief Save current XML document state to file
+ * The document is streamed into a temporary file that atomically replaces the
+ * original on success, so an interrupted save leaves the previous file intact
  */
-QMap<int, QStringList> XMLWorker::ExtractTableRows(const QDomElement &tableElement)
+bool XMLWorker::SaveXMLFile(const QString &filePath)
 {
-    QMap<int, QStringList> _rows;  // Map of row index to row data (row index as key, row data as value)
-
-    QDomNodeList _rowNodes = tableElement.elementsByTagName(ROW_ELEMENT_NAME);  // All row elements in table
+    if (!FileLoaded || CurrentFilePath.isEmpty()) {
+        qDebug() << "Error: No file loaded for saving";
+        return false;
+    }
+
+    XML_PROFILE_SCOPE("Save file");
+    const QString _targetPath = filePath.isEmpty() ? CurrentFilePath : filePath;  // File written by this save
+
+#ifdef Q_OS_WIN
+    // Windows refuses to replace a file that is still mapped
+    DetachSourceData();
+#endif
+
+    // Lazy tables that were not edited are still byte for byte what the source holds
+    const bool _patchSave = LoadedMode == LazyLoadMode && SourceIsUtf8;  // Flag indicating only edited tables are re-serialized
+
+    // Copied source bytes must not go through newline translation
+    QSaveFile xmlFile(_targetPath);
+    if (!xmlFile.open(_patchSave ? QIODevice::OpenMode(QIODevice::WriteOnly) : QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Error: Cannot open file for writing" << _targetPath;
+        return false;
+    }
+
+    // Patch the source, serialize the table store or walk the DOM, none builds the document text in memory
+    bool _written = false;  // Result of serializing (false on device error)
+    {
+        XML_PROFILE_SCOPE("Serialize");
+        if (_patchSave) {
+            _written = WritePatchedSource(&xmlFile);
+        } else {
+            _written = LoadedMode != DomLoadMode ? WriteTableStore(&xmlFile) : WriteDomDocument(&xmlFile);
+        }
+    }
+    if (!_written) {
+        xmlFile.cancelWriting();
+        qDebug() << "Error: Failed to write XML file" << _targetPath;
+        return false;
+    }
+
+    XML_PROFILE_COUNT("Bytes written", xmlFile.pos());
+    bool _committed = false;  // Result of replacing the file (false on error)
+    {
+        XML_PROFILE_SCOPE("Write to disk");
+        _committed = xmlFile.commit();
+    }
+    if (!_committed) {
+        qDebug() << "Error: Failed to replace XML file" << _targetPath << ":" << xmlFile.errorString();
+        return false;
+    }
+
+    // The saved file holds exactly the stored tables, so its sidecar needs no parse either
+    if ((LoadedMode == StreamingLoadMode || LoadedMode == ParallelLoadMode) && SidecarCacheEnabled) {
+        SidecarCache::Write(_targetPath, Store);
+    }
+
+    qDebug() << "Successfully saved XML file:" << _targetPath;
+    return true;
+}
+
+/**
+ * @brief Create an independent worker holding the current content, for saving on another thread
+ */
+XMLWorker *XMLWorker::CreateSaveSnapshot()
+{
+    if (!FileLoaded || CurrentFilePath.isEmpty()) {
+        qDebug() << "Error: No file loaded for saving";
+        return nullptr;
+    }
+
+    XML_PROFILE_SCOPE("Save snapshot");
+
+#ifdef Q_OS_WIN
+    // The snapshot replaces the file while this worker lives, neither may keep it mapped
+    DetachSourceData();
+#endif
+
+    XMLWorker *_snapshot = new XMLWorker();  // Worker receiving the copied content
+    _snapshot->CurrentFilePath = CurrentFilePath;
+    _snapshot->AvailableTableNames = AvailableTableNames;
+    _snapshot->FileLoaded = true;
+    _snapshot->Mode = LoadedMode;
+    _snapshot->LoadedMode = LoadedMode;
+    _snapshot->SidecarCacheEnabled = SidecarCacheEnabled;
+
+    if (LoadedMode == DomLoadMode) {
+        // DOM handles share their nodes, only a deep copy is independent of later edits
+        _snapshot->XmlDocument = XmlDocument.cloneNode(true).toDocument();
+        qDebug() << "Created save snapshot of the DOM document";
+        return _snapshot;
+    }
+
+    // Table copies share their columns until either side is modified
+    _snapshot->Store.SetRootElement(Store.GetRootName(), Store.GetRootAttributes());
+    for (const QSharedPointer<TableData> &_table : Store.GetTables()) {
+        _snapshot->Store.AddTable(QSharedPointer<TableData>(new TableData(*_table)));
+    }
+
+    if (LoadedMode == LazyLoadMode) {
+        // Untouched tables are parsed from the same source bytes, only edited tables travel along
+        _snapshot->SourceData = SourceData;
+        _snapshot->MappedFile = MappedFile;
+        _snapshot->DeclarationLength = DeclarationLength;
+        _snapshot->SourceIsUtf8 = SourceIsUtf8;
+        _snapshot->TableRanges = TableRanges;
+        _snapshot->TableRangeIndex = TableRangeIndex;
+
+        for (int _i = 0; _i < TableRanges.size(); ++_i) {  // Position of the table in the document
+            if (LazyTables.IsDirty(_i)) {
+                _snapshot->LazyTables.Insert(_i, QSharedPointer<TableData>(new TableData(*LazyTables.Peek(_i))));
+                _snapshot->LazyTables.MarkDirty(_i);
+            }
+        }
+    }
+
+    qDebug() << "Created save snapshot with" << AvailableTableNames.size() << "tables";
+    return _snapshot;
+}
+
+/**
+ * @brief Get path of currently loaded XML file
+ */
+QString XMLWorker::GetCurrentFilePath() const
+{
+    return CurrentFilePath;
+}
 
-    // Process each row element
-    for (int _i = 0; _i < _rowNodes.size(); ++_i) {  // Row index (0-based)
-        QDomElement _rowElement = _rowNodes.at(_i).toElement();  // Current row element
-        QDomNodeList _cellNodes = _rowElement.elementsByTagName(CELL_ELEMENT_NAME);  // All cells in current row
+/**
+ * @brief Check if XML file is currently loaded and ready
+ */
+bool XMLWorker::IsFileLoaded() const
+{
+    return FileLoaded;
+}
 
-        QStringList _rowData;  // List to store all cell values in current row
+/**
+ * @brief Parse loaded XML document and build the table index
+ */
+void XMLWorker::ParseXMLStructure()
+{
+    XML_PROFILE_SCOPE("Index tables");
 
-        // Extract text content from each cell
-        for (int _j = 0; _j < _cellNodes.size(); ++_j) {  // Cell index (0-based)
-            QDomElement _cellElement = _cellNodes.at(_j).toElement();  // Current cell element
-            _rowData.append(_cellElement.text());  // Add cell text to row data
+    AvailableTableNames.clear();
+    TableIndex.clear();
+
+    QDomElement rootElement = XmlDocument.documentElement();
+    QDomNodeList tableNodes = rootElement.elementsByTagName(TABLE_ELEMENT_NAME);
+
+    // Index every named table once, later lookups only hash the name
+    for (int i = 0; i < tableNodes.size(); ++i) {
+        QDomElement tableElement = tableNodes.at(i).toElement();
+        if (!tableElement.isNull()) {
+            QString tableName = tableElement.attribute("name");
+            if (!tableName.isEmpty()) {
+                AvailableTableNames.append(tableName);
+
+                // First table wins on duplicate names, same as the former linear search
+                if (!TableIndex.contains(tableName)) {
+                    TableIndexEntry indexEntry;
+                    indexEntry.Element = tableElement;
+                    indexEntry.RowCount = 0;
+                    for (QDomElement rowElement = tableElement.firstChildElement(ROW_ELEMENT_NAME); !rowElement.isNull();
+                         rowElement = rowElement.nextSiblingElement(ROW_ELEMENT_NAME)) {
+                        indexEntry.RowCount++;
+                    }
+                    indexEntry.ColumnHeaders = ExtractColumnHeaders(tableElement);
+                    indexEntry.RowElementsCached = false;
+                    TableIndex.insert(tableName, indexEntry);
+                }
+            }
         }
+    }
+
+    qDebug() << "Parsed XML structure, found tables:" << AvailableTableNames;
+}
+
+/**
+ * @brief Read XML file sequentially into the table store
+ * @param device Opened device with the file content
+ * @return true if the document was parsed successfully, false otherwise
+ */
+bool XMLWorker::ParseXMLStream(QIODevice &device)
+{
+    XML_PROFILE_SCOPE("Parse stream");
+
+    QXmlStreamReader _reader(&device);  // Sequential reader over the file content
+
+    // Locate the root element
+    if (!_reader.readNextStartElement()) {
+        qDebug() << "Error: No root element found";
+        return false;
+    }
+
+    Store.SetRootElement(_reader.name().toString(), _reader.attributes());
+    qDebug() << "Root element:" << _reader.name();
+
+    // Read direct children of the root, keeping only table elements
+    while (_reader.readNextStartElement()) {
+        if (_reader.name() == TABLE_ELEMENT_NAME) {
+            QSharedPointer<TableData> _table = ParseTableStream(_reader, Store.GetStringPool());  // Completely parsed table
+            if (_reader.hasError()) {
+                break;
+            }
+
+            // Publish the table so it can be displayed while the rest of the file is read
+            Store.AddTable(_table);
+            if (Observer && !_table->GetName().isEmpty()) {
+                Observer->OnTableLoaded(_table->GetName());
+            }
+            ReportStreamProgress(_reader);
+        } else {
+            _reader.skipCurrentElement();
+        }
+    }
 
-        _rows[_i] = _rowData;  // Store row data with row index as key
+    if (Observer && Observer->IsLoadCancelled()) {
+        qDebug() << "Loading cancelled";
+        return false;
+    }
+
+    if (_reader.hasError()) {
+        qDebug() << "Error: XML parsing failed at line" << _reader.lineNumber()
+                 << "column" << _reader.columnNumber() << ":" << _reader.errorString();
+        return false;
+    }
+
+    if (Store.GetTables().isEmpty()) {
+        qDebug() << "Warning: No table elements found";
+    }
+
+    qDebug() << "Parsed XML stream, found tables:" << Store.GetTableNames();
+    return true;
+}
+
+/**
+ * @brief Read one table element from the stream into a TableData
+ * @param reader Stream reader positioned on the table start element
+ * @param stringPool Pool for dictionary encoded values (a private pool is created if null)
+ * @return Shared pointer to the parsed table
+ */
+QSharedPointer<TableData> XMLWorker::ParseTableStream(QXmlStreamReader &reader, const QSharedPointer<StringPool> &stringPool)
+{
+    QSharedPointer<TableData> _table(new TableData(reader.attributes().value("name").toString(), stringPool));  // Table being filled
+    bool _headersKnown = false;  // Flag indicating column headers were taken from the first row (true) or not yet (false)
+
+    while (reader.readNextStartElement()) {
+        if (reader.name() != ROW_ELEMENT_NAME) {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        QStringList _rowData;      // Cell values of the current row
+        QStringList _cellNames;    // Cell names of the current row (only collected for the first row)
+        TablePager::ReadStreamRow(reader, CELL_ELEMENT_NAME, &_rowData, _headersKnown ? nullptr : &_cellNames);
+
+        // First row defines the column structure, same as ExtractColumnHeaders
+        if (!_headersKnown) {
+            _table->SetColumnHeaders(_cellNames);
+            _headersKnown = true;
+        }
+
+        _table->AppendRow(_rowData);
+
+        if (_table->GetRowCount() % PROGRESS_ROW_INTERVAL == 0 && !ReportStreamProgress(reader)) {
+            break;
+        }
+    }
+
+    // Numbers, dates and flags are kept as native values from here on
+    _table->InferColumnTypes();
+    return _table;
+}
+
+/**
+ * @brief Report read progress and poll for cancellation
+ * @param reader Stream reader whose device position is reported
+ * @return true to continue, false if loading was cancelled
+ */
+bool XMLWorker::ReportStreamProgress(QXmlStreamReader &reader)
+{
+    if (!reader.device()) {
+        // Table ranges may be parsed on pool threads, which must not call the observer
+        if (ParallelLoadCancelled.loadRelaxed()) {
+            reader.raiseError("Loading cancelled");
+            return false;
+        }
+        return true;
+    }
+
+    if (!Observer) {
+        return true;
+    }
+
+    if (Observer->IsLoadCancelled()) {
+        reader.raiseError("Loading cancelled");
+        return false;
+    }
+
+    Observer->OnLoadProgress(reader.device()->pos(), reader.device()->size());
+    return true;
+}
+
+/**
+ * @brief Serialize the table store as XML
+ * @param device Opened output device
+ * @return true if all data was written, false otherwise
+ */
+bool XMLWorker::WriteTableStore(QIODevice *device)
+{
+    const QString _rootName = Store.GetRootName().isEmpty() ? ROOT_ELEMENT_NAME : Store.GetRootName();  // Tag of the root element
+    const QXmlStreamAttributes _rootAttributes = Store.GetRootAttributes();  // Attributes of the root element
+    const QList<QSharedPointer<TableData>> _tables = Store.GetTables();  // Tables in memory (unused in lazy mode)
+    const int _tableCount = LoadedMode == LazyLoadMode ? TableRanges.size() : _tables.size();  // Number of tables to write
+
+    if (TableCodec::CanWriteRoot(_rootAttributes)) {
+        // Fixed layout serialization, byte-identical to the stream writer below
+        if (!TableCodec::WriteRootStart(device, _rootName, _rootAttributes, _tableCount == 0)) {
+            return false;
+        }
+
+        for (int _i = 0; _i < _tableCount; ++_i) {  // Position of the table in the document
+            QSharedPointer<TableData> _table = LoadedMode == LazyLoadMode ? LazyTables.Peek(_i) : _tables.at(_i);  // Table to write
+            if (_table.isNull()) {
+                _table = ParseTableRange(_i);  // Never opened or evicted, released right after writing
+            }
+
+            if (_table.isNull() || !TableCodec::WriteTable(device, *_table, 1)) {
+                qDebug() << "Error: Cannot serialize table" << _i;
+                return false;
+            }
+        }
+
+        return _tableCount == 0 || TableCodec::WriteRootEnd(device, _rootName);
+    }
+
+    QXmlStreamWriter _writer(device);  // Sequential writer producing the XML text
+    _writer.setAutoFormatting(true);
+    _writer.setAutoFormattingIndent(4);  // Indent with 4 spaces, same as the DOM path
+
+    _writer.writeStartDocument();
+    _writer.writeStartElement(_rootName);
+    _writer.writeAttributes(_rootAttributes);
+
+    if (LoadedMode == LazyLoadMode) {
+        // Tables that were never opened are parsed one at a time and released right after writing
+        for (int _i = 0; _i < TableRanges.size(); ++_i) {  // Position of the table in the document
+            QSharedPointer<TableData> _table = LazyTables.Peek(_i);  // Cached table (null if never opened or evicted)
+            if (_table.isNull()) {
+                _table = ParseTableRange(_i);
+            }
+
+            if (_table.isNull()) {
+                return false;
+            }
+
+            WriteTable(_writer, *_table);
+        }
+    } else {
+        for (const QSharedPointer<TableData> &_table : _tables) {
+            WriteTable(_writer, *_table);
+        }
+    }
+
+    _writer.writeEndElement();
+    _writer.writeEndDocument();
+
+    return !_writer.hasError();
+}
+
+/**
+ * @brief Write the source bytes with every edited table replaced by its serialization
+ * Everything between edited tables (untouched tables, comments, whitespace) is
+ * copied in large blocks straight from the source mapping
+ * @param device Opened output device
+ * @return true if all data was written, false otherwise
+ */
+bool XMLWorker::WritePatchedSource(QIODevice *device)
+{
+    qint64 _copiedUpTo = 0;  // Source offset up to which the output is complete
+    int _patchedTables = 0;  // Number of re-serialized tables
+
+    for (int _i = 0; _i < TableRanges.size(); ++_i) {  // Position of the table in the document
+        if (!LazyTables.IsDirty(_i)) {
+            continue;  // Copied together with the bytes around it
+        }
+
+        const XMLScanner::ElementRange &_range = TableRanges.at(_i);  // Bytes replaced by the edited table
+        const qint64 _length = _range.Start - _copiedUpTo;  // Untouched bytes before the table
+        if (device->write(SourceData.constData() + _copiedUpTo, _length) != _length) {
+            return false;
+        }
+
+        if (!TableCodec::WriteTable(device, *LazyTables.Peek(_i), 0)) {
+            qDebug() << "Error: Cannot serialize table" << _range.Name;
+            return false;
+        }
+
+        _copiedUpTo = _range.End;
+        _patchedTables++;
+    }
+
+    const qint64 _length = SourceData.size() - _copiedUpTo;  // Untouched bytes after the last edited table
+    if (device->write(SourceData.constData() + _copiedUpTo, _length) != _length) {
+        return false;
+    }
+
+    qDebug() << "Patched" << _patchedTables << "of" << TableRanges.size() << "tables,"
+             << _length << "trailing bytes copied";
+    return true;
+}
+
+/**
+ * @brief Serialize the DOM document as XML
+ * @param device Opened output device
+ * @return true if all data was written, false otherwise
+ */
+bool XMLWorker::WriteDomDocument(QIODevice *device)
+{
+    QXmlStreamWriter _writer(device);  // Sequential writer producing the XML text
+    _writer.setAutoFormatting(true);
+    _writer.setAutoFormattingIndent(4);  // Indent with 4 spaces, same as toString(4)
+
+    _writer.writeStartDocument();
+    for (QDomNode _node = XmlDocument.firstChild(); !_node.isNull(); _node = _node.nextSibling()) {
+        WriteDomNode(_writer, _node);
+    }
+    _writer.writeEndDocument();
+
+    return !_writer.hasError();
+}
+
+/**
+ * @brief Serialize a DOM node and its children
+ * @param writer Writer positioned where the node belongs
+ * @param node Node to write
+ */
+void XMLWorker::WriteDomNode(QXmlStreamWriter &writer, const QDomNode &node)
+{
+    switch (node.nodeType()) {
+    case QDomNode::ElementNode: {
+        const QDomElement _element = node.toElement();  // Element being written
+        writer.writeStartElement(_element.tagName());
+
+        const QDomNamedNodeMap _attributes = _element.attributes();  // Attributes of the element
+        for (int _i = 0; _i < _attributes.length(); ++_i) {  // Current attribute index
+            const QDomAttr _attribute = _attributes.item(_i).toAttr();  // Current attribute
+            writer.writeAttribute(_attribute.name(), _attribute.value());
+        }
+
+        for (QDomNode _child = node.firstChild(); !_child.isNull(); _child = _child.nextSibling()) {
+            WriteDomNode(writer, _child);
+        }
+
+        writer.writeEndElement();
+        break;
+    }
+    case QDomNode::TextNode:
+        writer.writeCharacters(node.nodeValue());
+        break;
+    case QDomNode::CDATASectionNode:
+        writer.writeCDATA(node.nodeValue());
+        break;
+    case QDomNode::CommentNode:
+        writer.writeComment(node.nodeValue());
+        break;
+    case QDomNode::EntityReferenceNode:
+        writer.writeEntityReference(node.nodeName());
+        break;
+    case QDomNode::ProcessingInstructionNode: {
+        const QDomProcessingInstruction _instruction = node.toProcessingInstruction();  // Instruction being written
+        if (_instruction.target() != "xml") {  // The declaration comes from writeStartDocument
+            writer.writeProcessingInstruction(_instruction.target(), _instruction.data());
+        }
+        break;
+    }
+    case QDomNode::DocumentTypeNode: {
+        const QDomDocumentType _doctype = node.toDocumentType();  // Document type being written
+        QString _dtd = "<!DOCTYPE " + _doctype.name();  // Declaration text
+        if (!_doctype.publicId().isEmpty()) {
+            _dtd += QString(" PUBLIC \"%1\" \"%2\"").arg(_doctype.publicId(), _doctype.systemId());
+        } else if (!_doctype.systemId().isEmpty()) {
+            _dtd += QString(" SYSTEM \"%1\"").arg(_doctype.systemId());
+        }
+        if (!_doctype.internalSubset().isEmpty()) {
+            _dtd += " [" + _doctype.internalSubset() + "]";
+        }
+        writer.writeDTD(_dtd + ">");
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Serialize one table element with the general writer
+ * @param writer Writer positioned inside the root element
+ * @param table Table to write
+ */
+void XMLWorker::WriteTable(QXmlStreamWriter &writer, const TableData &table)
+{
+    const QStringList _columnHeaders = table.GetColumnHeaders();  // Column names written as cell attributes
+
+    writer.writeStartElement(TABLE_ELEMENT_NAME);
+    writer.writeAttribute("name", table.GetName());
+
+    for (int _row = 0; _row < table.GetRowCount(); ++_row) {  // Current row index (0-based)
+        writer.writeStartElement(ROW_ELEMENT_NAME);
+
+        for (int _col = 0; _col < _columnHeaders.size(); ++_col) {  // Current column index (0-based)
+            writer.writeStartElement(CELL_ELEMENT_NAME);
+            writer.writeAttribute("name", _columnHeaders.at(_col));
+            writer.writeCharacters(table.GetCell(_row, _col));
+            writer.writeEndElement();
+        }
+
+        writer.writeEndElement();
+    }
+
+    writer.writeEndElement();
+}
+
+/**
+ * @brief Map an opened file into memory, falling back to reading it
+ * @param file File opened for reading
+ * @return File content, sharing the mapped pages without a copy if mapping succeeded
+ */
+QByteArray XMLWorker::MapFileData(QFile &file)
+{
+    const qint64 _size = file.size();  // Number of bytes to map
+    uchar *_mappedData = _size > 0 ? file.map(0, _size) : nullptr;  // Start of the mapping (nullptr if not mapped)
+
+    if (_mappedData) {
+        return QByteArray::fromRawData(reinterpret_cast<const char *>(_mappedData), _size);
+    }
+
+    // Empty files and devices that cannot be mapped (pipes, some network shares)
+    qDebug() << "Warning: Cannot map file" << file.fileName() << ", reading it instead";
+    return file.readAll();
+}
+
+/**
+ * @brief Copy lazily parsed source bytes out of the file mapping
+ * Only needed where a mapped file cannot be replaced; elsewhere the saved file
+ * is a new inode and the mapping keeps showing the loaded content
+ */
+void XMLWorker::DetachSourceData()
+{
+    if (MappedFile.isNull()) {
+        return;
+    }
+
+    SourceData = QByteArray(SourceData.constData(), SourceData.size());
+    MappedFile.reset();
+}
+
+/**
+ * @brief Record the root element and the byte range of every table without parsing rows
+ * @return true if the document structure was scanned successfully, false otherwise
+ */
+bool XMLWorker::ScanTableRanges()
+{
+    XML_PROFILE_SCOPE("Scan tables");
+
+    XMLScanner _scanner(SourceData.constData(), SourceData.size());  // Tag boundary scanner over the raw bytes
+    if (!_scanner.Scan(TABLE_ELEMENT_NAME, ROW_ELEMENT_NAME)) {
+        qDebug() << "Error: XML scan failed:" << _scanner.GetErrorString();
+        return false;
+    }
+
+    // Root name and attributes come from the prolog and root start tag alone
+    QXmlStreamReader _reader(QByteArray::fromRawData(SourceData.constData(), _scanner.GetRootStartTagEnd()));  // Reader over the document head
+    if (!_reader.readNextStartElement()) {
+        qDebug() << "Error: No root element found";
+        return false;
+    }
+
+    Store.SetRootElement(_reader.name().toString(), _reader.attributes());
+    qDebug() << "Root element:" << _reader.name();
+
+    DeclarationLength = _scanner.GetDeclarationLength();
+    TableRanges = _scanner.GetTableRanges();
+
+    // QXmlStreamWriter only produces UTF-8, other encodings cannot take re-serialized tables verbatim
+    const QString _encoding = _reader.documentEncoding().toString();  // Declared encoding (empty if none)
+    SourceIsUtf8 = _encoding.isEmpty() || _encoding.compare("UTF-8", Qt::CaseInsensitive) == 0;
+
+    for (int _i = 0; _i < TableRanges.size(); ++_i) {  // Position of the table in the document
+        const QString &_tableName = TableRanges.at(_i).Name;  // Name of the table (empty if unnamed)
+        if (_tableName.isEmpty()) {
+            continue;  // Kept for saving but not listed, same as the streaming store
+        }
+
+        AvailableTableNames.append(_tableName);
+        if (!TableRangeIndex.contains(_tableName)) {
+            TableRangeIndex.insert(_tableName, _i);
+        }
+    }
+
+    if (TableRanges.isEmpty()) {
+        qDebug() << "Warning: No table elements found";
+    }
+
+    qDebug() << "Scanned XML structure, found tables:" << AvailableTableNames;
+    return true;
+}
+
+/**
+ * @brief Parse every recorded table range on the global thread pool and add the tables to the store
+ * @return true if all tables were parsed, false on XML error or cancel
+ */
+bool XMLWorker::ParseTableRangesParallel()
+{
+    XML_PROFILE_SCOPE("Parse tables");
+
+    const int _tableCount = TableRanges.size();  // Number of tables to parse
+    QVector<QFuture<QSharedPointer<TableData>>> _futures(_tableCount);  // Pending parse of each table in document order
+    QSemaphore _finishedParses;  // Released by every finished parse to wake up the loading thread
+
+    // Largest tables are queued first so the longest parse starts right away and the rest fill the other threads
+    QVector<int> _queueOrder(_tableCount);  // Positions of the tables in submission order
+    std::iota(_queueOrder.begin(), _queueOrder.end(), 0);
+    std::stable_sort(_queueOrder.begin(), _queueOrder.end(), [this](int left, int right) {
+        return TableRanges.at(left).End - TableRanges.at(left).Start > TableRanges.at(right).End - TableRanges.at(right).Start;
+    });
+
+    ParallelLoadCancelled.storeRelaxed(0);
+    for (int _rangeIndex : _queueOrder) {  // Position of the table being queued
+        _futures[_rangeIndex] = QtConcurrent::run([this, _rangeIndex, &_finishedParses]() {
+            QSharedPointer<TableData> _table;  // Parsed table (null if cancelled or on XML error)
+            if (!ParallelLoadCancelled.loadRelaxed()) {
+                _table = ParseTableRange(_rangeIndex);
+            }
+            _finishedParses.release();
+            return _table;
+        });
+    }
+
+    // Collect in document order; every future is waited for because the tasks read SourceData
+    bool _success = true;  // Flag indicating all tables so far were parsed (true) or the load failed (false)
+    for (int _i = 0; _i < _tableCount; ++_i) {  // Position of the table being collected
+        while (!_futures.at(_i).isFinished()) {
+            _finishedParses.tryAcquire(1, PARALLEL_POLL_INTERVAL_MS);
+            if (Observer && Observer->IsLoadCancelled()) {
+                ParallelLoadCancelled.storeRelaxed(1);
+            }
+        }
+
+        const QSharedPointer<TableData> _table = _futures.at(_i).result();  // Parsed table (null if cancelled or on XML error)
+        if (!_success || _table.isNull()) {
+            _success = false;
+            ParallelLoadCancelled.storeRelaxed(1);  // Remaining tables are useless once one failed
+            continue;
+        }
+
+        Store.AddTable(_table);
+        if (Observer) {
+            if (!_table->GetName().isEmpty()) {
+                Observer->OnTableLoaded(_table->GetName());
+            }
+            Observer->OnLoadProgress(TableRanges.at(_i).End, SourceData.size());
+        }
+    }
+
+    // Every task has finished, so the stop request must not reach later lazy parses of this worker
+    ParallelLoadCancelled.storeRelaxed(0);
+
+    if (Observer && Observer->IsLoadCancelled()) {
+        qDebug() << "Loading cancelled";
+        return false;
+    }
+
+    if (!_success) {
+        return false;
+    }
+
+    qDebug() << "Parsed" << _tableCount << "tables on" << QThreadPool::globalInstance()->maxThreadCount() << "threads";
+    return true;
+}
+
+/**
+ * @brief Parse a single table from its recorded byte range
+ * @param rangeIndex Position of the table in TableRanges
+ * @return Shared pointer to the parsed table, null on XML error
+ */
+QSharedPointer<TableData> XMLWorker::ParseTableRange(int rangeIndex)
+{
+    XML_PROFILE_SCOPE("Parse table");
+
+    const XMLScanner::ElementRange &_range = TableRanges.at(rangeIndex);  // Bytes of the requested table
+
+    // Tables in the fixed layout are read straight from the bytes; anything else goes through the stream reader
+    if (SourceIsUtf8) {
+        QSharedPointer<TableData> _table;  // Table read by the fast path
+        const TableCodec::ParseResult _result = TableCodec::ParseTable(SourceData.constData() + _range.Start, _range.End - _range.Start,
+                                                                       SharedPool, &ParallelLoadCancelled, &_table);  // Outcome of the fast path
+        if (_result == TableCodec::Parsed) {
+            XML_PROFILE_COUNT("Bytes parsed", _range.End - _range.Start);
+            qDebug() << "Parsed table" << _range.Name << "from bytes" << _range.Start << "to" << _range.End << "with the fixed layout parser";
+            return _table;
+        }
+        if (_result == TableCodec::Cancelled) {
+            qDebug() << "Error: XML parsing failed in table" << _range.Name << ": Loading cancelled";
+            return QSharedPointer<TableData>();
+        }
+        qDebug() << "Table" << _range.Name << "is not in the fixed layout, using the stream reader";
+    }
+
+    // The declaration keeps the document encoding; prefixes are declared on the root, outside the range
+    QXmlStreamReader _reader;  // Reader over the declaration and the table element
+    _reader.setNamespaceProcessing(false);
+    _reader.addData(QByteArray::fromRawData(SourceData.constData(), DeclarationLength));
+    _reader.addData(QByteArray::fromRawData(SourceData.constData() + _range.Start, _range.End - _range.Start));
+
+    if (!_reader.readNextStartElement()) {
+        qDebug() << "Error: Table range" << rangeIndex << "does not start with an element";
+        return QSharedPointer<TableData>();
+    }
+
+    // Without a shared pool, a private pool per table lets eviction release the table's strings as well
+    QSharedPointer<TableData> _table = ParseTableStream(_reader, SharedPool);  // Parsed table
+    if (_reader.hasError()) {
+        qDebug() << "Error: XML parsing failed in table" << _range.Name << ":" << _reader.errorString();
+        return QSharedPointer<TableData>();
+    }
+
+    XML_PROFILE_COUNT("Bytes parsed", _range.End - _range.Start);
+    qDebug() << "Parsed table" << _range.Name << "from bytes" << _range.Start << "to" << _range.End;
+    return _table;
+}
+
+/**
+ * @brief Create a pager over a table whose rows are not extracted yet
+ * @param tableName Name of the table
+ * @return Pager over the table, null if the table is already in memory or unknown
+ */
+QSharedPointer<TablePager> XMLWorker::CreateTablePager(const QString &tableName)
+{
+    if (!FileLoaded || tableName.isEmpty()) {
+        return QSharedPointer<TablePager>();
+    }
+
+    if (LoadedMode == DomLoadMode) {
+        const TableIndexEntry *_indexEntry = FindTableIndexEntry(tableName);  // Index entry of the table (nullptr if not found)
+        if (!_indexEntry) {
+            return QSharedPointer<TablePager>();
+        }
+
+        return QSharedPointer<TablePager>(new TablePager(tableName, _indexEntry->Element, _indexEntry->ColumnHeaders, _indexEntry->RowCount,
+                                                         ROW_ELEMENT_NAME, CELL_ELEMENT_NAME));
+    }
+
+    if (LoadedMode != LazyLoadMode) {
+        return QSharedPointer<TablePager>();  // Streamed and parallel tables are always complete in the store
+    }
+
+    auto _iterator = TableRangeIndex.constFind(tableName);  // Range entry of the table (end if not found)
+    if (_iterator == TableRangeIndex.constEnd() || !LazyTables.Peek(_iterator.value()).isNull()) {
+        return QSharedPointer<TablePager>();  // Cached tables are served as they are
+    }
+
+    // The pager shares the source bytes and their mapping, the row count comes from the pre-scan
+    const XMLScanner::ElementRange &_range = TableRanges.at(_iterator.value());  // Bytes of the table
+    return QSharedPointer<TablePager>(new TablePager(_range.Name, SourceData, DeclarationLength, _range.Start, _range.End, _range.RowCount,
+                                                     MappedFile, ROW_ELEMENT_NAME, CELL_ELEMENT_NAME));
+}
+
+/**
+ * @brief Get a table of the compact storage in any mode but DomLoadMode
+ * @param tableName Name of the table
+ * @param markDirty Pin the table in the lazy cache because the caller is about to modify it
+ * @return Shared pointer to the table, null if not found
+ */
+QSharedPointer<TableData> XMLWorker::FindStoredTable(const QString &tableName, bool markDirty)
+{
+    if (LoadedMode != LazyLoadMode) {
+        return Store.FindTable(tableName);
+    }
+
+    auto _iterator = TableRangeIndex.constFind(tableName);  // Range entry of the table (end if not found)
+    if (_iterator == TableRangeIndex.constEnd()) {
+        return QSharedPointer<TableData>();
+    }
+
+    const int _rangeIndex = _iterator.value();  // Position of the table in the document
+    QSharedPointer<TableData> _table = LazyTables.Find(_rangeIndex);  // Cached table (null on first use or after eviction)
+    if (_table.isNull()) {
+        _table = ParseTableRange(_rangeIndex);
+        if (_table.isNull()) {
+            return _table;
+        }
+        LazyTables.Insert(_rangeIndex, _table);
+    }
+
+    if (markDirty) {
+        LazyTables.MarkDirty(_rangeIndex);
+    }
+
+    return _table;
+}
+
+/**
+ * @brief Find table element by name in current XML document
+ */
+QDomElement XMLWorker::FindTableElement(const QString &tableName)
+{
+    TableIndexEntry *indexEntry = FindTableIndexEntry(tableName);
+    return indexEntry ? indexEntry->Element : QDomElement();  // Return null element if not found
+}
+
+/**
+ * @brief Find index entry of a table in current XML document
+ */
+XMLWorker::TableIndexEntry *XMLWorker::FindTableIndexEntry(const QString &tableName)
+{
+    auto iterator = TableIndex.find(tableName);
+    return iterator != TableIndex.end() ? &iterator.value() : nullptr;
+}
+
+/**
+ * @brief Extract column headers from table element structure
+ */
+QStringList XMLWorker::ExtractColumnHeaders(const QDomElement &tableElement)
+{
+    QStringList headers;
+
+    // First direct row child determines column structure
+    QDomElement firstRow = tableElement.firstChildElement(ROW_ELEMENT_NAME);
+    if (!firstRow.isNull()) {
+        // Extract column names from cell attributes of the row's direct children
+        int i = 0;
+        for (QDomElement cellElement = firstRow.firstChildElement(CELL_ELEMENT_NAME); !cellElement.isNull();
+             cellElement = cellElement.nextSiblingElement(CELL_ELEMENT_NAME), ++i) {
+            QString columnName = cellElement.attribute("name");
+            headers.append(columnName.isEmpty() ? QString("Column_%1").arg(i + 1) : columnName);
+        }
+    }
+
+    return headers;
+}
+
+/**
+ * @brief Extract all row data from table element
+ * Walks only direct row and cell children, so nested elements are never visited
+ * @param tableElement DOM element representing the table
+ * @return QMap<int, QStringList> containing all row data, with row index as key
+ */
+QMap<int, QStringList> XMLWorker::ExtractTableRows(const QDomElement &tableElement)
+{
+    QMap<int, QStringList> _rows;  // Map of row index to row data (row index as key, row data as value)
+
+    int _i = 0;  // Row index (0-based)
+    for (QDomElement _rowElement = tableElement.firstChildElement(ROW_ELEMENT_NAME); !_rowElement.isNull();
+         _rowElement = _rowElement.nextSiblingElement(ROW_ELEMENT_NAME), ++_i) {
+        // Cell text is read in a single sibling walk, same as the paged reads of the table
+        _rows.insert(_rows.cend(), _i, TablePager::ReadDomRow(_rowElement, CELL_ELEMENT_NAME));  // Keys arrive in ascending order, append at the end
     }
 
     return _rows;  // Return map of all rows
@@ -408,22 +1692,78 @@ QMap<int, QStringList> XMLWorker::ExtractTableRows(const QDomElement &tableEleme
  */
 QDomElement XMLWorker::CreateRowElement(const QStringList &rowData, const QStringList &columnHeaders)
 {
-    QDomElement rowElement = XmlDocument.createElement(ROW_ELEMENT_NAME);
+    return CreateRowElement(rowData, CreateRowTemplate(columnHeaders));
+}
+
+/**
+ * @brief Create an empty row element that is cloned for every new row of a table
+ */
+QDomElement XMLWorker::CreateRowTemplate(const QStringList &columnHeaders)
+{
+    QDomElement _rowTemplate = XmlDocument.createElement(ROW_ELEMENT_NAME);  // Row with empty cells
 
-    // Create cell elements for each column
-    for (int i = 0; i < columnHeaders.size(); ++i) {
-        QDomElement cellElement = XmlDocument.createElement(CELL_ELEMENT_NAME);
-        cellElement.setAttribute("name", columnHeaders[i]);
+    for (const QString &_columnName : columnHeaders) {  // Name of the column the cell belongs to
+        QDomElement _cellElement = XmlDocument.createElement(CELL_ELEMENT_NAME);  // Named cell with an empty text node
+        _cellElement.setAttribute("name", _columnName);
+        _cellElement.appendChild(XmlDocument.createTextNode(QString()));
+        _rowTemplate.appendChild(_cellElement);
+    }
+
+    return _rowTemplate;
+}
+
+/**
+ * @brief Create new row element by cloning a row template
+ * Cloning copies the prepared cell structure in one pass; attribute names and
+ * column names are shared with the template instead of being set cell by cell
+ */
+QDomElement XMLWorker::CreateRowElement(const QStringList &rowData, const QDomElement &rowTemplate)
+{
+    QDomElement _rowElement = rowTemplate.cloneNode(true).toElement();  // New row with the template's cells
+
+    int _col = 0;  // Column of the current cell (0-based)
+    for (QDomNode _cellNode = _rowElement.firstChild(); !_cellNode.isNull() && _col < rowData.size();
+         _cellNode = _cellNode.nextSibling(), ++_col) {  // Cell element of the new row
+        if (!rowData.at(_col).isEmpty()) {
+            _cellNode.firstChild().setNodeValue(rowData.at(_col));
+        }
+    }
+
+    return _rowElement;
+}
 
-        // Set cell text content, use empty string if data not available
-        QString cellValue = (i < rowData.size()) ? rowData[i] : "";
-        QDomText cellText = XmlDocument.createTextNode(cellValue);
-        cellElement.appendChild(cellText);
+/**
+ * @brief Get row elements of a table, building the cached list on first use
+ */
+QVector<QDomElement> &XMLWorker::GetRowElements(TableIndexEntry &indexEntry)
+{
+    if (indexEntry.RowElementsCached) {
+        return indexEntry.RowElements;
+    }
+
+    indexEntry.RowElements.clear();
+    indexEntry.RowElements.reserve(indexEntry.RowCount);
+
+    for (QDomElement _rowElement = indexEntry.Element.firstChildElement(ROW_ELEMENT_NAME); !_rowElement.isNull();
+         _rowElement = _rowElement.nextSiblingElement(ROW_ELEMENT_NAME)) {
+        indexEntry.RowElements.append(_rowElement);
+    }
+
+    indexEntry.RowElementsCached = true;
+    return indexEntry.RowElements;
+}
 
-        rowElement.appendChild(cellElement);
+/**
+ * @brief Replace text content of a cell element
+ */
+void XMLWorker::SetCellElementText(QDomElement &cellElement, const QString &value)
+{
+    // Drop existing content, then add a single text node
+    while (cellElement.hasChildNodes()) {
+        cellElement.removeChild(cellElement.firstChild());
     }
 
-    return rowElement;
+    cellElement.appendChild(XmlDocument.createTextNode(value));
 }
 
 /**
@@ -7,11 +7,61 @@
 #include <QDomElement>
 #include <QDomNode>
 #include <QFile>
-#include <QTextStream>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QBuffer>
+#include <QScopedPointer>
+#include <QSaveFile>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include <QDebug>
+#include <QAtomicInt>
+#include <QFuture>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include "tablestore.h"
+#include "tablecache.h"
+#include "tablecodec.h"
+#include "tablepager.h"
+#include "xmlscanner.h"
+#include "xmltablemodel.h"
+#include "changejournal.h"
+#include "xmlprofiler.h"
+#include "sidecarcache.h"
+
+/**
+ * @brief Receiver of progress notifications while XMLWorker loads a file
+ * Callbacks run on the thread that called LoadXMLFile
+ */
+class XMLLoadObserver
+{
+public:
+    /**
+     * @brief Destructor for XMLLoadObserver
+     */
+    virtual ~XMLLoadObserver() = default;
+
+    /**
+     * @brief Called periodically while the file is read
+     * @param bytesRead Number of bytes consumed so far
+     * @param totalBytes Size of the file in bytes
+     */
+    virtual void OnLoadProgress(qint64 bytesRead, qint64 totalBytes) = 0;
+
+    /**
+     * @brief Called once a table is completely parsed and can be displayed
+     * @param tableName Name of the parsed table
+     */
+    virtual void OnTableLoaded(const QString &tableName) = 0;
+
+    /**
+     * @brief Polled while loading to abort the parse early
+     * @return true if loading should stop, false to continue
+     */
+    virtual bool IsLoadCancelled() const = 0;
+};
 
 /**
  * @brief Worker class for XML file operations
@@ -20,6 +70,16 @@
 class XMLWorker
 {
 public:
+    /**
+     * @brief Strategy used by LoadXMLFile to read the document
+     */
+    enum LoadMode {
+        DomLoadMode,           // Build a complete QDomDocument (original behaviour)
+        StreamingLoadMode,     // Read with QXmlStreamReader into the compact TableStore
+        LazyLoadMode,          // Record table byte ranges only, parse each table when first requested
+        ParallelLoadMode       // Record table byte ranges, then parse all tables concurrently into the TableStore
+    };
+
     /**
      * @brief Constructor for XMLWorker
      */
@@ -33,9 +93,53 @@ public:
     /**
      * @brief Load XML file and parse its structure
      * @param filePath Path to the XML file to load
-     * @return true if file loaded successfully, false otherwise
+     * @param observer Optional receiver of progress notifications and cancellation requests
+     * @return true if file loaded successfully, false otherwise (also when cancelled)
+     */
+    bool LoadXMLFile(const QString &filePath, XMLLoadObserver *observer = nullptr);
+
+    /**
+     * @brief Check if a table can already be displayed while a streaming load is still running
+     * @param tableName Name of the table
+     * @return true if the table is completely parsed, false otherwise
+     */
+    bool IsTableAvailable(const QString &tableName) const;
+
+    /**
+     * @brief Select how the next LoadXMLFile call reads the document
+     * @param mode DomLoadMode, StreamingLoadMode, LazyLoadMode or ParallelLoadMode
+     */
+    void SetLoadMode(LoadMode mode);
+
+    /**
+     * @brief Get the currently selected load mode
+     * @return LoadMode used by LoadXMLFile
+     */
+    LoadMode GetLoadMode() const;
+
+    /**
+     * @brief Enable the binary sidecar cache of StreamingLoadMode and ParallelLoadMode
+     * While enabled, loads read an up-to-date sidecar instead of parsing the file, and
+     * successful parses and saves write the sidecar next to the XML file
+     * @param enabled true to read and write sidecars, false to always parse (default)
      */
-    bool LoadXMLFile(const QString &filePath);
+    void SetSidecarCacheEnabled(bool enabled);
+
+    /**
+     * @brief Check if the binary sidecar cache is used
+     * @return true if sidecars are read and written, false otherwise
+     */
+    bool IsSidecarCacheEnabled() const;
+
+    /**
+     * @brief Share one string pool with other workers
+     * Stored tables and tables parsed in LazyLoadMode intern their dictionary values and
+     * column names into the pool, so values repeated across files are kept once. The pool
+     * only grows, so evicted lazy tables no longer release their strings. Must be set
+     * before LoadXMLFile
+     * @param stringPool Pool shared with other workers (null for private pools, the default)
+     */
+    void SetStringPool(const QSharedPointer<StringPool> &stringPool);
 
     /**
      * @brief Get list of available table names from loaded XML
@@ -44,12 +148,40 @@ public:
     QStringList GetTableNames() const;
 
     /**
-     * @brief Load specific table data into QTableWidget
+     * @brief Load specific table data into a table model
+     * Tables that are not in memory yet (DomLoadMode, unopened tables in LazyLoadMode)
+     * are handed to the model as a TablePager, so only the rows the view shows are extracted
      * @param tableName Name of the table to load
-     * @param tableWidget Target QTableWidget to populate
+     * @param tableModel Target model that will serve the table to its views
      * @return true if table loaded successfully, false otherwise
      */
-    bool LoadTableData(const QString &tableName, QTableWidget *tableWidget);
+    bool LoadTableData(const QString &tableName, XMLTableModel *tableModel);
+
+    /**
+     * @brief Get column names and row count of a table without extracting its rows
+     * Both come from the table index in DomLoadMode and from the pre-scan in LazyLoadMode,
+     * where the column names of an unopened table cost reading its first row
+     * @param tableName Name of the table
+     * @param columnHeaders Receives the column names
+     * @param rowCount Receives the number of rows
+     * @return true if the table was found, false otherwise
+     */
+    bool GetTableMetadata(const QString &tableName, QStringList *columnHeaders, int *rowCount);
+
+    /**
+     * @brief Keep a table a model has read completely through a TablePager, so it is not parsed again
+     * Only has an effect in LazyLoadMode for a table that is not cached yet
+     * @param tableData Complete, unmodified table as read by the pager
+     */
+    void CacheFetchedTable(const TableData &tableData);
+
+    /**
+     * @brief Copy a table into plain row/column storage, for use without a model or GUI
+     * @param tableName Name of the table to read
+     * @param tableData Target receiving headers and rows
+     * @return true if table was found, false otherwise
+     */
+    bool GetTable(const QString &tableName, TableData *tableData);
 
     /**
      * @brief Add new row to specified table
@@ -59,6 +191,14 @@ public:
      */
     bool AddRowToTable(const QString &tableName, const QStringList &rowData);
 
+    /**
+     * @brief Append a block of rows to a table, resolving the table once
+     * @param tableName Name of the table to modify
+     * @param rows Cell values of each new row, appended in order
+     * @return true if rows added successfully, false otherwise
+     */
+    bool AddRowsToTable(const QString &tableName, const QList<QStringList> &rows);
+
     /**
      * @brief Delete specific row from table
      * @param tableName Name of the table to modify
@@ -67,19 +207,61 @@ public:
      */
     bool DeleteRowFromTable(const QString &tableName, int rowIndex);
 
+    /**
+     * @brief Delete a set of rows from a table in a single pass
+     * @param tableName Name of the table to modify
+     * @param rowIndices Indices of the rows to delete (0-based, any order, duplicates ignored)
+     * @return true if rows deleted successfully, false otherwise (nothing is deleted if an index is out of range)
+     */
+    bool DeleteRowsFromTable(const QString &tableName, const QList<int> &rowIndices);
+
+    /**
+     * @brief Set the text of many cells of a table, resolving the table once
+     * @param tableName Name of the table to modify
+     * @param cellEdits Row, column and new text of every cell
+     * @return true if all cells were updated, false otherwise (nothing is changed if a row is out of range)
+     */
+    bool UpdateCells(const QString &tableName, const QList<ChangeJournal::CellEdit> &cellEdits);
+
     /**
      * @brief Update entire table with new data
      * @param tableName Name of the table to replace
-     * @param tableWidget Source QTableWidget containing new data
+     * @param tableModel Source model containing new data (rows it has not fetched yet are read first)
      * @return true if table updated successfully, false otherwise
      */
-    bool UpdateCompleteTable(const QString &tableName, QTableWidget *tableWidget);
+    bool UpdateCompleteTable(const QString &tableName, XMLTableModel *tableModel);
+
+    /**
+     * @brief Replace entire table with plain row/column data
+     * @param tableName Name of the table to replace
+     * @param tableData New headers and rows of the table
+     * @return true if table updated successfully, false otherwise
+     */
+    bool ReplaceTable(const QString &tableName, const TableData &tableData);
+
+    /**
+     * @brief Apply only the recorded changes to a table
+     * @param tableName Name of the table to modify
+     * @param journal Pending cell edits, inserted rows and deleted rows
+     * @return true if all changes were applied successfully, false otherwise
+     */
+    bool ApplyTableChanges(const QString &tableName, const ChangeJournal &journal);
+
+    /**
+     * @brief Save all changes back to the XML file, replacing it atomically
+     * @param filePath Target file (empty to overwrite the loaded file)
+     * @return true if file saved successfully, false otherwise (the previous file is kept)
+     */
+    bool SaveXMLFile(const QString &filePath = QString());
 
     /**
-     * @brief Save all changes back to the XML file
-     * @return true if file saved successfully, false otherwise
+     * @brief Create an independent worker holding the current content, for saving on another thread
+     * Stored tables are copied implicitly shared, so the copy is cheap and later edits
+     * to this worker detach from it; a DOM document has to be cloned completely.
+     * Only saving is supported on the snapshot
+     * @return New worker owned by the caller, nullptr if no file is loaded
      */
-    bool SaveXMLFile();
+    XMLWorker *CreateSaveSnapshot();
 
     /**
      * @brief Get current loaded file path
@@ -99,6 +281,134 @@ private:
      */
     void ParseXMLStructure();
 
+    /**
+     * @brief Read XML file sequentially into the table store
+     * @param device Opened device with the file content
+     * @return true if the document was parsed successfully, false otherwise
+     */
+    bool ParseXMLStream(QIODevice &device);
+
+    /**
+     * @brief Map an opened file into memory, falling back to reading it
+     * @param file File opened for reading
+     * @return File content, sharing the mapped pages without a copy if mapping succeeded
+     */
+    QByteArray MapFileData(QFile &file);
+
+    /**
+     * @brief Copy lazily parsed source bytes out of the file mapping before the file is replaced
+     */
+    void DetachSourceData();
+
+    /**
+     * @brief Replace all rows of a table with rows produced by a callable
+     * @param tableName Name of the table to update
+     * @param columnHeaders Column names of the new rows
+     * @param rowCount Number of new rows
+     * @param rowSource Callable returning the cell values of a row index as QStringList
+     * @return true if table updated successfully, false otherwise
+     */
+    template <typename RowSource>
+    bool ReplaceTableRows(const QString &tableName, const QStringList &columnHeaders, int rowCount, RowSource rowSource);
+
+    /**
+     * @brief Report read progress and poll for cancellation
+     * @param reader Stream reader whose device position is reported
+     * @return true to continue, false if loading was cancelled (an error is raised on the reader)
+     */
+    bool ReportStreamProgress(QXmlStreamReader &reader);
+
+    /**
+     * @brief Read one table element from the stream into a TableData
+     * @param reader Stream reader positioned on the table start element
+     * @param stringPool Pool for dictionary encoded values (a private pool is created if null)
+     * @return Shared pointer to the parsed table
+     */
+    QSharedPointer<TableData> ParseTableStream(QXmlStreamReader &reader, const QSharedPointer<StringPool> &stringPool);
+
+    /**
+     * @brief Record the root element and the byte range of every table without parsing rows
+     * @return true if the document structure was scanned successfully, false otherwise
+     */
+    bool ScanTableRanges();
+
+    /**
+     * @brief Parse every recorded table range on the global thread pool and add the tables to the store
+     * Tables are published in document order as soon as they and all tables before them are parsed
+     * @return true if all tables were parsed, false on XML error or cancel
+     */
+    bool ParseTableRangesParallel();
+
+    /**
+     * @brief Parse a single table from its recorded byte range
+     * UTF-8 tables in the fixed table/row/cell layout are read by TableCodec, others by QXmlStreamReader
+     * @param rangeIndex Position of the table in TableRanges
+     * @return Shared pointer to the parsed table, null on XML error
+     */
+    QSharedPointer<TableData> ParseTableRange(int rangeIndex);
+
+    /**
+     * @brief Create a pager over a table whose rows are not extracted yet
+     * @param tableName Name of the table
+     * @return Pager over the table, null if the table is already in memory or unknown
+     */
+    QSharedPointer<TablePager> CreateTablePager(const QString &tableName);
+
+    /**
+     * @brief Get a table of the compact storage in any mode but DomLoadMode
+     * @param tableName Name of the table
+     * @param markDirty Pin the table in the lazy cache because the caller is about to modify it
+     * @return Shared pointer to the table, null if not found
+     */
+    QSharedPointer<TableData> FindStoredTable(const QString &tableName, bool markDirty);
+
+    /**
+     * @brief Write the source bytes with every edited table replaced by its serialization
+     * @param device Opened output device
+     * @return true if all data was written, false otherwise
+     */
+    bool WritePatchedSource(QIODevice *device);
+
+    /**
+     * @brief Serialize the DOM document as XML
+     * @param device Opened output device
+     * @return true if all data was written, false otherwise
+     */
+    bool WriteDomDocument(QIODevice *device);
+
+    /**
+     * @brief Serialize a DOM node and its children
+     * @param writer Writer positioned where the node belongs
+     * @param node Node to write
+     */
+    void WriteDomNode(QXmlStreamWriter &writer, const QDomNode &node);
+
+    /**
+     * @brief Serialize one table element with the general writer
+     * @param writer Writer positioned inside the root element
+     * @param table Table to write
+     */
+    void WriteTable(QXmlStreamWriter &writer, const TableData &table);
+
+    /**
+     * @brief Serialize the table store as XML
+     * Uses the byte templates of TableCodec unless root attributes need namespace declarations
+     * @param device Opened output device
+     * @return true if all data was written, false otherwise
+     */
+    bool WriteTableStore(QIODevice *device);
+
+    /**
+     * @brief Index entry describing one table of the DOM document
+     */
+    struct TableIndexEntry {
+        QDomElement Element;                 // Table element in the DOM document
+        int RowCount;                        // Number of row elements in the table
+        QStringList ColumnHeaders;           // Column names taken from the first row (empty if table has no rows)
+        QVector<QDomElement> RowElements;    // Row elements in document order (only valid if RowElementsCached is true)
+        bool RowElementsCached;              // Flag indicating RowElements is up to date (true) or must be rebuilt (false)
+    };
+
     /**
      * @brief Find table element by name in DOM document
      * @param tableName Name of the table to find
@@ -106,6 +416,13 @@ private:
      */
     QDomElement FindTableElement(const QString &tableName);
 
+    /**
+     * @brief Find index entry of a table in DOM document
+     * @param tableName Name of the table to find
+     * @return Pointer to the index entry, nullptr if not found
+     */
+    TableIndexEntry *FindTableIndexEntry(const QString &tableName);
+
     /**
      * @brief Extract column headers from table element
      * @param tableElement DOM element representing the table
@@ -128,6 +445,35 @@ private:
      */
     QDomElement CreateRowElement(const QStringList &rowData, const QStringList &columnHeaders);
 
+    /**
+     * @brief Create an empty row element that is cloned for every new row of a table
+     * @param columnHeaders QStringList containing column names
+     * @return QDomElement holding one named cell with an empty text node per column
+     */
+    QDomElement CreateRowTemplate(const QStringList &columnHeaders);
+
+    /**
+     * @brief Create new row element by cloning a row template
+     * @param rowData QStringList containing cell values
+     * @param rowTemplate Row returned by CreateRowTemplate
+     * @return QDomElement representing the new row
+     */
+    QDomElement CreateRowElement(const QStringList &rowData, const QDomElement &rowTemplate);
+
+    /**
+     * @brief Get row elements of a table, building the cached list on first use
+     * @param indexEntry Index entry of the table
+     * @return Reference to the cached row elements in document order
+     */
+    QVector<QDomElement> &GetRowElements(TableIndexEntry &indexEntry);
+
+    /**
+     * @brief Replace text content of a cell element
+     * @param cellElement Cell element to modify
+     * @param value New cell text
+     */
+    void SetCellElementText(QDomElement &cellElement, const QString &value);
+
     /**
      * @brief Validate XML file structure
      * @return true if structure is valid, false otherwise
@@ -139,12 +485,31 @@ private:
     QDomDocument XmlDocument;            // DOM representation of XML file (empty if no file loaded)
     QStringList AvailableTableNames;     // List of table names in current file (empty if no tables found)
     bool FileLoaded;                     // Flag indicating if file is loaded (true) or not loaded (false)
+    LoadMode Mode;                       // Load strategy for the next LoadXMLFile call (DomLoadMode by default)
+    LoadMode LoadedMode;                 // Load strategy used for the currently loaded file
+    bool SidecarCacheEnabled;            // Flag indicating sidecars are read and written (true) or ignored (false)
+    QSharedPointer<StringPool> SharedPool;  // Pool shared with other workers (null for a private pool per load and per lazy table)
+    TableStore Store;                    // Compact table storage filled in StreamingLoadMode and ParallelLoadMode (empty in DomLoadMode)
+    XMLLoadObserver *Observer;           // Receiver of progress for the running load (nullptr if none)
+    QAtomicInt StreamingLoadRunning;     // Non-zero while a streaming or parallel load is publishing tables (read from other threads)
+    QAtomicInt ParallelLoadCancelled;    // Non-zero once pool threads parsing table ranges should stop
+    QHash<QString, TableIndexEntry> TableIndex;  // Table name to DOM table information, built once per load in DomLoadMode
+    QByteArray SourceData;               // Raw file content the table ranges point into, usually mapped (LazyLoadMode, or while a ParallelLoadMode load runs)
+    QSharedPointer<QFile> MappedFile;    // Keeps the mapping behind SourceData alive, shared with save snapshots (null if SourceData is not mapped)
+    qint64 DeclarationLength;            // Length of the XML declaration at the start of SourceData (0 if none)
+    bool SourceIsUtf8;                   // Flag indicating SourceData is UTF-8 (true) so edited tables can be spliced in, or not (false)
+    QVector<XMLScanner::ElementRange> TableRanges;  // Byte ranges of all tables in document order (LazyLoadMode, or while a ParallelLoadMode load runs)
+    QHash<QString, int> TableRangeIndex; // Table name to position in TableRanges (first table wins on duplicates)
+    TableCache LazyTables;               // Recently used and edited tables parsed from TableRanges
 
     // XML structure constants
     static const QString ROOT_ELEMENT_NAME;     // Expected root element name
     static const QString TABLE_ELEMENT_NAME;    // Expected table element name
     static const QString ROW_ELEMENT_NAME;      // Expected row element name
     static const QString CELL_ELEMENT_NAME;     // Expected cell element name
+    static const int PROGRESS_ROW_INTERVAL;     // Rows parsed between two progress reports
+    static const int LAZY_TABLE_CACHE_CAPACITY; // Unedited tables kept parsed in LazyLoadMode
+    static const int PARALLEL_POLL_INTERVAL_MS; // Longest wait for a parallel table parse before polling for cancellation
 };
 
 #endif // XMLWORKER_H
@@ -0,0 +1,159 @@
+#include "xmlworkspace.h"
+#include <QFileInfo>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
+
+/**
+ * @brief Constructor initializes an empty workspace with a fresh pool
+ */
+XMLWorkspace::XMLWorkspace()
+    : Workers()                        // No open files
+    , FilePaths()                      // No open files
+    , Pool(new StringPool())           // Pool shared by all files
+    , Mode(XMLWorker::StreamingLoadMode)  // Whole files, compared tables are read completely anyway
+    , SidecarCacheEnabled(false)       // Always parse unless enabled
+    , FilePool()                       // One thread per core by default
+{
+}
+
+/**
+ * @brief Destructor waits for running file loads
+ */
+XMLWorkspace::~XMLWorkspace()
+{
+    FilePool.waitForDone();
+}
+
+/**
+ * @brief Select how files opened from now on are read
+ */
+void XMLWorkspace::SetLoadMode(XMLWorker::LoadMode mode)
+{
+    Mode = mode;
+}
+
+/**
+ * @brief Enable the binary sidecar cache for files opened from now on
+ */
+void XMLWorkspace::SetSidecarCacheEnabled(bool enabled)
+{
+    SidecarCacheEnabled = enabled;
+}
+
+/**
+ * @brief Load several files concurrently and add them to the workspace, blocking until all are done
+ */
+bool XMLWorkspace::OpenFiles(const QStringList &filePaths)
+{
+    XML_PROFILE_SCOPE("Open workspace files");
+
+    QStringList _newPaths;                        // Absolute paths of the files being loaded
+    QList<QSharedPointer<XMLWorker>> _newWorkers; // Worker of each file being loaded
+    QList<QFuture<bool>> _loads;                  // Running load of each file
+
+    for (const QString &_filePath : filePaths) {  // Requested file
+        const QString _fileKey = GetFileKey(_filePath);  // Absolute path of the file
+        if (FilePaths.contains(_fileKey) || _newPaths.contains(_fileKey)) {
+            continue;
+        }
+
+        QSharedPointer<XMLWorker> _worker(new XMLWorker());  // Worker holding the file
+        _worker->SetLoadMode(Mode);
+        _worker->SetSidecarCacheEnabled(SidecarCacheEnabled);
+        _worker->SetStringPool(Pool);
+
+        XMLWorker *_loadingWorker = _worker.data();  // Worker used by the pool thread (kept alive by _newWorkers)
+        _loads.append(QtConcurrent::run(&FilePool, [_loadingWorker, _fileKey]() {
+            return _loadingWorker->LoadXMLFile(_fileKey);
+        }));
+        _newPaths.append(_fileKey);
+        _newWorkers.append(_worker);
+    }
+
+    // Files are added in the requested order, whichever finished first
+    bool _allOpened = true;  // Flag indicating every new file was loaded (true) or not (false)
+    for (int _i = 0; _i < _loads.size(); ++_i) {  // Position of the file among the new files
+        if (!_loads[_i].result()) {
+            qDebug() << "Error: Cannot open" << _newPaths.at(_i) << "in the workspace";
+            _allOpened = false;
+            continue;
+        }
+
+        Workers.append(_newWorkers.at(_i));
+        FilePaths.append(_newPaths.at(_i));
+    }
+
+    qDebug() << "Workspace holds" << Workers.size() << "files sharing" << Pool->GetSize() << "pooled strings";
+    return _allOpened;
+}
+
+/**
+ * @brief Remove a file from the workspace
+ */
+void XMLWorkspace::CloseFile(int index)
+{
+    if (index < 0 || index >= Workers.size()) {
+        return;
+    }
+
+    Workers.removeAt(index);
+    FilePaths.removeAt(index);
+}
+
+/**
+ * @brief Remove all files and release the shared pool
+ */
+void XMLWorkspace::Clear()
+{
+    Workers.clear();
+    FilePaths.clear();
+    Pool.reset(new StringPool());
+}
+
+/**
+ * @brief Get number of open files
+ */
+int XMLWorkspace::GetFileCount() const
+{
+    return Workers.size();
+}
+
+/**
+ * @brief Find an open file by path
+ */
+int XMLWorkspace::FindFile(const QString &filePath) const
+{
+    return FilePaths.indexOf(GetFileKey(filePath));
+}
+
+/**
+ * @brief Get paths of all open files in the order they were opened
+ */
+QStringList XMLWorkspace::GetFilePaths() const
+{
+    return FilePaths;
+}
+
+/**
+ * @brief Get the worker holding an open file
+ */
+XMLWorker *XMLWorkspace::GetWorker(int index) const
+{
+    return index >= 0 && index < Workers.size() ? Workers.at(index).data() : nullptr;
+}
+
+/**
+ * @brief Get the pool shared by all files of the workspace
+ */
+QSharedPointer<StringPool> XMLWorkspace::GetStringPool() const
+{
+    return Pool;
+}
+
+/**
+ * @brief Get the absolute path a file is identified by
+ */
+QString XMLWorkspace::GetFileKey(const QString &filePath)
+{
+    return QFileInfo(filePath).absoluteFilePath();
+}
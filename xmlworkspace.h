@@ -0,0 +1,111 @@
+#ifndef XMLWORKSPACE_H
+#define XMLWORKSPACE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include "stringpool.h"
+#include "xmlworker.h"
+
+/**
+ * @brief Set of XML files open side by side, each held by its own XMLWorker
+ * Files are loaded concurrently on a thread pool of the workspace, separate from
+ * the global pool that ParallelLoadMode and the table algorithms use, so a file
+ * load never waits for pool threads another file load is blocking. All workers
+ * intern their values into one shared StringPool, so column names and category
+ * values repeated across files are stored once
+ */
+class XMLWorkspace
+{
+public:
+    /**
+     * @brief Constructor for an empty workspace
+     */
+    XMLWorkspace();
+
+    /**
+     * @brief Destructor waits for running file loads
+     */
+    ~XMLWorkspace();
+
+    /**
+     * @brief Select how files opened from now on are read
+     * @param mode Load mode passed to every new worker (StreamingLoadMode by default)
+     */
+    void SetLoadMode(XMLWorker::LoadMode mode);
+
+    /**
+     * @brief Enable the binary sidecar cache for files opened from now on
+     * @param enabled true to read and write sidecars, false to always parse (default)
+     */
+    void SetSidecarCacheEnabled(bool enabled);
+
+    /**
+     * @brief Load several files concurrently and add them to the workspace, blocking until all are done
+     * Files that are already open are kept as they are; files that fail to load are not added
+     * @param filePaths Paths of the XML files to open
+     * @return true if every file is open afterwards, false if at least one failed to load
+     */
+    bool OpenFiles(const QStringList &filePaths);
+
+    /**
+     * @brief Remove a file from the workspace
+     * The strings it added stay in the shared pool until the workspace is cleared
+     * @param index Position of the file (0-based)
+     */
+    void CloseFile(int index);
+
+    /**
+     * @brief Remove all files and release the shared pool
+     */
+    void Clear();
+
+    /**
+     * @brief Get number of open files
+     * @return File count (0 if the workspace is empty)
+     */
+    int GetFileCount() const;
+
+    /**
+     * @brief Find an open file by path
+     * @param filePath Path of the file, compared after resolving it to an absolute path
+     * @return Position of the file (0-based), -1 if it is not open
+     */
+    int FindFile(const QString &filePath) const;
+
+    /**
+     * @brief Get paths of all open files in the order they were opened
+     * @return QStringList containing absolute file paths
+     */
+    QStringList GetFilePaths() const;
+
+    /**
+     * @brief Get the worker holding an open file
+     * @param index Position of the file (0-based)
+     * @return Worker owned by the workspace, nullptr if index is out of range
+     */
+    XMLWorker *GetWorker(int index) const;
+
+    /**
+     * @brief Get the pool shared by all files of the workspace
+     * @return Shared pointer to the string pool (never null)
+     */
+    QSharedPointer<StringPool> GetStringPool() const;
+
+private:
+    /**
+     * @brief Get the absolute path a file is identified by
+     */
+    static QString GetFileKey(const QString &filePath);
+
+    QList<QSharedPointer<XMLWorker>> Workers;  // Workers of the open files in the order they were opened
+    QStringList FilePaths;               // Absolute path of each open file (same order as Workers)
+    QSharedPointer<StringPool> Pool;     // Pool shared by all workers (never null)
+    XMLWorker::LoadMode Mode;            // Load mode of files opened from now on
+    bool SidecarCacheEnabled;            // Flag indicating new workers use sidecars (true) or always parse (false)
+    QThreadPool FilePool;                // Threads loading files concurrently
+};
+
+#endif // XMLWORKSPACE_H